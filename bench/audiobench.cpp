@@ -0,0 +1,73 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "audiosystem.hpp"
+
+namespace nabla2d
+{
+    // One 512 frame callback mixing range(0) looping voices of one second of noise, all real.
+    // range(1) plays them at another pitch so every voice is resampled.
+    static void BM_AudioMix(benchmark::State &aState)
+    {
+        const auto voices = static_cast<std::size_t>(aState.range(0));
+        const std::size_t frames = 512;
+
+        AudioSystem audioSystem;
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> sample(-1.0F, 1.0F);
+        std::vector<float> noise(static_cast<std::size_t>(audioSystem.GetSampleRate()));
+        for (auto &value : noise)
+        {
+            value = sample(random);
+        }
+        const auto sound = audioSystem.LoadSamples(noise, 1, audioSystem.GetSampleRate());
+
+        audioSystem.SetRealVoiceCount(voices);
+        for (std::size_t i = 0; i < voices; ++i)
+        {
+            AudioSystem::PlayParameters parameters;
+            parameters.volume = 1.0F / static_cast<float>(voices);
+            parameters.pan = static_cast<float>(i % 3) - 1.0F;
+            parameters.pitch = aState.range(1) != 0 ? 0.75F + 0.01F * static_cast<float>(i % 50) : 1.0F;
+            parameters.loop = true;
+            audioSystem.Play(sound, parameters);
+        }
+
+        std::vector<float> output(frames * 2);
+        for (auto _ : aState)
+        {
+            audioSystem.Render(output.data(), frames);
+            benchmark::DoNotOptimize(output.data());
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(voices * frames));
+        aState.counters["load"] = static_cast<double>(audioSystem.GetStats().load);
+    }
+    BENCHMARK(BM_AudioMix)
+        ->ArgNames({"voices", "resample"})
+        ->ArgsProduct({{32, 256}, {0, 1}})
+        ->Unit(benchmark::kMicrosecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
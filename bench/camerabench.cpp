@@ -0,0 +1,100 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <benchmark/benchmark.h>
+
+#include "camera.hpp"
+
+namespace nabla2d
+{
+    static void BM_CameraUpdateMoved(benchmark::State &aState)
+    {
+        Camera camera({0.0F, 0.0F, 10.0F});
+        float x = 0.0F;
+        for (auto _ : aState)
+        {
+            camera.SetPosition({x, 0.0F, 10.0F});
+            camera.Update();
+            benchmark::DoNotOptimize(camera.GetProjectionViewMatrix());
+            x += 0.01F;
+        }
+    }
+    BENCHMARK(BM_CameraUpdateMoved);
+
+    static void BM_CameraUpdateProjection(benchmark::State &aState)
+    {
+        Camera camera({0.0F, 0.0F, 10.0F});
+        auto settings = camera.GetProjectionSettings();
+        for (auto _ : aState)
+        {
+            settings.aspectRatio = settings.aspectRatio == 1.0F ? 16.0F / 9.0F : 1.0F;
+            camera.SetProjectionSettings(settings);
+            camera.Update();
+            benchmark::DoNotOptimize(camera.GetProjectionViewMatrix());
+        }
+    }
+    BENCHMARK(BM_CameraUpdateProjection);
+
+    static void BM_CameraUpdateStill(benchmark::State &aState)
+    {
+        Camera camera({0.0F, 0.0F, 10.0F});
+        camera.Update();
+        for (auto _ : aState)
+        {
+            camera.Update();
+            benchmark::DoNotOptimize(camera.GetProjectionViewMatrix());
+        }
+    }
+    BENCHMARK(BM_CameraUpdateStill);
+
+    static void BM_CameraUpdateMovedOrthographic(benchmark::State &aState)
+    {
+        Camera camera({0.0F, 0.0F, 10.0F});
+        auto settings = camera.GetProjectionSettings();
+        settings.projection = Camera::PROJECTION_ORTHOGRAPHIC;
+        settings.pixelSnap = true;
+        camera.SetProjectionSettings(settings);
+        float x = 0.0F;
+        for (auto _ : aState)
+        {
+            camera.SetPosition({x, 0.0F, 10.0F});
+            camera.Update();
+            benchmark::DoNotOptimize(camera.GetProjectionViewMatrix());
+            x += 0.01F;
+        }
+    }
+    BENCHMARK(BM_CameraUpdateMovedOrthographic);
+
+    static void BM_CameraScreenToWorld(benchmark::State &aState)
+    {
+        Camera camera({0.0F, 0.0F, 10.0F});
+        camera.Update();
+        glm::vec2 screen{0.0F, 0.0F};
+        for (auto _ : aState)
+        {
+            benchmark::DoNotOptimize(camera.ScreenToWorld(screen));
+            screen.x = screen.x < 1600.0F ? screen.x + 1.0F : 0.0F;
+        }
+    }
+    BENCHMARK(BM_CameraScreenToWorld);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
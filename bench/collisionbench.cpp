@@ -0,0 +1,119 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "scene.hpp"
+#include "jobsystem.hpp"
+#include "components.hpp"
+#include "collisionsystem.hpp"
+#include "scenegenerator.hpp"
+
+namespace nabla2d
+{
+    // aCount unit sized colliders, half boxes and half circles, spread so each one touches
+    // about one other. Returns their velocities.
+    static std::vector<glm::vec2> CreateColliders(Scene &aScene, std::size_t aCount)
+    {
+        auto &registry = aScene.GetRegistry();
+        const auto entities = SceneGenerator::Flat(aScene, aCount);
+        const float size = std::sqrt(static_cast<float>(aCount) * 4.0F);
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> position(0.0F, size);
+        std::uniform_real_distribution<float> velocity(-0.1F, 0.1F);
+
+        std::vector<glm::vec2> velocities;
+        velocities.reserve(aCount);
+        for (std::size_t i = 0; i < entities.size(); ++i)
+        {
+            auto &world = registry.emplace<WorldTransform>(entities[i]);
+            world.matrix[3] = glm::vec4(position(random), position(random), 0.0F, 1.0F);
+            if (i % 2 == 0)
+            {
+                registry.emplace<BoxCollider>(entities[i]);
+            }
+            else
+            {
+                registry.emplace<CircleCollider>(entities[i]);
+            }
+            velocities.emplace_back(velocity(random), velocity(random));
+        }
+        return velocities;
+    }
+
+    // Every collider moves every tick. range(1) is the worker count, 0 for one per hardware thread.
+    static void BM_CollisionSystemUpdate(benchmark::State &aState)
+    {
+        Scene scene;
+        const auto velocities = CreateColliders(scene, static_cast<std::size_t>(aState.range(0)));
+        auto view = scene.GetRegistry().view<WorldTransform>();
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(1)));
+        CollisionSystem collisionSystem(jobSystem);
+        collisionSystem.Update(scene.GetRegistry());
+
+        std::size_t contacts = 0;
+        for (auto _ : aState)
+        {
+            std::size_t i = 0;
+            view.each([&velocities, &i](WorldTransform &aWorld)
+                      { aWorld.matrix[3] += glm::vec4(velocities[i++], 0.0F, 0.0F); });
+            collisionSystem.Update(scene.GetRegistry());
+            contacts += collisionSystem.GetContacts().size();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+        aState.counters["contacts"] = benchmark::Counter(static_cast<double>(contacts), benchmark::Counter::kAvgIterations);
+    }
+    BENCHMARK(BM_CollisionSystemUpdate)
+        ->ArgNames({"colliders", "workers"})
+        ->ArgsProduct({{1000, 10000, 50000}, {1, 0}})
+        ->Unit(benchmark::kMillisecond);
+
+    // What the broadphase replaces: every pair of bounding boxes
+    static void BM_CollisionBruteForce(benchmark::State &aState)
+    {
+        Scene scene;
+        CreateColliders(scene, static_cast<std::size_t>(aState.range(0)));
+        std::vector<glm::vec2> centers;
+        scene.GetRegistry().view<WorldTransform>().each([&centers](const WorldTransform &aWorld)
+                                                        { centers.emplace_back(aWorld.matrix[3]); });
+
+        for (auto _ : aState)
+        {
+            std::size_t contacts = 0;
+            for (std::size_t i = 0; i < centers.size(); ++i)
+            {
+                for (auto j = i + 1; j < centers.size(); ++j)
+                {
+                    const auto delta = glm::abs(centers[i] - centers[j]);
+                    contacts += delta.x <= 1.0F && delta.y <= 1.0F ? 1 : 0;
+                }
+            }
+            benchmark::DoNotOptimize(contacts);
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_CollisionBruteForce)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
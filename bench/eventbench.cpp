@@ -0,0 +1,110 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "eventbus.hpp"
+#include "jobsystem.hpp"
+
+namespace nabla2d
+{
+    struct DamageEvent
+    {
+        uint32_t entity;
+        float amount;
+    };
+
+    // range(0) events published on the game thread, then dispatched to one handler
+    static void BM_EventBusPublish(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        EventBus bus;
+        bus.SetCapacity<DamageEvent>(count);
+        float total = 0.0F;
+        bus.Subscribe<DamageEvent>([&total](const std::vector<DamageEvent> &aEvents)
+                                   {
+                                       for (const auto &event : aEvents)
+                                       {
+                                           total += event.amount;
+                                       } });
+
+        for (auto _ : aState)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                bus.Publish(DamageEvent{static_cast<uint32_t>(i), 1.0F});
+            }
+            bus.Dispatch();
+        }
+        benchmark::DoNotOptimize(total);
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(count));
+        aState.counters["dropped"] = static_cast<double>(bus.GetDroppedCount());
+    }
+    BENCHMARK(BM_EventBusPublish)
+        ->ArgNames({"events"})
+        ->Arg(1024)
+        ->Arg(65536)
+        ->Unit(benchmark::kMicrosecond);
+
+    // range(0) chunks of range(1) events published over the job system, one queue per worker
+    // thread, then one dispatch on the game thread
+    static void BM_EventBusWorkers(benchmark::State &aState)
+    {
+        const auto chunks = static_cast<std::size_t>(aState.range(0));
+        const auto count = static_cast<std::size_t>(aState.range(1));
+        JobSystem jobSystem(chunks - 1);
+        EventBus bus;
+        // One thread may end up publishing every chunk
+        bus.SetCapacity<DamageEvent>(chunks * count);
+        float total = 0.0F;
+        bus.Subscribe<DamageEvent>([&total](const std::vector<DamageEvent> &aEvents)
+                                   {
+                                       for (const auto &event : aEvents)
+                                       {
+                                           total += event.amount;
+                                       } });
+
+        for (auto _ : aState)
+        {
+            jobSystem.ParallelFor(chunks, 1, [&bus, count](std::size_t aBegin, std::size_t aEnd)
+                                  {
+                                      for (std::size_t chunk = aBegin; chunk < aEnd; ++chunk)
+                                      {
+                                          for (std::size_t i = 0; i < count; ++i)
+                                          {
+                                              bus.Publish(DamageEvent{static_cast<uint32_t>(chunk * count + i), 1.0F});
+                                          }
+                                      } });
+            bus.Dispatch();
+        }
+        benchmark::DoNotOptimize(total);
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(chunks * count));
+        aState.counters["dropped"] = static_cast<double>(bus.GetDroppedCount());
+    }
+    BENCHMARK(BM_EventBusWorkers)
+        ->ArgNames({"threads", "events"})
+        ->ArgsProduct({{2, 4, 8}, {16384}})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
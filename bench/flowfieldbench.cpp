@@ -0,0 +1,163 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "scene.hpp"
+#include "navgrid.hpp"
+#include "jobsystem.hpp"
+#include "components.hpp"
+#include "transform2d.hpp"
+#include "flowfieldsystem.hpp"
+
+namespace nabla2d
+{
+    // aSize x aSize grid, about a fifth of it blocked and a fifth with a higher cost
+    static void CreateGrid(NavGrid &aGrid, int aSize)
+    {
+        aGrid.Resize(aSize, aSize);
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> cell(0, aSize - 1);
+        std::uniform_int_distribution<int> cost(2, 8);
+        for (int i = 0; i < aSize * aSize / 5; ++i)
+        {
+            aGrid.SetCost(cell(random), cell(random), NavGrid::kBlocked);
+            aGrid.SetCost(cell(random), cell(random), static_cast<uint8_t>(cost(random)));
+        }
+        std::vector<uint32_t> changes;
+        aGrid.TakeChanges(changes);
+    }
+
+    // Goals spread over the grid, one field per goal
+    static std::vector<glm::ivec2> GetGoal(int aSize, int aField)
+    {
+        const auto step = aSize / 4;
+        return {{step + (aField % 3) * step, step + (aField / 3 % 3) * step}};
+    }
+
+    // Full rebuild: range(0) grid size, range(1) fields, range(2) workers (0 for one per
+    // hardware thread)
+    static void BM_FlowFieldIntegrate(benchmark::State &aState)
+    {
+        const auto size = static_cast<int>(aState.range(0));
+        const auto fieldCount = static_cast<int>(aState.range(1));
+        NavGrid grid;
+        CreateGrid(grid, size);
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(2)));
+        FlowFieldSystem flowFieldSystem(jobSystem, grid);
+        for (int field = 0; field < fieldCount; ++field)
+        {
+            flowFieldSystem.AddField(GetGoal(size, field));
+        }
+
+        const std::vector<uint32_t> changes;
+        for (auto _ : aState)
+        {
+            for (int field = 0; field < fieldCount; ++field)
+            {
+                flowFieldSystem.SetGoals(static_cast<FlowFieldSystem::FieldID>(field), GetGoal(size, field));
+            }
+            flowFieldSystem.Update(changes);
+        }
+        aState.SetItemsProcessed(aState.iterations() * fieldCount * size * size);
+    }
+    BENCHMARK(BM_FlowFieldIntegrate)
+        ->ArgNames({"size", "fields", "workers"})
+        ->ArgsProduct({{128, 512}, {1, 8}, {1, 0}})
+        ->Unit(benchmark::kMillisecond);
+
+    // A few tiles toggled per update on a 512 grid. range(0) 1 repairs the fields, 0 rebuilds
+    // them for comparison.
+    static void BM_FlowFieldTileChange(benchmark::State &aState)
+    {
+        const int size = 512;
+        const bool repair = aState.range(0) != 0;
+        NavGrid grid;
+        CreateGrid(grid, size);
+        JobSystem jobSystem(1);
+        FlowFieldSystem flowFieldSystem(jobSystem, grid);
+        flowFieldSystem.AddField(GetGoal(size, 0));
+        flowFieldSystem.Update({});
+
+        std::mt19937 random(2);
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        std::vector<uint32_t> changes;
+        for (auto _ : aState)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                const auto x = cell(random);
+                const auto y = cell(random);
+                grid.SetCost(x, y, grid.IsBlocked(x, y) ? NavGrid::kDefaultCost : NavGrid::kBlocked);
+            }
+            grid.TakeChanges(changes);
+            if (!repair)
+            {
+                flowFieldSystem.SetGoals(0, GetGoal(size, 0));
+            }
+            flowFieldSystem.Update(changes);
+        }
+        aState.SetLabel(repair ? "repair" : "rebuild");
+    }
+    BENCHMARK(BM_FlowFieldTileChange)->ArgName("repair")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+    // Steering pass only: range(0) agents on a 256 grid, range(1) workers
+    static void BM_FlowFieldSteer(benchmark::State &aState)
+    {
+        const int size = 256;
+        const auto agentCount = static_cast<std::size_t>(aState.range(0));
+        NavGrid grid;
+        CreateGrid(grid, size);
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(1)));
+        FlowFieldSystem flowFieldSystem(jobSystem, grid);
+        for (int field = 0; field < 4; ++field)
+        {
+            flowFieldSystem.AddField(GetGoal(size, field));
+        }
+        flowFieldSystem.Update({});
+
+        Scene scene;
+        const auto entities = scene.CreateEntities(std::vector<StringID>(agentCount), std::vector<uint32_t>(agentCount, Scene::kNoParent));
+        auto &registry = scene.GetRegistry();
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> position(0.0F, static_cast<float>(size));
+        for (std::size_t i = 0; i < agentCount; ++i)
+        {
+            registry.emplace<Transform2D>(entities[i], glm::vec2{position(random), position(random)});
+            registry.emplace<FlowAgent>(entities[i], FlowAgent{static_cast<uint32_t>(i % 4)});
+        }
+
+        for (auto _ : aState)
+        {
+            flowFieldSystem.Steer(scene, 1.0F / 60.0F);
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(agentCount));
+    }
+    BENCHMARK(BM_FlowFieldSteer)
+        ->ArgNames({"agents", "workers"})
+        ->ArgsProduct({{1 << 10, 1 << 14}, {1, 0}})
+        ->Unit(benchmark::kMicrosecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,166 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+
+#include <random>
+#include <vector>
+#include <utility>
+#include <benchmark/benchmark.h>
+
+#include "navgrid.hpp"
+#include "jobsystem.hpp"
+#include "pathfinder.hpp"
+#include "pathfindingsystem.hpp"
+
+namespace nabla2d
+{
+    // aSize x aSize map of random straight walls, with some loose blocked cells
+    static void CreateMap(NavGrid &aGrid, int aSize)
+    {
+        aGrid.Resize(aSize, aSize);
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> cell(0, aSize - 1);
+        std::uniform_int_distribution<int> length(5, 45);
+        for (int i = 0; i < aSize * aSize / 160; ++i)
+        {
+            const auto x = cell(random);
+            const auto y = cell(random);
+            const auto wallLength = length(random);
+            const bool horizontal = (random() & 1U) != 0;
+            for (int j = 0; j < wallLength; ++j)
+            {
+                aGrid.SetCost(horizontal ? x + j : x, horizontal ? y : y + j, NavGrid::kBlocked);
+            }
+        }
+        for (int i = 0; i < aSize * aSize / 40; ++i)
+        {
+            aGrid.SetCost(cell(random), cell(random), NavGrid::kBlocked);
+        }
+        std::vector<uint32_t> changes;
+        aGrid.TakeChanges(changes);
+    }
+
+    // Reachable start and goal pairs at least half the map apart
+    static std::vector<std::pair<glm::ivec2, glm::ivec2>> CreateQueries(const Pathfinder &aPathfinder, const NavGrid &aGrid, std::size_t aCount)
+    {
+        std::mt19937 random(2);
+        std::uniform_int_distribution<int> cell(0, aGrid.GetWidth() - 1);
+        Pathfinder::Context context;
+        std::vector<glm::ivec2> path;
+        std::vector<std::pair<glm::ivec2, glm::ivec2>> queries;
+        while (queries.size() < aCount)
+        {
+            const glm::ivec2 start(cell(random), cell(random));
+            const glm::ivec2 goal(cell(random), cell(random));
+            if (std::abs(goal.x - start.x) + std::abs(goal.y - start.y) < aGrid.GetWidth() / 2)
+            {
+                continue;
+            }
+            if (aPathfinder.FindPath(context, start, goal, Pathfinder::SEARCH_JPSPLUS, path))
+            {
+                queries.emplace_back(start, goal);
+            }
+        }
+        return queries;
+    }
+
+    // range(0) search (0 A*, 1 JPS+, 2 hierarchical), range(1) map size
+    static void BM_PathfindingSearch(benchmark::State &aState)
+    {
+        const auto search = static_cast<Pathfinder::Search>(aState.range(0));
+        NavGrid grid;
+        CreateMap(grid, static_cast<int>(aState.range(1)));
+        JobSystem jobSystem;
+        Pathfinder pathfinder(grid);
+        pathfinder.Update(jobSystem);
+        const auto queries = CreateQueries(pathfinder, grid, 32);
+
+        Pathfinder::Context context;
+        std::vector<glm::ivec2> path;
+        std::size_t expanded = 0;
+        for (auto _ : aState)
+        {
+            for (const auto &query : queries)
+            {
+                benchmark::DoNotOptimize(pathfinder.FindPath(context, query.first, query.second, search, path));
+                expanded += context.GetExpandedCount();
+            }
+        }
+        const auto searches = aState.iterations() * static_cast<int64_t>(queries.size());
+        aState.SetItemsProcessed(searches);
+        aState.counters["expanded"] = static_cast<double>(expanded) / static_cast<double>(searches);
+        const char *labels[] = {"A*", "JPS+", "hierarchical"};
+        aState.SetLabel(labels[aState.range(0)]);
+    }
+    BENCHMARK(BM_PathfindingSearch)
+        ->ArgNames({"search", "size"})
+        ->ArgsProduct({{Pathfinder::SEARCH_ASTAR, Pathfinder::SEARCH_JPSPLUS, Pathfinder::SEARCH_HIERARCHICAL}, {256, 1024}})
+        ->Unit(benchmark::kMicrosecond);
+
+    // Jump distances and cluster graph from scratch, range(0) workers (0 for one per hardware
+    // thread)
+    static void BM_PathfindingPreprocess(benchmark::State &aState)
+    {
+        NavGrid grid;
+        CreateMap(grid, 1024);
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            Pathfinder pathfinder(grid);
+            pathfinder.Update(jobSystem);
+            benchmark::DoNotOptimize(pathfinder.GetEdgeCount());
+        }
+    }
+    BENCHMARK(BM_PathfindingPreprocess)->ArgName("workers")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+    // 256 hierarchical requests answered by one unbudgeted update, range(0) workers
+    static void BM_PathfindingRequests(benchmark::State &aState)
+    {
+        NavGrid grid;
+        CreateMap(grid, 1024);
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(0)));
+        Pathfinder pathfinder(grid);
+        pathfinder.Update(jobSystem);
+        const auto queries = CreateQueries(pathfinder, grid, 256);
+        PathfindingSystem pathfindingSystem(jobSystem, grid);
+        pathfindingSystem.SetBudget(static_cast<std::size_t>(-1));
+
+        std::vector<PathfindingSystem::RequestID> requests;
+        std::vector<glm::vec2> waypoints;
+        for (auto _ : aState)
+        {
+            requests.clear();
+            for (const auto &query : queries)
+            {
+                requests.push_back(pathfindingSystem.RequestPath(grid.CellToWorld(query.first), grid.CellToWorld(query.second)));
+            }
+            pathfindingSystem.Update({});
+            for (const auto request : requests)
+            {
+                pathfindingSystem.TakePath(request, waypoints);
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(queries.size()));
+    }
+    BENCHMARK(BM_PathfindingRequests)->ArgName("workers")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,92 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "scene.hpp"
+#include "jobsystem.hpp"
+#include "components.hpp"
+#include "transform2d.hpp"
+#include "physicssystem.hpp"
+#include "collisionsystem.hpp"
+#include "hierarchysystem.hpp"
+
+namespace nabla2d
+{
+    // aCount pyramids of unit boxes, aBase boxes wide, standing side by side on one static ground
+    static void CreatePyramids(Scene &aScene, std::size_t aBase, std::size_t aCount)
+    {
+        const float spacing = 1.05F;
+        const float width = static_cast<float>(aBase) * spacing + 4.0F;
+        const std::size_t boxCount = aCount * aBase * (aBase + 1) / 2;
+        const auto entities = aScene.CreateEntities(std::vector<StringID>(boxCount + 1), std::vector<uint32_t>(boxCount + 1, Scene::kNoParent));
+
+        auto &registry = aScene.GetRegistry();
+        const auto ground = entities.back();
+        registry.emplace<Transform2D>(ground, glm::vec2{width * static_cast<float>(aCount) * 0.5F, -0.5F});
+        registry.emplace<BoxCollider>(ground, BoxCollider{{0.0F, 0.0F}, {width * static_cast<float>(aCount) * 0.5F, 0.5F}});
+
+        std::size_t next = 0;
+        for (std::size_t pyramid = 0; pyramid < aCount; ++pyramid)
+        {
+            for (std::size_t row = 0; row < aBase; ++row)
+            {
+                for (std::size_t column = 0; column < aBase - row; ++column)
+                {
+                    const auto entity = entities[next++];
+                    const float x = width * static_cast<float>(pyramid) + 2.0F + (static_cast<float>(column) + static_cast<float>(row) * 0.5F) * spacing;
+                    registry.emplace<Transform2D>(entity, glm::vec2{x, 0.5F + static_cast<float>(row)});
+                    registry.emplace<BoxCollider>(entity);
+                    registry.emplace<RigidBody>(entity);
+                }
+            }
+        }
+    }
+
+    // One fixed tick: world transforms, contacts, then the solver. range(0) pyramids of base
+    // 20 (210 bodies each), range(1) workers (0 for one per hardware thread), range(2) sleeping.
+    static void BM_PhysicsPyramids(benchmark::State &aState)
+    {
+        Scene scene;
+        CreatePyramids(scene, 20, static_cast<std::size_t>(aState.range(0)));
+        JobSystem jobSystem(static_cast<std::size_t>(aState.range(1)));
+        CollisionSystem collisionSystem(jobSystem);
+        PhysicsSystem physicsSystem(jobSystem);
+        physicsSystem.SetSleepEnabled(aState.range(2) != 0);
+
+        for (auto _ : aState)
+        {
+            HierarchySystem::Update(scene);
+            collisionSystem.Update(scene.GetRegistry());
+            physicsSystem.Step(scene, collisionSystem, 1.0F / 60.0F);
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(physicsSystem.GetBodyCount()));
+        aState.counters["bodies"] = static_cast<double>(physicsSystem.GetBodyCount());
+        aState.counters["awakeIslands"] = static_cast<double>(physicsSystem.GetAwakeIslandCount());
+    }
+    BENCHMARK(BM_PhysicsPyramids)
+        ->ArgNames({"pyramids", "workers", "sleep"})
+        ->ArgsProduct({{8, 48}, {1, 0}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
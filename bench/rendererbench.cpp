@@ -0,0 +1,116 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "camera.hpp"
+#include "sprite.hpp"
+#include "transform.hpp"
+#include "components.hpp"
+#include "rendersystem.hpp"
+#include "scenegenerator.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // CPU side of sprite submission (texture bind, MVP, draw call), measured against
+    // the null backend so GPU and driver time stay out of it
+    static void BM_RendererSubmitSprites(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        std::unique_ptr<Sprite> sprite(Sprite::FromJSON(renderer, NABLA2D_ASSETS_DIR "/ball.json", {1.0F, 1.0F}, "roll"));
+
+        auto transforms = SceneGenerator::RandomTransforms(count);
+        std::vector<glm::mat4> matrices;
+        matrices.reserve(count);
+        for (auto &transform : transforms)
+        {
+            matrices.push_back(transform.GetMatrix());
+        }
+
+        Camera camera({0.0F, 0.0F, 150.0F});
+        camera.Update();
+
+        for (auto _ : aState)
+        {
+            renderer->Clear();
+            for (const auto &matrix : matrices)
+            {
+                sprite->Draw(camera, matrix);
+            }
+            renderer->Render();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_RendererSubmitSprites)->Arg(1 << 10)->Arg(1 << 14);
+
+    // Same sprites as above, drawn from the registry by RenderSystem
+    static void BM_RenderSystemDraw(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        std::unique_ptr<Sprite> sprite(Sprite::FromJSON(renderer, NABLA2D_ASSETS_DIR "/ball.json", {1.0F, 1.0F}, "roll"));
+
+        Scene scene;
+        auto &registry = scene.GetRegistry();
+        const auto entities = SceneGenerator::Flat(scene, count);
+        for (auto entity : entities)
+        {
+            registry.emplace<WorldTransform>(entity, registry.get<Transform>(entity).GetMatrix());
+            registry.emplace<SpriteRenderer>(entity, sprite->GetSpriteRenderer());
+        }
+
+        Camera camera({0.0F, 0.0F, 150.0F});
+        camera.Update();
+
+        RenderSystem renderSystem;
+        for (auto _ : aState)
+        {
+            renderer->Clear();
+            renderSystem.Draw(scene, *renderer, camera);
+            renderer->Render();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_RenderSystemDraw)->Arg(1 << 10)->Arg(1 << 14);
+
+    static void BM_RendererLoadDeleteData(benchmark::State &aState)
+    {
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        const std::vector<std::pair<glm::vec3, glm::vec2>> quad = {
+            {{-0.5F, -0.5F, 0.0F}, {0.0F, 0.0F}},
+            {{0.5F, -0.5F, 0.0F}, {1.0F, 0.0F}},
+            {{0.5F, 0.5F, 0.0F}, {1.0F, 1.0F}},
+            {{-0.5F, 0.5F, 0.0F}, {0.0F, 1.0F}}};
+        const std::vector<unsigned int> indices = {0, 1, 2, 2, 3, 0};
+        for (auto _ : aState)
+        {
+            const auto handle = renderer->LoadData(quad, indices);
+            renderer->DeleteData(handle);
+        }
+    }
+    BENCHMARK(BM_RendererLoadDeleteData);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,198 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <filesystem>
+#include <benchmark/benchmark.h>
+
+#include "scene.hpp"
+#include "stringid.hpp"
+#include "sceneserializer.hpp"
+#include "scenegenerator.hpp"
+
+namespace nabla2d
+{
+    static void BM_SceneCreateEntity(benchmark::State &aState)
+    {
+        const auto tags = SceneGenerator::Tags(static_cast<std::size_t>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            aState.PauseTiming();
+            Scene scene;
+            aState.ResumeTiming();
+            for (const auto &tag : tags)
+            {
+                benchmark::DoNotOptimize(scene.CreateEntity(tag));
+            }
+            aState.PauseTiming();
+            scene.Clear();
+            aState.ResumeTiming();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SceneCreateEntity)->Arg(1 << 10)->Arg(1 << 14);
+
+    static void BM_SceneCreateEntities(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        const std::vector<StringID> tags(count);
+        const std::vector<uint32_t> parents(count, Scene::kNoParent);
+        for (auto _ : aState)
+        {
+            aState.PauseTiming();
+            Scene scene;
+            aState.ResumeTiming();
+            benchmark::DoNotOptimize(scene.CreateEntities(tags, parents));
+            aState.PauseTiming();
+            scene.Clear();
+            aState.ResumeTiming();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SceneCreateEntities)->Arg(1 << 10)->Arg(1 << 14);
+
+    // Moves every entity of a flat scene back and forth between two parents
+    static void BM_SceneSetParent(benchmark::State &aState)
+    {
+        Scene scene;
+        const auto entities = SceneGenerator::Flat(scene, static_cast<std::size_t>(aState.range(0)));
+        const auto parents = SceneGenerator::Flat(scene, 2);
+        std::size_t pass = 0;
+        for (auto _ : aState)
+        {
+            for (std::size_t i = 0; i < entities.size(); ++i)
+            {
+                scene.SetParent(entities[i], parents[(i + pass) & 1]);
+            }
+            ++pass;
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SceneSetParent)->Arg(1 << 10)->Arg(1 << 13);
+
+    static void BM_SceneDestroyEntity(benchmark::State &aState)
+    {
+        int64_t destroyed = 0;
+        for (auto _ : aState)
+        {
+            aState.PauseTiming();
+            Scene scene;
+            const auto entities = SceneGenerator::Tree(scene, static_cast<std::size_t>(aState.range(0)), 4);
+            aState.ResumeTiming();
+            for (auto it = entities.rbegin(); it != entities.rend(); ++it)
+            {
+                scene.DestroyEntity(*it);
+            }
+            destroyed += static_cast<int64_t>(entities.size());
+        }
+        aState.SetItemsProcessed(destroyed);
+    }
+    BENCHMARK(BM_SceneDestroyEntity)->Arg(5)->Arg(7);
+
+    static void BM_SceneDestroyEntities(benchmark::State &aState)
+    {
+        int64_t destroyed = 0;
+        for (auto _ : aState)
+        {
+            aState.PauseTiming();
+            Scene scene;
+            const auto entities = SceneGenerator::Tree(scene, static_cast<std::size_t>(aState.range(0)), 4);
+            aState.ResumeTiming();
+            scene.DestroyEntities(entities);
+            destroyed += static_cast<int64_t>(entities.size());
+        }
+        aState.SetItemsProcessed(destroyed);
+    }
+    BENCHMARK(BM_SceneDestroyEntities)->Arg(5)->Arg(7);
+
+    static void BM_SceneGetEntityTree(benchmark::State &aState)
+    {
+        Scene scene;
+        const auto entities = SceneGenerator::Tree(scene, static_cast<std::size_t>(aState.range(0)), 4);
+        for (auto _ : aState)
+        {
+            // Reparenting a root onto itself is enough to dirty the cached tree
+            scene.SetParent(entities.front(), entt::null);
+            benchmark::DoNotOptimize(scene.GetEntityTree());
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(entities.size()));
+    }
+    BENCHMARK(BM_SceneGetEntityTree)->Arg(5)->Arg(7);
+
+    // aCount entities with a Transform, entity i is the child of entity (i - 1) / 4
+    static void CreateSavedScene(Scene &aScene, std::size_t aCount)
+    {
+        SceneSerializer::RegisterComponent<Transform>("Transform");
+        const auto entities = SceneGenerator::Flat(aScene, aCount);
+        for (std::size_t i = 1; i < entities.size(); ++i)
+        {
+            aScene.SetParent(entities[i], entities[(i - 1) / 4]);
+        }
+    }
+
+    static std::string GetScenePath(const std::string &aName)
+    {
+        return (std::filesystem::temp_directory_path() / ("nabla2d_scenebench_" + aName + ".n2ds")).string();
+    }
+
+    static void BM_SceneSave(benchmark::State &aState)
+    {
+        Scene scene;
+        CreateSavedScene(scene, static_cast<std::size_t>(aState.range(0)));
+        const auto path = GetScenePath("save");
+        for (auto _ : aState)
+        {
+            if (!SceneSerializer::Save(scene, path))
+            {
+                aState.SkipWithError("Failed to save the scene");
+                break;
+            }
+        }
+        std::filesystem::remove(path);
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SceneSave)->Arg(1 << 14)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+    // Load clears the scene it's given, so every iteration restores the whole file again
+    static void BM_SceneLoad(benchmark::State &aState)
+    {
+        const auto path = GetScenePath("load");
+        {
+            Scene source;
+            CreateSavedScene(source, static_cast<std::size_t>(aState.range(0)));
+            SceneSerializer::Save(source, path);
+        }
+
+        Scene scene;
+        for (auto _ : aState)
+        {
+            if (!SceneSerializer::Load(scene, path))
+            {
+                aState.SkipWithError("Failed to load the scene");
+                break;
+            }
+        }
+        std::filesystem::remove(path);
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SceneLoad)->Arg(1 << 14)->Arg(200000)->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
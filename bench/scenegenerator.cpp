@@ -0,0 +1,107 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "scenegenerator.hpp"
+
+#include <random>
+
+#include "stringid.hpp"
+
+namespace nabla2d
+{
+    std::vector<entt::entity> SceneGenerator::Flat(Scene &aScene, std::size_t aCount, uint32_t aSeed)
+    {
+        return Create(aScene, std::vector<uint32_t>(aCount, Scene::kNoParent), aSeed);
+    }
+
+    std::vector<entt::entity> SceneGenerator::Chain(Scene &aScene, std::size_t aDepth, uint32_t aSeed)
+    {
+        std::vector<uint32_t> parents(aDepth);
+        for (std::size_t i = 0; i < aDepth; ++i)
+        {
+            parents[i] = i == 0 ? Scene::kNoParent : static_cast<uint32_t>(i - 1);
+        }
+        return Create(aScene, parents, aSeed);
+    }
+
+    std::vector<entt::entity> SceneGenerator::Tree(Scene &aScene, std::size_t aDepth, std::size_t aBranching, uint32_t aSeed)
+    {
+        std::vector<uint32_t> parents;
+        if (aDepth == 0)
+        {
+            return {};
+        }
+
+        parents.push_back(Scene::kNoParent);
+        std::size_t levelBegin = 0;
+        std::size_t levelEnd = 1;
+        for (std::size_t depth = 1; depth < aDepth; ++depth)
+        {
+            for (std::size_t parent = levelBegin; parent < levelEnd; ++parent)
+            {
+                parents.insert(parents.end(), aBranching, static_cast<uint32_t>(parent));
+            }
+            levelBegin = levelEnd;
+            levelEnd = parents.size();
+        }
+        return Create(aScene, parents, aSeed);
+    }
+
+    std::vector<Transform> SceneGenerator::RandomTransforms(std::size_t aCount, uint32_t aSeed)
+    {
+        std::mt19937 random(aSeed);
+        std::uniform_real_distribution<float> position(-100.0F, 100.0F);
+        std::uniform_real_distribution<float> angle(-180.0F, 180.0F);
+        std::uniform_real_distribution<float> scale(0.5F, 2.0F);
+
+        std::vector<Transform> transforms;
+        transforms.reserve(aCount);
+        for (std::size_t i = 0; i < aCount; ++i)
+        {
+            const auto s = scale(random);
+            transforms.emplace_back(glm::vec3{position(random), position(random), 0.0F},
+                                    glm::vec3{0.0F, 0.0F, angle(random)},
+                                    glm::vec3{s, s, 1.0F});
+        }
+        return transforms;
+    }
+
+    std::vector<std::string> SceneGenerator::Tags(std::size_t aCount, const std::string &aPrefix)
+    {
+        std::vector<std::string> tags;
+        tags.reserve(aCount);
+        for (std::size_t i = 0; i < aCount; ++i)
+        {
+            tags.push_back(aPrefix + "_" + std::to_string(i));
+        }
+        return tags;
+    }
+
+    std::vector<entt::entity> SceneGenerator::Create(Scene &aScene, const std::vector<uint32_t> &aParents, uint32_t aSeed)
+    {
+        auto entities = aScene.CreateEntities(std::vector<StringID>(aParents.size()), aParents);
+        auto transforms = RandomTransforms(entities.size(), aSeed);
+        aScene.GetRegistry().insert<Transform>(entities.begin(), entities.end(), transforms.begin());
+        return entities;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,58 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_SCENEGENERATOR_HPP
+#define NABLA2D_SCENEGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "transform.hpp"
+
+namespace nabla2d
+{
+    // Synthetic scenes for the benchmarks. Entities are created anonymous through
+    // Scene::CreateEntities and get a Transform, generation is seeded so runs compare.
+    class SceneGenerator
+    {
+    public:
+        // aCount root entities
+        static std::vector<entt::entity> Flat(Scene &aScene, std::size_t aCount, uint32_t aSeed = 1);
+        // One chain of aDepth entities, each the child of the previous one
+        static std::vector<entt::entity> Chain(Scene &aScene, std::size_t aDepth, uint32_t aSeed = 1);
+        // Full tree with aBranching children per node, aDepth levels deep (roots included)
+        static std::vector<entt::entity> Tree(Scene &aScene, std::size_t aDepth, std::size_t aBranching, uint32_t aSeed = 1);
+
+        static std::vector<Transform> RandomTransforms(std::size_t aCount, uint32_t aSeed = 1);
+        // Unique tags ("<prefix>_<i>"), built ahead so tag formatting stays out of the timings
+        static std::vector<std::string> Tags(std::size_t aCount, const std::string &aPrefix = "entity");
+
+    private:
+        static std::vector<entt::entity> Create(Scene &aScene, const std::vector<uint32_t> &aParents, uint32_t aSeed);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_SCENEGENERATOR_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,90 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "scene.hpp"
+#include "transform2d.hpp"
+#include "scriptsystem.hpp"
+
+namespace nabla2d
+{
+    // Both scripts move every Transform2D by one unit. The first one writes through the bulk
+    // view, the second one calls into C++ twice per entity.
+    static const char *kBulkScript = R"(
+        return {
+            components = {"Transform2D"},
+            each = function(view, count, dt)
+                local x, y = view.x, view.y
+                for i = 1, count do
+                    x[i] = x[i] + 1
+                    y[i] = y[i] + 1
+                end
+            end
+        })";
+
+    static const char *kPerEntityScript = R"(
+        local transform = nabla.transform
+        return {
+            components = {"Transform2D"},
+            each = function(view, count, dt)
+                local entity = view.entity
+                for i = 1, count do
+                    local x, y = transform.get(entity[i])
+                    transform.set(entity[i], x + 1, y + 1)
+                end
+            end
+        })";
+
+    // One script tick over range(0) entities, range(1) selects the bulk view
+    static void BM_ScriptMove(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        Scene scene;
+        const auto entities = scene.CreateEntities(std::vector<StringID>(count), std::vector<uint32_t>(count, Scene::kNoParent));
+        auto &registry = scene.GetRegistry();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            registry.emplace<Transform2D>(entities[i], glm::vec2(static_cast<float>(i), 0.0F));
+        }
+
+        ScriptSystem scriptSystem(scene);
+        if (!scriptSystem.LoadSource("move", aState.range(1) != 0 ? kBulkScript : kPerEntityScript))
+        {
+            aState.SkipWithError("Cannot load the script");
+            return;
+        }
+
+        for (auto _ : aState)
+        {
+            scriptSystem.Update(1.0F / 60.0F);
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_ScriptMove)
+        ->ArgNames({"entities", "bulk"})
+        ->ArgsProduct({{1000, 50000}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,93 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "sprite.hpp"
+#include "jobsystem.hpp"
+#include "animationsystem.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    static const std::string kBallPath = NABLA2D_ASSETS_DIR "/ball.json";
+
+    static std::shared_ptr<Renderer> CreateNullRenderer()
+    {
+        return std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+    }
+
+    static void BM_SpriteUpdateAnimation(benchmark::State &aState)
+    {
+        auto renderer = CreateNullRenderer();
+        std::vector<std::unique_ptr<Sprite>> sprites;
+        for (int64_t i = 0; i < aState.range(0); ++i)
+        {
+            sprites.emplace_back(Sprite::FromJSON(renderer, kBallPath, {1.0F, 1.0F}, "roll"));
+        }
+
+        for (auto _ : aState)
+        {
+            for (auto &sprite : sprites)
+            {
+                sprite->UpdateAnimation(1.0F / 60.0F);
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_SpriteUpdateAnimation)->Arg(1 << 10)->Arg(1 << 14);
+
+    // Same workload as above, as one batched pass. Entities are only ids here, Apply isn't measured.
+    static void BM_AnimationSystemUpdate(benchmark::State &aState)
+    {
+        auto renderer = CreateNullRenderer();
+        std::unique_ptr<Sprite> sprite(Sprite::FromJSON(renderer, kBallPath));
+        JobSystem jobSystem;
+        AnimationSystem animationSystem(jobSystem);
+        const auto clip = animationSystem.AddClip(*sprite, "roll");
+        for (int64_t i = 0; i < aState.range(0); ++i)
+        {
+            animationSystem.Play(static_cast<entt::entity>(i), clip);
+        }
+
+        for (auto _ : aState)
+        {
+            animationSystem.Update(1.0F / 60.0F);
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_AnimationSystemUpdate)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 16);
+
+    static void BM_SpriteFromJSON(benchmark::State &aState)
+    {
+        auto renderer = CreateNullRenderer();
+        for (auto _ : aState)
+        {
+            std::unique_ptr<Sprite> sprite(Sprite::FromJSON(renderer, kBallPath));
+            benchmark::DoNotOptimize(sprite.get());
+        }
+    }
+    BENCHMARK(BM_SpriteFromJSON);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,146 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <memory>
+#include <random>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <benchmark/benchmark.h>
+
+#include "camera.hpp"
+#include "tilemap.hpp"
+#include "gputilemap.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // aSize x aSize map of 16 pixel tiles cut from ball.png: a full ground layer and a sparse
+    // one on top. Written to the temporary directory next to a copy of the tileset image.
+    static std::string WriteMap(int aSize)
+    {
+        const auto directory = std::filesystem::temp_directory_path() / "nabla2d_tilemapbench";
+        std::filesystem::create_directories(directory);
+        std::filesystem::copy_file(NABLA2D_ASSETS_DIR "/ball.png", directory / "ball.png", std::filesystem::copy_options::overwrite_existing);
+
+        const auto path = directory / ("map" + std::to_string(aSize) + ".tmx");
+        std::ofstream file(path);
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+             << "<map version=\"1.10\" orientation=\"orthogonal\" renderorder=\"right-down\" width=\"" << aSize << "\" height=\"" << aSize
+             << "\" tilewidth=\"16\" tileheight=\"16\" infinite=\"0\">\n"
+             << " <tileset firstgid=\"1\" name=\"ball\" tilewidth=\"16\" tileheight=\"16\" tilecount=\"9\" columns=\"3\">\n"
+             << "  <image source=\"ball.png\" width=\"48\" height=\"48\"/>\n"
+             << " </tileset>\n";
+
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> tile(1, 9);
+        const char *layers[] = {"ground", "details"};
+        for (int layer = 0; layer < 2; ++layer)
+        {
+            file << " <layer id=\"" << layer + 1 << "\" name=\"" << layers[layer] << "\" width=\"" << aSize << "\" height=\"" << aSize << "\">\n"
+                 << "  <data encoding=\"csv\">\n";
+            for (int i = 0; i < aSize * aSize; ++i)
+            {
+                const bool empty = layer == 1 && random() % 8 != 0;
+                file << (empty ? 0 : tile(random)) << (i + 1 < aSize * aSize ? "," : "\n");
+            }
+            file << "  </data>\n </layer>\n";
+        }
+        file << "</map>\n";
+        return path.string();
+    }
+
+    // Both draw the same view over the middle of the map, range(0) is the map size. The chunked
+    // Tilemap draws the chunks in view, GPUTilemap one quad per layer whatever the size.
+    static void BM_TilemapDraw(benchmark::State &aState)
+    {
+        const auto size = static_cast<int>(aState.range(0));
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        std::unique_ptr<Tilemap> tilemap(Tilemap::FromTMX(renderer, WriteMap(size)));
+        if (tilemap == nullptr)
+        {
+            aState.SkipWithError("Failed to load the map");
+            return;
+        }
+
+        Camera camera({static_cast<float>(size) * 0.5F, static_cast<float>(size) * 0.5F, 40.0F});
+        camera.Update();
+        for (auto _ : aState)
+        {
+            renderer->Clear();
+            tilemap->Draw(camera);
+            renderer->Render();
+        }
+        aState.counters["drawCalls"] = static_cast<double>(tilemap->GetDrawCallCount());
+    }
+    BENCHMARK(BM_TilemapDraw)->Arg(64)->Arg(256)->Arg(1024);
+
+    static void BM_GPUTilemapDraw(benchmark::State &aState)
+    {
+        const auto size = static_cast<int>(aState.range(0));
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        std::unique_ptr<GPUTilemap> tilemap(GPUTilemap::FromTMX(renderer, WriteMap(size)));
+        if (tilemap == nullptr)
+        {
+            aState.SkipWithError("Failed to load the map");
+            return;
+        }
+
+        Camera camera({static_cast<float>(size) * 0.5F, static_cast<float>(size) * 0.5F, 40.0F});
+        camera.Update();
+        for (auto _ : aState)
+        {
+            renderer->Clear();
+            tilemap->Update(1.0F / 60.0F);
+            tilemap->Draw(camera);
+            renderer->Render();
+        }
+        aState.counters["drawCalls"] = static_cast<double>(tilemap->GetDrawCallCount());
+    }
+    BENCHMARK(BM_GPUTilemapDraw)->Arg(64)->Arg(256)->Arg(1024);
+
+    // Loading cost, geometry baking against one texture upload per layer
+    static void BM_TilemapLoad(benchmark::State &aState)
+    {
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        const auto path = WriteMap(static_cast<int>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            std::unique_ptr<Tilemap> tilemap(Tilemap::FromTMX(renderer, path));
+            benchmark::DoNotOptimize(tilemap.get());
+        }
+    }
+    BENCHMARK(BM_TilemapLoad)->Arg(256)->Unit(benchmark::kMillisecond);
+
+    static void BM_GPUTilemapLoad(benchmark::State &aState)
+    {
+        auto renderer = std::shared_ptr<Renderer>(Renderer::Create("", {1280, 720}, Renderer::BACKEND_NULL));
+        const auto path = WriteMap(static_cast<int>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            std::unique_ptr<GPUTilemap> tilemap(GPUTilemap::FromTMX(renderer, path));
+            benchmark::DoNotOptimize(tilemap.get());
+        }
+    }
+    BENCHMARK(BM_GPUTilemapLoad)->Arg(256)->Unit(benchmark::kMillisecond);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
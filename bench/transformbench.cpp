@@ -0,0 +1,182 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <vector>
+#include <random>
+#include <benchmark/benchmark.h>
+
+#include "transform.hpp"
+#include "transform2d.hpp"
+#include "transformbatch.hpp"
+#include "scenegenerator.hpp"
+
+namespace nabla2d
+{
+    // Matrix rebuild, every transform is dirtied before GetMatrix
+    static void BM_TransformUpdateMatrix(benchmark::State &aState)
+    {
+        auto transforms = SceneGenerator::RandomTransforms(static_cast<std::size_t>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            for (auto &transform : transforms)
+            {
+                transform.Translate({0.01F, 0.0F, 0.0F});
+                benchmark::DoNotOptimize(transform.GetMatrix());
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_TransformUpdateMatrix)->Arg(1 << 10)->Arg(1 << 16);
+
+    // Cached path, nothing changed since the last GetMatrix
+    static void BM_TransformGetMatrixCached(benchmark::State &aState)
+    {
+        auto transforms = SceneGenerator::RandomTransforms(static_cast<std::size_t>(aState.range(0)));
+        for (auto &transform : transforms)
+        {
+            transform.GetMatrix();
+        }
+        for (auto _ : aState)
+        {
+            for (auto &transform : transforms)
+            {
+                benchmark::DoNotOptimize(transform.GetMatrix());
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_TransformGetMatrixCached)->Arg(1 << 10)->Arg(1 << 16);
+
+    // Compare with BM_TransformUpdateMatrix: same transforms, composed from SoA arrays
+    static void BM_TransformBatchCompose(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        const auto transforms = SceneGenerator::RandomTransforms(count);
+        TransformBatch batch;
+        batch.Resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            batch.Set(i, transforms[i]);
+        }
+
+        std::vector<glm::mat4> matrices(count);
+        for (auto _ : aState)
+        {
+            batch.Compose(matrices.data());
+            benchmark::DoNotOptimize(matrices.data());
+            benchmark::ClobberMemory();
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+        aState.SetLabel(TransformBatch::GetInstructionSet());
+    }
+    BENCHMARK(BM_TransformBatchCompose)->Arg(1 << 10)->Arg(1 << 16);
+
+    static void BM_TransformLerp(benchmark::State &aState)
+    {
+        const auto count = static_cast<std::size_t>(aState.range(0));
+        const auto from = SceneGenerator::RandomTransforms(count, 1);
+        const auto to = SceneGenerator::RandomTransforms(count, 2);
+        for (auto _ : aState)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto transform = Transform::Lerp(from[i], to[i], 0.5F);
+                benchmark::DoNotOptimize(transform.GetMatrix());
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_TransformLerp)->Arg(1 << 10)->Arg(1 << 16);
+
+    static std::vector<Transform2D> RandomTransforms2D(std::size_t aCount)
+    {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> position(-100.0F, 100.0F);
+        std::uniform_real_distribution<float> angle(-180.0F, 180.0F);
+        std::uniform_real_distribution<float> scale(0.5F, 2.0F);
+        std::vector<Transform2D> transforms;
+        transforms.reserve(aCount);
+        for (std::size_t i = 0; i < aCount; ++i)
+        {
+            transforms.emplace_back(glm::vec2{position(random), position(random)}, angle(random), glm::vec2{scale(random), scale(random)});
+        }
+        return transforms;
+    }
+
+    // Compare with BM_TransformUpdateMatrix
+    static void BM_Transform2DGetMatrix(benchmark::State &aState)
+    {
+        auto transforms = RandomTransforms2D(static_cast<std::size_t>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            for (auto &transform : transforms)
+            {
+                transform.Translate({0.01F, 0.0F});
+                benchmark::DoNotOptimize(transform.GetMatrix());
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_Transform2DGetMatrix)->Arg(1 << 10)->Arg(1 << 16);
+
+    static void BM_Transform2DGetInverseMatrix(benchmark::State &aState)
+    {
+        const auto transforms = RandomTransforms2D(static_cast<std::size_t>(aState.range(0)));
+        for (auto _ : aState)
+        {
+            for (const auto &transform : transforms)
+            {
+                benchmark::DoNotOptimize(transform.GetInverseMatrix());
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+    }
+    BENCHMARK(BM_Transform2DGetInverseMatrix)->Arg(1 << 10)->Arg(1 << 16);
+
+    // What HierarchySystem does per child: parent world matrix times local matrix.
+    // Arg 0 lifts the local matrix to a mat4 first, arg 1 uses the 3x2 path.
+    static void BM_Transform2DParentMultiply(benchmark::State &aState)
+    {
+        const auto transforms = RandomTransforms2D(1 << 12);
+        std::vector<glm::mat3x2> locals;
+        locals.reserve(transforms.size());
+        for (const auto &transform : transforms)
+        {
+            locals.push_back(transform.GetMatrix());
+        }
+
+        const bool affine = aState.range(0) != 0;
+        glm::mat4 world(1.0F);
+        for (auto _ : aState)
+        {
+            for (const auto &local : locals)
+            {
+                const auto child = affine ? Transform2D::Multiply(world, local) : world * Transform2D::ToMat4(local);
+                benchmark::DoNotOptimize(child);
+            }
+        }
+        aState.SetItemsProcessed(aState.iterations() * static_cast<int64_t>(locals.size()));
+        aState.SetLabel(affine ? "mat4 * mat3x2" : "mat4 * mat4");
+    }
+    BENCHMARK(BM_Transform2DParentMultiply)->Arg(0)->Arg(1);
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,113 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Example gameplay plugin: a ring of entities spinning around their center, faster while
+// space is held. Edit and rebuild it while the game runs to see it reloaded in place.
+
+#include <cmath>
+#include <vector>
+#include <cstring>
+
+#include "pluginapi.hpp"
+#include "transform2d.hpp"
+
+namespace
+{
+    constexpr std::size_t kCount = 12;
+    constexpr float kRadius = 2.0F;
+
+    // Per-entity state, in the PluginData storage
+    struct Spinner
+    {
+        float angle;
+        float speed;
+    };
+
+    float sTime = 0.0F;
+} // namespace
+
+NABLA2D_PLUGIN_EXPORT uint32_t nabla2d_plugin_version()
+{
+    return nabla2d::kPluginAPIVersion;
+}
+
+NABLA2D_PLUGIN_EXPORT bool nabla2d_plugin_load(const nabla2d::PluginAPI *aAPI, const std::vector<uint8_t> *aState)
+{
+    if (aState != nullptr && aState->size() == sizeof(sTime))
+    {
+        std::memcpy(&sTime, aState->data(), sizeof(sTime));
+    }
+
+    auto &data = nabla2d::GetPluginData(*aAPI);
+    if (data.size() > 0)
+    {
+        return true;
+    }
+
+    auto &registry = aAPI->scene->GetRegistry();
+    const auto entities = aAPI->scene->CreateEntities(std::vector<nabla2d::StringID>(kCount), std::vector<uint32_t>(kCount, nabla2d::Scene::kNoParent));
+    for (std::size_t i = 0; i < kCount; ++i)
+    {
+        const float angle = static_cast<float>(i) * 6.2831853F / static_cast<float>(kCount);
+        registry.emplace<nabla2d::Transform2D>(entities[i], glm::vec2(std::cos(angle), std::sin(angle)) * kRadius);
+        data.emplace(entities[i]).Set(Spinner{angle, 1.0F + static_cast<float>(i % 3)});
+    }
+    return true;
+}
+
+NABLA2D_PLUGIN_EXPORT void nabla2d_plugin_update(const nabla2d::PluginAPI *aAPI, float aDeltaTime)
+{
+    sTime += aDeltaTime;
+    const float boost = aAPI->keyHeld(nabla2d::Input::KEY_SPACE) ? 4.0F : 1.0F;
+    // Breathes with the plugin's own clock, which carries over reloads
+    const float radius = kRadius + 0.5F * std::sin(sTime);
+
+    auto &registry = aAPI->scene->GetRegistry();
+    auto &data = nabla2d::GetPluginData(*aAPI);
+    for (const auto entity : data)
+    {
+        auto spinner = data.get(entity).Get<Spinner>();
+        spinner.angle += spinner.speed * boost * aDeltaTime;
+        data.get(entity).Set(spinner);
+
+        auto *transform = registry.try_get<nabla2d::Transform2D>(entity);
+        if (transform != nullptr)
+        {
+            transform->SetPosition(glm::vec2(std::cos(spinner.angle), std::sin(spinner.angle)) * radius);
+            transform->SetRotation(glm::degrees(spinner.angle));
+        }
+    }
+}
+
+NABLA2D_PLUGIN_EXPORT void nabla2d_plugin_unload(const nabla2d::PluginAPI *aAPI, std::vector<uint8_t> *aState)
+{
+    if (aState != nullptr)
+    {
+        aState->resize(sizeof(sTime));
+        std::memcpy(aState->data(), &sTime, sizeof(sTime));
+        return;
+    }
+
+    auto &data = nabla2d::GetPluginData(*aAPI);
+    aAPI->scene->DestroyEntities(std::vector<entt::entity>(data.begin(), data.end()));
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,65 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_AABB_HPP
+#define NABLA2D_AABB_HPP
+
+#include <glm/glm.hpp>
+
+namespace nabla2d
+{
+    // Axis-aligned box on the XY plane
+    struct AABB
+    {
+        glm::vec2 min{0.0F, 0.0F};
+        glm::vec2 max{0.0F, 0.0F};
+
+        glm::vec2 GetCenter() const
+        {
+            return (min + max) * 0.5F;
+        }
+
+        glm::vec2 GetHalfSize() const
+        {
+            return (max - min) * 0.5F;
+        }
+
+        bool Overlaps(const AABB &aOther) const
+        {
+            return min.x <= aOther.max.x && max.x >= aOther.min.x && min.y <= aOther.max.y && max.y >= aOther.min.y;
+        }
+
+        bool Contains(const glm::vec2 &aPoint) const
+        {
+            return aPoint.x >= min.x && aPoint.x <= max.x && aPoint.y >= min.y && aPoint.y <= max.y;
+        }
+
+        // Squared distance from aPoint to the box, 0 inside
+        float GetDistance2(const glm::vec2 &aPoint) const
+        {
+            const auto delta = glm::max(glm::max(min - aPoint, aPoint - max), glm::vec2(0.0F));
+            return glm::dot(delta, delta);
+        }
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_AABB_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,310 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "animationsystem.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+#include "logger.hpp"
+#include "components.hpp"
+
+namespace nabla2d
+{
+    AnimationSystem::AnimationSystem(JobSystem &aJobSystem) : mJobSystem(aJobSystem)
+    {
+    }
+
+    AnimationSystem::ClipID AnimationSystem::AddClip(const Sprite &aSprite, const std::string &aAnimation)
+    {
+        for (std::size_t i = 0; i < mClips.size(); ++i)
+        {
+            if (mClips[i].sprite == aSprite.GetPath() && mClips[i].animation == aAnimation)
+            {
+                return static_cast<ClipID>(i);
+            }
+        }
+
+        const auto &animations = aSprite.GetAnimations();
+        const auto animation = animations.find(aAnimation);
+        if (animation == animations.end())
+        {
+            Logger::error("AnimationSystem::AddClip: Sprite '{}' has no animation '{}'", aSprite.GetPath(), aAnimation);
+            return kInvalidClip;
+        }
+
+        const auto &frames = aSprite.GetFrames();
+        const auto &range = animation->second;
+        if (range.startIndex < 0 || range.endIndex < range.startIndex || static_cast<std::size_t>(range.endIndex) >= frames.size())
+        {
+            Logger::error("AnimationSystem::AddClip: Animation '{}' of sprite '{}' has invalid frames", aAnimation, aSprite.GetPath());
+            return kInvalidClip;
+        }
+
+        Clip clip{range.type,
+                  static_cast<uint32_t>(mFrameDurations.size()),
+                  static_cast<uint32_t>(range.endIndex - range.startIndex + 1),
+                  0.0F,
+                  aSprite.GetPath(),
+                  aAnimation};
+        for (int frame = range.startIndex; frame <= range.endIndex; ++frame)
+        {
+            mFrameDurations.push_back(frames[frame].duration);
+            mFrameAtlasInfo.push_back(frames[frame].atlasInfo);
+        }
+
+        // Time until the playback is back to the same frame going the same way. Ping-pong
+        // plays the end frames once per cycle and the others twice.
+        const auto first = mFrameDurations.begin() + clip.firstFrame;
+        clip.cycleDuration = std::accumulate(first, mFrameDurations.end(), 0.0F);
+        if (clip.type == Sprite::PINGPONG && clip.frameCount > 1)
+        {
+            clip.cycleDuration = 2.0F * clip.cycleDuration - *first - mFrameDurations.back();
+        }
+
+        mClips.push_back(std::move(clip));
+        return static_cast<ClipID>(mClips.size() - 1);
+    }
+
+    std::size_t AnimationSystem::GetClipCount() const
+    {
+        return mClips.size();
+    }
+
+    void AnimationSystem::Play(entt::entity aEntity, ClipID aClip)
+    {
+        if (aClip >= mClips.size())
+        {
+            Logger::error("AnimationSystem::Play: Clip #{} does not exist", aClip);
+            return;
+        }
+
+        auto slot = GetSlot(aEntity);
+        if (slot == kInvalid)
+        {
+            const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+            if (id >= mSparse.size())
+            {
+                mSparse.resize(std::max(id + 1, mSparse.size() * 2), kInvalid);
+            }
+
+            slot = static_cast<uint32_t>(mEntities.size());
+            mSparse[id] = slot;
+            mEntities.push_back(aEntity);
+            mClipIDs.emplace_back();
+            mFrames.emplace_back();
+            mDirections.emplace_back();
+            mTimers.emplace_back();
+            mDurations.emplace_back();
+            mChanged.emplace_back();
+        }
+
+        const auto &clip = mClips[aClip];
+        const bool backward = clip.type == Sprite::BACKWARD;
+        const bool animated = clip.type != Sprite::STATIC && clip.frameCount > 1 && clip.cycleDuration > 0.0F;
+
+        mClipIDs[slot] = aClip;
+        mFrames[slot] = backward ? static_cast<int32_t>(clip.frameCount - 1) : 0;
+        mDirections[slot] = backward ? -1 : 1;
+        mTimers[slot] = 0.0F;
+        // Clips that never advance get a duration the timer can't reach
+        mDurations[slot] = animated ? mFrameDurations[clip.firstFrame + mFrames[slot]] : std::numeric_limits<float>::infinity();
+        mChanged[slot] = 1;
+    }
+
+    void AnimationSystem::Stop(entt::entity aEntity)
+    {
+        const auto slot = GetSlot(aEntity);
+        if (slot != kInvalid)
+        {
+            Remove(slot);
+        }
+    }
+
+    bool AnimationSystem::IsPlaying(entt::entity aEntity) const
+    {
+        return GetSlot(aEntity) != kInvalid;
+    }
+
+    AnimationSystem::ClipID AnimationSystem::GetClip(entt::entity aEntity) const
+    {
+        const auto slot = GetSlot(aEntity);
+        return slot == kInvalid ? kInvalidClip : mClipIDs[slot];
+    }
+
+    std::size_t AnimationSystem::GetSize() const
+    {
+        return mEntities.size();
+    }
+
+    void AnimationSystem::Clear()
+    {
+        mEntities.clear();
+        mClipIDs.clear();
+        mFrames.clear();
+        mDirections.clear();
+        mTimers.clear();
+        mDurations.clear();
+        mChanged.clear();
+        mSparse.clear();
+    }
+
+    void AnimationSystem::Update(float aDeltaTime)
+    {
+        if (mEntities.size() <= kGrainSize)
+        {
+            Advance(0, mEntities.size(), aDeltaTime);
+            return;
+        }
+
+        mJobSystem.ParallelFor(mEntities.size(), kGrainSize, [this, aDeltaTime](std::size_t aBegin, std::size_t aEnd)
+                               { Advance(aBegin, aEnd, aDeltaTime); });
+    }
+
+    void AnimationSystem::Apply(entt::registry &aRegistry)
+    {
+        for (std::size_t slot = 0; slot < mEntities.size();)
+        {
+            const auto entity = mEntities[slot];
+            if (!aRegistry.valid(entity))
+            {
+                // The last entity is swapped in, check this slot again
+                Remove(static_cast<uint32_t>(slot));
+                continue;
+            }
+
+            if (mChanged[slot] != 0)
+            {
+                auto *sprite = aRegistry.try_get<SpriteRenderer>(entity);
+                if (sprite != nullptr)
+                {
+                    sprite->atlasInfo = mFrameAtlasInfo[mClips[mClipIDs[slot]].firstFrame + mFrames[slot]];
+                }
+                mChanged[slot] = 0;
+            }
+            ++slot;
+        }
+    }
+
+    uint32_t AnimationSystem::GetSlot(entt::entity aEntity) const
+    {
+        const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+        if (id >= mSparse.size() || mSparse[id] == kInvalid || mEntities[mSparse[id]] != aEntity)
+        {
+            return kInvalid;
+        }
+        return mSparse[id];
+    }
+
+    void AnimationSystem::Remove(uint32_t aSlot)
+    {
+        const auto last = mEntities.size() - 1;
+        mSparse[entt::to_entity(mEntities[aSlot])] = kInvalid;
+        if (aSlot != last)
+        {
+            mEntities[aSlot] = mEntities[last];
+            mClipIDs[aSlot] = mClipIDs[last];
+            mFrames[aSlot] = mFrames[last];
+            mDirections[aSlot] = mDirections[last];
+            mTimers[aSlot] = mTimers[last];
+            mDurations[aSlot] = mDurations[last];
+            mChanged[aSlot] = mChanged[last];
+            mSparse[entt::to_entity(mEntities[aSlot])] = aSlot;
+        }
+
+        mEntities.pop_back();
+        mClipIDs.pop_back();
+        mFrames.pop_back();
+        mDirections.pop_back();
+        mTimers.pop_back();
+        mDurations.pop_back();
+        mChanged.pop_back();
+    }
+
+    void AnimationSystem::Advance(std::size_t aBegin, std::size_t aEnd, float aDeltaTime)
+    {
+        // Both loops are straight passes over contiguous floats, only the (rare) entities
+        // that reach the end of their frame take the slow path
+        float *timers = mTimers.data();
+        const float *durations = mDurations.data();
+        for (std::size_t i = aBegin; i < aEnd; ++i)
+        {
+            timers[i] += aDeltaTime;
+        }
+        for (std::size_t i = aBegin; i < aEnd; ++i)
+        {
+            if (timers[i] >= durations[i])
+            {
+                Step(i);
+            }
+        }
+    }
+
+    void AnimationSystem::Step(std::size_t aSlot)
+    {
+        const auto &clip = mClips[mClipIDs[aSlot]];
+        const float *durations = mFrameDurations.data() + clip.firstFrame;
+        const auto last = static_cast<int32_t>(clip.frameCount - 1);
+
+        // Whole cycles end up on the same frame, only the remainder needs stepping
+        float timer = mTimers[aSlot];
+        if (timer >= clip.cycleDuration)
+        {
+            timer = std::fmod(timer, clip.cycleDuration);
+        }
+
+        const auto startFrame = mFrames[aSlot];
+        auto frame = startFrame;
+        auto direction = mDirections[aSlot];
+        while (timer >= durations[frame])
+        {
+            timer -= durations[frame];
+            switch (clip.type)
+            {
+            case Sprite::FORWARD:
+                frame = frame == last ? 0 : frame + 1;
+                break;
+            case Sprite::BACKWARD:
+                frame = frame == 0 ? last : frame - 1;
+                break;
+            case Sprite::PINGPONG:
+                if (frame + direction < 0 || frame + direction > last)
+                {
+                    direction = -direction;
+                }
+                frame += direction;
+                break;
+            default:
+                break;
+            }
+        }
+
+        mTimers[aSlot] = timer;
+        mFrames[aSlot] = frame;
+        mDirections[aSlot] = direction;
+        mDurations[aSlot] = durations[frame];
+        mChanged[aSlot] |= frame != startFrame ? 1 : 0;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,108 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_ANIMATIONSYSTEM_HPP
+#define NABLA2D_ANIMATIONSYSTEM_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "sprite.hpp"
+#include "jobsystem.hpp"
+
+namespace nabla2d
+{
+    // Sprite animation for many entities at once. Clips are copied out of sprites and
+    // addressed by id, playback state is kept as parallel arrays (clip, frame, direction,
+    // timer) advanced in chunks over the job system, and the current frame is written to
+    // the entities' SpriteRenderer by Apply.
+    class AnimationSystem
+    {
+    public:
+        typedef uint32_t ClipID;
+        static constexpr ClipID kInvalidClip = 0xFFFFFFFFU;
+
+        explicit AnimationSystem(JobSystem &aJobSystem);
+        AnimationSystem(const AnimationSystem &aAnimationSystem) = delete;
+        AnimationSystem &operator=(const AnimationSystem &aAnimationSystem) = delete;
+        ~AnimationSystem() = default;
+
+        // Adding the same sprite animation twice returns the same id
+        ClipID AddClip(const Sprite &aSprite, const std::string &aAnimation);
+        std::size_t GetClipCount() const;
+
+        // Starts aClip from its first frame, replacing whatever aEntity was playing
+        void Play(entt::entity aEntity, ClipID aClip);
+        void Stop(entt::entity aEntity);
+        bool IsPlaying(entt::entity aEntity) const;
+        ClipID GetClip(entt::entity aEntity) const;
+        std::size_t GetSize() const;
+        void Clear();
+
+        // Deltas longer than a whole clip cycle are wrapped first, so frames are skipped
+        // correctly whatever the step
+        void Update(float aDeltaTime);
+        // Writes frames that changed since the last call to the SpriteRenderer components,
+        // destroyed entities are dropped
+        void Apply(entt::registry &aRegistry);
+
+    private:
+        static constexpr uint32_t kInvalid = 0xFFFFFFFFU;
+        static constexpr std::size_t kGrainSize = 4096;
+
+        struct Clip
+        {
+            Sprite::AnimationType type;
+            uint32_t firstFrame;
+            uint32_t frameCount;
+            float cycleDuration;
+            std::string sprite;
+            std::string animation;
+        };
+
+        JobSystem &mJobSystem;
+
+        std::vector<Clip> mClips;
+        std::vector<float> mFrameDurations;
+        std::vector<glm::vec4> mFrameAtlasInfo;
+
+        std::vector<entt::entity> mEntities;
+        std::vector<ClipID> mClipIDs;
+        std::vector<int32_t> mFrames;
+        std::vector<int32_t> mDirections;
+        std::vector<float> mTimers;
+        std::vector<float> mDurations;
+        std::vector<uint8_t> mChanged;
+        std::vector<uint32_t> mSparse;
+
+        uint32_t GetSlot(entt::entity aEntity) const;
+        void Remove(uint32_t aSlot);
+        void Advance(std::size_t aBegin, std::size_t aEnd, float aDeltaTime);
+        void Step(std::size_t aSlot);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_ANIMATIONSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,397 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "audiostream.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#define STB_VORBIS_NO_PUSHDATA_API
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wunknown-warning-option"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-value"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wtype-limits"
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#pragma GCC diagnostic ignored "-Wmisleading-indentation"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+#endif
+#include <stb_vorbis.c>
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr uint16_t kFormatPCM = 1;
+        constexpr uint16_t kFormatFloat = 3;
+        constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+        uint16_t ReadU16(const uint8_t *aBytes)
+        {
+            return static_cast<uint16_t>(aBytes[0] | (aBytes[1] << 8));
+        }
+
+        uint32_t ReadU32(const uint8_t *aBytes)
+        {
+            return static_cast<uint32_t>(aBytes[0]) | (static_cast<uint32_t>(aBytes[1]) << 8) |
+                   (static_cast<uint32_t>(aBytes[2]) << 16) | (static_cast<uint32_t>(aBytes[3]) << 24);
+        }
+
+        // Integer PCM from 8 to 32 bits or 32 bit floats, only the first two channels are kept
+        class WAVDecoder final : public AudioStream::Decoder
+        {
+        public:
+            bool Open(const std::string &aPath)
+            {
+                mFile.open(aPath, std::ios::binary);
+                uint8_t header[12];
+                if (!mFile.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+                    std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0)
+                {
+                    Logger::error("WAVDecoder::Open: '{}' is not a WAV file", aPath);
+                    return false;
+                }
+
+                // Chunks until the samples, "fmt " comes first
+                bool hasFormat = false;
+                uint8_t chunk[8];
+                while (mFile.read(reinterpret_cast<char *>(chunk), sizeof(chunk)))
+                {
+                    const uint32_t size = ReadU32(chunk + 4);
+                    if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+                    {
+                        std::vector<uint8_t> format(size);
+                        if (!mFile.read(reinterpret_cast<char *>(format.data()), static_cast<std::streamsize>(size)))
+                        {
+                            break;
+                        }
+                        mFormat = ReadU16(format.data());
+                        mFileChannels = ReadU16(format.data() + 2);
+                        sampleRate = static_cast<int>(ReadU32(format.data() + 4));
+                        mBlockAlign = ReadU16(format.data() + 12);
+                        mBits = ReadU16(format.data() + 14);
+                        if (mFormat == kFormatExtensible && size >= 26)
+                        {
+                            mFormat = ReadU16(format.data() + 24);
+                        }
+                        hasFormat = true;
+                        mFile.seekg(size % 2, std::ios::cur);
+                    }
+                    else if (std::memcmp(chunk, "data", 4) == 0)
+                    {
+                        if (!hasFormat || !IsSupported())
+                        {
+                            break;
+                        }
+                        mDataOffset = static_cast<uint64_t>(mFile.tellg());
+                        channels = std::min<uint32_t>(mFileChannels, 2);
+                        frames = size / mBlockAlign;
+                        return true;
+                    }
+                    else
+                    {
+                        // Chunks are padded to an even size
+                        mFile.seekg(static_cast<std::streamoff>(size + size % 2), std::ios::cur);
+                    }
+                }
+
+                Logger::error("WAVDecoder::Open: '{}' has no samples in a supported format", aPath);
+                return false;
+            }
+
+            std::size_t Read(float *aOutput, std::size_t aFrames) override
+            {
+                const auto count = static_cast<std::size_t>(std::min<uint64_t>(aFrames, frames - mPosition));
+                mBytes.resize(count * mBlockAlign);
+                if (count == 0 || !mFile.read(reinterpret_cast<char *>(mBytes.data()), static_cast<std::streamsize>(mBytes.size())))
+                {
+                    return 0;
+                }
+
+                const std::size_t sampleBytes = mBits / 8;
+                for (std::size_t frame = 0; frame < count; ++frame)
+                {
+                    const uint8_t *block = mBytes.data() + frame * mBlockAlign;
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        aOutput[frame * channels + channel] = ToFloat(block + channel * sampleBytes);
+                    }
+                }
+                mPosition += count;
+                return count;
+            }
+
+            bool Seek(uint64_t aFrame) override
+            {
+                mFile.clear();
+                mPosition = std::min(aFrame, frames);
+                return static_cast<bool>(mFile.seekg(static_cast<std::streamoff>(mDataOffset + mPosition * mBlockAlign)));
+            }
+
+        private:
+            std::ifstream mFile;
+            uint16_t mFormat{0};
+            uint16_t mFileChannels{0};
+            uint16_t mBlockAlign{0};
+            uint16_t mBits{0};
+            uint64_t mDataOffset{0};
+            uint64_t mPosition{0};
+            std::vector<uint8_t> mBytes;
+
+            bool IsSupported() const
+            {
+                const bool pcm = mFormat == kFormatPCM && (mBits == 8 || mBits == 16 || mBits == 24 || mBits == 32);
+                const bool ieee = mFormat == kFormatFloat && mBits == 32;
+                return (pcm || ieee) && mFileChannels > 0 && sampleRate > 0 && mBlockAlign >= mFileChannels * (mBits / 8);
+            }
+
+            float ToFloat(const uint8_t *aSample) const
+            {
+                switch (mBits)
+                {
+                case 8:
+                    return static_cast<float>(static_cast<int>(aSample[0]) - 128) / 128.0F;
+                case 16:
+                    return static_cast<float>(static_cast<int16_t>(ReadU16(aSample))) / 32768.0F;
+                case 24:
+                {
+                    // Shifted to the top of a 32 bit value to keep the sign
+                    const uint32_t bits = (static_cast<uint32_t>(aSample[0]) << 8) | (static_cast<uint32_t>(aSample[1]) << 16) | (static_cast<uint32_t>(aSample[2]) << 24);
+                    return static_cast<float>(static_cast<int32_t>(bits)) / 2147483648.0F;
+                }
+                default:
+                    break;
+                }
+
+                const uint32_t bits = ReadU32(aSample);
+                if (mFormat == kFormatFloat)
+                {
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+                return static_cast<float>(static_cast<int32_t>(bits)) / 2147483648.0F;
+            }
+        };
+
+        // Files with more than two channels are mixed down to stereo by stb_vorbis
+        class VorbisDecoder final : public AudioStream::Decoder
+        {
+        public:
+            ~VorbisDecoder() override
+            {
+                if (mVorbis != nullptr)
+                {
+                    stb_vorbis_close(mVorbis);
+                }
+            }
+
+            bool Open(const std::string &aPath)
+            {
+                int error = 0;
+                mVorbis = stb_vorbis_open_filename(aPath.c_str(), &error, nullptr);
+                if (mVorbis == nullptr)
+                {
+                    Logger::error("VorbisDecoder::Open: Cannot open '{}' (error {})", aPath, error);
+                    return false;
+                }
+
+                const stb_vorbis_info info = stb_vorbis_get_info(mVorbis);
+                channels = static_cast<uint32_t>(std::min(info.channels, 2));
+                sampleRate = static_cast<int>(info.sample_rate);
+                frames = stb_vorbis_stream_length_in_samples(mVorbis);
+                return true;
+            }
+
+            std::size_t Read(float *aOutput, std::size_t aFrames) override
+            {
+                const auto samples = static_cast<int>(std::min<std::size_t>(aFrames * channels, 1U << 20));
+                return static_cast<std::size_t>(stb_vorbis_get_samples_float_interleaved(mVorbis, static_cast<int>(channels), aOutput, samples));
+            }
+
+            bool Seek(uint64_t aFrame) override
+            {
+                return stb_vorbis_seek(mVorbis, static_cast<unsigned int>(std::min(aFrame, frames))) != 0;
+            }
+
+        private:
+            stb_vorbis *mVorbis{nullptr};
+        };
+
+        std::size_t RoundUpToPowerOfTwo(std::size_t aValue)
+        {
+            std::size_t power = 1;
+            while (power < aValue)
+            {
+                power <<= 1;
+            }
+            return power;
+        }
+    } // namespace
+
+    AudioStream *AudioStream::FromFile(const std::string &aPath, float aLatency, bool aLoop)
+    {
+        std::string extension = aPath.substr(std::min(aPath.find_last_of('.'), aPath.size()));
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char aChar)
+                       { return static_cast<char>(std::tolower(aChar)); });
+
+        std::unique_ptr<Decoder> decoder;
+        if (extension == ".wav")
+        {
+            auto wav = std::make_unique<WAVDecoder>();
+            if (!wav->Open(aPath))
+            {
+                return nullptr;
+            }
+            decoder = std::move(wav);
+        }
+        else if (extension == ".ogg")
+        {
+            auto vorbis = std::make_unique<VorbisDecoder>();
+            if (!vorbis->Open(aPath))
+            {
+                return nullptr;
+            }
+            decoder = std::move(vorbis);
+        }
+        else
+        {
+            Logger::error("AudioStream::FromFile: Unsupported file type '{}'", aPath);
+            return nullptr;
+        }
+        const auto frames = static_cast<std::size_t>(std::max(aLatency, 0.0F) * static_cast<float>(decoder->sampleRate));
+        return new AudioStream(std::move(decoder), frames, aLoop);
+    }
+
+    AudioStream::AudioStream(std::unique_ptr<Decoder> aDecoder, std::size_t aBufferFrames, bool aLoop)
+        : mDecoder(std::move(aDecoder)), mLoop(aLoop)
+    {
+        const auto frames = RoundUpToPowerOfTwo(std::max(aBufferFrames, kMinBufferFrames));
+        mBuffer.resize(frames * mDecoder->channels);
+        mMask = frames - 1;
+    }
+
+    uint32_t AudioStream::GetChannels() const
+    {
+        return mDecoder->channels;
+    }
+
+    int AudioStream::GetSampleRate() const
+    {
+        return mDecoder->sampleRate;
+    }
+
+    uint64_t AudioStream::GetFrameCount() const
+    {
+        return mDecoder->frames;
+    }
+
+    std::size_t AudioStream::GetBufferFrames() const
+    {
+        return mMask + 1;
+    }
+
+    bool AudioStream::Seek(uint64_t aFrame)
+    {
+        mFinished.store(false, std::memory_order_relaxed);
+        return mDecoder->Seek(aFrame);
+    }
+
+    void AudioStream::Fill()
+    {
+        if (mFinished.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const auto channels = mDecoder->channels;
+        auto written = mWritten.load(std::memory_order_relaxed);
+        bool rewound = false;
+        while (true)
+        {
+            const auto space = GetBufferFrames() - static_cast<std::size_t>(written - mRead.load(std::memory_order_acquire));
+            if (space == 0)
+            {
+                return;
+            }
+
+            // Up to the end of the ring, the rest goes to the start on the next pass
+            const auto offset = static_cast<std::size_t>(written & mMask);
+            const auto count = mDecoder->Read(mBuffer.data() + offset * channels, std::min(space, GetBufferFrames() - offset));
+            if (count > 0)
+            {
+                written += count;
+                mWritten.store(written, std::memory_order_release);
+                rewound = false;
+                continue;
+            }
+
+            // The end of the file, an empty one doesn't loop forever
+            if (!mLoop || rewound || !mDecoder->Seek(0))
+            {
+                mFinished.store(true, std::memory_order_release);
+                return;
+            }
+            rewound = true;
+        }
+    }
+
+    std::size_t AudioStream::GetAvailableFrames() const
+    {
+        return static_cast<std::size_t>(mWritten.load(std::memory_order_acquire) - mRead.load(std::memory_order_relaxed));
+    }
+
+    void AudioStream::Peek(float *aOutput, std::size_t aFrames) const
+    {
+        const auto channels = mDecoder->channels;
+        const auto offset = static_cast<std::size_t>(mRead.load(std::memory_order_relaxed) & mMask);
+        const auto first = std::min(aFrames, GetBufferFrames() - offset);
+        std::memcpy(aOutput, mBuffer.data() + offset * channels, first * channels * sizeof(float));
+        std::memcpy(aOutput + first * channels, mBuffer.data(), (aFrames - first) * channels * sizeof(float));
+    }
+
+    void AudioStream::Consume(std::size_t aFrames)
+    {
+        mRead.store(mRead.load(std::memory_order_relaxed) + aFrames, std::memory_order_release);
+    }
+
+    bool AudioStream::IsFinished() const
+    {
+        return mFinished.load(std::memory_order_acquire);
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,100 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_AUDIOSTREAM_HPP
+#define NABLA2D_AUDIOSTREAM_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace nabla2d
+{
+    // A sound file decoded a little at a time into a ring of float frames. One thread decodes
+    // (Fill, Seek) while the audio callback reads (Peek, Consume), the two sides only share
+    // the read and write counters. Looping streams go back to the start as soon as the
+    // decoder reaches the end, so the beginning is already buffered when playback wraps.
+    class AudioStream
+    {
+    public:
+        // Incremental decoder of one file, mono or stereo
+        class Decoder
+        {
+        public:
+            virtual ~Decoder() = default;
+            // Decodes up to aFrames interleaved frames, returns 0 at the end of the file
+            virtual std::size_t Read(float *aOutput, std::size_t aFrames) = 0;
+            virtual bool Seek(uint64_t aFrame) = 0;
+
+            uint32_t channels{0};
+            int sampleRate{0};
+            uint64_t frames{0};
+        };
+
+        // Smallest buffer, whatever the latency asked for
+        static constexpr std::size_t kMinBufferFrames = 8192;
+
+        // .wav (integer PCM or float) and .ogg (Vorbis) files, buffering about aLatency seconds.
+        // Returns nullptr when the file can't be opened.
+        static AudioStream *FromFile(const std::string &aPath, float aLatency, bool aLoop);
+
+        // aBufferFrames is rounded up to a power of two
+        AudioStream(std::unique_ptr<Decoder> aDecoder, std::size_t aBufferFrames, bool aLoop);
+        AudioStream(const AudioStream &aAudioStream) = delete;
+        AudioStream &operator=(const AudioStream &aAudioStream) = delete;
+        ~AudioStream() = default;
+
+        uint32_t GetChannels() const;
+        int GetSampleRate() const;
+        uint64_t GetFrameCount() const;
+        std::size_t GetBufferFrames() const;
+
+        // Decoding side, one thread at a time. Seek is only valid before the stream is read.
+        bool Seek(uint64_t aFrame);
+        // Decodes until the buffer is full or a non-looping file ended
+        void Fill();
+
+        // Reading side
+        std::size_t GetAvailableFrames() const;
+        // Copies the next aFrames buffered frames, at most GetAvailableFrames()
+        void Peek(float *aOutput, std::size_t aFrames) const;
+        void Consume(std::size_t aFrames);
+        // A non-looping file was decoded to the end, what's left is in the buffer. Check it
+        // before GetAvailableFrames so the last frames aren't missed.
+        bool IsFinished() const;
+
+    private:
+        std::unique_ptr<Decoder> mDecoder;
+        bool mLoop;
+        std::vector<float> mBuffer;
+        std::size_t mMask;
+
+        alignas(64) std::atomic<uint64_t> mRead{0};
+        alignas(64) std::atomic<uint64_t> mWritten{0};
+        std::atomic<bool> mFinished{false};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_AUDIOSTREAM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,951 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "audiosystem.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <SDL2/SDL.h>
+
+#include "logger.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NABLA2D_AUDIO_SSE
+#endif
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr float kQuarterPi = 0.78539816F;
+        constexpr float kMinPitch = 1.0F / 64.0F;
+        constexpr float kMaxPitch = 64.0F;
+
+        // Constant power panning for mono sounds, balance for stereo ones
+        void ComputeGains(uint32_t aChannels, float aVolume, float aPan, float &aLeft, float &aRight)
+        {
+            if (aChannels == 1)
+            {
+                const float angle = (aPan + 1.0F) * kQuarterPi;
+                aLeft = aVolume * std::cos(angle);
+                aRight = aVolume * std::sin(angle);
+            }
+            else
+            {
+                aLeft = aVolume * std::min(1.0F, 1.0F - aPan);
+                aRight = aVolume * std::min(1.0F, 1.0F + aPan);
+            }
+        }
+
+        void AudioCallback(void *aUserData, Uint8 *aStream, int aLength)
+        {
+            static_cast<AudioSystem *>(aUserData)->Render(reinterpret_cast<float *>(aStream), static_cast<std::size_t>(aLength) / (2 * sizeof(float)));
+        }
+
+        // Adds aCount stereo frames of a sound read from aPosition every aStep frames (linear
+        // interpolation), with the gains ramped by aStepLeft and aStepRight every frame
+        void MixSegment(const float *aSamples, uint32_t aChannels, double aPosition, double aStep,
+                        float *aOutput, std::size_t aCount, float aLeft, float aRight, float aStepLeft, float aStepRight)
+        {
+            std::size_t i = 0;
+#if defined(NABLA2D_AUDIO_SSE)
+            // Four frames at a time, as two registers of interleaved left and right samples
+            __m128 gains0 = _mm_setr_ps(aLeft, aRight, aLeft + aStepLeft, aRight + aStepRight);
+            __m128 gains1 = _mm_add_ps(gains0, _mm_setr_ps(2.0F * aStepLeft, 2.0F * aStepRight, 2.0F * aStepLeft, 2.0F * aStepRight));
+            const __m128 gainStep = _mm_setr_ps(4.0F * aStepLeft, 4.0F * aStepRight, 4.0F * aStepLeft, 4.0F * aStepRight);
+            // No resampling, the samples are loaded as they are
+            const bool direct = aStep == 1.0 && aPosition == std::floor(aPosition);
+            const auto base = static_cast<std::size_t>(aPosition);
+            const float step = static_cast<float>(aStep);
+            const __m128 laneSteps = _mm_setr_ps(0.0F, step, 2.0F * step, 3.0F * step);
+
+            for (; i + 4 <= aCount; i += 4)
+            {
+                __m128 frames0;
+                __m128 frames1;
+                if (direct)
+                {
+                    const float *source = aSamples + (base + i) * aChannels;
+                    if (aChannels == 1)
+                    {
+                        const __m128 mono = _mm_loadu_ps(source);
+                        frames0 = _mm_unpacklo_ps(mono, mono);
+                        frames1 = _mm_unpackhi_ps(mono, mono);
+                    }
+                    else
+                    {
+                        frames0 = _mm_loadu_ps(source);
+                        frames1 = _mm_loadu_ps(source + 4);
+                    }
+                }
+                else
+                {
+                    // Lane offsets are small, so floats keep the fractions exact enough
+                    const double position = aPosition + aStep * static_cast<double>(i);
+                    const auto index = static_cast<std::size_t>(position);
+                    const __m128 offsets = _mm_add_ps(_mm_set1_ps(static_cast<float>(position - static_cast<double>(index))), laneSteps);
+                    const __m128i whole = _mm_cvttps_epi32(offsets);
+                    const __m128 fraction = _mm_sub_ps(offsets, _mm_cvtepi32_ps(whole));
+                    alignas(16) int32_t lanes[4];
+                    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), whole);
+
+                    const float *source = aSamples + index * aChannels;
+                    __m128 left;
+                    __m128 right;
+                    if (aChannels == 1)
+                    {
+                        const __m128 from = _mm_setr_ps(source[lanes[0]], source[lanes[1]], source[lanes[2]], source[lanes[3]]);
+                        const __m128 to = _mm_setr_ps(source[lanes[0] + 1], source[lanes[1] + 1], source[lanes[2] + 1], source[lanes[3] + 1]);
+                        left = _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), fraction));
+                        right = left;
+                    }
+                    else
+                    {
+                        const __m128 fromLeft = _mm_setr_ps(source[lanes[0] * 2], source[lanes[1] * 2], source[lanes[2] * 2], source[lanes[3] * 2]);
+                        const __m128 toLeft = _mm_setr_ps(source[lanes[0] * 2 + 2], source[lanes[1] * 2 + 2], source[lanes[2] * 2 + 2], source[lanes[3] * 2 + 2]);
+                        const __m128 fromRight = _mm_setr_ps(source[lanes[0] * 2 + 1], source[lanes[1] * 2 + 1], source[lanes[2] * 2 + 1], source[lanes[3] * 2 + 1]);
+                        const __m128 toRight = _mm_setr_ps(source[lanes[0] * 2 + 3], source[lanes[1] * 2 + 3], source[lanes[2] * 2 + 3], source[lanes[3] * 2 + 3]);
+                        left = _mm_add_ps(fromLeft, _mm_mul_ps(_mm_sub_ps(toLeft, fromLeft), fraction));
+                        right = _mm_add_ps(fromRight, _mm_mul_ps(_mm_sub_ps(toRight, fromRight), fraction));
+                    }
+                    frames0 = _mm_unpacklo_ps(left, right);
+                    frames1 = _mm_unpackhi_ps(left, right);
+                }
+
+                float *output = aOutput + i * 2;
+                _mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_mul_ps(frames0, gains0)));
+                _mm_storeu_ps(output + 4, _mm_add_ps(_mm_loadu_ps(output + 4), _mm_mul_ps(frames1, gains1)));
+                gains0 = _mm_add_ps(gains0, gainStep);
+                gains1 = _mm_add_ps(gains1, gainStep);
+            }
+#endif
+            for (; i < aCount; ++i)
+            {
+                const double position = aPosition + aStep * static_cast<double>(i);
+                const auto index = static_cast<std::size_t>(position);
+                const float fraction = static_cast<float>(position - static_cast<double>(index));
+                const float *from = aSamples + index * aChannels;
+                const float *to = from + aChannels;
+                const float left = from[0] + (to[0] - from[0]) * fraction;
+                const float right = aChannels == 1 ? left : from[1] + (to[1] - from[1]) * fraction;
+                aOutput[i * 2] += left * (aLeft + aStepLeft * static_cast<float>(i));
+                aOutput[i * 2 + 1] += right * (aRight + aStepRight * static_cast<float>(i));
+            }
+        }
+
+        void ApplyMasterVolume(float *aOutput, std::size_t aCount, float aVolume)
+        {
+            std::size_t i = 0;
+#if defined(NABLA2D_AUDIO_SSE)
+            const __m128 volume = _mm_set1_ps(aVolume);
+            const __m128 low = _mm_set1_ps(-1.0F);
+            const __m128 high = _mm_set1_ps(1.0F);
+            for (; i + 4 <= aCount; i += 4)
+            {
+                const __m128 samples = _mm_mul_ps(_mm_loadu_ps(aOutput + i), volume);
+                _mm_storeu_ps(aOutput + i, _mm_min_ps(_mm_max_ps(samples, low), high));
+            }
+#endif
+            for (; i < aCount; ++i)
+            {
+                aOutput[i] = std::clamp(aOutput[i] * aVolume, -1.0F, 1.0F);
+            }
+        }
+    } // namespace
+
+    AudioSystem::AudioSystem(int aSampleRate)
+        : mSampleRate(aSampleRate), mStreamScratch((kStreamChunk * kMaxStreamStep + 3) * 2)
+    {
+    }
+
+    AudioSystem::~AudioSystem()
+    {
+        Destroy();
+    }
+
+    bool AudioSystem::Init(int aBufferFrames)
+    {
+        if (mDevice != 0)
+        {
+            Logger::error("AudioSystem::Init: The device is already open");
+            return false;
+        }
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
+        {
+            Logger::error("AudioSystem::Init: Cannot initialize SDL audio: {}", SDL_GetError());
+            return false;
+        }
+
+        // No changes allowed, SDL converts to the device format so the mixer always runs at
+        // its own rate in stereo floats
+        SDL_AudioSpec desired{};
+        SDL_AudioSpec obtained{};
+        desired.freq = mSampleRate;
+        desired.format = AUDIO_F32SYS;
+        desired.channels = 2;
+        desired.samples = static_cast<Uint16>(aBufferFrames);
+        desired.callback = &AudioCallback;
+        desired.userdata = this;
+        mDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0);
+        if (mDevice == 0)
+        {
+            Logger::error("AudioSystem::Init: Cannot open the audio device: {}", SDL_GetError());
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            return false;
+        }
+
+        // Streams started before the device opened are already buffered
+        StartStreaming();
+
+        SDL_PauseAudioDevice(mDevice, 0);
+        Logger::info("Audio device open with the '{}' driver, {} Hz, {} frames per buffer", SDL_GetCurrentAudioDriver(), mSampleRate, obtained.samples);
+        return true;
+    }
+
+    void AudioSystem::Destroy()
+    {
+        if (mDevice != 0)
+        {
+            // Waits for the callback to return
+            SDL_CloseAudioDevice(mDevice);
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            mDevice = 0;
+        }
+        if (mStreamThread.joinable())
+        {
+            mStreaming.store(false);
+            mStreamThread.join();
+        }
+    }
+
+    bool AudioSystem::IsOpen() const
+    {
+        return mDevice != 0;
+    }
+
+    AudioSystem::SoundHandle AudioSystem::LoadWAV(const std::string &aPath)
+    {
+        SDL_AudioSpec spec{};
+        Uint8 *buffer = nullptr;
+        Uint32 length = 0;
+        if (SDL_LoadWAV(aPath.c_str(), &spec, &buffer, &length) == nullptr)
+        {
+            Logger::error("AudioSystem::LoadWAV: Cannot load '{}': {}", aPath, SDL_GetError());
+            return kInvalidSound;
+        }
+
+        const int channels = std::min<int>(spec.channels, 2);
+        SDL_AudioCVT cvt;
+        if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, AUDIO_F32SYS, static_cast<Uint8>(channels), spec.freq) < 0)
+        {
+            Logger::error("AudioSystem::LoadWAV: Cannot convert '{}': {}", aPath, SDL_GetError());
+            SDL_FreeWAV(buffer);
+            return kInvalidSound;
+        }
+
+        std::vector<uint8_t> data(static_cast<std::size_t>(length) * static_cast<std::size_t>(std::max(cvt.len_mult, 1)));
+        std::memcpy(data.data(), buffer, length);
+        SDL_FreeWAV(buffer);
+
+        std::size_t size = length;
+        if (cvt.needed != 0)
+        {
+            cvt.buf = data.data();
+            cvt.len = static_cast<int>(length);
+            if (SDL_ConvertAudio(&cvt) != 0)
+            {
+                Logger::error("AudioSystem::LoadWAV: Cannot convert '{}': {}", aPath, SDL_GetError());
+                return kInvalidSound;
+            }
+            size = static_cast<std::size_t>(cvt.len_cvt);
+        }
+
+        std::vector<float> samples(size / sizeof(float));
+        std::memcpy(samples.data(), data.data(), samples.size() * sizeof(float));
+        return AddSound(std::move(samples), channels, spec.freq);
+    }
+
+    AudioSystem::SoundHandle AudioSystem::LoadSamples(const std::vector<float> &aSamples, int aChannels, int aSampleRate)
+    {
+        if (aChannels < 1 || aChannels > 2 || aSampleRate <= 0 || aSamples.size() % static_cast<std::size_t>(aChannels) != 0)
+        {
+            Logger::error("AudioSystem::LoadSamples: Expected mono or stereo samples with a valid rate");
+            return kInvalidSound;
+        }
+        return AddSound(aSamples, aChannels, aSampleRate);
+    }
+
+    AudioSystem::VoiceHandle AudioSystem::Play(SoundHandle aSound)
+    {
+        return Play(aSound, PlayParameters());
+    }
+
+    AudioSystem::VoiceHandle AudioSystem::Play(SoundHandle aSound, const PlayParameters &aParameters)
+    {
+        if (aSound == kInvalidSound || aSound > mSounds.size())
+        {
+            Logger::error("AudioSystem::Play: Invalid sound");
+            return kInvalidVoice;
+        }
+
+        if (++mNextVoice == kInvalidVoice)
+        {
+            ++mNextVoice;
+        }
+        if (!mCommands.TryPush({COMMAND_PLAY, mNextVoice, mSounds[aSound - 1].get(), nullptr, 0.0F, aParameters}))
+        {
+            Logger::warn("AudioSystem::Play: The command queue is full");
+            return kInvalidVoice;
+        }
+        mPlaying.insert(mNextVoice);
+        return mNextVoice;
+    }
+
+    void AudioSystem::Stop(VoiceHandle aVoice)
+    {
+        Send({COMMAND_STOP, aVoice, nullptr, nullptr, 0.0F, {}});
+    }
+
+    void AudioSystem::StopAll()
+    {
+        Send({COMMAND_STOP_ALL, kInvalidVoice, nullptr, nullptr, 0.0F, {}});
+    }
+
+    void AudioSystem::SetVolume(VoiceHandle aVoice, float aVolume)
+    {
+        Send({COMMAND_VOLUME, aVoice, nullptr, nullptr, aVolume, {}});
+    }
+
+    void AudioSystem::SetPan(VoiceHandle aVoice, float aPan)
+    {
+        Send({COMMAND_PAN, aVoice, nullptr, nullptr, aPan, {}});
+    }
+
+    void AudioSystem::SetPitch(VoiceHandle aVoice, float aPitch)
+    {
+        Send({COMMAND_PITCH, aVoice, nullptr, nullptr, aPitch, {}});
+    }
+
+    void AudioSystem::SetMasterVolume(float aVolume)
+    {
+        Send({COMMAND_MASTER_VOLUME, kInvalidVoice, nullptr, nullptr, aVolume, {}});
+    }
+
+    void AudioSystem::SetRealVoiceCount(std::size_t aCount)
+    {
+        Send({COMMAND_REAL_VOICES, kInvalidVoice, nullptr, nullptr, static_cast<float>(std::min(aCount, kMaxVoices)), {}});
+    }
+
+    AudioSystem::VoiceHandle AudioSystem::PlayStream(const std::string &aPath, const PlayParameters &aParameters)
+    {
+        StreamSource source{aPath, aParameters.loop};
+        AudioStream *stream = OpenStream(source, 0.0);
+        if (stream == nullptr)
+        {
+            return kInvalidVoice;
+        }
+
+        if (++mNextVoice == kInvalidVoice)
+        {
+            ++mNextVoice;
+        }
+        if (!mCommands.TryPush({COMMAND_PLAY, mNextVoice, nullptr, stream, 0.0F, aParameters}))
+        {
+            Logger::warn("AudioSystem::PlayStream: The command queue is full");
+            FreeStream(stream);
+            return kInvalidVoice;
+        }
+        mPlaying.insert(mNextVoice);
+        mStreamSources.emplace(mNextVoice, std::move(source));
+        return mNextVoice;
+    }
+
+    bool AudioSystem::SeekStream(VoiceHandle aVoice, double aSeconds)
+    {
+        const auto source = mStreamSources.find(aVoice);
+        if (source == mStreamSources.end())
+        {
+            Logger::error("AudioSystem::SeekStream: Not a streamed voice");
+            return false;
+        }
+
+        AudioStream *stream = OpenStream(source->second, aSeconds);
+        if (stream == nullptr)
+        {
+            return false;
+        }
+        if (!mCommands.TryPush({COMMAND_SEEK_STREAM, aVoice, nullptr, stream, 0.0F, {}}))
+        {
+            Logger::warn("AudioSystem::SeekStream: The command queue is full");
+            FreeStream(stream);
+            return false;
+        }
+        return true;
+    }
+
+    void AudioSystem::SetStreamLatency(float aSeconds)
+    {
+        mStreamLatency = std::max(aSeconds, 0.0F);
+    }
+
+    void AudioSystem::Update()
+    {
+        VoiceHandle voice;
+        while (mEnded.TryPop(voice))
+        {
+            mPlaying.erase(voice);
+            mStreamSources.erase(voice);
+        }
+
+        AudioStream *stream;
+        while (mReleasedStreams.TryPop(stream))
+        {
+            FreeStream(stream);
+        }
+    }
+
+    bool AudioSystem::IsPlaying(VoiceHandle aVoice) const
+    {
+        return mPlaying.count(aVoice) > 0;
+    }
+
+    void AudioSystem::Render(float *aOutput, std::size_t aFrames)
+    {
+        const auto start = SDL_GetPerformanceCounter();
+        ApplyCommands();
+        std::fill(aOutput, aOutput + aFrames * 2, 0.0F);
+
+        // The most important voices are mixed, the others only move forward in their sound
+        const auto count = mVoiceCount;
+        const auto realCount = std::min(mRealVoiceCount, count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            mOrder[i] = static_cast<uint16_t>(i);
+        }
+        if (realCount < count)
+        {
+            std::nth_element(mOrder.begin(), mOrder.begin() + static_cast<std::ptrdiff_t>(realCount), mOrder.begin() + static_cast<std::ptrdiff_t>(count),
+                             [this](uint16_t aVoice, uint16_t aOther)
+                             { return IsMoreImportant(mVoices[aVoice], mVoices[aOther]); });
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto &voice = mVoices[mOrder[i]];
+            const bool real = i < realCount;
+            bool playing;
+            if (real)
+            {
+                // A voice coming back from virtual fades in, a new one starts at full volume
+                if (!voice.real && voice.started)
+                {
+                    voice.gains[0] = 0.0F;
+                    voice.gains[1] = 0.0F;
+                }
+
+                float left;
+                float right;
+                ComputeGains(GetChannels(voice), voice.volume, voice.pan, left, right);
+                playing = voice.stream != nullptr ? MixStream(voice, aOutput, aFrames, left, right) : MixVoice(voice, aOutput, aFrames, left, right);
+            }
+            else if (voice.real)
+            {
+                // Fades out over one buffer before going silent
+                playing = voice.stream != nullptr ? MixStream(voice, aOutput, aFrames, 0.0F, 0.0F) : MixVoice(voice, aOutput, aFrames, 0.0F, 0.0F);
+            }
+            else
+            {
+                playing = voice.stream != nullptr ? SkipStream(voice, aFrames) : SkipVoice(voice, aFrames);
+            }
+
+            voice.real = real;
+            voice.started = true;
+            if (!playing)
+            {
+                EndVoice(voice);
+                voice.handle = kInvalidVoice;
+            }
+        }
+
+        for (std::size_t i = 0; i < mVoiceCount;)
+        {
+            if (mVoices[i].handle == kInvalidVoice)
+            {
+                mVoices[i] = mVoices[--mVoiceCount];
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        ApplyMasterVolume(aOutput, aFrames * 2, mMasterVolume);
+
+        const double milliseconds = static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+        mStatRealVoices.store(static_cast<uint32_t>(realCount), std::memory_order_relaxed);
+        mStatVirtualVoices.store(static_cast<uint32_t>(count - realCount), std::memory_order_relaxed);
+        mStatCallbackMilliseconds.store(static_cast<float>(milliseconds), std::memory_order_relaxed);
+        if (aFrames > 0)
+        {
+            mStatLoad.store(static_cast<float>(milliseconds * static_cast<double>(mSampleRate) / (1000.0 * static_cast<double>(aFrames))), std::memory_order_relaxed);
+        }
+    }
+
+    void AudioSystem::RenderOffline(float *aOutput, std::size_t aFrames)
+    {
+        if (mDevice != 0)
+        {
+            Logger::error("AudioSystem::RenderOffline: The device is open, its callback renders");
+            return;
+        }
+        StartStreaming();
+        mWaitForStreams = true;
+        Render(aOutput, aFrames);
+        mWaitForStreams = false;
+    }
+
+    int AudioSystem::GetSampleRate() const
+    {
+        return mSampleRate;
+    }
+
+    AudioSystem::Stats AudioSystem::GetStats() const
+    {
+        return {mStatRealVoices.load(std::memory_order_relaxed),
+                mStatVirtualVoices.load(std::memory_order_relaxed),
+                mStatCallbackMilliseconds.load(std::memory_order_relaxed),
+                mStatLoad.load(std::memory_order_relaxed),
+                mStatStreamUnderruns.load(std::memory_order_relaxed)};
+    }
+
+    AudioSystem::SoundHandle AudioSystem::AddSound(std::vector<float> aSamples, int aChannels, int aSampleRate)
+    {
+        const auto channels = static_cast<std::size_t>(aChannels);
+        const auto frames = aSamples.size() / channels;
+        if (frames == 0)
+        {
+            Logger::error("AudioSystem::AddSound: The sound is empty");
+            return kInvalidSound;
+        }
+
+        // Two guard frames, interpolation can read one past the end and rounding another one
+        for (std::size_t frame = 0; frame < 2; ++frame)
+        {
+            for (std::size_t channel = 0; channel < channels; ++channel)
+            {
+                aSamples.push_back(aSamples[(frame % frames) * channels + channel]);
+            }
+        }
+
+        auto sound = std::make_unique<Sound>();
+        sound->samples = std::move(aSamples);
+        sound->frames = frames;
+        sound->channels = static_cast<uint32_t>(channels);
+        sound->sampleRate = static_cast<float>(aSampleRate);
+        mSounds.push_back(std::move(sound));
+        return static_cast<SoundHandle>(mSounds.size());
+    }
+
+    AudioStream *AudioSystem::OpenStream(const StreamSource &aSource, double aSeconds)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mStreamMutex);
+            if (mStreams.size() >= kMaxStreams)
+            {
+                Logger::error("AudioSystem::OpenStream: Too many streams playing");
+                return nullptr;
+            }
+        }
+
+        std::unique_ptr<AudioStream> stream(AudioStream::FromFile(aSource.path, mStreamLatency, aSource.loop));
+        if (stream == nullptr)
+        {
+            return nullptr;
+        }
+
+        // Nothing else sees the stream yet, it's decoded on this thread up to its latency
+        const auto frames = stream->GetFrameCount();
+        auto frame = static_cast<uint64_t>(std::max(aSeconds, 0.0) * static_cast<double>(stream->GetSampleRate()));
+        frame = aSource.loop && frames > 0 ? frame % frames : std::min(frame, frames);
+        if (frame > 0 && !stream->Seek(frame))
+        {
+            Logger::error("AudioSystem::OpenStream: Cannot seek '{}' to {}s", aSource.path, aSeconds);
+            return nullptr;
+        }
+        stream->Fill();
+
+        std::lock_guard<std::mutex> lock(mStreamMutex);
+        mStreams.push_back(std::move(stream));
+        StartStreaming();
+        return mStreams.back().get();
+    }
+
+    void AudioSystem::FreeStream(AudioStream *aStream)
+    {
+        std::lock_guard<std::mutex> lock(mStreamMutex);
+        const auto stream = std::find_if(mStreams.begin(), mStreams.end(), [aStream](const std::unique_ptr<AudioStream> &aOther)
+                                         { return aOther.get() == aStream; });
+        if (stream != mStreams.end())
+        {
+            *stream = std::move(mStreams.back());
+            mStreams.pop_back();
+        }
+    }
+
+    void AudioSystem::FillStreams()
+    {
+        std::lock_guard<std::mutex> lock(mStreamMutex);
+        for (const auto &stream : mStreams)
+        {
+            stream->Fill();
+        }
+    }
+
+    void AudioSystem::StartStreaming()
+    {
+        if (!mStreamThread.joinable())
+        {
+            mStreaming.store(true);
+            mStreamThread = std::thread(&AudioSystem::StreamLoop, this);
+        }
+    }
+
+    void AudioSystem::StreamLoop()
+    {
+        while (mStreaming.load(std::memory_order_relaxed))
+        {
+            FillStreams();
+            std::this_thread::sleep_for(std::chrono::milliseconds(kStreamPollMilliseconds));
+        }
+    }
+
+    void AudioSystem::Send(const Command &aCommand)
+    {
+        if (!mCommands.TryPush(aCommand))
+        {
+            Logger::warn("AudioSystem: The command queue is full, dropping a command");
+        }
+    }
+
+    void AudioSystem::ApplyCommands()
+    {
+        Command command;
+        while (mCommands.TryPop(command))
+        {
+            if (command.type == COMMAND_PLAY)
+            {
+                StartVoice(command);
+                continue;
+            }
+            if (command.type == COMMAND_SEEK_STREAM)
+            {
+                // The new stream is already decoded at the right place, the old one is freed
+                Voice *voice = FindVoice(command.voice);
+                if (voice == nullptr || voice->stream == nullptr)
+                {
+                    mReleasedStreams.TryPush(command.stream);
+                    continue;
+                }
+                mReleasedStreams.TryPush(voice->stream);
+                voice->stream = command.stream;
+                voice->position = 0.0;
+                continue;
+            }
+            if (command.type == COMMAND_STOP_ALL)
+            {
+                for (std::size_t i = 0; i < mVoiceCount; ++i)
+                {
+                    EndVoice(mVoices[i]);
+                }
+                mVoiceCount = 0;
+                continue;
+            }
+            if (command.type == COMMAND_MASTER_VOLUME)
+            {
+                mMasterVolume = std::max(command.value, 0.0F);
+                continue;
+            }
+            if (command.type == COMMAND_REAL_VOICES)
+            {
+                mRealVoiceCount = static_cast<std::size_t>(command.value);
+                continue;
+            }
+
+            // The voice may have ended before the command arrived
+            Voice *voice = FindVoice(command.voice);
+            if (voice == nullptr)
+            {
+                continue;
+            }
+            switch (command.type)
+            {
+            case COMMAND_STOP:
+                EndVoice(*voice);
+                *voice = mVoices[--mVoiceCount];
+                break;
+            case COMMAND_VOLUME:
+                voice->volume = std::max(command.value, 0.0F);
+                break;
+            case COMMAND_PAN:
+                voice->pan = std::clamp(command.value, -1.0F, 1.0F);
+                break;
+            case COMMAND_PITCH:
+                voice->pitch = std::clamp(command.value, kMinPitch, kMaxPitch);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void AudioSystem::StartVoice(const Command &aCommand)
+    {
+        const auto &parameters = aCommand.parameters;
+        Voice voice{aCommand.voice, aCommand.sound, aCommand.stream, 0.0, std::max(parameters.volume, 0.0F), std::clamp(parameters.pan, -1.0F, 1.0F),
+                    std::clamp(parameters.pitch, kMinPitch, kMaxPitch), parameters.priority, parameters.loop, false, false, {0.0F, 0.0F}};
+
+        // New voices start at their full gains, see Render
+        ComputeGains(GetChannels(voice), voice.volume, voice.pan, voice.gains[0], voice.gains[1]);
+
+        if (mVoiceCount < kMaxVoices)
+        {
+            mVoices[mVoiceCount++] = voice;
+            return;
+        }
+
+        // Every slot is taken, the least important voice makes room if the new one matters more
+        auto *least = &mVoices[0];
+        for (std::size_t i = 1; i < mVoiceCount; ++i)
+        {
+            if (IsMoreImportant(*least, mVoices[i]))
+            {
+                least = &mVoices[i];
+            }
+        }
+        if (IsMoreImportant(*least, voice))
+        {
+            EndVoice(voice);
+            return;
+        }
+        EndVoice(*least);
+        *least = voice;
+    }
+
+    void AudioSystem::EndVoice(const Voice &aVoice)
+    {
+        mEnded.TryPush(aVoice.handle);
+        if (aVoice.stream != nullptr)
+        {
+            mReleasedStreams.TryPush(aVoice.stream);
+        }
+    }
+
+    AudioSystem::Voice *AudioSystem::FindVoice(VoiceHandle aVoice)
+    {
+        for (std::size_t i = 0; i < mVoiceCount; ++i)
+        {
+            if (mVoices[i].handle == aVoice)
+            {
+                return &mVoices[i];
+            }
+        }
+        return nullptr;
+    }
+
+    uint32_t AudioSystem::GetChannels(const Voice &aVoice) const
+    {
+        return aVoice.stream != nullptr ? aVoice.stream->GetChannels() : aVoice.sound->channels;
+    }
+
+    double AudioSystem::GetStreamStep(const Voice &aVoice) const
+    {
+        const double step = static_cast<double>(aVoice.stream->GetSampleRate()) / static_cast<double>(mSampleRate) * static_cast<double>(aVoice.pitch);
+        return std::min(step, static_cast<double>(kMaxStreamStep));
+    }
+
+    bool AudioSystem::IsMoreImportant(const Voice &aVoice, const Voice &aOther) const
+    {
+        if (aVoice.priority != aOther.priority)
+        {
+            return aVoice.priority > aOther.priority;
+        }
+        return aVoice.volume > aOther.volume;
+    }
+
+    bool AudioSystem::MixVoice(Voice &aVoice, float *aOutput, std::size_t aFrames, float aLeft, float aRight)
+    {
+        const Sound &sound = *aVoice.sound;
+        const double step = static_cast<double>(sound.sampleRate) / static_cast<double>(mSampleRate) * static_cast<double>(aVoice.pitch);
+        const auto frames = static_cast<double>(sound.frames);
+        const float stepLeft = (aLeft - aVoice.gains[0]) / static_cast<float>(aFrames);
+        const float stepRight = (aRight - aVoice.gains[1]) / static_cast<float>(aFrames);
+        float left = aVoice.gains[0];
+        float right = aVoice.gains[1];
+
+        // Mixed in segments that end with the sound, looping voices go back to the start
+        std::size_t done = 0;
+        while (done < aFrames)
+        {
+            if (aVoice.position >= frames)
+            {
+                if (!aVoice.loop)
+                {
+                    return false;
+                }
+                aVoice.position = std::fmod(aVoice.position, frames);
+            }
+
+            const auto count = std::min(aFrames - done, static_cast<std::size_t>(std::ceil((frames - aVoice.position) / step)));
+            MixSegment(sound.samples.data(), sound.channels, aVoice.position, step, aOutput + done * 2, count, left, right, stepLeft, stepRight);
+            aVoice.position += step * static_cast<double>(count);
+            left += stepLeft * static_cast<float>(count);
+            right += stepRight * static_cast<float>(count);
+            done += count;
+        }
+
+        aVoice.gains[0] = aLeft;
+        aVoice.gains[1] = aRight;
+        return aVoice.loop || aVoice.position < frames;
+    }
+
+    bool AudioSystem::SkipVoice(Voice &aVoice, std::size_t aFrames)
+    {
+        const Sound &sound = *aVoice.sound;
+        const auto frames = static_cast<double>(sound.frames);
+        aVoice.position += static_cast<double>(sound.sampleRate) / static_cast<double>(mSampleRate) * static_cast<double>(aVoice.pitch) * static_cast<double>(aFrames);
+        if (aVoice.position < frames)
+        {
+            return true;
+        }
+        if (!aVoice.loop)
+        {
+            return false;
+        }
+        aVoice.position = std::fmod(aVoice.position, frames);
+        return true;
+    }
+
+    bool AudioSystem::MixStream(Voice &aVoice, float *aOutput, std::size_t aFrames, float aLeft, float aRight)
+    {
+        AudioStream &stream = *aVoice.stream;
+        const auto channels = stream.GetChannels();
+        const double step = GetStreamStep(aVoice);
+        const float stepLeft = (aLeft - aVoice.gains[0]) / static_cast<float>(aFrames);
+        const float stepRight = (aRight - aVoice.gains[1]) / static_cast<float>(aFrames);
+        float left = aVoice.gains[0];
+        float right = aVoice.gains[1];
+
+        // Mixed in chunks copied out of the ring, so interpolation reads contiguous frames
+        std::size_t done = 0;
+        while (done < aFrames)
+        {
+            const auto count = std::min(aFrames - done, kStreamChunk);
+            const double end = aVoice.position + step * static_cast<double>(count);
+            const auto needed = std::max(static_cast<std::size_t>(end - step) + 2, static_cast<std::size_t>(end));
+            if (mWaitForStreams)
+            {
+                WaitForStream(stream, needed);
+            }
+            const bool finished = stream.IsFinished();
+            const auto available = stream.GetAvailableFrames();
+            if (available < needed && !finished)
+            {
+                // The decoder fell behind, the voice waits with the rest of the buffer silent
+                mStatStreamUnderruns.fetch_add(1, std::memory_order_relaxed);
+                aVoice.gains[0] = left;
+                aVoice.gains[1] = right;
+                return true;
+            }
+
+            // Frames past the end of the file are silent
+            const auto copied = std::min(available, needed);
+            stream.Peek(mStreamScratch.data(), copied);
+            std::fill(mStreamScratch.begin() + static_cast<std::ptrdiff_t>(copied * channels), mStreamScratch.begin() + static_cast<std::ptrdiff_t>(needed * channels), 0.0F);
+            MixSegment(mStreamScratch.data(), channels, aVoice.position, step, aOutput + done * 2, count, left, right, stepLeft, stepRight);
+            if (finished && end >= static_cast<double>(available))
+            {
+                stream.Consume(available);
+                return false;
+            }
+
+            const auto consumed = static_cast<std::size_t>(end);
+            stream.Consume(consumed);
+            aVoice.position = end - static_cast<double>(consumed);
+            left += stepLeft * static_cast<float>(count);
+            right += stepRight * static_cast<float>(count);
+            done += count;
+        }
+
+        aVoice.gains[0] = aLeft;
+        aVoice.gains[1] = aRight;
+        return true;
+    }
+
+    void AudioSystem::WaitForStream(const AudioStream &aStream, std::size_t aFrames) const
+    {
+        while (!aStream.IsFinished() && aStream.GetAvailableFrames() < aFrames)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    bool AudioSystem::SkipStream(Voice &aVoice, std::size_t aFrames)
+    {
+        AudioStream &stream = *aVoice.stream;
+        const double end = aVoice.position + GetStreamStep(aVoice) * static_cast<double>(aFrames);
+        const auto whole = static_cast<std::size_t>(end);
+        auto remaining = whole;
+        if (mWaitForStreams)
+        {
+            // There can be more frames to skip than the buffer holds, they're dropped as the
+            // decoding thread delivers them
+            WaitForStream(stream, std::min(remaining, stream.GetBufferFrames()));
+            while (remaining > stream.GetAvailableFrames() && !stream.IsFinished())
+            {
+                const auto available = stream.GetAvailableFrames();
+                stream.Consume(available);
+                remaining -= available;
+                WaitForStream(stream, std::min(remaining, stream.GetBufferFrames()));
+            }
+        }
+        const bool finished = stream.IsFinished();
+        const auto available = stream.GetAvailableFrames();
+        if (finished && remaining >= available)
+        {
+            stream.Consume(available);
+            return false;
+        }
+
+        // A virtual voice doesn't wait for the decoder, it loses the frames that weren't there
+        if (remaining > available)
+        {
+            mStatStreamUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        stream.Consume(std::min(remaining, available));
+        aVoice.position = end - static_cast<double>(whole);
+        return true;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
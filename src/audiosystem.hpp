@@ -0,0 +1,276 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_AUDIOSYSTEM_HPP
+#define NABLA2D_AUDIOSYSTEM_HPP
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "spscqueue.hpp"
+#include "audiostream.hpp"
+
+namespace nabla2d
+{
+    // Stereo float mixer running in the SDL audio callback. The game thread only sends commands
+    // through a lock-free queue and reads back the voices that ended through another one, the
+    // callback owns every voice and never locks or allocates. When more voices play than can
+    // be mixed, the least important ones (lower priority, then lower volume) become virtual:
+    // they keep their place in the sound but aren't heard until a slot frees up.
+    // Sounds stay loaded until the system is destroyed, the callback reads them without a lock.
+    // Long sounds and music are streamed instead: a background thread decodes them into ring
+    // buffers ahead of the callback, and the callback hands them back once their voice ended.
+    // RenderOffline mixes without a device and waits for that thread instead of underrunning,
+    // so its output doesn't depend on timing.
+    class AudioSystem
+    {
+    public:
+        typedef uint32_t SoundHandle;
+        typedef uint32_t VoiceHandle;
+
+        static constexpr SoundHandle kInvalidSound = 0;
+        static constexpr VoiceHandle kInvalidVoice = 0;
+        static constexpr int kDefaultSampleRate = 48000;
+        static constexpr int kDefaultBufferFrames = 512;
+        // Voices playing at once, real and virtual
+        static constexpr std::size_t kMaxVoices = 256;
+        static constexpr std::size_t kDefaultRealVoices = 32;
+        // Seconds of audio decoded ahead of a streamed voice
+        static constexpr float kDefaultStreamLatency = 0.25F;
+        static constexpr std::size_t kMaxStreams = 32;
+
+        struct PlayParameters
+        {
+            float volume{1.0F};
+            // -1 left, 1 right
+            float pan{0.0F};
+            // Playback rate, 2 is an octave up
+            float pitch{1.0F};
+            int priority{0};
+            bool loop{false};
+        };
+
+        struct Stats
+        {
+            uint32_t realVoices;
+            uint32_t virtualVoices;
+            // Time spent in the last callback, and its share of the buffer duration
+            float callbackMilliseconds;
+            float load;
+            // Buffers where a streamed voice ran out of decoded frames, since the start
+            uint32_t streamUnderruns;
+        };
+
+        explicit AudioSystem(int aSampleRate = kDefaultSampleRate);
+        AudioSystem(const AudioSystem &aAudioSystem) = delete;
+        AudioSystem &operator=(const AudioSystem &aAudioSystem) = delete;
+        ~AudioSystem();
+
+        // Opens the default output device. The SDL_AUDIODRIVER environment variable picks the
+        // driver, "dummy" or "disk" run the callback without a sound card.
+        bool Init(int aBufferFrames = kDefaultBufferFrames);
+        void Destroy();
+        bool IsOpen() const;
+
+        SoundHandle LoadWAV(const std::string &aPath);
+        // Interleaved mono or stereo samples
+        SoundHandle LoadSamples(const std::vector<float> &aSamples, int aChannels, int aSampleRate);
+
+        // Returns kInvalidVoice when the command queue is full. A voice can still be refused or
+        // stolen by a more important one once the mixer gets the command, it then just ends.
+        VoiceHandle Play(SoundHandle aSound);
+        VoiceHandle Play(SoundHandle aSound, const PlayParameters &aParameters);
+        void Stop(VoiceHandle aVoice);
+        void StopAll();
+        void SetVolume(VoiceHandle aVoice, float aVolume);
+        void SetPan(VoiceHandle aVoice, float aPan);
+        void SetPitch(VoiceHandle aVoice, float aPitch);
+        void SetMasterVolume(float aVolume);
+        // Voices actually mixed, up to kMaxVoices
+        void SetRealVoiceCount(std::size_t aCount);
+
+        // Plays a .wav or .ogg file decoded while it plays. The first kDefaultStreamLatency
+        // seconds (see SetStreamLatency) are decoded before returning, so the voice starts
+        // with the next buffer. Looping streams decode the start again ahead of the end.
+        VoiceHandle PlayStream(const std::string &aPath, const PlayParameters &aParameters);
+        // Jumps to aSeconds in a streamed voice. The new position is decoded before returning
+        // and swapped in by the mixer, so the voice never waits for the decoder.
+        bool SeekStream(VoiceHandle aVoice, double aSeconds);
+        // Seconds decoded ahead by the streams started afterwards
+        void SetStreamLatency(float aSeconds);
+
+        // Call once per frame on the game thread, forgets the voices that ended and frees their
+        // streams
+        void Update();
+        bool IsPlaying(VoiceHandle aVoice) const;
+
+        // Mixes aFrames interleaved stereo frames into aOutput. Called by the device callback,
+        // never waits: a stream the decoding thread didn't fill in time underruns.
+        void Render(float *aOutput, std::size_t aFrames);
+        // Game thread, only while no device is open. Like Render, but every streamed voice
+        // first waits for the frames it needs, so the output is the same on every run.
+        void RenderOffline(float *aOutput, std::size_t aFrames);
+
+        int GetSampleRate() const;
+        Stats GetStats() const;
+
+    private:
+        static constexpr std::size_t kCommandCapacity = 4096;
+        static constexpr std::size_t kEndedCapacity = 4096;
+        // Streams are mixed kStreamChunk frames at a time and read at most kMaxStreamStep
+        // frames per output frame, the chunk is copied out of the ring for interpolation
+        static constexpr std::size_t kStreamChunk = 256;
+        static constexpr std::size_t kMaxStreamStep = 16;
+        static constexpr int kStreamPollMilliseconds = 5;
+        static_assert(kStreamChunk * kMaxStreamStep + 3 <= AudioStream::kMinBufferFrames, "A stream chunk must fit in its buffer");
+
+        typedef enum
+        {
+            COMMAND_PLAY,
+            COMMAND_SEEK_STREAM,
+            COMMAND_STOP,
+            COMMAND_STOP_ALL,
+            COMMAND_VOLUME,
+            COMMAND_PAN,
+            COMMAND_PITCH,
+            COMMAND_MASTER_VOLUME,
+            COMMAND_REAL_VOICES
+        } CommandType;
+
+        // Samples are followed by a copy of the first frame, so interpolating past the last
+        // frame of a looping sound reads the right value
+        struct Sound
+        {
+            std::vector<float> samples;
+            std::size_t frames;
+            uint32_t channels;
+            float sampleRate;
+        };
+
+        struct Command
+        {
+            CommandType type;
+            VoiceHandle voice;
+            const Sound *sound;
+            AudioStream *stream;
+            float value;
+            PlayParameters parameters;
+        };
+
+        // Plays either a sound or a stream. The position of a streamed voice is relative to the
+        // read position of its stream.
+        struct Voice
+        {
+            VoiceHandle handle;
+            const Sound *sound;
+            AudioStream *stream;
+            double position;
+            float volume;
+            float pan;
+            float pitch;
+            int priority;
+            bool loop;
+            bool real;
+            // Mixed or skipped at least once
+            bool started;
+            // Gains reached at the end of the last buffer, new gains are ramped from there
+            float gains[2];
+        };
+
+        // What's needed to open a streamed voice again when seeking
+        struct StreamSource
+        {
+            std::string path;
+            bool loop;
+        };
+
+        int mSampleRate;
+        uint32_t mDevice{0};
+        std::vector<std::unique_ptr<Sound>> mSounds;
+        VoiceHandle mNextVoice{kInvalidVoice};
+        std::unordered_set<VoiceHandle> mPlaying;
+        std::unordered_map<VoiceHandle, StreamSource> mStreamSources;
+        float mStreamLatency{kDefaultStreamLatency};
+
+        SPSCQueue<Command> mCommands{kCommandCapacity};
+        SPSCQueue<VoiceHandle> mEnded{kEndedCapacity};
+        SPSCQueue<AudioStream *> mReleasedStreams{kEndedCapacity};
+
+        // Game and decoding threads, the callback only sees the streams of its voices
+        std::mutex mStreamMutex;
+        std::vector<std::unique_ptr<AudioStream>> mStreams;
+        std::thread mStreamThread;
+        std::atomic<bool> mStreaming{false};
+
+        // Callback thread only
+        std::array<Voice, kMaxVoices> mVoices;
+        std::size_t mVoiceCount{0};
+        std::array<uint16_t, kMaxVoices> mOrder;
+        std::size_t mRealVoiceCount{kDefaultRealVoices};
+        float mMasterVolume{1.0F};
+        std::vector<float> mStreamScratch;
+        // Set by RenderOffline for the length of its Render
+        bool mWaitForStreams{false};
+
+        std::atomic<uint32_t> mStatRealVoices{0};
+        std::atomic<uint32_t> mStatVirtualVoices{0};
+        std::atomic<float> mStatCallbackMilliseconds{0.0F};
+        std::atomic<float> mStatLoad{0.0F};
+        std::atomic<uint32_t> mStatStreamUnderruns{0};
+
+        SoundHandle AddSound(std::vector<float> aSamples, int aChannels, int aSampleRate);
+        AudioStream *OpenStream(const StreamSource &aSource, double aSeconds);
+        void FreeStream(AudioStream *aStream);
+        void FillStreams();
+        // Runs the decoding thread, from the first stream or device on
+        void StartStreaming();
+        // Decoding thread, tops the streams up every kStreamPollMilliseconds
+        void StreamLoop();
+        void Send(const Command &aCommand);
+        void ApplyCommands();
+        void StartVoice(const Command &aCommand);
+        // Hands the voice and its stream back to the game thread
+        void EndVoice(const Voice &aVoice);
+        Voice *FindVoice(VoiceHandle aVoice);
+        uint32_t GetChannels(const Voice &aVoice) const;
+        double GetStreamStep(const Voice &aVoice) const;
+        bool IsMoreImportant(const Voice &aVoice, const Voice &aOther) const;
+        // Returns false once a non-looping voice reached the end of its sound
+        bool MixVoice(Voice &aVoice, float *aOutput, std::size_t aFrames, float aLeft, float aRight);
+        bool SkipVoice(Voice &aVoice, std::size_t aFrames);
+        bool MixStream(Voice &aVoice, float *aOutput, std::size_t aFrames, float aLeft, float aRight);
+        bool SkipStream(Voice &aVoice, std::size_t aFrames);
+        // Until aStream holds aFrames frames or its file was decoded to the end
+        void WaitForStream(const AudioStream &aStream, std::size_t aFrames) const;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_AUDIOSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -20,6 +20,8 @@
 
 #include "camera.hpp"
 
+#include <cmath>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 
@@ -33,7 +35,9 @@ namespace nabla2d
                                                           mNextProjectionSettings(aSettings),
                                                           mViewMatrix(1.0F),
                                                           mProjectionMatrix(1.0F),
-                                                          mProjectionViewMatrix(1.0F)
+                                                          mProjectionViewMatrix(1.0F),
+                                                          mInverseProjectionMatrix(1.0F),
+                                                          mInverseProjectionViewMatrix(1.0F)
     {
         Update();
     }
@@ -130,12 +134,55 @@ namespace nabla2d
         return mProjectionViewMatrix;
     }
 
+    const glm::mat4 &Camera::GetInverseProjectionViewMatrix() const
+    {
+        return mInverseProjectionViewMatrix;
+    }
+
+    glm::vec2 Camera::WorldToScreen(const glm::vec3 &aWorld) const
+    {
+        const auto clip = mProjectionViewMatrix * glm::vec4(aWorld, 1.0F);
+        const auto ndc = glm::vec2(clip) / clip.w;
+        return glm::vec2(ndc.x + 1.0F, 1.0F - ndc.y) * 0.5F * mProjectionSettings.viewportSize;
+    }
+
+    glm::vec3 Camera::ScreenToWorld(const glm::vec2 &aScreen, float aPlaneZ) const
+    {
+        const auto ndc = aScreen / mProjectionSettings.viewportSize * 2.0F - 1.0F;
+        return NDCToWorld({ndc.x, -ndc.y}, aPlaneZ);
+    }
+
+    AABB Camera::GetVisibleBounds(float aPlaneZ) const
+    {
+        AABB bounds{glm::vec2(NDCToWorld({-1.0F, -1.0F}, aPlaneZ)), glm::vec2(NDCToWorld({-1.0F, -1.0F}, aPlaneZ))};
+        for (const auto &corner : {glm::vec2(1.0F, -1.0F), glm::vec2(1.0F, 1.0F), glm::vec2(-1.0F, 1.0F)})
+        {
+            const auto point = glm::vec2(NDCToWorld(corner, aPlaneZ));
+            bounds.min = glm::min(bounds.min, point);
+            bounds.max = glm::max(bounds.max, point);
+        }
+        return bounds;
+    }
+
+    glm::vec3 Camera::NDCToWorld(const glm::vec2 &aNDC, float aPlaneZ) const
+    {
+        const auto near = mInverseProjectionViewMatrix * glm::vec4(aNDC, -1.0F, 1.0F);
+        const auto far = mInverseProjectionViewMatrix * glm::vec4(aNDC, 1.0F, 1.0F);
+        const auto origin = glm::vec3(near) / near.w;
+        const auto direction = glm::vec3(far) / far.w - origin;
+        if (std::abs(direction.z) < 1e-6F)
+        {
+            // View ray parallel to the plane
+            return origin;
+        }
+        return origin + direction * ((aPlaneZ - origin.z) / direction.z);
+    }
+
     void Camera::Update()
     {
         if (mTransformChanged)
         {
             mTransform = mNextTransform;
-            mViewMatrix = glm::inverse(mTransform.GetMatrix());
             mForward = mTransform.GetForward();
             mUp = mTransform.GetUp();
             mRight = mTransform.GetRight();
@@ -144,12 +191,40 @@ namespace nabla2d
         if (mProjectionSettingsChanged)
         {
             mProjectionSettings = mNextProjectionSettings;
-            mProjectionMatrix = glm::perspective(mProjectionSettings.fov, mProjectionSettings.aspectRatio, mProjectionSettings.near, mProjectionSettings.far);
+            if (mProjectionSettings.projection == PROJECTION_ORTHOGRAPHIC)
+            {
+                const auto halfSize = mProjectionSettings.viewportSize * 0.5F / mProjectionSettings.pixelsPerUnit;
+                mProjectionMatrix = glm::ortho(-halfSize.x, halfSize.x, -halfSize.y, halfSize.y, mProjectionSettings.near, mProjectionSettings.far);
+            }
+            else
+            {
+                mProjectionMatrix = glm::perspective(mProjectionSettings.fov, mProjectionSettings.aspectRatio, mProjectionSettings.near, mProjectionSettings.far);
+            }
+            // Only changes on resize, the general inverse is fine here
+            mInverseProjectionMatrix = glm::inverse(mProjectionMatrix);
         }
 
         if (mTransformChanged || mProjectionSettingsChanged)
         {
+            auto position = mTransform.GetPosition();
+            if (mProjectionSettings.projection == PROJECTION_ORTHOGRAPHIC && mProjectionSettings.pixelSnap)
+            {
+                const float pixelsPerUnit = mProjectionSettings.pixelsPerUnit;
+                position.x = std::round(position.x * pixelsPerUnit) / pixelsPerUnit;
+                position.y = std::round(position.y * pixelsPerUnit) / pixelsPerUnit;
+            }
+
+            // The camera transform is rigid (its scale is never changed), so the view matrix is
+            // the transposed rotation and the rotated opposite translation
+            const auto rotation = glm::mat3_cast(mTransform.GetRotationQuat());
+            const auto inverseRotation = glm::transpose(rotation);
+            mViewMatrix = glm::mat4(inverseRotation);
+            mViewMatrix[3] = glm::vec4(-(inverseRotation * position), 1.0F);
+
+            auto cameraMatrix = glm::mat4(rotation);
+            cameraMatrix[3] = glm::vec4(position, 1.0F);
             mProjectionViewMatrix = mProjectionMatrix * mViewMatrix;
+            mInverseProjectionViewMatrix = cameraMatrix * mInverseProjectionMatrix;
         }
 
         mTransformChanged = false;
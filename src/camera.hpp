@@ -22,6 +22,7 @@
 #define NABLA2D_CAMERA_HPP
 
 #include <glm/glm.hpp>
+#include "aabb.hpp"
 #include "transform.hpp"
 
 namespace nabla2d
@@ -29,18 +30,31 @@ namespace nabla2d
     class Camera
     {
     public:
+        typedef enum
+        {
+            PROJECTION_PERSPECTIVE,
+            PROJECTION_ORTHOGRAPHIC
+        } Projection;
+
         typedef struct
         {
             float fov;
             float aspectRatio;
             float near;
             float far;
+            Projection projection;
+            // Window size in pixels, used by the screen space helpers and the orthographic
+            // projection, which shows viewportSize / pixelsPerUnit world units
+            glm::vec2 viewportSize;
+            float pixelsPerUnit;
+            // Orthographic only: rounds the view position to whole pixels so sprites don't shimmer
+            bool pixelSnap;
         } ProjectionSettings;
 
         explicit Camera(const glm::vec3 &aPosition = {0.0F, 0.0F, 0.0F},
                         const glm::vec3 &aRotation = {0.0F, 0.0F, 0.0F},
                         const ProjectionSettings &aSettings = {
-                            45.0F, 16.0F / 9.0F, 0.1F, 100.0F});
+                            45.0F, 16.0F / 9.0F, 0.1F, 100.0F, PROJECTION_PERSPECTIVE, {1600.0F, 900.0F}, 100.0F, false});
         ~Camera() = default;
 
         const glm::vec3 &GetPosition() const;
@@ -65,6 +79,14 @@ namespace nabla2d
         const glm::mat4 &GetViewMatrix() const;
         const glm::mat4 &GetProjectionMatrix() const;
         const glm::mat4 &GetProjectionViewMatrix() const;
+        const glm::mat4 &GetInverseProjectionViewMatrix() const;
+
+        // Screen positions are in pixels from the top left corner of the viewport.
+        // ScreenToWorld returns the point under aScreen on the plane z = aPlaneZ.
+        glm::vec2 WorldToScreen(const glm::vec3 &aWorld) const;
+        glm::vec3 ScreenToWorld(const glm::vec2 &aScreen, float aPlaneZ = 0.0F) const;
+        // Part of the plane z = aPlaneZ covered by the viewport, for culling queries
+        AABB GetVisibleBounds(float aPlaneZ = 0.0F) const;
 
         void Update();
 
@@ -84,6 +106,10 @@ namespace nabla2d
         glm::mat4 mViewMatrix;
         glm::mat4 mProjectionMatrix;
         glm::mat4 mProjectionViewMatrix;
+        glm::mat4 mInverseProjectionMatrix;
+        glm::mat4 mInverseProjectionViewMatrix;
+
+        glm::vec3 NDCToWorld(const glm::vec2 &aNDC, float aPlaneZ) const;
     };
 } // namespace nabla2d
 
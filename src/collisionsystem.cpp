@@ -0,0 +1,287 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "collisionsystem.hpp"
+
+#include <cmath>
+#include <iterator>
+#include <algorithm>
+
+#include "components.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        uint64_t GetPairKey(const CollisionSystem::Contact &aContact)
+        {
+            return (static_cast<uint64_t>(entt::to_integral(aContact.a)) << 32U) | entt::to_integral(aContact.b);
+        }
+
+        bool ComparePairs(const CollisionSystem::Contact &aFirst, const CollisionSystem::Contact &aSecond)
+        {
+            return GetPairKey(aFirst) < GetPairKey(aSecond);
+        }
+    } // namespace
+
+    CollisionSystem::CollisionSystem(JobSystem &aJobSystem, float aCellSize) : mJobSystem(aJobSystem),
+                                                                               mBroadphase(aCellSize)
+    {
+    }
+
+    void CollisionSystem::Update(const entt::registry &aRegistry)
+    {
+        ++mStamp;
+        std::swap(mColliders, mPreviousColliders);
+        mColliders.clear();
+
+        aRegistry.view<WorldTransform, BoxCollider>().each([this](auto aEntity, const WorldTransform &aWorld, const BoxCollider &aCollider)
+                                                           {
+                                                               const auto &m = aWorld.matrix;
+                                                               auto &shape = AddShape(aEntity, SHAPE_BOX, aCollider.layer, aCollider.mask);
+                                                               shape.center = glm::vec2(m * glm::vec4(aCollider.center, 0.0F, 1.0F));
+                                                               shape.halfSize = {std::abs(m[0][0]) * aCollider.halfSize.x + std::abs(m[1][0]) * aCollider.halfSize.y,
+                                                                                 std::abs(m[0][1]) * aCollider.halfSize.x + std::abs(m[1][1]) * aCollider.halfSize.y};
+                                                               mBroadphase.Update(aEntity, {shape.center - shape.halfSize, shape.center + shape.halfSize}); });
+
+        aRegistry.view<WorldTransform, CircleCollider>().each([this](auto aEntity, const WorldTransform &aWorld, const CircleCollider &aCollider)
+                                                              {
+                                                                  const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+                                                                  if (id < mShapes.size() && mShapes[id].entity == aEntity && mShapes[id].stamp == mStamp)
+                                                                  {
+                                                                      return;
+                                                                  }
+
+                                                                  const auto &m = aWorld.matrix;
+                                                                  auto &shape = AddShape(aEntity, SHAPE_CIRCLE, aCollider.layer, aCollider.mask);
+                                                                  shape.center = glm::vec2(m * glm::vec4(aCollider.center, 0.0F, 1.0F));
+                                                                  shape.radius = aCollider.radius * std::max(glm::length(glm::vec2(m[0])), glm::length(glm::vec2(m[1])));
+                                                                  shape.halfSize = glm::vec2(shape.radius);
+                                                                  mBroadphase.Update(aEntity, {shape.center - shape.halfSize, shape.center + shape.halfSize}); });
+
+        // Whatever wasn't seen this tick lost its collider or was destroyed
+        for (auto entity : mPreviousColliders)
+        {
+            const auto &shape = mShapes[entt::to_entity(entity)];
+            if (shape.entity != entity || shape.stamp != mStamp)
+            {
+                mBroadphase.Remove(entity);
+            }
+        }
+
+        mBroadphase.QueryPairs(mJobSystem, mPairs);
+
+        // Narrow phase in place, pairs that don't touch are marked with a null entity
+        mCandidates.resize(mPairs.size());
+        mJobSystem.ParallelFor(mPairs.size(), kGrainSize, [this](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   for (auto i = aBegin; i < aEnd; ++i)
+                                   {
+                                       auto [first, second] = mPairs[i];
+                                       if (entt::to_integral(second) < entt::to_integral(first))
+                                       {
+                                           std::swap(first, second);
+                                       }
+
+                                       auto &contact = mCandidates[i];
+                                       const auto &firstShape = mShapes[entt::to_entity(first)];
+                                       const auto &secondShape = mShapes[entt::to_entity(second)];
+                                       const bool layers = (firstShape.layer & secondShape.mask) != 0 && (secondShape.layer & firstShape.mask) != 0;
+                                       contact.a = layers && Collide(firstShape, secondShape, contact) ? first : entt::null;
+                                       contact.b = second;
+                                   } });
+
+        std::swap(mContacts, mPreviousContacts);
+        mContacts.clear();
+        std::copy_if(mCandidates.begin(), mCandidates.end(), std::back_inserter(mContacts), [](const Contact &aContact)
+                     { return aContact.a != entt::null; });
+        std::sort(mContacts.begin(), mContacts.end(), ComparePairs);
+
+        // Both lists are sorted, so a single merge pass splits them into begin/stay/end
+        mBeginContacts.clear();
+        mStayContacts.clear();
+        mEndContacts.clear();
+        auto current = mContacts.begin();
+        auto previous = mPreviousContacts.begin();
+        while (current != mContacts.end() || previous != mPreviousContacts.end())
+        {
+            if (previous == mPreviousContacts.end() || (current != mContacts.end() && ComparePairs(*current, *previous)))
+            {
+                mBeginContacts.push_back(*current++);
+            }
+            else if (current == mContacts.end() || ComparePairs(*previous, *current))
+            {
+                mEndContacts.push_back(*previous++);
+            }
+            else
+            {
+                mStayContacts.push_back(*current++);
+                ++previous;
+            }
+        }
+    }
+
+    void CollisionSystem::Clear()
+    {
+        mBroadphase.Clear();
+        mShapes.clear();
+        mColliders.clear();
+        mPreviousColliders.clear();
+        mPairs.clear();
+        mCandidates.clear();
+        mContacts.clear();
+        mPreviousContacts.clear();
+        mBeginContacts.clear();
+        mStayContacts.clear();
+        mEndContacts.clear();
+    }
+
+    std::size_t CollisionSystem::GetColliderCount() const
+    {
+        return mColliders.size();
+    }
+
+    const std::vector<CollisionSystem::Contact> &CollisionSystem::GetContacts() const
+    {
+        return mContacts;
+    }
+
+    const std::vector<CollisionSystem::Contact> &CollisionSystem::GetBeginContacts() const
+    {
+        return mBeginContacts;
+    }
+
+    const std::vector<CollisionSystem::Contact> &CollisionSystem::GetStayContacts() const
+    {
+        return mStayContacts;
+    }
+
+    const std::vector<CollisionSystem::Contact> &CollisionSystem::GetEndContacts() const
+    {
+        return mEndContacts;
+    }
+
+    CollisionSystem::Shape &CollisionSystem::AddShape(entt::entity aEntity, ShapeType aType, uint32_t aLayer, uint32_t aMask)
+    {
+        const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+        if (id >= mShapes.size())
+        {
+            mShapes.resize(std::max(id + 1, mShapes.size() * 2));
+        }
+
+        auto &shape = mShapes[id];
+        shape.entity = aEntity;
+        shape.type = aType;
+        shape.layer = aLayer;
+        shape.mask = aMask;
+        shape.stamp = mStamp;
+        mColliders.push_back(aEntity);
+        return shape;
+    }
+
+    bool CollisionSystem::Collide(const Shape &aFirst, const Shape &aSecond, Contact &aContact)
+    {
+        const auto delta = aSecond.center - aFirst.center;
+
+        if (aFirst.type == SHAPE_BOX && aSecond.type == SHAPE_BOX)
+        {
+            const auto overlap = aFirst.halfSize + aSecond.halfSize - glm::abs(delta);
+            if (overlap.x < 0.0F || overlap.y < 0.0F)
+            {
+                return false;
+            }
+            const auto overlapMin = glm::max(aFirst.center - aFirst.halfSize, aSecond.center - aSecond.halfSize);
+            const auto overlapMax = glm::min(aFirst.center + aFirst.halfSize, aSecond.center + aSecond.halfSize);
+            aContact.point = (overlapMin + overlapMax) * 0.5F;
+            // Separate along the axis of least overlap
+            if (overlap.x < overlap.y)
+            {
+                aContact.normal = {delta.x < 0.0F ? -1.0F : 1.0F, 0.0F};
+                aContact.depth = overlap.x;
+            }
+            else
+            {
+                aContact.normal = {0.0F, delta.y < 0.0F ? -1.0F : 1.0F};
+                aContact.depth = overlap.y;
+            }
+            return true;
+        }
+
+        if (aFirst.type == SHAPE_CIRCLE && aSecond.type == SHAPE_CIRCLE)
+        {
+            const auto radius = aFirst.radius + aSecond.radius;
+            const auto distance2 = glm::dot(delta, delta);
+            if (distance2 > radius * radius)
+            {
+                return false;
+            }
+            const auto distance = std::sqrt(distance2);
+            aContact.normal = distance > 0.0F ? delta / distance : glm::vec2(1.0F, 0.0F);
+            aContact.depth = radius - distance;
+            aContact.point = aFirst.center + aContact.normal * (aFirst.radius - aContact.depth * 0.5F);
+            return true;
+        }
+
+        // Box against circle, worked out from the box and flipped back if needed
+        const bool flip = aFirst.type == SHAPE_CIRCLE;
+        const auto &box = flip ? aSecond : aFirst;
+        const auto &circle = flip ? aFirst : aSecond;
+        const auto local = circle.center - box.center;
+        const auto closest = glm::clamp(local, -box.halfSize, box.halfSize);
+
+        if (closest == local)
+        {
+            // Circle center inside the box, push out through the nearest face
+            const auto distance = box.halfSize - glm::abs(local);
+            if (distance.x < distance.y)
+            {
+                aContact.normal = {local.x < 0.0F ? -1.0F : 1.0F, 0.0F};
+                aContact.depth = distance.x + circle.radius;
+            }
+            else
+            {
+                aContact.normal = {0.0F, local.y < 0.0F ? -1.0F : 1.0F};
+                aContact.depth = distance.y + circle.radius;
+            }
+        }
+        else
+        {
+            const auto offset = local - closest;
+            const auto distance2 = glm::dot(offset, offset);
+            if (distance2 > circle.radius * circle.radius)
+            {
+                return false;
+            }
+            const auto distance = std::sqrt(distance2);
+            aContact.normal = offset / distance;
+            aContact.depth = circle.radius - distance;
+        }
+
+        aContact.point = circle.center - aContact.normal * (circle.radius - aContact.depth * 0.5F);
+        if (flip)
+        {
+            aContact.normal = -aContact.normal;
+        }
+        return true;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,119 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_COLLISIONSYSTEM_HPP
+#define NABLA2D_COLLISIONSYSTEM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "jobsystem.hpp"
+#include "spatialindex.hpp"
+
+namespace nabla2d
+{
+    // Contacts between BoxCollider and CircleCollider entities, once per fixed tick. World
+    // space boxes are kept in a SpatialIndex updated in place, candidate pairs and contact
+    // geometry are computed in chunks over the job system, and the result is diffed against
+    // the previous tick into begin/stay/end lists.
+    // Boxes stay axis aligned in world space (a rotated box is tested as its bounding box) and
+    // circles are scaled by the largest axis of their transform.
+    class CollisionSystem
+    {
+    public:
+        // a < b, normal points from a to b and depth is how far they overlap along it. The
+        // point is in world space, halfway through the overlap.
+        struct Contact
+        {
+            entt::entity a;
+            entt::entity b;
+            glm::vec2 normal;
+            glm::vec2 point;
+            float depth;
+        };
+
+        explicit CollisionSystem(JobSystem &aJobSystem, float aCellSize = 2.0F);
+        CollisionSystem(const CollisionSystem &aCollisionSystem) = delete;
+        CollisionSystem &operator=(const CollisionSystem &aCollisionSystem) = delete;
+        ~CollisionSystem() = default;
+
+        // Reads WorldTransform with a BoxCollider or a CircleCollider (the box wins if both are
+        // present), so call it after HierarchySystem::Update
+        void Update(const entt::registry &aRegistry);
+        void Clear();
+
+        std::size_t GetColliderCount() const;
+        // Every touching pair of this tick, sorted by (a, b)
+        const std::vector<Contact> &GetContacts() const;
+        const std::vector<Contact> &GetBeginContacts() const;
+        const std::vector<Contact> &GetStayContacts() const;
+        // Pairs that stopped touching, with their geometry from the last tick they touched
+        const std::vector<Contact> &GetEndContacts() const;
+
+    private:
+        static constexpr std::size_t kGrainSize = 2048;
+
+        typedef enum
+        {
+            SHAPE_BOX,
+            SHAPE_CIRCLE
+        } ShapeType;
+
+        struct Shape
+        {
+            entt::entity entity{entt::null};
+            ShapeType type;
+            glm::vec2 center;
+            glm::vec2 halfSize;
+            float radius;
+            uint32_t layer;
+            uint32_t mask;
+            uint32_t stamp{0};
+        };
+
+        JobSystem &mJobSystem;
+        SpatialIndex mBroadphase;
+        uint32_t mStamp{0};
+
+        // Indexed by entity id
+        std::vector<Shape> mShapes;
+        std::vector<entt::entity> mColliders;
+        std::vector<entt::entity> mPreviousColliders;
+
+        std::vector<std::pair<entt::entity, entt::entity>> mPairs;
+        std::vector<Contact> mCandidates;
+        std::vector<Contact> mContacts;
+        std::vector<Contact> mPreviousContacts;
+        std::vector<Contact> mBeginContacts;
+        std::vector<Contact> mStayContacts;
+        std::vector<Contact> mEndContacts;
+
+        Shape &AddShape(entt::entity aEntity, ShapeType aType, uint32_t aLayer, uint32_t aMask);
+        static bool Collide(const Shape &aFirst, const Shape &aSecond, Contact &aContact);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_COLLISIONSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,119 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_COMPONENTS_HPP
+#define NABLA2D_COMPONENTS_HPP
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "transform.hpp"
+#include "transform2d.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // Registry components shared by the engine systems. The local Transform and
+    // Transform2D components live in transform.hpp and transform2d.hpp.
+
+    // Local to world matrix, written by HierarchySystem
+    struct WorldTransform
+    {
+        glm::mat4 matrix{1.0F};
+    };
+
+    // Transform at the start of the current fixed tick. Entities that have one are
+    // rendered interpolated between it and their Transform.
+    struct PreviousTransform
+    {
+        Transform transform;
+    };
+
+    // Same as PreviousTransform, for entities using a Transform2D
+    struct PreviousTransform2D
+    {
+        Transform2D transform;
+    };
+
+    // Local space extents on the XY plane (a sprite quad is centered with a half size of 0.5)
+    struct Bounds
+    {
+        glm::vec2 center{0.0F, 0.0F};
+        glm::vec2 halfSize{0.5F, 0.5F};
+    };
+
+    // What RenderSystem needs to draw a sprite frame. Plain handles copied out of a Sprite
+    // (see Sprite::GetSpriteRenderer), the Sprite itself keeps owning the resources.
+    struct SpriteRenderer
+    {
+        Renderer::TextureHandle texture{0};
+        Renderer::DataHandle data{0};
+        glm::vec2 size{1.0F, 1.0F};
+        glm::vec4 atlasInfo{0.0F, 0.0F, 1.0F, 1.0F};
+    };
+
+    // Colliders are in local space like Bounds and read by CollisionSystem. Two colliders
+    // touch when each one's layer is in the other's mask.
+    struct BoxCollider
+    {
+        glm::vec2 center{0.0F, 0.0F};
+        glm::vec2 halfSize{0.5F, 0.5F};
+        uint32_t layer{1};
+        uint32_t mask{0xFFFFFFFFU};
+    };
+
+    struct CircleCollider
+    {
+        glm::vec2 center{0.0F, 0.0F};
+        float radius{0.5F};
+        uint32_t layer{1};
+        uint32_t mask{0xFFFFFFFFU};
+    };
+
+    // Moved by PhysicsSystem, on root entities with a Transform2D and a collider. A mass of 0
+    // makes the body static. Bodies with a CircleCollider rotate, boxes keep their rotation.
+    struct RigidBody
+    {
+        glm::vec2 velocity{0.0F, 0.0F};
+        float angularVelocity{0.0F};
+        float mass{1.0F};
+        float friction{0.4F};
+        float restitution{0.0F};
+        float gravityScale{1.0F};
+        // How long the body has been nearly still, islands fall asleep once all their bodies are
+        float sleepTime{0.0F};
+        bool awake{true};
+    };
+
+    // Steered by FlowFieldSystem along one of its fields, on root entities with a Transform2D.
+    // The velocity replaces the one of a RigidBody, so gravity should be off for those.
+    struct FlowAgent
+    {
+        uint32_t field{0};
+        float speed{2.0F};
+        // How quickly the velocity turns to the field's direction, per second
+        float steering{8.0F};
+        glm::vec2 velocity{0.0F, 0.0F};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_COMPONENTS_HPP
+
+// くコ:彡
\ No newline at end of file
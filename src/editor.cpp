@@ -462,6 +462,7 @@ namespace nabla2d
     void Editor::GUIDrawEntityNode(Scene &aScene, Scene::EntityNode &aNode, std::vector<std::pair<entt::entity, entt::entity>> &aNewParents)
     {
         const auto &entityTag = aScene.GetTag(aNode.entity);
+        const auto entityLabel = entityTag.empty() ? fmt::format("#{}", entt::to_integral(aNode.entity)) : entityTag;
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
         if (aNode.children.empty())
         {
@@ -476,7 +477,7 @@ namespace nabla2d
             flags |= ImGuiTreeNodeFlags_Selected;
         }
 
-        const bool isBranchOpen = ImGui::TreeNodeEx(fmt::format("{}##Entity", entityTag).c_str(), flags);
+        const bool isBranchOpen = ImGui::TreeNodeEx(fmt::format("{}##Entity{}", entityLabel, entt::to_integral(aNode.entity)).c_str(), flags);
 
         if (ImGui::IsItemClicked())
         {
@@ -488,7 +489,7 @@ namespace nabla2d
             if (ImGui::BeginDragDropSource())
             {
                 ImGui::SetDragDropPayload("Entity", &aNode.entity, sizeof(entt::entity));
-                ImGui::Text("%s", entityTag.c_str());
+                ImGui::Text("%s", entityLabel.c_str());
                 ImGui::EndDragDropSource();
             }
         }
@@ -0,0 +1,161 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "eventbus.hpp"
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        std::atomic<std::size_t> sEventTypeCount{0};
+
+        // Indices of exited threads are reused, a new thread only pushes to a queue after the
+        // previous owner released it under the same lock
+        std::mutex sProducerMutex;
+        std::vector<std::size_t> sFreeProducers;
+        std::atomic<std::size_t> sProducerCount{0};
+
+        struct ProducerSlot
+        {
+            std::size_t index;
+
+            ProducerSlot()
+            {
+                std::lock_guard<std::mutex> lock(sProducerMutex);
+                if (!sFreeProducers.empty())
+                {
+                    index = sFreeProducers.back();
+                    sFreeProducers.pop_back();
+                    return;
+                }
+
+                index = sProducerCount.load(std::memory_order_relaxed);
+                if (index >= EventBus::kMaxProducers)
+                {
+                    Logger::error("EventBus: More than {} threads publishing, their events are dropped", EventBus::kMaxProducers);
+                    return;
+                }
+                sProducerCount.store(index + 1, std::memory_order_release);
+            }
+
+            ~ProducerSlot()
+            {
+                if (index < EventBus::kMaxProducers)
+                {
+                    std::lock_guard<std::mutex> lock(sProducerMutex);
+                    sFreeProducers.push_back(index);
+                }
+            }
+        };
+    } // namespace
+
+    EventBus::~EventBus()
+    {
+        for (auto &channel : mChannels)
+        {
+            delete channel.load(std::memory_order_relaxed);
+        }
+    }
+
+    void EventBus::Unsubscribe(Subscription aSubscription)
+    {
+        for (auto &channel : mChannels)
+        {
+            auto *current = channel.load(std::memory_order_acquire);
+            if (current != nullptr)
+            {
+                current->Unsubscribe(aSubscription);
+            }
+        }
+    }
+
+    std::size_t EventBus::Dispatch()
+    {
+        // Everything is drained before the first handler runs, so what handlers publish waits
+        const auto producers = GetProducerCount();
+        std::array<ChannelBase *, kMaxEventTypes> pending;
+        std::size_t pendingCount = 0;
+        std::size_t events = 0;
+        for (auto &channel : mChannels)
+        {
+            auto *current = channel.load(std::memory_order_acquire);
+            if (current == nullptr)
+            {
+                continue;
+            }
+            const auto count = current->Drain(producers);
+            if (count > 0)
+            {
+                pending[pendingCount++] = current;
+                events += count;
+            }
+        }
+
+        for (std::size_t i = 0; i < pendingCount; ++i)
+        {
+            pending[i]->Deliver();
+        }
+        return events;
+    }
+
+    std::size_t EventBus::GetDroppedCount() const
+    {
+        std::size_t dropped = 0;
+        for (const auto &channel : mChannels)
+        {
+            const auto *current = channel.load(std::memory_order_acquire);
+            if (current != nullptr)
+            {
+                dropped += current->dropped.load(std::memory_order_relaxed);
+            }
+        }
+        return dropped;
+    }
+
+    std::size_t EventBus::NextEventType()
+    {
+        const auto type = sEventTypeCount.fetch_add(1, std::memory_order_relaxed);
+        if (type >= kMaxEventTypes)
+        {
+            throw std::runtime_error("EventBus: More than " + std::to_string(kMaxEventTypes) + " event types");
+        }
+        return type;
+    }
+
+    std::size_t EventBus::GetProducer()
+    {
+        thread_local ProducerSlot slot;
+        return slot.index;
+    }
+
+    std::size_t EventBus::GetProducerCount()
+    {
+        return std::min(sProducerCount.load(std::memory_order_acquire), kMaxProducers);
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
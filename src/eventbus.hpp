@@ -0,0 +1,262 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_EVENTBUS_HPP
+#define NABLA2D_EVENTBUS_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+#include "spscqueue.hpp"
+
+namespace nabla2d
+{
+    // Typed events published from any thread and delivered in batches by Dispatch, on the game
+    // thread. Every publishing thread gets its own lock-free queue per event type, so producers
+    // never wait on each other. Dispatch first moves the events of each type into one
+    // contiguous array, then hands each array to the handlers of its type. Events from one
+    // thread keep their order, threads come in the order they first published.
+    // Events published by handlers are delivered by the next Dispatch.
+    class EventBus
+    {
+    public:
+        typedef uint32_t Subscription;
+
+        static constexpr Subscription kInvalidSubscription = 0;
+        // Threads publishing at once, and event types, across every bus
+        static constexpr std::size_t kMaxProducers = 64;
+        static constexpr std::size_t kMaxEventTypes = 128;
+        // Events each thread can queue between two dispatches, per type
+        static constexpr std::size_t kDefaultCapacity = 4096;
+
+        template <typename T>
+        using Handler = std::function<void(const std::vector<T> &)>;
+
+        EventBus() = default;
+        EventBus(const EventBus &aEventBus) = delete;
+        EventBus &operator=(const EventBus &aEventBus) = delete;
+        ~EventBus();
+
+        // Applies to the threads that didn't publish a T yet
+        template <typename T>
+        void SetCapacity(std::size_t aCapacity)
+        {
+            GetChannel<T>().capacity.store(aCapacity, std::memory_order_relaxed);
+        }
+
+        // Any thread. Returns false and drops the event when this thread's queue is full.
+        template <typename T>
+        bool Publish(const T &aEvent)
+        {
+            auto &channel = GetChannel<T>();
+            auto *queue = channel.GetQueue(GetProducer());
+            if (queue == nullptr || !queue->TryPush(aEvent))
+            {
+                channel.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        // Game thread, handlers are called in the order they subscribed. Handlers can subscribe
+        // and unsubscribe, the change applies once the handlers of the current type ran.
+        template <typename T>
+        Subscription Subscribe(Handler<T> aHandler)
+        {
+            if (++mNextSubscription == kInvalidSubscription)
+            {
+                ++mNextSubscription;
+            }
+            auto &channel = GetChannel<T>();
+            (channel.delivering ? channel.added : channel.handlers).push_back({mNextSubscription, std::move(aHandler), true});
+            return mNextSubscription;
+        }
+
+        void Unsubscribe(Subscription aSubscription);
+
+        // Game thread. Returns the number of events delivered.
+        std::size_t Dispatch();
+
+        // Events lost to full queues since the bus was created
+        std::size_t GetDroppedCount() const;
+
+    private:
+        class ChannelBase
+        {
+        public:
+            virtual ~ChannelBase() = default;
+            // Moves the queued events to the batch, returns their number
+            virtual std::size_t Drain(std::size_t aProducers) = 0;
+            virtual void Deliver() = 0;
+            virtual void Unsubscribe(Subscription aSubscription) = 0;
+
+            std::atomic<std::size_t> capacity{kDefaultCapacity};
+            std::atomic<std::size_t> dropped{0};
+        };
+
+        template <typename T>
+        class Channel final : public ChannelBase
+        {
+        public:
+            ~Channel() override
+            {
+                for (auto &queue : queues)
+                {
+                    delete queue.load(std::memory_order_relaxed);
+                }
+            }
+
+            // Each thread creates its own queue the first time it publishes a T
+            SPSCQueue<T> *GetQueue(std::size_t aProducer)
+            {
+                if (aProducer >= kMaxProducers)
+                {
+                    return nullptr;
+                }
+                auto *queue = queues[aProducer].load(std::memory_order_relaxed);
+                if (queue == nullptr)
+                {
+                    queue = new SPSCQueue<T>(capacity.load(std::memory_order_relaxed));
+                    queues[aProducer].store(queue, std::memory_order_release);
+                }
+                return queue;
+            }
+
+            std::size_t Drain(std::size_t aProducers) override
+            {
+                events.clear();
+                for (std::size_t producer = 0; producer < aProducers; ++producer)
+                {
+                    auto *queue = queues[producer].load(std::memory_order_acquire);
+                    if (queue != nullptr)
+                    {
+                        queue->PopAll(events);
+                    }
+                }
+                return events.size();
+            }
+
+            void Deliver() override
+            {
+                delivering = true;
+                for (const auto &handler : handlers)
+                {
+                    if (handler.active)
+                    {
+                        handler.function(events);
+                    }
+                }
+                delivering = false;
+
+                // Changes made by the handlers
+                handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [](const Entry &aEntry)
+                                              { return !aEntry.active; }),
+                               handlers.end());
+                std::move(added.begin(), added.end(), std::back_inserter(handlers));
+                added.clear();
+            }
+
+            void Unsubscribe(Subscription aSubscription) override
+            {
+                for (auto *list : {&handlers, &added})
+                {
+                    for (auto handler = list->begin(); handler != list->end(); ++handler)
+                    {
+                        if (handler->subscription != aSubscription)
+                        {
+                            continue;
+                        }
+                        // The handler may be running, it's only removed after the loop
+                        if (delivering && list == &handlers)
+                        {
+                            handler->active = false;
+                        }
+                        else
+                        {
+                            list->erase(handler);
+                        }
+                        return;
+                    }
+                }
+            }
+
+            std::array<std::atomic<SPSCQueue<T> *>, kMaxProducers> queues{};
+            std::vector<T> events;
+            struct Entry
+            {
+                Subscription subscription;
+                Handler<T> function;
+                bool active;
+            };
+
+            std::vector<Entry> handlers;
+            std::vector<Entry> added;
+            bool delivering{false};
+        };
+
+        std::array<std::atomic<ChannelBase *>, kMaxEventTypes> mChannels{};
+        std::mutex mChannelMutex;
+        Subscription mNextSubscription{kInvalidSubscription};
+
+        // Sequential index of an event type, shared by every bus
+        static std::size_t NextEventType();
+        template <typename T>
+        static std::size_t GetEventType()
+        {
+            static const std::size_t type = NextEventType();
+            return type;
+        }
+
+        // Index of the calling thread's queues, handed back when the thread exits.
+        // kMaxProducers once every index is taken.
+        static std::size_t GetProducer();
+        static std::size_t GetProducerCount();
+
+        // Only the first use of a type takes the lock
+        template <typename T>
+        Channel<T> &GetChannel()
+        {
+            const auto type = GetEventType<T>();
+            auto *channel = mChannels[type].load(std::memory_order_acquire);
+            if (channel == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(mChannelMutex);
+                channel = mChannels[type].load(std::memory_order_relaxed);
+                if (channel == nullptr)
+                {
+                    channel = new Channel<T>();
+                    mChannels[type].store(channel, std::memory_order_release);
+                }
+            }
+            return static_cast<Channel<T> &>(*channel);
+        }
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_EVENTBUS_HPP
+
+// くコ:彡
\ No newline at end of file
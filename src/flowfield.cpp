@@ -0,0 +1,406 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "flowfield.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr float kDiagonal = 0.70710678F;
+    } // namespace
+
+    void FlowField::SetGoals(const std::vector<glm::ivec2> &aGoals)
+    {
+        mGoals = aGoals;
+        mGoalsChanged = true;
+    }
+
+    const std::vector<glm::ivec2> &FlowField::GetGoals() const
+    {
+        return mGoals;
+    }
+
+    void FlowField::Integrate(const NavGrid &aGrid)
+    {
+        mWidth = aGrid.GetWidth();
+        mHeight = aGrid.GetHeight();
+        mLayoutVersion = aGrid.GetLayoutVersion();
+        mGoalsChanged = false;
+
+        const auto cellCount = aGrid.GetCellCount();
+        mIntegration.assign(cellCount, kUnreachable);
+        mParents.assign(cellCount, kNoDirection);
+        mDirections.assign(cellCount, kNoDirection);
+        mInvalidMask.assign(cellCount, 0);
+
+        mHeap.clear();
+        for (const auto &goal : mGoals)
+        {
+            if (aGrid.IsBlocked(goal.x, goal.y))
+            {
+                continue;
+            }
+            const auto index = aGrid.GetIndex(goal.x, goal.y);
+            if (mIntegration[index] != 0)
+            {
+                mIntegration[index] = 0;
+                Push(0, index);
+            }
+        }
+        Propagate(aGrid);
+
+        mDirtyMin = {0, 0};
+        mDirtyMax = {mWidth - 1, mHeight - 1};
+    }
+
+    void FlowField::Repair(const NavGrid &aGrid, const std::vector<uint32_t> &aChangedCells)
+    {
+        if (IsStale(aGrid))
+        {
+            Integrate(aGrid);
+            return;
+        }
+        if (aChangedCells.empty())
+        {
+            return;
+        }
+
+        // A changed cell moves the cost of every path entering it, and blocking or freeing
+        // it adds or removes the diagonal steps around its corners
+        mInvalid.clear();
+        for (const auto index : aChangedCells)
+        {
+            const auto cell = aGrid.GetCell(index);
+            MarkDirty(cell);
+            Invalidate(aGrid, index);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                const auto x = cell.x + NavGrid::kOffsetX[direction];
+                const auto y = cell.y + NavGrid::kOffsetY[direction];
+                if (!aGrid.IsInside(x, y))
+                {
+                    continue;
+                }
+                const auto neighbour = aGrid.GetIndex(x, y);
+                const auto parent = mParents[neighbour];
+                if (parent == kNoDirection || (parent & 1U) == 0)
+                {
+                    continue;
+                }
+                const bool cutsCorner = (x + NavGrid::kOffsetX[parent] == cell.x && y == cell.y) || (x == cell.x && y + NavGrid::kOffsetY[parent] == cell.y);
+                if (cutsCorner)
+                {
+                    Invalidate(aGrid, neighbour);
+                }
+            }
+        }
+
+        // Restart from everything bordering the invalidated cells, and from the neighbours of
+        // the changed ones in case they got cheaper
+        mHeap.clear();
+        for (const auto &goal : mGoals)
+        {
+            if (aGrid.IsBlocked(goal.x, goal.y))
+            {
+                continue;
+            }
+            const auto index = aGrid.GetIndex(goal.x, goal.y);
+            if (mInvalidMask[index] != 0)
+            {
+                mIntegration[index] = 0;
+                Push(0, index);
+            }
+        }
+        const auto pushNeighbours = [this, &aGrid](uint32_t aIndex)
+        {
+            const auto cell = aGrid.GetCell(aIndex);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                const auto x = cell.x + NavGrid::kOffsetX[direction];
+                const auto y = cell.y + NavGrid::kOffsetY[direction];
+                if (!aGrid.IsInside(x, y))
+                {
+                    continue;
+                }
+                const auto neighbour = aGrid.GetIndex(x, y);
+                if (mInvalidMask[neighbour] == 0 && mIntegration[neighbour] != kUnreachable)
+                {
+                    Push(mIntegration[neighbour], neighbour);
+                }
+            }
+        };
+        for (const auto index : mInvalid)
+        {
+            MarkDirty(aGrid.GetCell(index));
+            pushNeighbours(index);
+        }
+        for (const auto index : aChangedCells)
+        {
+            pushNeighbours(index);
+        }
+        for (const auto index : mInvalid)
+        {
+            mInvalidMask[index] = 0;
+        }
+
+        Propagate(aGrid);
+    }
+
+    void FlowField::BuildDirections(const NavGrid &aGrid, int aBegin, int aEnd)
+    {
+        const auto begin = std::max(aBegin, mDirtyMin.y);
+        const auto end = std::min(aEnd, mDirtyMax.y + 1);
+        for (int y = begin; y < end; ++y)
+        {
+            for (int x = mDirtyMin.x; x <= mDirtyMax.x; ++x)
+            {
+                const auto index = aGrid.GetIndex(x, y);
+                auto best = mIntegration[index];
+                auto direction = kNoDirection;
+                if (best != kUnreachable && best != 0 && !aGrid.IsBlocked(x, y))
+                {
+                    const auto steps = aGrid.GetSteps(x, y);
+                    for (uint8_t candidate = 0; candidate < 8; ++candidate)
+                    {
+                        if ((steps & (1U << candidate)) == 0)
+                        {
+                            continue;
+                        }
+                        const auto integration = mIntegration[aGrid.GetIndex(x + NavGrid::kOffsetX[candidate], y + NavGrid::kOffsetY[candidate])];
+                        if (integration < best)
+                        {
+                            best = integration;
+                            direction = candidate;
+                        }
+                    }
+                }
+                mDirections[index] = direction;
+            }
+        }
+    }
+
+    void FlowField::ClearDirtyRegion()
+    {
+        mDirtyMin = {0, 0};
+        mDirtyMax = {-1, -1};
+    }
+
+    bool FlowField::IsDirty() const
+    {
+        return mDirtyMax.x >= mDirtyMin.x && mDirtyMax.y >= mDirtyMin.y;
+    }
+
+    const glm::ivec2 &FlowField::GetDirtyMin() const
+    {
+        return mDirtyMin;
+    }
+
+    const glm::ivec2 &FlowField::GetDirtyMax() const
+    {
+        return mDirtyMax;
+    }
+
+    bool FlowField::IsStale(const NavGrid &aGrid) const
+    {
+        return mGoalsChanged || mLayoutVersion != aGrid.GetLayoutVersion();
+    }
+
+    uint32_t FlowField::GetIntegration(int aX, int aY) const
+    {
+        if (aX < 0 || aY < 0 || aX >= mWidth || aY >= mHeight)
+        {
+            return kUnreachable;
+        }
+        return mIntegration[static_cast<std::size_t>(aY) * static_cast<std::size_t>(mWidth) + static_cast<std::size_t>(aX)];
+    }
+
+    uint8_t FlowField::GetDirection(int aX, int aY) const
+    {
+        if (aX < 0 || aY < 0 || aX >= mWidth || aY >= mHeight)
+        {
+            return kNoDirection;
+        }
+        return mDirections[static_cast<std::size_t>(aY) * static_cast<std::size_t>(mWidth) + static_cast<std::size_t>(aX)];
+    }
+
+    glm::vec2 FlowField::Sample(const NavGrid &aGrid, const glm::vec2 &aPosition) const
+    {
+        const auto local = (aPosition - aGrid.GetOrigin()) / aGrid.GetCellSize();
+        const auto cellX = static_cast<int>(std::floor(local.x));
+        const auto cellY = static_cast<int>(std::floor(local.y));
+        const auto integration = GetIntegration(cellX, cellY);
+        if (integration == 0 || integration == kUnreachable)
+        {
+            return {0.0F, 0.0F};
+        }
+
+        // Bilinear between the centers of the four closest cells, skipping the ones without
+        // a direction
+        const auto offset = local - 0.5F;
+        const auto baseX = static_cast<int>(std::floor(offset.x));
+        const auto baseY = static_cast<int>(std::floor(offset.y));
+        const auto tx = offset.x - static_cast<float>(baseX);
+        const auto ty = offset.y - static_cast<float>(baseY);
+        glm::vec2 direction(0.0F, 0.0F);
+        for (int dy = 0; dy < 2; ++dy)
+        {
+            for (int dx = 0; dx < 2; ++dx)
+            {
+                const auto cellDirection = GetDirection(baseX + dx, baseY + dy);
+                if (cellDirection != kNoDirection)
+                {
+                    const auto weight = (dx == 0 ? 1.0F - tx : tx) * (dy == 0 ? 1.0F - ty : ty);
+                    direction += weight * GetVector(cellDirection);
+                }
+            }
+        }
+
+        // Opposite directions on both sides of a wall can cancel out, the cell's own wins then
+        const auto length = glm::length(direction);
+        if (length > 1e-4F)
+        {
+            return direction / length;
+        }
+        return GetVector(GetDirection(cellX, cellY));
+    }
+
+    glm::ivec2 FlowField::GetOffset(uint8_t aDirection)
+    {
+        if (aDirection >= kNoDirection)
+        {
+            return {0, 0};
+        }
+        return {NavGrid::kOffsetX[aDirection], NavGrid::kOffsetY[aDirection]};
+    }
+
+    glm::vec2 FlowField::GetVector(uint8_t aDirection)
+    {
+        if (aDirection >= kNoDirection)
+        {
+            return {0.0F, 0.0F};
+        }
+        const auto scale = (aDirection & 1U) != 0 ? kDiagonal : 1.0F;
+        return {static_cast<float>(NavGrid::kOffsetX[aDirection]) * scale, static_cast<float>(NavGrid::kOffsetY[aDirection]) * scale};
+    }
+
+    void FlowField::Push(uint32_t aCost, uint32_t aIndex)
+    {
+        mHeap.push_back((static_cast<uint64_t>(aCost) << 32U) | aIndex);
+        std::push_heap(mHeap.begin(), mHeap.end(), std::greater<uint64_t>());
+    }
+
+    void FlowField::Propagate(const NavGrid &aGrid)
+    {
+        const auto &costs = aGrid.GetCosts();
+        while (!mHeap.empty())
+        {
+            std::pop_heap(mHeap.begin(), mHeap.end(), std::greater<uint64_t>());
+            const auto item = mHeap.back();
+            mHeap.pop_back();
+
+            const auto cost = static_cast<uint32_t>(item >> 32U);
+            const auto index = static_cast<uint32_t>(item);
+            if (cost != mIntegration[index])
+            {
+                continue;
+            }
+
+            // Stepping from a neighbour into this cell costs this cell's cost
+            const auto cell = aGrid.GetCell(index);
+            const auto cellCost = static_cast<uint32_t>(costs[index]);
+            const auto steps = aGrid.GetSteps(cell.x, cell.y);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                if ((steps & (1U << direction)) == 0)
+                {
+                    continue;
+                }
+                const glm::ivec2 neighbour(cell.x + NavGrid::kOffsetX[direction], cell.y + NavGrid::kOffsetY[direction]);
+                const auto neighbourIndex = aGrid.GetIndex(neighbour.x, neighbour.y);
+                const auto integration = cost + cellCost * ((direction & 1U) != 0 ? kDiagonalCost : kStraightCost);
+                if (integration < mIntegration[neighbourIndex])
+                {
+                    mIntegration[neighbourIndex] = integration;
+                    mParents[neighbourIndex] = static_cast<uint8_t>((direction + 4U) & 7U);
+                    MarkDirty(neighbour);
+                    Push(integration, neighbourIndex);
+                }
+            }
+        }
+    }
+
+    void FlowField::Invalidate(const NavGrid &aGrid, uint32_t aIndex)
+    {
+        if (mInvalidMask[aIndex] != 0)
+        {
+            return;
+        }
+
+        // Every cell whose path goes through aIndex, walking the parent links backwards
+        auto next = mInvalid.size();
+        mInvalidMask[aIndex] = 1;
+        mInvalid.push_back(aIndex);
+        while (next < mInvalid.size())
+        {
+            const auto index = mInvalid[next++];
+            const auto cell = aGrid.GetCell(index);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                const auto x = cell.x + NavGrid::kOffsetX[direction];
+                const auto y = cell.y + NavGrid::kOffsetY[direction];
+                if (!aGrid.IsInside(x, y))
+                {
+                    continue;
+                }
+                const auto child = aGrid.GetIndex(x, y);
+                if (mInvalidMask[child] == 0 && mParents[child] == ((direction + 4U) & 7U))
+                {
+                    mInvalidMask[child] = 1;
+                    mInvalid.push_back(child);
+                }
+            }
+            mIntegration[index] = kUnreachable;
+            mParents[index] = kNoDirection;
+        }
+    }
+
+    void FlowField::MarkDirty(const glm::ivec2 &aCell)
+    {
+        // Directions also depend on the neighbours
+        const glm::ivec2 low(std::max(aCell.x - 1, 0), std::max(aCell.y - 1, 0));
+        const glm::ivec2 high(std::min(aCell.x + 1, mWidth - 1), std::min(aCell.y + 1, mHeight - 1));
+        if (!IsDirty())
+        {
+            mDirtyMin = low;
+            mDirtyMax = high;
+            return;
+        }
+        mDirtyMin = glm::min(mDirtyMin, low);
+        mDirtyMax = glm::max(mDirtyMax, high);
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
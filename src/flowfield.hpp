@@ -0,0 +1,102 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_FLOWFIELD_HPP
+#define NABLA2D_FLOWFIELD_HPP
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "navgrid.hpp"
+
+namespace nabla2d
+{
+    // Shortest paths from every cell of a NavGrid to the closest of a set of goal cells.
+    // The integration field is the cost to reach a goal, 10 per straight step and 14 per
+    // diagonal one times the cost of the cell entered, as integers so a repaired field is
+    // exactly the one a full integration would give. Diagonal steps can't cut blocked corners.
+    // The direction field points every cell at its cheapest neighbour.
+    class FlowField
+    {
+    public:
+        static constexpr uint32_t kUnreachable = 0xFFFFFFFFU;
+        static constexpr uint8_t kNoDirection = 8;
+
+        FlowField() = default;
+        ~FlowField() = default;
+
+        // Goals outside the grid or on blocked cells are ignored
+        void SetGoals(const std::vector<glm::ivec2> &aGoals);
+        const std::vector<glm::ivec2> &GetGoals() const;
+
+        // Dijkstra from the goals over the whole grid
+        void Integrate(const NavGrid &aGrid);
+        // Only recomputes the cells whose path went through one of aChangedCells (NavGrid
+        // indices), and the ones a cheaper cell now gives a shorter path
+        void Repair(const NavGrid &aGrid, const std::vector<uint32_t> &aChangedCells);
+        // Rows [aBegin, aEnd) of the region changed by the last Integrate or Repair, rows
+        // are independent so they can be split over the job system
+        void BuildDirections(const NavGrid &aGrid, int aBegin, int aEnd);
+        void ClearDirtyRegion();
+        bool IsDirty() const;
+        const glm::ivec2 &GetDirtyMin() const;
+        const glm::ivec2 &GetDirtyMax() const;
+        bool IsStale(const NavGrid &aGrid) const;
+
+        uint32_t GetIntegration(int aX, int aY) const;
+        uint8_t GetDirection(int aX, int aY) const;
+        // Unit vector towards the goals at aPosition, blended between the four closest cells.
+        // Zero on a goal cell or where no goal can be reached.
+        glm::vec2 Sample(const NavGrid &aGrid, const glm::vec2 &aPosition) const;
+
+        static glm::ivec2 GetOffset(uint8_t aDirection);
+        static glm::vec2 GetVector(uint8_t aDirection);
+
+    private:
+        static constexpr uint32_t kStraightCost = 10;
+        static constexpr uint32_t kDiagonalCost = 14;
+
+        std::vector<glm::ivec2> mGoals;
+        std::vector<uint32_t> mIntegration;
+        // Direction of the neighbour each cell was reached from, to find what depends on a cell
+        std::vector<uint8_t> mParents;
+        std::vector<uint8_t> mDirections;
+        std::vector<uint64_t> mHeap;
+        std::vector<uint32_t> mInvalid;
+        std::vector<uint8_t> mInvalidMask;
+        int mWidth{0};
+        int mHeight{0};
+        uint32_t mLayoutVersion{0xFFFFFFFFU};
+        bool mGoalsChanged{true};
+        glm::ivec2 mDirtyMin{0, 0};
+        glm::ivec2 mDirtyMax{-1, -1};
+
+        void Push(uint32_t aCost, uint32_t aIndex);
+        void Propagate(const NavGrid &aGrid);
+        void Invalidate(const NavGrid &aGrid, uint32_t aIndex);
+        void MarkDirty(const glm::ivec2 &aCell);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_FLOWFIELD_HPP
+
+// くコ:彡
\ No newline at end of file
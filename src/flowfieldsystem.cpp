@@ -0,0 +1,181 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "flowfieldsystem.hpp"
+
+#include <algorithm>
+
+#include "components.hpp"
+#include "transform2d.hpp"
+
+namespace nabla2d
+{
+    FlowFieldSystem::FlowFieldSystem(JobSystem &aJobSystem, const NavGrid &aGrid) : mJobSystem(aJobSystem), mGrid(aGrid)
+    {
+    }
+
+    FlowFieldSystem::FieldID FlowFieldSystem::AddField(const std::vector<glm::ivec2> &aGoals)
+    {
+        mFields.emplace_back();
+        mFields.back().SetGoals(aGoals);
+        return static_cast<FieldID>(mFields.size() - 1);
+    }
+
+    void FlowFieldSystem::SetGoals(FieldID aField, const std::vector<glm::ivec2> &aGoals)
+    {
+        if (aField < mFields.size())
+        {
+            mFields[aField].SetGoals(aGoals);
+        }
+    }
+
+    const FlowField &FlowFieldSystem::GetField(FieldID aField) const
+    {
+        return mFields[aField];
+    }
+
+    std::size_t FlowFieldSystem::GetFieldCount() const
+    {
+        return mFields.size();
+    }
+
+    void FlowFieldSystem::Clear()
+    {
+        mFields.clear();
+    }
+
+    void FlowFieldSystem::Update(const std::vector<uint32_t> &aChangedCells)
+    {
+        if (mFields.empty())
+        {
+            return;
+        }
+
+        // Dijkstra is sequential, fields are the unit of work
+        mJobSystem.ParallelFor(mFields.size(), 1, [this, &aChangedCells](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   for (auto field = aBegin; field < aEnd; ++field)
+                                   {
+                                       if (mFields[field].IsStale(mGrid))
+                                       {
+                                           mFields[field].Integrate(mGrid);
+                                       }
+                                       else
+                                       {
+                                           mFields[field].Repair(mGrid, aChangedCells);
+                                       }
+                                   } });
+
+        // Directions only read the integration field, any row range of any field can go
+        mDirectionTasks.clear();
+        for (std::size_t field = 0; field < mFields.size(); ++field)
+        {
+            const auto &flowField = mFields[field];
+            if (!flowField.IsDirty())
+            {
+                continue;
+            }
+            for (int row = flowField.GetDirtyMin().y; row <= flowField.GetDirtyMax().y; row += kDirectionRows)
+            {
+                mDirectionTasks.push_back({static_cast<uint32_t>(field), row, std::min(row + kDirectionRows, flowField.GetDirtyMax().y + 1)});
+            }
+        }
+        mJobSystem.ParallelFor(mDirectionTasks.size(), 1, [this](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   for (auto i = aBegin; i < aEnd; ++i)
+                                   {
+                                       const auto &task = mDirectionTasks[i];
+                                       mFields[task.field].BuildDirections(mGrid, task.begin, task.end);
+                                   } });
+
+        for (auto &field : mFields)
+        {
+            field.ClearDirtyRegion();
+        }
+    }
+
+    glm::vec2 FlowFieldSystem::Sample(FieldID aField, const glm::vec2 &aPosition) const
+    {
+        if (aField >= mFields.size())
+        {
+            return {0.0F, 0.0F};
+        }
+        return mFields[aField].Sample(mGrid, aPosition);
+    }
+
+    void FlowFieldSystem::Steer(Scene &aScene, float aDeltaTime)
+    {
+        auto &registry = aScene.GetRegistry();
+        mAgents.clear();
+        mPositions.clear();
+        mVelocities.clear();
+        mAgentFields.clear();
+        mSpeeds.clear();
+        mSteering.clear();
+        registry.view<FlowAgent, Transform2D>().each([this, &aScene](auto aEntity, const FlowAgent &aAgent, const Transform2D &aTransform)
+                                                     {
+                                                         if (aAgent.field >= mFields.size() || aScene.GetParent(aEntity) != entt::null)
+                                                         {
+                                                             return;
+                                                         }
+                                                         mAgents.push_back(aEntity);
+                                                         mPositions.push_back(aTransform.GetPosition());
+                                                         mVelocities.push_back(aAgent.velocity);
+                                                         mAgentFields.push_back(aAgent.field);
+                                                         mSpeeds.push_back(aAgent.speed);
+                                                         mSteering.push_back(aAgent.steering); });
+
+        mJobSystem.ParallelFor(mAgents.size(), kAgentGrainSize, [this, aDeltaTime](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   for (auto i = aBegin; i < aEnd; ++i)
+                                   {
+                                       const auto desired = mFields[mAgentFields[i]].Sample(mGrid, mPositions[i]) * mSpeeds[i];
+                                       const auto blend = std::min(mSteering[i] * aDeltaTime, 1.0F);
+                                       mVelocities[i] += (desired - mVelocities[i]) * blend;
+                                   } });
+
+        for (std::size_t i = 0; i < mAgents.size(); ++i)
+        {
+            const auto &velocity = mVelocities[i];
+            registry.get<FlowAgent>(mAgents[i]).velocity = velocity;
+
+            auto *body = registry.try_get<RigidBody>(mAgents[i]);
+            if (body != nullptr && body->mass > 0.0F)
+            {
+                body->velocity = velocity;
+                if (velocity.x != 0.0F || velocity.y != 0.0F)
+                {
+                    body->awake = true;
+                    body->sleepTime = 0.0F;
+                }
+                continue;
+            }
+            registry.get<Transform2D>(mAgents[i]).Translate(velocity * aDeltaTime);
+        }
+    }
+
+    std::size_t FlowFieldSystem::GetAgentCount() const
+    {
+        return mAgents.size();
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
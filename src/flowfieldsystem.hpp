@@ -0,0 +1,95 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_FLOWFIELDSYSTEM_HPP
+#define NABLA2D_FLOWFIELDSYSTEM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "navgrid.hpp"
+#include "flowfield.hpp"
+#include "jobsystem.hpp"
+
+namespace nabla2d
+{
+    // Flow fields over a NavGrid, one per goal set, shared by every FlowAgent heading there.
+    // Fields are integrated one per job and their direction rows split over the job system.
+    // Cells changed on the grid only repair the parts of the fields depending on them.
+    class FlowFieldSystem
+    {
+    public:
+        typedef uint32_t FieldID;
+        static constexpr FieldID kInvalidField = 0xFFFFFFFFU;
+
+        FlowFieldSystem(JobSystem &aJobSystem, const NavGrid &aGrid);
+        FlowFieldSystem(const FlowFieldSystem &aFlowFieldSystem) = delete;
+        FlowFieldSystem &operator=(const FlowFieldSystem &aFlowFieldSystem) = delete;
+        ~FlowFieldSystem() = default;
+
+        // Goals are grid cells, the field is built by the next Update
+        FieldID AddField(const std::vector<glm::ivec2> &aGoals);
+        void SetGoals(FieldID aField, const std::vector<glm::ivec2> &aGoals);
+        const FlowField &GetField(FieldID aField) const;
+        std::size_t GetFieldCount() const;
+        void Clear();
+
+        // aChangedCells are the grid cells changed since the last Update (see
+        // NavGrid::TakeChanges). Fields whose goals or grid layout changed are rebuilt.
+        void Update(const std::vector<uint32_t> &aChangedCells);
+        glm::vec2 Sample(FieldID aField, const glm::vec2 &aPosition) const;
+
+        // Turns the velocity of every root FlowAgent towards its field. Agents with a RigidBody
+        // get the velocity for PhysicsSystem to move them, the others are moved here.
+        void Steer(Scene &aScene, float aDeltaTime);
+        std::size_t GetAgentCount() const;
+
+    private:
+        static constexpr std::size_t kAgentGrainSize = 1024;
+        static constexpr int kDirectionRows = 32;
+
+        struct DirectionTask
+        {
+            uint32_t field;
+            int begin;
+            int end;
+        };
+
+        JobSystem &mJobSystem;
+        const NavGrid &mGrid;
+        std::vector<FlowField> mFields;
+        std::vector<DirectionTask> mDirectionTasks;
+
+        std::vector<entt::entity> mAgents;
+        std::vector<glm::vec2> mPositions;
+        std::vector<glm::vec2> mVelocities;
+        std::vector<FieldID> mAgentFields;
+        std::vector<float> mSpeeds;
+        std::vector<float> mSteering;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_FLOWFIELDSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,172 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "frameprofiler.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+namespace nabla2d
+{
+    FrameProfiler::Scope::Scope(FrameProfiler &aProfiler, Phase aPhase) : mProfiler(aProfiler),
+                                                                          mPhase(aPhase)
+    {
+        if (mProfiler.mStarted)
+        {
+            mStart = Clock::now();
+        }
+    }
+
+    FrameProfiler::Scope::~Scope()
+    {
+        if (mProfiler.mStarted)
+        {
+            mProfiler.mCurrentPhases[mPhase] += std::chrono::duration<double, std::milli>(Clock::now() - mStart).count();
+        }
+    }
+
+    void FrameProfiler::Start(std::size_t aExpectedFrames)
+    {
+        mFrameTimes.clear();
+        mFrameTimes.reserve(aExpectedFrames);
+        for (auto &phase : mPhaseTimes)
+        {
+            phase.clear();
+            phase.reserve(aExpectedFrames);
+        }
+        mRendererStats.clear();
+        mRendererStats.reserve(aExpectedFrames);
+        mStarted = true;
+    }
+
+    void FrameProfiler::Stop()
+    {
+        mStarted = false;
+    }
+
+    bool FrameProfiler::IsStarted() const
+    {
+        return mStarted;
+    }
+
+    std::size_t FrameProfiler::GetFrameCount() const
+    {
+        return mFrameTimes.size();
+    }
+
+    void FrameProfiler::BeginFrame()
+    {
+        if (!mStarted)
+        {
+            return;
+        }
+
+        mCurrentPhases.fill(0.0);
+        mFrameStart = Clock::now();
+    }
+
+    void FrameProfiler::EndFrame(const Renderer::FrameStats &aRendererStats)
+    {
+        if (!mStarted)
+        {
+            return;
+        }
+
+        mFrameTimes.push_back(std::chrono::duration<double, std::milli>(Clock::now() - mFrameStart).count());
+        for (std::size_t i = 0; i < PHASE_COUNT; ++i)
+        {
+            mPhaseTimes[i].push_back(mCurrentPhases[i]);
+        }
+        mRendererStats.push_back(aRendererStats);
+    }
+
+    nlohmann::json FrameProfiler::GetReport() const
+    {
+        nlohmann::json report;
+        report["frames"] = mFrameTimes.size();
+        report["frameTime"] = Summarize(mFrameTimes);
+
+        for (std::size_t i = 0; i < PHASE_COUNT; ++i)
+        {
+            report["phases"][GetPhaseName(static_cast<Phase>(i))] = Summarize(mPhaseTimes[i]);
+        }
+
+        const std::array<std::pair<const char *, uint64_t Renderer::FrameStats::*>, 5> counters = {{
+            {"drawCalls", &Renderer::FrameStats::drawCalls},
+            {"elements", &Renderer::FrameStats::elements},
+            {"shaderBinds", &Renderer::FrameStats::shaderBinds},
+            {"textureBinds", &Renderer::FrameStats::textureBinds},
+            {"dataUploads", &Renderer::FrameStats::dataUploads},
+        }};
+        for (const auto &counter : counters)
+        {
+            std::vector<double> samples(mRendererStats.size());
+            std::transform(mRendererStats.begin(), mRendererStats.end(), samples.begin(), [&counter](const Renderer::FrameStats &aStats)
+                           { return static_cast<double>(aStats.*counter.second); });
+            report["renderer"][counter.first] = Summarize(std::move(samples));
+        }
+
+        return report;
+    }
+
+    const char *FrameProfiler::GetPhaseName(Phase aPhase)
+    {
+        switch (aPhase)
+        {
+        case PHASE_SIMULATION:
+            return "simulation";
+        case PHASE_CAMERA:
+            return "camera";
+        case PHASE_STREAMING:
+            return "streaming";
+        case PHASE_HIERARCHY:
+            return "hierarchy";
+        case PHASE_SPATIAL:
+            return "spatial";
+        case PHASE_RENDER:
+            return "render";
+        default:
+            return "unknown";
+        }
+    }
+
+    nlohmann::json FrameProfiler::Summarize(std::vector<double> aSamples)
+    {
+        if (aSamples.empty())
+        {
+            return {{"mean", 0.0}, {"p50", 0.0}, {"p95", 0.0}, {"p99", 0.0}, {"max", 0.0}};
+        }
+
+        std::sort(aSamples.begin(), aSamples.end());
+        // Nearest-rank percentile
+        const auto percentile = [&aSamples](double aPercent)
+        {
+            const auto rank = static_cast<std::size_t>(std::ceil(aPercent / 100.0 * static_cast<double>(aSamples.size())));
+            return aSamples[std::clamp<std::size_t>(rank, 1, aSamples.size()) - 1];
+        };
+
+        const double mean = std::accumulate(aSamples.begin(), aSamples.end(), 0.0) / static_cast<double>(aSamples.size());
+        return {{"mean", mean}, {"p50", percentile(50.0)}, {"p95", percentile(95.0)}, {"p99", percentile(99.0)}, {"max", aSamples.back()}};
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,96 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_FRAMEPROFILER_HPP
+#define NABLA2D_FRAMEPROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // Per-frame CPU timings (whole frame and phases) and renderer counters, summarised
+    // as percentiles. Scopes cost nothing while the profiler isn't started.
+    class FrameProfiler
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        typedef enum
+        {
+            PHASE_SIMULATION,
+            PHASE_CAMERA,
+            PHASE_STREAMING,
+            PHASE_HIERARCHY,
+            PHASE_SPATIAL,
+            PHASE_RENDER,
+            PHASE_COUNT
+        } Phase;
+
+        class Scope
+        {
+        public:
+            Scope(FrameProfiler &aProfiler, Phase aPhase);
+            ~Scope();
+
+        private:
+            FrameProfiler &mProfiler;
+            Phase mPhase;
+            Clock::time_point mStart;
+        };
+
+        FrameProfiler() = default;
+        ~FrameProfiler() = default;
+
+        void Start(std::size_t aExpectedFrames = 0);
+        void Stop();
+        bool IsStarted() const;
+        std::size_t GetFrameCount() const;
+
+        void BeginFrame();
+        void EndFrame(const Renderer::FrameStats &aRendererStats);
+
+        // Times are in milliseconds
+        nlohmann::json GetReport() const;
+
+        static const char *GetPhaseName(Phase aPhase);
+
+    private:
+        bool mStarted{false};
+        Clock::time_point mFrameStart;
+        std::array<double, PHASE_COUNT> mCurrentPhases{};
+
+        std::vector<double> mFrameTimes;
+        std::array<std::vector<double>, PHASE_COUNT> mPhaseTimes;
+        std::vector<Renderer::FrameStats> mRendererStats;
+
+        static nlohmann::json Summarize(std::vector<double> aSamples);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_FRAMEPROFILER_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -23,19 +23,42 @@
 #include <cmath>
 #include <chrono>
 #include <numeric>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <filesystem>
 #include <imgui.h>
 #include <fmt/format.h>
 #include <glm/glm.hpp>
 
 #include "logger.hpp"
 #include "input.hpp"
+#include "components.hpp"
+#include "sceneserializer.hpp"
+#include "hierarchysystem.hpp"
 
 namespace nabla2d
 {
-    Game::Game()
+    Game::Game(Renderer::Backend aBackend) : mWorldStreamer(mScene, mJobSystem),
+                                             mAnimationSystem(mJobSystem),
+                                             mCollisionSystem(mJobSystem),
+                                             mPhysicsSystem(mJobSystem),
+                                             mFlowFieldSystem(mJobSystem, mNavGrid),
+                                             mPathfindingSystem(mJobSystem, mNavGrid),
+                                             mScriptSystem(mScene),
+                                             mPluginHost(mScene, mCamera),
+                                             mHeadless(aBackend == Renderer::BACKEND_NULL)
     {
-        mCamera = Camera({0.0F, 0.0F, 5.0F}, {0.0F, 0.0F, 0.0F}, {45.0F, 16.0F / 9.0F, 0.1F, 100.0F});
-        mRenderer = std::shared_ptr<Renderer>(Renderer::Create("Nabla2D", {1600, 900}));
+        SceneSerializer::RegisterComponent<Transform>("Transform");
+        SceneSerializer::RegisterComponent<Transform2D>("Transform2D");
+        SceneSerializer::RegisterComponent<Bounds>("Bounds");
+        SceneSerializer::RegisterComponent<BoxCollider>("BoxCollider");
+        SceneSerializer::RegisterComponent<CircleCollider>("CircleCollider");
+        SceneSerializer::RegisterComponent<RigidBody>("RigidBody");
+        SceneSerializer::RegisterComponent<FlowAgent>("FlowAgent");
+
+        mCamera = Camera({0.0F, 0.0F, 5.0F}, {0.0F, 0.0F, 0.0F}, {45.0F, 16.0F / 9.0F, 0.1F, 100.0F, Camera::PROJECTION_PERSPECTIVE, {1600.0F, 900.0F}, 100.0F, false});
+        mRenderer = std::shared_ptr<Renderer>(Renderer::Create("Nabla2D", {1600, 900}, aBackend));
 
         mTestShader = mRenderer->LoadShader(R"(
         #version 330 core
@@ -65,9 +88,13 @@ namespace nabla2d
         mSprites.emplace_back(Sprite::FromPNG(mRenderer, "assets/logo.png"));
         mSprites.emplace_back(Sprite::FromJSON(mRenderer, "assets/ball.json"));
         mSprites[1]->SetAnimation("roll");
-        mTestTransform = Transform({0.5F, 0.5F, 0.0F}, {0.0F, 0.0F, 0.0F}, {1.0F, 1.0F, 1.0F});
 
         mEditor.Init(mRenderer);
+        mPluginHost.Init(mRenderer);
+        if (!mHeadless)
+        {
+            mAudioSystem.Init();
+        }
 
         mScene.CreateEntity("entity1");
         mScene.CreateEntity("entity2");
@@ -78,14 +105,55 @@ namespace nabla2d
         entity = mScene.CreateEntity("entity7", entity);
         mScene.CreateEntity("entity8", entity);
 
+        auto &registry = mScene.GetRegistry();
+        mBall = mScene.CreateEntity("ball");
+        registry.emplace<Transform>(mBall, glm::vec3{0.5F, 0.5F, 0.0F}, glm::vec3{0.0F, 0.0F, 0.0F}, glm::vec3{1.0F, 1.0F, 1.0F});
+        registry.emplace<PreviousTransform>(mBall, registry.get<Transform>(mBall));
+        registry.emplace<SpriteRenderer>(mBall, mSprites[1]->GetSpriteRenderer());
+        registry.emplace<Bounds>(mBall);
+        mAnimationSystem.Play(mBall, mAnimationSystem.AddClip(*mSprites[1], "roll"));
+
+        if (std::filesystem::exists("assets/world"))
+        {
+            mWorldStreamer.Open("assets/world");
+        }
+
+        if (std::filesystem::exists("assets/map.tmx"))
+        {
+            mTilemap.reset(Tilemap::FromTMX(mRenderer, "assets/map.tmx"));
+            mNavGrid.LoadTiledMap("assets/map.tmx");
+        }
+
+        if (std::filesystem::is_directory("assets/scripts"))
+        {
+            // Sorted so scripts run in the same order on every platform
+            std::vector<std::filesystem::path> scripts;
+            for (const auto &entry : std::filesystem::directory_iterator("assets/scripts"))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".lua")
+                {
+                    scripts.push_back(entry.path());
+                }
+            }
+            std::sort(scripts.begin(), scripts.end());
+            for (const auto &script : scripts)
+            {
+                mScriptSystem.Load(script.string());
+            }
+        }
+
         Logger::info("Game created");
     }
 
     Game::~Game()
     {
+        mPluginHost.Destroy();
         mSprites.clear();
+        mTilemap.reset();
+        mGPUTilemap.reset();
 
         mEditor.Destroy();
+        mAudioSystem.Destroy();
 
         Logger::info("Game destroyed");
     }
@@ -95,6 +163,109 @@ namespace nabla2d
         return mDeltaTime;
     }
 
+    float Game::GetInterpolation() const
+    {
+        return mInterpolation;
+    }
+
+    EventBus &Game::GetEventBus()
+    {
+        return mEventBus;
+    }
+
+    bool Game::RecordInput(const std::string &aPath)
+    {
+        mRenderer->SetInputEnabled(true);
+        return mInputRecorder.StartRecording(aPath);
+    }
+
+    bool Game::ReplayInput(const std::string &aPath)
+    {
+        if (!mInputRecorder.StartReplay(aPath))
+        {
+            return false;
+        }
+        mRenderer->SetInputEnabled(false);
+        return true;
+    }
+
+    bool Game::LoadPlugin(const std::string &aPath)
+    {
+        return mPluginHost.Load(aPath);
+    }
+
+    bool Game::UseGPUTilemap(bool aEnabled)
+    {
+        if (aEnabled == (mGPUTilemap != nullptr))
+        {
+            return true;
+        }
+
+        const auto *path = mTilemap != nullptr ? &mTilemap->GetPath() : (mGPUTilemap != nullptr ? &mGPUTilemap->GetPath() : nullptr);
+        if (path == nullptr)
+        {
+            Logger::error("Game::UseGPUTilemap: No tilemap is loaded");
+            return false;
+        }
+
+        if (aEnabled)
+        {
+            mGPUTilemap.reset(GPUTilemap::FromTMX(mRenderer, *path));
+            if (mGPUTilemap == nullptr)
+            {
+                return false;
+            }
+            mTilemap.reset();
+        }
+        else
+        {
+            mTilemap.reset(Tilemap::FromTMX(mRenderer, *path));
+            if (mTilemap == nullptr)
+            {
+                return false;
+            }
+            mGPUTilemap.reset();
+        }
+        return true;
+    }
+
+    void Game::FixedUpdate(float aDeltaTime)
+    {
+        HierarchySystem::SavePreviousTransforms(mScene);
+
+        mAnimationSystem.Update(aDeltaTime);
+
+        if (mBenchmark != BENCHMARK_NONE)
+        {
+            UpdateBenchmark(aDeltaTime);
+        }
+
+        mScriptSystem.Update(aDeltaTime);
+        mPluginHost.Update(aDeltaTime);
+
+        mNavGrid.TakeChanges(mNavChanges);
+        mPathfindingSystem.Update(mNavChanges);
+        // Agents set their velocities before the physics step moves them
+        if (mFlowFieldSystem.GetFieldCount() > 0)
+        {
+            mFlowFieldSystem.Update(mNavChanges);
+            mFlowFieldSystem.Steer(mScene, aDeltaTime);
+        }
+
+        // Contacts are for the pose at the end of this tick, not the interpolated one drawn last
+        // frame. Keeps running one more tick after the last collider is gone to report the ends.
+        const auto &registry = mScene.GetRegistry();
+        if (mCollisionSystem.GetColliderCount() > 0 || !registry.view<BoxCollider>().empty() || !registry.view<CircleCollider>().empty())
+        {
+            HierarchySystem::Update(mScene);
+            mCollisionSystem.Update(registry);
+            mPhysicsSystem.Step(mScene, mCollisionSystem, aDeltaTime);
+        }
+
+        // What happened during the tick is handled before the next one starts
+        mEventBus.Dispatch();
+    }
+
     void Game::Run()
     {
         Logger::info("Game started");
@@ -107,36 +278,241 @@ namespace nabla2d
             mDeltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(currentTime - lastTime).count();
             lastTime = currentTime;
 
-            if (mRenderer->HasBeenResized())
+            if (mInputRecorder.IsReplaying())
+            {
+                if (!mInputRecorder.ReplayFrame(mDeltaTime))
+                {
+                    break;
+                }
+            }
+            else
             {
-                auto projectionSettings = Camera::ProjectionSettings{45.0F, mRenderer->GetAspectRatio(), 0.1F, 100.0F};
-                mCamera.SetProjectionSettings(projectionSettings);
+                mInputRecorder.RecordFrame(mDeltaTime);
             }
 
-            mCamera.Update();
+            Step(mDeltaTime);
+        }
+        mInputRecorder.Stop();
+        Logger::info("Game ended");
+    }
 
-            mRenderer->Clear();
+    bool Game::RunBenchmark(const std::string &aScenario, std::size_t aFrames, const std::string &aReportPath)
+    {
+        if (!SetupBenchmark(aScenario))
+        {
+            return false;
+        }
+
+        Logger::info("Benchmark '{}' started ({} frames)", aScenario, aFrames);
+        Input::Init();
+
+        // Every frame is exactly one fixed step, so runs do the same work whatever the machine
+        for (std::size_t frame = 0; frame < kBenchmarkWarmupFrames + aFrames; ++frame)
+        {
+            if (frame == kBenchmarkWarmupFrames)
+            {
+                mProfiler.Start(aFrames);
+            }
+
+            mRenderer->PollWindowEvents();
+            mProfiler.BeginFrame();
+            Step(kFixedDeltaTime);
+            mProfiler.EndFrame(mRenderer->GetFrameStats());
+        }
+        mProfiler.Stop();
+
+        auto report = mProfiler.GetReport();
+        report["scenario"] = aScenario;
+        report["renderer"]["backend"] = mRenderer->GetRendererInfo();
 
-            static float totalDelta = 0.0F;
-            totalDelta += mDeltaTime;
+        std::ofstream file(aReportPath);
+        if (!file)
+        {
+            Logger::error("Game::RunBenchmark: Failed to open '{}' for writing", aReportPath);
+            return false;
+        }
+        file << report.dump(2) << std::endl;
+
+        Logger::info("Benchmark '{}' done: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+                     aScenario,
+                     report["frameTime"]["p50"].get<double>(),
+                     report["frameTime"]["p95"].get<double>(),
+                     report["frameTime"]["p99"].get<double>(),
+                     report["frameTime"]["max"].get<double>());
+        return true;
+    }
+
+    void Game::Step(float aDeltaTime)
+    {
+        {
+            FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_SIMULATION);
+
+            // Simulation runs at a fixed rate whatever the frame rate. Long frames (breakpoints,
+            // window drags) are clamped and leftover steps dropped, so slow frames can't snowball.
+            mAccumulator += std::min(aDeltaTime, kMaxDeltaTime);
+            int steps = 0;
+            while (mAccumulator >= kFixedDeltaTime && steps < kMaxFixedSteps)
+            {
+                FixedUpdate(kFixedDeltaTime);
+                mAccumulator -= kFixedDeltaTime;
+                ++steps;
+            }
+            if (steps == kMaxFixedSteps)
+            {
+                mAccumulator = std::fmod(mAccumulator, kFixedDeltaTime);
+            }
+            mInterpolation = mAccumulator / kFixedDeltaTime;
+            mAnimationSystem.Apply(mScene.GetRegistry());
+        }
+
+        // Forgets the voices the mixer finished with since the last frame
+        mAudioSystem.Update();
+        // Events published outside of the fixed ticks
+        mEventBus.Dispatch();
+
+        if (mRenderer->HasBeenResized())
+        {
+            auto projectionSettings = mCamera.GetProjectionSettings();
+            projectionSettings.aspectRatio = mRenderer->GetAspectRatio();
+            projectionSettings.viewportSize = {mRenderer->GetWidth(), mRenderer->GetHeight()};
+            mCamera.SetProjectionSettings(projectionSettings);
+        }
+
+        {
+            FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_CAMERA);
+            mCamera.Update();
+        }
+        {
+            FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_STREAMING);
+            mWorldStreamer.Update(mCamera);
+        }
+        {
+            FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_HIERARCHY);
+            HierarchySystem::Update(mScene, mInterpolation);
+        }
+        {
+            FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_SPATIAL);
+            mSpatialIndex.Update(mScene.GetRegistry());
+        }
 
-            // --------------- EDITOR ---------------
-            mEditor.Update(mDeltaTime, totalDelta, mCamera);
-            mEditor.DrawGrid(mCamera);
+        FrameProfiler::Scope scope(mProfiler, FrameProfiler::PHASE_RENDER);
+        mRenderer->Clear();
 
-            // --------------- TEST SPRITE ---------------
+        mTotalTime += aDeltaTime;
 
-            mSprites.at(1)->UpdateAnimation(mDeltaTime);
-            mRenderer->UseShader(mTestShader);
-            mSprites.at(1)->Draw(mCamera, mTestTransform.GetMatrix());
+        // --------------- EDITOR ---------------
+        mEditor.Update(aDeltaTime, mTotalTime, mCamera);
+        mEditor.DrawGrid(mCamera);
 
-            // --------------- EDITOR ---------------
+        // --------------- SPRITES ---------------
+        mRenderer->UseShader(mTestShader);
+        if (mTilemap != nullptr)
+        {
+            mTilemap->Draw(mCamera);
+        }
+        else if (mGPUTilemap != nullptr)
+        {
+            mGPUTilemap->Update(aDeltaTime);
+            mGPUTilemap->Draw(mCamera);
+        }
+        mRenderSystem.Draw(mScene, *mRenderer, mCamera);
+
+        // --------------- EDITOR ---------------
+        // The null backend has no ImGui context
+        if (!mHeadless)
+        {
             mEditor.DrawGUI(mCamera, mScene);
+        }
+
+        mRenderer->Render();
+        Input::Update();
+    }
 
-            mRenderer->Render();
-            Input::Update();
+    bool Game::SetupBenchmark(const std::string &aScenario)
+    {
+        std::vector<uint32_t> parents;
+        if (aScenario == "sprites")
+        {
+            // Sprite storm: many independent sprites spinning around
+            mBenchmark = BENCHMARK_SPRITES;
+            parents.assign(10000, Scene::kNoParent);
+        }
+        else if (aScenario == "hierarchy")
+        {
+            // Deep hierarchies: 64 chains of 64 entities, the roots move every step
+            constexpr uint32_t kChains = 64;
+            constexpr uint32_t kDepth = 64;
+            mBenchmark = BENCHMARK_HIERARCHY;
+            for (uint32_t chain = 0; chain < kChains; ++chain)
+            {
+                for (uint32_t depth = 0; depth < kDepth; ++depth)
+                {
+                    parents.push_back(depth == 0 ? Scene::kNoParent : chain * kDepth + depth - 1);
+                }
+            }
+        }
+        else if (aScenario == "grid")
+        {
+            // Editor grid with a moving camera, nothing else
+            mBenchmark = BENCHMARK_GRID;
+        }
+        else
+        {
+            Logger::error("Game::SetupBenchmark: Unknown scenario '{}' (expected sprites, hierarchy or grid)", aScenario);
+            return false;
+        }
+
+        mBenchmarkEntities = mScene.CreateEntities(std::vector<StringID>(parents.size()), parents);
+
+        auto &registry = mScene.GetRegistry();
+        const auto clip = mAnimationSystem.AddClip(*mSprites.at(1), "roll");
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> position(-20.0F, 20.0F);
+        for (std::size_t i = 0; i < mBenchmarkEntities.size(); ++i)
+        {
+            const bool root = parents[i] == Scene::kNoParent;
+            const auto entity = mBenchmarkEntities[i];
+            registry.emplace<Transform>(entity, root ? glm::vec3{position(random), position(random), 0.0F} : glm::vec3{0.5F, 0.0F, 0.0F},
+                                        glm::vec3{0.0F, 0.0F, 0.0F},
+                                        glm::vec3{0.25F, 0.25F, 1.0F});
+            registry.emplace<PreviousTransform>(entity, registry.get<Transform>(entity));
+            registry.emplace<Bounds>(entity);
+            registry.emplace<SpriteRenderer>(entity, mSprites.at(1)->GetSpriteRenderer());
+            mAnimationSystem.Play(entity, clip);
+        }
+
+        mCamera.SetPosition({0.0F, 0.0F, 60.0F});
+        return true;
+    }
+
+    void Game::UpdateBenchmark(float aDeltaTime)
+    {
+        auto &registry = mScene.GetRegistry();
+        switch (mBenchmark)
+        {
+        case BENCHMARK_SPRITES:
+            for (auto entity : mBenchmarkEntities)
+            {
+                auto &transform = registry.get<Transform>(entity);
+                transform.Rotate(90.0F * aDeltaTime, {0.0F, 0.0F, 1.0F});
+                transform.Translate(transform.GetRight() * aDeltaTime);
+            }
+            break;
+        case BENCHMARK_HIERARCHY:
+            for (auto entity : mBenchmarkEntities)
+            {
+                registry.get<Transform>(entity).Rotate(10.0F * aDeltaTime, {0.0F, 0.0F, 1.0F});
+            }
+            break;
+        case BENCHMARK_GRID:
+        {
+            const float time = mTotalTime;
+            mCamera.SetPosition({10.0F * std::sin(time), 10.0F * std::cos(time), 30.0F + 20.0F * std::sin(0.5F * time)});
+            break;
+        }
+        default:
+            break;
         }
-        Logger::info("Game ended");
     }
 } // namespace nabla2d
 
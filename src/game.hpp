@@ -22,13 +22,35 @@
 #define NABLA2D_GAME_HPP
 
 #include <array>
+#include <string>
+#include <vector>
 #include <memory>
+#include <entt/entt.hpp>
 
 #include "camera.hpp"
 #include "editor.hpp"
 #include "scene.hpp"
 #include "sprite.hpp"
+#include "tilemap.hpp"
+#include "gputilemap.hpp"
 #include "transform.hpp"
+#include "transform2d.hpp"
+#include "jobsystem.hpp"
+#include "inputrecorder.hpp"
+#include "frameprofiler.hpp"
+#include "spatialindex.hpp"
+#include "rendersystem.hpp"
+#include "animationsystem.hpp"
+#include "collisionsystem.hpp"
+#include "physicssystem.hpp"
+#include "navgrid.hpp"
+#include "flowfieldsystem.hpp"
+#include "pathfindingsystem.hpp"
+#include "scriptsystem.hpp"
+#include "pluginhost.hpp"
+#include "audiosystem.hpp"
+#include "eventbus.hpp"
+#include "worldstreamer.hpp"
 #include "renderer/renderer.hpp"
 
 namespace nabla2d
@@ -36,25 +58,84 @@ namespace nabla2d
     class Game
     {
     public:
-        Game();
+        explicit Game(Renderer::Backend aBackend = Renderer::BACKEND_SDLGL);
         ~Game();
 
+        static constexpr float kFixedDeltaTime = 1.0F / 60.0F;
+        static constexpr int kMaxFixedSteps = 5;
+        static constexpr float kMaxDeltaTime = 0.25F;
+
         float GetDeltaTime() const;
+        float GetInterpolation() const;
+        // Events are delivered at the end of every fixed tick, and once per frame before drawing
+        EventBus &GetEventBus();
+
+        bool RecordInput(const std::string &aPath);
+        // The game stops once the whole recording has been played
+        bool ReplayInput(const std::string &aPath);
+        // Native gameplay plugin, reloaded whenever the library is rebuilt
+        bool LoadPlugin(const std::string &aPath);
+        // Draws the map with GPUTilemap instead of the chunked Tilemap, reloading it
+        bool UseGPUTilemap(bool aEnabled);
 
         void Run();
+        // Runs a scripted scenario ("sprites", "hierarchy" or "grid") for aFrames frames at the
+        // fixed timestep, and writes frame time percentiles, phase timings and renderer counters
+        bool RunBenchmark(const std::string &aScenario, std::size_t aFrames, const std::string &aReportPath);
 
     private:
+        typedef enum
+        {
+            BENCHMARK_NONE,
+            BENCHMARK_SPRITES,
+            BENCHMARK_HIERARCHY,
+            BENCHMARK_GRID
+        } Benchmark;
+
+        static constexpr std::size_t kBenchmarkWarmupFrames = 60;
+
         float mDeltaTime{0.0F};
+        float mAccumulator{0.0F};
+        float mInterpolation{1.0F};
         std::shared_ptr<Renderer> mRenderer;
 
         Camera mCamera;
         Scene mScene;
+        JobSystem mJobSystem;
+        WorldStreamer mWorldStreamer;
+        SpatialIndex mSpatialIndex;
+        RenderSystem mRenderSystem;
+        AnimationSystem mAnimationSystem;
+        CollisionSystem mCollisionSystem;
+        PhysicsSystem mPhysicsSystem;
+        NavGrid mNavGrid;
+        FlowFieldSystem mFlowFieldSystem;
+        PathfindingSystem mPathfindingSystem;
+        ScriptSystem mScriptSystem;
+        PluginHost mPluginHost;
+        AudioSystem mAudioSystem;
+        EventBus mEventBus;
+        std::vector<uint32_t> mNavChanges;
+        InputRecorder mInputRecorder;
         Editor mEditor;
+        bool mHeadless{false};
+
+        FrameProfiler mProfiler;
+        Benchmark mBenchmark{BENCHMARK_NONE};
+        std::vector<entt::entity> mBenchmarkEntities;
+        float mTotalTime{0.0F};
 
         Renderer::ShaderHandle mTestShader;
         std::vector<std::shared_ptr<Sprite>> mSprites;
-        Transform mTestTransform;
+        std::unique_ptr<Tilemap> mTilemap;
+        // Only one of the two is loaded
+        std::unique_ptr<GPUTilemap> mGPUTilemap;
+        entt::entity mBall{entt::null};
 
+        void Step(float aDeltaTime);
+        void FixedUpdate(float aDeltaTime);
+        bool SetupBenchmark(const std::string &aScenario);
+        void UpdateBenchmark(float aDeltaTime);
         void DrawEditorWindows();
     };
 } // namespace nabla2d
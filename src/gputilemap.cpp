@@ -0,0 +1,437 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "gputilemap.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <tmxlite/Map.hpp>
+#include <tmxlite/TileLayer.hpp>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr uint32_t kTileIDMask = 0x0FFFFFFFU;
+        // tmxlite strips Tiled's flip bits off the ids, they are put back in the same place
+        constexpr int kFlipFlagsShift = 28;
+
+        const char *const kVertexShader = R"(
+        #version 330 core
+        uniform mat4 u_ModelViewProjectionMatrix;
+        layout (location = 0) in vec3 a_Position;
+        layout (location = 1) in vec2 a_TexCoord;
+        out vec2 v_Position;
+        void main()
+        {
+            gl_Position = u_ModelViewProjectionMatrix * vec4(a_Position, 1.0);
+            v_Position = a_Position.xy;
+        }
+        )";
+
+        const char *const kFragmentShader = R"(
+        #version 330 core
+        uniform sampler2D u_Texture;
+        uniform usampler2D u_Tiles;
+        uniform usampler2D u_Animations;
+        uniform int u_Animated;
+        uniform int u_Time;
+        uniform int u_FirstID;
+        uniform int u_TileCount;
+        uniform int u_Columns;
+        uniform vec4 u_TileRect;
+        uniform vec2 u_TileStride;
+        in vec2 v_Position;
+        out vec4 FragColor;
+
+        int FetchAnimation(int aIndex)
+        {
+            return int(texelFetch(u_Animations, ivec2(aIndex % 256, aIndex / 256), 0).r);
+        }
+
+        void main()
+        {
+            ivec2 cell = clamp(ivec2(floor(v_Position)), ivec2(0), textureSize(u_Tiles, 0) - 1);
+            uint tile = texelFetch(u_Tiles, cell, 0).r;
+            int id = int(tile & 0x0FFFFFFFu) - u_FirstID;
+            if (id < 0 || id >= u_TileCount)
+            {
+                discard;
+            }
+
+            // Header of the table: record of each tile, then the records:
+            // frame count, total duration, then end time and tile of each frame
+            int record = u_Animated != 0 ? FetchAnimation(id) : 0;
+            if (record != 0)
+            {
+                int frameCount = FetchAnimation(record);
+                int time = u_Time % FetchAnimation(record + 1);
+                for (int i = 0; i < frameCount; ++i)
+                {
+                    id = FetchAnimation(record + 3 + i * 2);
+                    if (time < FetchAnimation(record + 2 + i * 2))
+                    {
+                        break;
+                    }
+                }
+            }
+
+            // Tiled rows go down, and flips are undone in the reverse order Tiled applies them
+            vec2 local = vec2(fract(v_Position.x), 1.0 - fract(v_Position.y));
+            if ((tile & 0x40000000u) != 0u)
+            {
+                local.y = 1.0 - local.y;
+            }
+            if ((tile & 0x80000000u) != 0u)
+            {
+                local.x = 1.0 - local.x;
+            }
+            if ((tile & 0x20000000u) != 0u)
+            {
+                local = local.yx;
+            }
+
+            // Stay half a texel inside the tile so neighbours don't bleed in
+            vec2 tileMin = u_TileRect.xy + vec2(id % u_Columns, id / u_Columns) * u_TileStride;
+            vec2 halfTexel = 0.5 / vec2(textureSize(u_Texture, 0));
+            vec2 uv = clamp(tileMin + local * u_TileRect.zw, tileMin + halfTexel, tileMin + u_TileRect.zw - halfTexel);
+            FragColor = textureGrad(u_Texture, uv, dFdx(v_Position) * u_TileRect.zw, dFdy(v_Position) * u_TileRect.zw);
+        }
+        )";
+    } // namespace
+
+    GPUTilemap::~GPUTilemap()
+    {
+        if (mRenderer != nullptr)
+        {
+            for (const auto &layer : mLayers)
+            {
+                mRenderer->DeleteTexture(layer.tiles);
+            }
+            for (const auto &tileset : mTilesets)
+            {
+                mRenderer->DeleteTexture(tileset.texture);
+                if (tileset.animations != 0)
+                {
+                    mRenderer->DeleteTexture(tileset.animations);
+                }
+            }
+            if (mQuad != 0)
+            {
+                mRenderer->DeleteData(mQuad);
+            }
+            if (mShader != 0)
+            {
+                mRenderer->DeleteShader(mShader);
+            }
+        }
+    }
+
+    GPUTilemap *GPUTilemap::FromTMX(std::shared_ptr<Renderer> aRenderer,
+                                    const std::string &aPath,
+                                    const Renderer::TextureFilter &aFilter)
+    {
+        tmx::Map map;
+        if (!map.load(aPath))
+        {
+            Logger::error("GPUTilemap::FromTMX: Failed to load map '{}'", aPath);
+            return nullptr;
+        }
+        if (map.isInfinite() || map.getOrientation() != tmx::Orientation::Orthogonal)
+        {
+            Logger::error("GPUTilemap::FromTMX: Only finite orthogonal maps are supported ('{}')", aPath);
+            return nullptr;
+        }
+
+        GPUTilemap *tilemap = new GPUTilemap();
+        tilemap->mRenderer = aRenderer;
+        tilemap->mPath = aPath;
+        tilemap->mSize = {static_cast<int>(map.getTileCount().x), static_cast<int>(map.getTileCount().y)};
+        if (tilemap->mSize.x <= 0 || tilemap->mSize.y <= 0)
+        {
+            delete tilemap;
+            Logger::error("GPUTilemap::FromTMX: Map '{}' is empty", aPath);
+            return nullptr;
+        }
+
+        tilemap->mShader = aRenderer->LoadShader(kVertexShader, kFragmentShader);
+        if (tilemap->mShader == 0)
+        {
+            delete tilemap;
+            Logger::error("GPUTilemap::FromTMX: Failed to load the tilemap shader");
+            return nullptr;
+        }
+
+        const auto size = glm::vec2(tilemap->mSize);
+        tilemap->mQuad = aRenderer->LoadData({{{0.0F, 0.0F, 0.0F}, {0.0F, 1.0F}},
+                                              {{size.x, 0.0F, 0.0F}, {1.0F, 1.0F}},
+                                              {{size.x, size.y, 0.0F}, {1.0F, 0.0F}},
+                                              {{0.0F, size.y, 0.0F}, {0.0F, 0.0F}}},
+                                             {0, 1, 2, 2, 3, 0});
+
+        for (const auto &tileset : map.getTilesets())
+        {
+            if (tileset.getImagePath().empty() || tileset.getColumnCount() == 0 || tileset.getTileCount() == 0)
+            {
+                Logger::warn("GPUTilemap::FromTMX: Skipping image collection tileset '{}' in map '{}'", tileset.getName(), aPath);
+                continue;
+            }
+
+            Tileset info{};
+            info.texture = aRenderer->LoadTexture(tileset.getImagePath(), aFilter);
+            if (info.texture == 0)
+            {
+                delete tilemap;
+                Logger::error("GPUTilemap::FromTMX: Failed to load tileset image '{}'", tileset.getImagePath());
+                return nullptr;
+            }
+            info.firstGID = tileset.getFirstGID();
+            info.tileCount = tileset.getTileCount();
+            info.columns = tileset.getColumnCount();
+
+            const auto textureInfo = aRenderer->GetTextureInfo(info.texture);
+            const auto imageSize = glm::vec2(std::max(textureInfo.width, 1), std::max(textureInfo.height, 1));
+            const auto tileSize = glm::vec2(tileset.getTileSize().x, tileset.getTileSize().y);
+            info.tileRect = glm::vec4(glm::vec2(static_cast<float>(tileset.getMargin())) / imageSize, tileSize / imageSize);
+            info.tileStride = (tileSize + static_cast<float>(tileset.getSpacing())) / imageSize;
+
+            // tmxlite stores animation frames as global ids
+            std::vector<uint32_t> animations(info.tileCount, 0);
+            for (const auto &tile : tileset.getTiles())
+            {
+                const auto &frames = tile.animation.frames;
+                if (tile.ID >= info.tileCount || frames.empty())
+                {
+                    continue;
+                }
+
+                const auto record = animations.size();
+                animations.push_back(static_cast<uint32_t>(frames.size()));
+                animations.push_back(0);
+                uint32_t time = 0;
+                for (const auto &frame : frames)
+                {
+                    time += frame.duration;
+                    animations.push_back(time);
+                    animations.push_back(frame.tileID >= info.firstGID ? std::min(frame.tileID - info.firstGID, info.tileCount - 1) : 0);
+                }
+                if (time == 0)
+                {
+                    animations.resize(record);
+                    continue;
+                }
+                animations[record + 1] = time;
+                animations[tile.ID] = static_cast<uint32_t>(record);
+            }
+
+            if (animations.size() > info.tileCount)
+            {
+                const auto rows = (animations.size() + kAnimationTableWidth - 1) / kAnimationTableWidth;
+                animations.resize(rows * kAnimationTableWidth, 0);
+                info.animations = aRenderer->LoadDataTexture(kAnimationTableWidth, static_cast<int>(rows), animations);
+            }
+            tilemap->mTilesets.push_back(info);
+        }
+
+        std::size_t tileLayerCount = 0;
+        for (const auto &layer : map.getLayers())
+        {
+            tileLayerCount += layer->getType() == tmx::Layer::Type::Tile ? 1 : 0;
+        }
+
+        const auto width = static_cast<std::size_t>(tilemap->mSize.x);
+        const auto height = static_cast<std::size_t>(tilemap->mSize.y);
+        std::size_t layerIndex = 0;
+        for (const auto &mapLayer : map.getLayers())
+        {
+            if (mapLayer->getType() != tmx::Layer::Type::Tile)
+            {
+                continue;
+            }
+            const auto depth = (static_cast<float>(layerIndex++) - static_cast<float>(tileLayerCount)) * kLayerDepth;
+            const auto &tiles = mapLayer->getLayerAs<tmx::TileLayer>().getTiles();
+            if (!mapLayer->getVisible() || tiles.size() < width * height)
+            {
+                continue;
+            }
+
+            Layer layer;
+            layer.name = mapLayer->getName();
+            layer.depth = depth;
+            layer.ids.resize(width * height);
+            layer.tilesets.resize(tilemap->mTilesets.size(), 0);
+            for (std::size_t y = 0; y < height; ++y)
+            {
+                // Tiled rows go down, ours go up
+                const auto *row = &tiles[(height - 1 - y) * width];
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    const uint32_t tile = row[x].ID | (static_cast<uint32_t>(row[x].flipFlags) << kFlipFlagsShift);
+                    layer.ids[y * width + x] = tile;
+                    const int tileset = tilemap->GetTileset(tile);
+                    if (tileset >= 0)
+                    {
+                        layer.tilesets[static_cast<std::size_t>(tileset)] = 1;
+                    }
+                }
+            }
+
+            layer.tiles = aRenderer->LoadDataTexture(tilemap->mSize.x, tilemap->mSize.y, layer.ids);
+            if (layer.tiles == 0)
+            {
+                delete tilemap;
+                Logger::error("GPUTilemap::FromTMX: Failed to upload layer '{}' of map '{}'", mapLayer->getName(), aPath);
+                return nullptr;
+            }
+            tilemap->mLayers.push_back(std::move(layer));
+        }
+
+        return tilemap;
+    }
+
+    void GPUTilemap::Update(float aDeltaTime)
+    {
+        mTime += static_cast<double>(aDeltaTime);
+    }
+
+    void GPUTilemap::Draw(const Camera &aCamera)
+    {
+        mDrawCallCount = 0;
+
+        mRenderer->UseShader(mShader);
+        mRenderer->SetUniform("u_Tiles", 1);
+        mRenderer->SetUniform("u_Animations", 2);
+        // Milliseconds, wrapping after a few weeks
+        mRenderer->SetUniform("u_Time", static_cast<int>(std::fmod(mTime * 1000.0, 2147483647.0)));
+
+        const Renderer::DrawParameters parameters;
+        const auto bounds = GetBounds();
+        for (const auto &layer : mLayers)
+        {
+            if (!aCamera.GetVisibleBounds(layer.depth).Overlaps(bounds))
+            {
+                continue;
+            }
+
+            mRenderer->BindTexture(layer.tiles, 1);
+            const auto transform = glm::translate(glm::mat4(1.0F), {0.0F, 0.0F, layer.depth});
+            for (std::size_t i = 0; i < mTilesets.size(); ++i)
+            {
+                if (layer.tilesets[i] == 0)
+                {
+                    continue;
+                }
+
+                const auto &tileset = mTilesets[i];
+                mRenderer->UseTexture(tileset.texture);
+                if (tileset.animations != 0)
+                {
+                    mRenderer->BindTexture(tileset.animations, 2);
+                }
+                mRenderer->SetUniform("u_Animated", tileset.animations != 0 ? 1 : 0);
+                mRenderer->SetUniform("u_FirstID", static_cast<int>(tileset.firstGID));
+                mRenderer->SetUniform("u_TileCount", static_cast<int>(tileset.tileCount));
+                mRenderer->SetUniform("u_Columns", static_cast<int>(tileset.columns));
+                mRenderer->SetUniform("u_TileRect", tileset.tileRect);
+                mRenderer->SetUniform("u_TileStride", tileset.tileStride);
+                mRenderer->DrawData(mQuad, aCamera, transform, parameters);
+                ++mDrawCallCount;
+            }
+        }
+    }
+
+    uint32_t GPUTilemap::GetTile(std::size_t aLayer, int aX, int aY) const
+    {
+        if (aLayer >= mLayers.size() || aX < 0 || aY < 0 || aX >= mSize.x || aY >= mSize.y)
+        {
+            return 0;
+        }
+        return mLayers[aLayer].ids[static_cast<std::size_t>(aY * mSize.x + aX)];
+    }
+
+    bool GPUTilemap::SetTile(std::size_t aLayer, int aX, int aY, uint32_t aTile)
+    {
+        if (aLayer >= mLayers.size() || aX < 0 || aY < 0 || aX >= mSize.x || aY >= mSize.y)
+        {
+            Logger::error("GPUTilemap::SetTile: No tile ({}, {}) in layer {}", aX, aY, aLayer);
+            return false;
+        }
+
+        auto &layer = mLayers[aLayer];
+        auto &tile = layer.ids[static_cast<std::size_t>(aY * mSize.x + aX)];
+        if (tile == aTile)
+        {
+            return true;
+        }
+        tile = aTile;
+
+        const int tileset = GetTileset(aTile);
+        if (tileset >= 0)
+        {
+            layer.tilesets[static_cast<std::size_t>(tileset)] = 1;
+        }
+        mRenderer->UpdateDataTexture(layer.tiles, aX, aY, 1, 1, {aTile});
+        return true;
+    }
+
+    const std::string &GPUTilemap::GetPath() const
+    {
+        return mPath;
+    }
+
+    const glm::ivec2 &GPUTilemap::GetSize() const
+    {
+        return mSize;
+    }
+
+    AABB GPUTilemap::GetBounds() const
+    {
+        return {glm::vec2(0.0F), glm::vec2(mSize)};
+    }
+
+    std::size_t GPUTilemap::GetLayerCount() const
+    {
+        return mLayers.size();
+    }
+
+    std::size_t GPUTilemap::GetDrawCallCount() const
+    {
+        return mDrawCallCount;
+    }
+
+    int GPUTilemap::GetTileset(uint32_t aTile) const
+    {
+        const auto id = aTile & kTileIDMask;
+        for (std::size_t i = 0; i < mTilesets.size(); ++i)
+        {
+            if (id >= mTilesets[i].firstGID && id - mTilesets[i].firstGID < mTilesets[i].tileCount)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
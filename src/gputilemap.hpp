@@ -0,0 +1,116 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_GPUTILEMAP_HPP
+#define NABLA2D_GPUTILEMAP_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+#include "camera.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // Orthogonal Tiled map drawn as one quad per layer and tileset. The global tile ids of a
+    // layer, flip flags included, live in a 32 bits integer texture read by the fragment shader,
+    // so a map costs 4 bytes per tile on the GPU and its draw cost doesn't depend on its size.
+    // Animated tiles are resolved in the shader from a per-tileset table and the map time.
+    // Same coordinates as Tilemap, but tiles are always drawn at the map tile size.
+    class GPUTilemap
+    {
+    public:
+        ~GPUTilemap();
+        GPUTilemap(const GPUTilemap &aTilemap) = delete;
+        GPUTilemap &operator=(const GPUTilemap &aTilemap) = delete;
+
+        // Row width of the animation tables (hardcoded in the shader), entry i is at (i % width, i / width)
+        static constexpr int kAnimationTableWidth = 256;
+        static constexpr float kLayerDepth = 0.001F;
+
+        // The layers can't be larger than the maximum texture size of the renderer
+        static GPUTilemap *FromTMX(std::shared_ptr<Renderer> aRenderer,
+                                   const std::string &aPath,
+                                   const Renderer::TextureFilter &aFilter = Renderer::TextureFilter::NEAREST);
+
+        // Advances the time used by animated tiles
+        void Update(float aDeltaTime);
+        // Leaves the tilemap shader in use
+        void Draw(const Camera &aCamera);
+
+        // Tiled global ids, with the flip flags in the high bits and 0 for no tile
+        uint32_t GetTile(std::size_t aLayer, int aX, int aY) const;
+        bool SetTile(std::size_t aLayer, int aX, int aY, uint32_t aTile);
+
+        const std::string &GetPath() const;
+        const glm::ivec2 &GetSize() const;
+        AABB GetBounds() const;
+        std::size_t GetLayerCount() const;
+        std::size_t GetDrawCallCount() const;
+
+    private:
+        GPUTilemap() = default;
+
+        struct Tileset
+        {
+            Renderer::TextureHandle texture;
+            // 0 when no tile is animated
+            Renderer::TextureHandle animations;
+            uint32_t firstGID;
+            uint32_t tileCount;
+            uint32_t columns;
+            // Margin and tile size, then tile size plus spacing, in texture coordinates
+            glm::vec4 tileRect;
+            glm::vec2 tileStride;
+        };
+
+        struct Layer
+        {
+            std::string name;
+            float depth;
+            Renderer::TextureHandle tiles;
+            std::vector<uint32_t> ids;
+            // Tilesets with at least one tile in the layer, each one costs a draw
+            std::vector<uint8_t> tilesets;
+        };
+
+        std::shared_ptr<Renderer> mRenderer;
+        std::string mPath{""};
+        glm::ivec2 mSize{0, 0};
+        double mTime{0.0};
+
+        Renderer::ShaderHandle mShader{0};
+        Renderer::DataHandle mQuad{0};
+        std::vector<Tileset> mTilesets;
+        std::vector<Layer> mLayers;
+
+        std::size_t mDrawCallCount{0};
+
+        int GetTileset(uint32_t aTile) const;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_GPUTILEMAP_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,96 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "hierarchysystem.hpp"
+
+#include <vector>
+#include <utility>
+
+#include "transform.hpp"
+#include "transform2d.hpp"
+#include "components.hpp"
+
+namespace nabla2d
+{
+    void HierarchySystem::Update(Scene &aScene, float aInterpolation)
+    {
+        auto &registry = aScene.GetRegistry();
+
+        // Parent matrices are kept on a separate stack, indexed by the entries below
+        std::vector<glm::mat4> matrices{glm::mat4(1.0F)};
+        std::vector<std::pair<entt::entity, std::size_t>> stack;
+        for (auto root : aScene.GetChildren(entt::null))
+        {
+            stack.emplace_back(root, 0);
+        }
+
+        while (!stack.empty())
+        {
+            const auto [entity, parentMatrix] = stack.back();
+            stack.pop_back();
+
+            auto matrix = parentMatrix;
+            auto *transform = registry.try_get<Transform>(entity);
+            if (transform != nullptr)
+            {
+                const auto *previous = registry.try_get<PreviousTransform>(entity);
+                if (previous != nullptr && aInterpolation < 1.0F)
+                {
+                    matrices.push_back(matrices[parentMatrix] * Transform::Lerp(previous->transform, *transform, aInterpolation).GetMatrix());
+                }
+                else
+                {
+                    matrices.push_back(matrices[parentMatrix] * transform->GetMatrix());
+                }
+                matrix = matrices.size() - 1;
+                registry.get_or_emplace<WorldTransform>(entity).matrix = matrices.back();
+            }
+            else if (auto *transform2D = registry.try_get<Transform2D>(entity); transform2D != nullptr)
+            {
+                const auto *previous = registry.try_get<PreviousTransform2D>(entity);
+                if (previous != nullptr && aInterpolation < 1.0F)
+                {
+                    matrices.push_back(Transform2D::Multiply(matrices[parentMatrix], Transform2D::Lerp(previous->transform, *transform2D, aInterpolation).GetMatrix()));
+                }
+                else
+                {
+                    matrices.push_back(Transform2D::Multiply(matrices[parentMatrix], transform2D->GetMatrix()));
+                }
+                matrix = matrices.size() - 1;
+                registry.get_or_emplace<WorldTransform>(entity).matrix = matrices.back();
+            }
+
+            for (auto child : aScene.GetChildren(entity))
+            {
+                stack.emplace_back(child, matrix);
+            }
+        }
+    }
+
+    void HierarchySystem::SavePreviousTransforms(Scene &aScene)
+    {
+        aScene.GetRegistry().view<Transform, PreviousTransform>().each([](const Transform &aTransform, PreviousTransform &aPrevious)
+                                                                       { aPrevious.transform = aTransform; });
+        aScene.GetRegistry().view<Transform2D, PreviousTransform2D>().each([](const Transform2D &aTransform, PreviousTransform2D &aPrevious)
+                                                                           { aPrevious.transform = aTransform; });
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
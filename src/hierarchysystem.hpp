@@ -0,0 +1,44 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_HIERARCHYSYSTEM_HPP
+#define NABLA2D_HIERARCHYSYSTEM_HPP
+
+#include "scene.hpp"
+
+namespace nabla2d
+{
+    class HierarchySystem
+    {
+    public:
+        // Walks the scene tree and writes a WorldTransform for every entity with a Transform or a
+        // Transform2D (Transform wins if both are present). Entities without either pass their
+        // parent's matrix down unchanged, entities with a PreviousTransform(2D) are blended
+        // towards their current transform by aInterpolation.
+        static void Update(Scene &aScene, float aInterpolation = 1.0F);
+
+        // Copies every Transform(2D) into its PreviousTransform(2D), call before each fixed tick
+        static void SavePreviousTransforms(Scene &aScene);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_HIERARCHYSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
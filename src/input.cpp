@@ -86,6 +86,20 @@ namespace nabla2d
         sMouseScroll = aMouseScroll;
     }
 
+    void Input::FeedState(const State &aState)
+    {
+        FeedKeys(aState.keys);
+        FeedAxes(aState.axes);
+        FeedMousePos(aState.mousePos);
+        FeedMouseDelta(aState.mouseDelta);
+        FeedMouseScroll(aState.mouseScroll);
+    }
+
+    Input::State Input::GetState()
+    {
+        return {sKeys, sAxes, sMousePos, sMouseDelta, sMouseScroll};
+    }
+
     bool Input::KeyDown(Key aKey)
     {
         if (aKey < 0 || aKey >= KEY_COUNT)
@@ -58,6 +58,15 @@ namespace nabla2d
             AXIS_COUNT
         } Axis;
 
+        struct State
+        {
+            std::array<bool, KEY_COUNT> keys;
+            std::array<glm::vec2, AXIS_COUNT> axes;
+            glm::vec2 mousePos;
+            glm::vec2 mouseDelta;
+            float mouseScroll;
+        };
+
         static void Init();
         static void Update();
 
@@ -66,6 +75,10 @@ namespace nabla2d
         static void FeedMousePos(const glm::vec2 &aMousePos);
         static void FeedMouseDelta(const glm::vec2 &aMouseDelta);
         static void FeedMouseScroll(float aMouseScroll);
+        static void FeedState(const State &aState);
+
+        // Everything fed since the last Update
+        static State GetState();
 
         static bool KeyDown(Key aKey);
         static bool KeyUp(Key aKey);
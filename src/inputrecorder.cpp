@@ -0,0 +1,269 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "inputrecorder.hpp"
+
+#include <cstring>
+#include <iterator>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr uint8_t kChangedKeys = 1U << 0U;
+        constexpr uint8_t kChangedAxes = 1U << 1U;
+        constexpr uint8_t kChangedMousePos = 1U << 2U;
+        constexpr uint8_t kChangedMouseDelta = 1U << 3U;
+        constexpr uint8_t kChangedMouseScroll = 1U << 4U;
+
+        static_assert(Input::KEY_COUNT <= 32, "Keys are recorded as a 32-bit mask");
+
+        struct LogHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t keyCount;
+            uint32_t axisCount;
+        };
+
+        template <typename T>
+        void Write(std::ofstream &aFile, const T &aValue)
+        {
+            aFile.write(reinterpret_cast<const char *>(&aValue), sizeof(T));
+        }
+
+        template <typename T>
+        bool Read(const std::vector<uint8_t> &aLog, std::size_t &aCursor, T &aValue)
+        {
+            if (aLog.size() - aCursor < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&aValue, aLog.data() + aCursor, sizeof(T));
+            aCursor += sizeof(T);
+            return true;
+        }
+
+        uint32_t PackKeys(const std::array<bool, Input::KEY_COUNT> &aKeys)
+        {
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < aKeys.size(); ++i)
+            {
+                mask |= static_cast<uint32_t>(aKeys[i]) << i;
+            }
+            return mask;
+        }
+    } // namespace
+
+    InputRecorder::~InputRecorder()
+    {
+        Stop();
+    }
+
+    bool InputRecorder::StartRecording(const std::string &aPath)
+    {
+        Stop();
+
+        mFile.open(aPath, std::ios::binary | std::ios::trunc);
+        if (!mFile.is_open())
+        {
+            Logger::error("InputRecorder::StartRecording: Failed to open file '{}'", aPath);
+            return false;
+        }
+
+        Write(mFile, LogHeader{kMagic, kVersion, Input::KEY_COUNT, Input::AXIS_COUNT});
+        mMode = RECORDING;
+        mPath = aPath;
+        Logger::info("Recording input to '{}'", aPath);
+        return true;
+    }
+
+    bool InputRecorder::StartReplay(const std::string &aPath)
+    {
+        Stop();
+
+        std::ifstream file(aPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            Logger::error("InputRecorder::StartReplay: Failed to open file '{}'", aPath);
+            return false;
+        }
+        mLog.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        LogHeader header;
+        if (!Read(mLog, mCursor, header) || header.magic != kMagic || header.version != kVersion)
+        {
+            Logger::error("InputRecorder::StartReplay: File '{}' is not a version {} input log", aPath, kVersion);
+            mLog.clear();
+            mCursor = 0;
+            return false;
+        }
+        if (header.keyCount != Input::KEY_COUNT || header.axisCount != Input::AXIS_COUNT)
+        {
+            Logger::error("InputRecorder::StartReplay: File '{}' was recorded with {} keys and {} axes, expected {} and {}",
+                          aPath, header.keyCount, header.axisCount, Input::KEY_COUNT, Input::AXIS_COUNT);
+            mLog.clear();
+            mCursor = 0;
+            return false;
+        }
+
+        mMode = REPLAYING;
+        mPath = aPath;
+        Logger::info("Replaying input from '{}'", aPath);
+        return true;
+    }
+
+    void InputRecorder::Stop()
+    {
+        if (mMode == RECORDING)
+        {
+            mFile.close();
+            Logger::info("Recorded {} frames of input to '{}'", mFrameCount, mPath);
+        }
+        else if (mMode == REPLAYING)
+        {
+            Logger::info("Replayed {} frames of input from '{}'", mFrameCount, mPath);
+        }
+
+        mMode = IDLE;
+        mLog.clear();
+        mCursor = 0;
+        mFrameCount = 0;
+        mLastState = {};
+    }
+
+    bool InputRecorder::IsRecording() const
+    {
+        return mMode == RECORDING;
+    }
+
+    bool InputRecorder::IsReplaying() const
+    {
+        return mMode == REPLAYING;
+    }
+
+    std::size_t InputRecorder::GetFrameCount() const
+    {
+        return mFrameCount;
+    }
+
+    void InputRecorder::RecordFrame(float aDeltaTime)
+    {
+        if (mMode != RECORDING)
+        {
+            return;
+        }
+
+        const auto state = Input::GetState();
+        const bool first = mFrameCount == 0;
+        uint8_t changes = 0;
+        changes |= first || state.keys != mLastState.keys ? kChangedKeys : 0U;
+        changes |= first || state.axes != mLastState.axes ? kChangedAxes : 0U;
+        changes |= first || state.mousePos != mLastState.mousePos ? kChangedMousePos : 0U;
+        changes |= first || state.mouseDelta != mLastState.mouseDelta ? kChangedMouseDelta : 0U;
+        changes |= first || state.mouseScroll != mLastState.mouseScroll ? kChangedMouseScroll : 0U;
+
+        Write(mFile, aDeltaTime);
+        Write(mFile, changes);
+        if ((changes & kChangedKeys) != 0U)
+        {
+            Write(mFile, PackKeys(state.keys));
+        }
+        if ((changes & kChangedAxes) != 0U)
+        {
+            Write(mFile, state.axes);
+        }
+        if ((changes & kChangedMousePos) != 0U)
+        {
+            Write(mFile, state.mousePos);
+        }
+        if ((changes & kChangedMouseDelta) != 0U)
+        {
+            Write(mFile, state.mouseDelta);
+        }
+        if ((changes & kChangedMouseScroll) != 0U)
+        {
+            Write(mFile, state.mouseScroll);
+        }
+
+        mLastState = state;
+        ++mFrameCount;
+    }
+
+    bool InputRecorder::ReplayFrame(float &aDeltaTime)
+    {
+        if (mMode != REPLAYING)
+        {
+            return false;
+        }
+
+        if (mCursor == mLog.size())
+        {
+            return false;
+        }
+
+        float deltaTime;
+        uint8_t changes;
+        auto state = mLastState;
+        bool valid = Read(mLog, mCursor, deltaTime) && Read(mLog, mCursor, changes);
+        if (valid && (changes & kChangedKeys) != 0U)
+        {
+            uint32_t mask = 0;
+            valid = Read(mLog, mCursor, mask);
+            for (std::size_t i = 0; valid && i < state.keys.size(); ++i)
+            {
+                state.keys[i] = ((mask >> i) & 1U) != 0U;
+            }
+        }
+        if (valid && (changes & kChangedAxes) != 0U)
+        {
+            valid = Read(mLog, mCursor, state.axes);
+        }
+        if (valid && (changes & kChangedMousePos) != 0U)
+        {
+            valid = Read(mLog, mCursor, state.mousePos);
+        }
+        if (valid && (changes & kChangedMouseDelta) != 0U)
+        {
+            valid = Read(mLog, mCursor, state.mouseDelta);
+        }
+        if (valid && (changes & kChangedMouseScroll) != 0U)
+        {
+            valid = Read(mLog, mCursor, state.mouseScroll);
+        }
+
+        if (!valid)
+        {
+            Logger::error("InputRecorder::ReplayFrame: File '{}' is truncated after {} frames", mPath, mFrameCount);
+            mCursor = mLog.size();
+            return false;
+        }
+
+        Input::FeedState(state);
+        aDeltaTime = deltaTime;
+        mLastState = state;
+        ++mFrameCount;
+        return true;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
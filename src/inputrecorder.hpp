@@ -0,0 +1,81 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_INPUTRECORDER_HPP
+#define NABLA2D_INPUTRECORDER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+
+#include "input.hpp"
+
+namespace nabla2d
+{
+    // Records the Input state and delta time of every frame to a file, and plays it back.
+    // Each frame is stored as its delta time, a mask of the fields that changed since
+    // the previous frame and those fields only, so idle frames take 5 bytes.
+    class InputRecorder
+    {
+    public:
+        static constexpr uint32_t kMagic = 0x4944324EU; // "N2DI"
+        static constexpr uint32_t kVersion = 1;
+
+        InputRecorder() = default;
+        InputRecorder(const InputRecorder &aInputRecorder) = delete;
+        InputRecorder &operator=(const InputRecorder &aInputRecorder) = delete;
+        ~InputRecorder();
+
+        bool StartRecording(const std::string &aPath);
+        bool StartReplay(const std::string &aPath);
+        void Stop();
+
+        bool IsRecording() const;
+        bool IsReplaying() const;
+        std::size_t GetFrameCount() const;
+
+        // Call once per frame, after the input has been fed and before Input::Update
+        void RecordFrame(float aDeltaTime);
+        // Feeds the next recorded frame to Input and replaces aDeltaTime.
+        // Returns false once every frame has been played.
+        bool ReplayFrame(float &aDeltaTime);
+
+    private:
+        enum Mode
+        {
+            IDLE,
+            RECORDING,
+            REPLAYING
+        };
+
+        Mode mMode{IDLE};
+        std::string mPath;
+        std::ofstream mFile;
+        std::vector<uint8_t> mLog;
+        std::size_t mCursor{0};
+        std::size_t mFrameCount{0};
+        Input::State mLastState{};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_INPUTRECORDER_HPP
+
+// くコ:彡
\ No newline at end of file
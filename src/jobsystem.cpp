@@ -0,0 +1,148 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "jobsystem.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    JobSystem::JobSystem(std::size_t aThreadCount)
+    {
+        if (aThreadCount == 0)
+        {
+            const auto hardwareThreads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+            aThreadCount = std::max<std::size_t>(hardwareThreads, 2) - 1;
+        }
+
+        mWorkers.reserve(aThreadCount);
+        for (std::size_t i = 0; i < aThreadCount; ++i)
+        {
+            mWorkers.emplace_back(&JobSystem::WorkerLoop, this);
+        }
+
+        Logger::debug("Job system started with {} workers", aThreadCount);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mCondition.notify_all();
+
+        for (auto &worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    std::size_t JobSystem::GetThreadCount() const
+    {
+        return mWorkers.size();
+    }
+
+    void JobSystem::ParallelFor(std::size_t aCount, std::size_t aGrainSize, const std::function<void(std::size_t, std::size_t)> &aJob)
+    {
+        if (aCount == 0)
+        {
+            return;
+        }
+
+        aGrainSize = std::max<std::size_t>(aGrainSize, 1);
+        const auto chunkCount = (aCount + aGrainSize - 1) / aGrainSize;
+        if (chunkCount == 1 || mWorkers.empty())
+        {
+            aJob(0, aCount);
+            return;
+        }
+
+        struct State
+        {
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+
+        // Workers that start after every chunk was claimed return immediately,
+        // so the state is shared to outlive this call
+        auto run = [state, chunkCount, aCount, aGrainSize, &aJob]()
+        {
+            for (auto chunk = state->next++; chunk < chunkCount; chunk = state->next++)
+            {
+                const auto begin = chunk * aGrainSize;
+                aJob(begin, std::min(begin + aGrainSize, aCount));
+                if (++state->done == chunkCount)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        const auto helpers = std::min(chunkCount - 1, mWorkers.size());
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            Enqueue(run);
+        }
+        run();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state, chunkCount]()
+                             { return state->done == chunkCount; });
+    }
+
+    void JobSystem::Enqueue(std::function<void()> aJob)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mJobs.push(std::move(aJob));
+        }
+        mCondition.notify_one();
+    }
+
+    void JobSystem::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]()
+                                { return mStopping || !mJobs.empty(); });
+                if (mStopping && mJobs.empty())
+                {
+                    return;
+                }
+                job = std::move(mJobs.front());
+                mJobs.pop();
+            }
+            job();
+        }
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,77 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_JOBSYSTEM_HPP
+#define NABLA2D_JOBSYSTEM_HPP
+
+#include <queue>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+namespace nabla2d
+{
+    // Fixed pool of worker threads consuming a shared FIFO of jobs
+    class JobSystem
+    {
+    public:
+        // 0 picks one worker per hardware thread, minus the main thread
+        explicit JobSystem(std::size_t aThreadCount = 0);
+        JobSystem(const JobSystem &aJobSystem) = delete;
+        JobSystem &operator=(const JobSystem &aJobSystem) = delete;
+        ~JobSystem();
+
+        std::size_t GetThreadCount() const;
+
+        template <typename F>
+        std::future<std::invoke_result_t<F>> Schedule(F &&aJob)
+        {
+            auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(aJob));
+            auto future = task->get_future();
+            Enqueue([task]()
+                    { (*task)(); });
+            return future;
+        }
+
+        // Calls aJob(begin, end) over [0, aCount) in chunks of aGrainSize and blocks until
+        // every chunk is done. The calling thread takes chunks too, so nesting is safe.
+        void ParallelFor(std::size_t aCount, std::size_t aGrainSize, const std::function<void(std::size_t, std::size_t)> &aJob);
+
+    private:
+        std::vector<std::thread> mWorkers;
+        std::queue<std::function<void()>> mJobs;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        bool mStopping{false};
+
+        void Enqueue(std::function<void()> aJob);
+        void WorkerLoop();
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_JOBSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
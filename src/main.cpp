@@ -18,16 +18,93 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <string>
+#include <vector>
+#include <cstdlib>
 #include <iostream>
 
 #include "logger.hpp"
 #include "game.hpp"
 
-int main()
+int main(int argc, char *argv[])
 {
   nabla2d::Logger::setLevel(nabla2d::Logger::Level::LOG_DEBUG);
 
+  std::string recordPath;
+  std::string replayPath;
+  std::string benchScenario;
+  std::string benchReport = "report.json";
+  std::size_t benchFrames = 1000;
+  std::vector<std::string> plugins;
+  bool gpuTilemap = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--record" && i + 1 < argc)
+    {
+      recordPath = argv[++i];
+    }
+    else if (arg == "--replay" && i + 1 < argc)
+    {
+      replayPath = argv[++i];
+    }
+    else if (arg == "--plugin" && i + 1 < argc)
+    {
+      plugins.push_back(argv[++i]);
+    }
+    else if (arg == "--gpu-tilemap")
+    {
+      gpuTilemap = true;
+    }
+    else if (arg == "--bench" && i + 1 < argc)
+    {
+      benchScenario = argv[++i];
+    }
+    else if (arg == "--frames" && i + 1 < argc && std::strtoul(argv[i + 1], nullptr, 10) > 0)
+    {
+      benchFrames = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--out" && i + 1 < argc)
+    {
+      benchReport = argv[++i];
+    }
+    else
+    {
+      nabla2d::Logger::error("Usage: {} [--record <file> | --replay <file>] [--plugin <library>...] [--gpu-tilemap] [--bench <scenario> [--frames <count>] [--out <report.json>]]", argv[0]);
+      return 1;
+    }
+  }
+
+  if (!benchScenario.empty())
+  {
+    nabla2d::Logger::setLevel(nabla2d::Logger::Level::LOG_INFO);
+    nabla2d::Game game(nabla2d::Renderer::BACKEND_NULL);
+    return game.RunBenchmark(benchScenario, benchFrames, benchReport) ? 0 : 1;
+  }
+
   nabla2d::Game game;
+
+  if (!recordPath.empty() && !game.RecordInput(recordPath))
+  {
+    return 1;
+  }
+  if (!replayPath.empty() && !game.ReplayInput(replayPath))
+  {
+    return 1;
+  }
+  if (gpuTilemap && !game.UseGPUTilemap(true))
+  {
+    return 1;
+  }
+  for (const auto &plugin : plugins)
+  {
+    if (!game.LoadPlugin(plugin))
+    {
+      return 1;
+    }
+  }
+
   game.Run();
 
   return 0;
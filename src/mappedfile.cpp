@@ -0,0 +1,149 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "mappedfile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string &aPath)
+    {
+        mFile = CreateFileA(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+            mFile = nullptr;
+            Logger::error("MappedFile: Failed to open file '{}'", aPath);
+            return;
+        }
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(mFile, &size) == 0 || size.QuadPart == 0)
+        {
+            return;
+        }
+        mSize = static_cast<std::size_t>(size.QuadPart);
+
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapping == nullptr)
+        {
+            Logger::error("MappedFile: Failed to map file '{}'", aPath);
+            mSize = 0;
+            return;
+        }
+
+        mData = static_cast<const uint8_t *>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+        if (mData == nullptr)
+        {
+            Logger::error("MappedFile: Failed to map file '{}'", aPath);
+            mSize = 0;
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData != nullptr)
+        {
+            UnmapViewOfFile(mData);
+        }
+        if (mMapping != nullptr)
+        {
+            CloseHandle(mMapping);
+        }
+        if (mFile != nullptr)
+        {
+            CloseHandle(mFile);
+        }
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return mFile != nullptr;
+    }
+#else
+    MappedFile::MappedFile(const std::string &aPath)
+    {
+        mFile = open(aPath.c_str(), O_RDONLY);
+        if (mFile < 0)
+        {
+            Logger::error("MappedFile: Failed to open file '{}'", aPath);
+            return;
+        }
+
+        struct stat fileStat;
+        if (fstat(mFile, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            return;
+        }
+        mSize = static_cast<std::size_t>(fileStat.st_size);
+
+        void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+        if (data == MAP_FAILED)
+        {
+            Logger::error("MappedFile: Failed to map file '{}'", aPath);
+            mSize = 0;
+            return;
+        }
+        madvise(data, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const uint8_t *>(data);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData != nullptr)
+        {
+            munmap(const_cast<uint8_t *>(mData), mSize);
+        }
+        if (mFile >= 0)
+        {
+            close(mFile);
+        }
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return mFile >= 0;
+    }
+#endif
+
+    const uint8_t *MappedFile::GetData() const
+    {
+        return mData;
+    }
+
+    std::size_t MappedFile::GetSize() const
+    {
+        return mSize;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,58 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_MAPPEDFILE_HPP
+#define NABLA2D_MAPPEDFILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace nabla2d
+{
+    // Read-only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &aPath);
+        MappedFile(const MappedFile &aFile) = delete;
+        MappedFile &operator=(const MappedFile &aFile) = delete;
+        ~MappedFile();
+
+        bool IsOpen() const;
+        const uint8_t *GetData() const;
+        std::size_t GetSize() const;
+
+    private:
+        const uint8_t *mData{nullptr};
+        std::size_t mSize{0};
+
+#ifdef _WIN32
+        void *mFile{nullptr};
+        void *mMapping{nullptr};
+#else
+        int mFile{-1};
+#endif
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_MAPPEDFILE_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,265 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "navgrid.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <tmxlite/Map.hpp>
+#include <tmxlite/TileLayer.hpp>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        uint8_t GetTileCost(const std::vector<tmx::Property> &aProperties)
+        {
+            uint8_t cost = NavGrid::kDefaultCost;
+            for (const auto &property : aProperties)
+            {
+                if (property.getName() == "blocked" && property.getType() == tmx::Property::Type::Boolean && property.getBoolValue())
+                {
+                    return NavGrid::kBlocked;
+                }
+                if (property.getName() == "cost")
+                {
+                    int value = cost;
+                    if (property.getType() == tmx::Property::Type::Int)
+                    {
+                        value = property.getIntValue();
+                    }
+                    else if (property.getType() == tmx::Property::Type::Float)
+                    {
+                        value = static_cast<int>(std::lround(property.getFloatValue()));
+                    }
+                    cost = static_cast<uint8_t>(std::clamp(value, 1, static_cast<int>(NavGrid::kBlocked)));
+                }
+            }
+            return cost;
+        }
+    } // namespace
+
+    void NavGrid::Resize(int aWidth, int aHeight, float aCellSize, const glm::vec2 &aOrigin, uint8_t aCost)
+    {
+        mWidth = std::max(aWidth, 0);
+        mHeight = std::max(aHeight, 0);
+        mCellSize = aCellSize > 0.0F ? aCellSize : 1.0F;
+        mOrigin = aOrigin;
+        mCosts.assign(static_cast<std::size_t>(mWidth) * static_cast<std::size_t>(mHeight), std::max<uint8_t>(aCost, 1));
+        mChanges.clear();
+        mChanged.assign(mCosts.size(), 0);
+        ++mLayoutVersion;
+    }
+
+    bool NavGrid::LoadTiledMap(const std::string &aPath, const std::string &aLayer, float aCellSize)
+    {
+        tmx::Map map;
+        if (!map.load(aPath))
+        {
+            Logger::error("NavGrid::LoadTiledMap: Failed to load map '{}'", aPath);
+            return false;
+        }
+        if (map.isInfinite())
+        {
+            Logger::error("NavGrid::LoadTiledMap: Infinite maps are not supported ('{}')", aPath);
+            return false;
+        }
+
+        // Cost of every global tile id, 0 being the empty tile
+        std::vector<uint8_t> tileCosts(1, kDefaultCost);
+        for (const auto &tileset : map.getTilesets())
+        {
+            tileCosts.resize(std::max<std::size_t>(tileCosts.size(), tileset.getLastGID() + 1), kDefaultCost);
+            for (const auto &tile : tileset.getTiles())
+            {
+                const auto id = tileset.getFirstGID() + tile.ID;
+                if (id < tileCosts.size())
+                {
+                    tileCosts[id] = GetTileCost(tile.properties);
+                }
+            }
+        }
+
+        const auto tileCount = map.getTileCount();
+        const auto width = static_cast<int>(tileCount.x);
+        const auto height = static_cast<int>(tileCount.y);
+        Resize(width, height, aCellSize, {0.0F, 0.0F}, kDefaultCost);
+
+        bool found = false;
+        for (const auto &layer : map.getLayers())
+        {
+            if (layer->getType() != tmx::Layer::Type::Tile || (!aLayer.empty() && layer->getName() != aLayer))
+            {
+                continue;
+            }
+            found = true;
+
+            // Tiled rows go down, ours go up
+            const auto &tiles = layer->getLayerAs<tmx::TileLayer>().getTiles();
+            const auto count = std::min(tiles.size(), mCosts.size());
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto id = tiles[i].ID;
+                const auto cost = id < tileCosts.size() ? tileCosts[id] : kDefaultCost;
+                const auto x = static_cast<int>(i % static_cast<std::size_t>(width));
+                const auto y = height - 1 - static_cast<int>(i / static_cast<std::size_t>(width));
+                auto &cell = mCosts[GetIndex(x, y)];
+                cell = std::max(cell, cost);
+            }
+        }
+
+        if (!found)
+        {
+            Logger::error("NavGrid::LoadTiledMap: No tile layer '{}' in map '{}'", aLayer, aPath);
+            return false;
+        }
+        return true;
+    }
+
+    int NavGrid::GetWidth() const
+    {
+        return mWidth;
+    }
+
+    int NavGrid::GetHeight() const
+    {
+        return mHeight;
+    }
+
+    float NavGrid::GetCellSize() const
+    {
+        return mCellSize;
+    }
+
+    const glm::vec2 &NavGrid::GetOrigin() const
+    {
+        return mOrigin;
+    }
+
+    std::size_t NavGrid::GetCellCount() const
+    {
+        return mCosts.size();
+    }
+
+    bool NavGrid::IsInside(int aX, int aY) const
+    {
+        return aX >= 0 && aY >= 0 && aX < mWidth && aY < mHeight;
+    }
+
+    bool NavGrid::IsBlocked(int aX, int aY) const
+    {
+        return !IsInside(aX, aY) || mCosts[GetIndex(aX, aY)] == kBlocked;
+    }
+
+    uint8_t NavGrid::GetCost(int aX, int aY) const
+    {
+        return IsInside(aX, aY) ? mCosts[GetIndex(aX, aY)] : kBlocked;
+    }
+
+    const std::vector<uint8_t> &NavGrid::GetCosts() const
+    {
+        return mCosts;
+    }
+
+    void NavGrid::SetCost(int aX, int aY, uint8_t aCost)
+    {
+        if (!IsInside(aX, aY))
+        {
+            return;
+        }
+
+        const auto index = GetIndex(aX, aY);
+        aCost = std::max<uint8_t>(aCost, 1);
+        if (mCosts[index] == aCost)
+        {
+            return;
+        }
+        mCosts[index] = aCost;
+        if (mChanged[index] == 0)
+        {
+            mChanged[index] = 1;
+            mChanges.push_back(index);
+        }
+    }
+
+    uint8_t NavGrid::GetSteps(int aX, int aY) const
+    {
+        uint8_t open = 0;
+        for (uint8_t direction = 0; direction < 8; ++direction)
+        {
+            if (!IsBlocked(aX + kOffsetX[direction], aY + kOffsetY[direction]))
+            {
+                open |= static_cast<uint8_t>(1U << direction);
+            }
+        }
+
+        // The corners of a diagonal step are the straight directions on each side of it
+        const auto rotatedLeft = static_cast<uint8_t>((open << 1U) | (open >> 7U));
+        const auto rotatedRight = static_cast<uint8_t>((open >> 1U) | (open << 7U));
+        return static_cast<uint8_t>(open & (0x55U | (rotatedLeft & rotatedRight)));
+    }
+
+    uint32_t NavGrid::GetIndex(int aX, int aY) const
+    {
+        return static_cast<uint32_t>(aY) * static_cast<uint32_t>(mWidth) + static_cast<uint32_t>(aX);
+    }
+
+    glm::ivec2 NavGrid::GetCell(uint32_t aIndex) const
+    {
+        const auto width = static_cast<uint32_t>(mWidth);
+        return {static_cast<int>(aIndex % width), static_cast<int>(aIndex / width)};
+    }
+
+    glm::ivec2 NavGrid::WorldToCell(const glm::vec2 &aPosition) const
+    {
+        const auto cell = glm::floor((aPosition - mOrigin) / mCellSize);
+        return {static_cast<int>(cell.x), static_cast<int>(cell.y)};
+    }
+
+    glm::vec2 NavGrid::CellToWorld(const glm::ivec2 &aCell) const
+    {
+        return mOrigin + (glm::vec2(aCell) + 0.5F) * mCellSize;
+    }
+
+    void NavGrid::TakeChanges(std::vector<uint32_t> &aChanges)
+    {
+        aChanges.clear();
+        aChanges.swap(mChanges);
+        for (const auto index : aChanges)
+        {
+            mChanged[index] = 0;
+        }
+    }
+
+    bool NavGrid::HasChanges() const
+    {
+        return !mChanges.empty();
+    }
+
+    uint32_t NavGrid::GetLayoutVersion() const
+    {
+        return mLayoutVersion;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,96 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_NAVGRID_HPP
+#define NABLA2D_NAVGRID_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace nabla2d
+{
+    // Walkable cost per cell for the navigation systems, on the XY plane with cell (0, 0) at
+    // aOrigin and y going up. Costs are 1 to 254, kBlocked cells can't be entered. Cells whose
+    // cost changed are recorded until TakeChanges, so the systems built on the grid can update
+    // what they derived from it instead of starting over.
+    class NavGrid
+    {
+    public:
+        static constexpr uint8_t kBlocked = 0xFF;
+        static constexpr uint8_t kDefaultCost = 1;
+        // Neighbour directions counterclockwise from +X, odd ones are diagonal
+        static constexpr int kOffsetX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+        static constexpr int kOffsetY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+        NavGrid() = default;
+        ~NavGrid() = default;
+
+        // Every cell is reset to aCost, and the change list is cleared
+        void Resize(int aWidth, int aHeight, float aCellSize = 1.0F, const glm::vec2 &aOrigin = {0.0F, 0.0F}, uint8_t aCost = kDefaultCost);
+        // One cell per tile, from the tile layer named aLayer or the highest cost of every
+        // tile layer when empty. A tile costs its "cost" property, or kBlocked when its
+        // "blocked" property is true, and empty tiles cost kDefaultCost.
+        bool LoadTiledMap(const std::string &aPath, const std::string &aLayer = "", float aCellSize = 1.0F);
+
+        int GetWidth() const;
+        int GetHeight() const;
+        float GetCellSize() const;
+        const glm::vec2 &GetOrigin() const;
+        std::size_t GetCellCount() const;
+
+        bool IsInside(int aX, int aY) const;
+        bool IsBlocked(int aX, int aY) const;
+        uint8_t GetCost(int aX, int aY) const;
+        const std::vector<uint8_t> &GetCosts() const;
+        // Cost 0 is clamped to 1, out of range cells are ignored
+        void SetCost(int aX, int aY, uint8_t aCost);
+        // Bit d is set when the step in direction d from (aX, aY) is allowed. Diagonal steps
+        // can't cut blocked corners.
+        uint8_t GetSteps(int aX, int aY) const;
+
+        uint32_t GetIndex(int aX, int aY) const;
+        glm::ivec2 GetCell(uint32_t aIndex) const;
+        glm::ivec2 WorldToCell(const glm::vec2 &aPosition) const;
+        glm::vec2 CellToWorld(const glm::ivec2 &aCell) const;
+
+        // Indices of the cells changed since the last call, each one once
+        void TakeChanges(std::vector<uint32_t> &aChanges);
+        bool HasChanges() const;
+        // Bumped by Resize and LoadTiledMap, derived data has to be rebuilt when it moves
+        uint32_t GetLayoutVersion() const;
+
+    private:
+        int mWidth{0};
+        int mHeight{0};
+        float mCellSize{1.0F};
+        glm::vec2 mOrigin{0.0F, 0.0F};
+        std::vector<uint8_t> mCosts;
+        std::vector<uint32_t> mChanges;
+        std::vector<uint8_t> mChanged;
+        uint32_t mLayoutVersion{0};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_NAVGRID_HPP
+
+// くコ:彡
\ No newline at end of file
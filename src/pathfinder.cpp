@@ -0,0 +1,828 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "pathfinder.hpp"
+
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+
+namespace nabla2d
+{
+    namespace
+    {
+        int Sign(int aValue)
+        {
+            return (aValue > 0) - (aValue < 0);
+        }
+
+        void PushHeap(std::vector<uint64_t> &aHeap, uint32_t aKey, uint32_t aValue)
+        {
+            aHeap.push_back((static_cast<uint64_t>(aKey) << 32U) | aValue);
+            std::push_heap(aHeap.begin(), aHeap.end(), std::greater<uint64_t>());
+        }
+
+        uint64_t PopHeap(std::vector<uint64_t> &aHeap)
+        {
+            std::pop_heap(aHeap.begin(), aHeap.end(), std::greater<uint64_t>());
+            const auto item = aHeap.back();
+            aHeap.pop_back();
+            return item;
+        }
+    } // namespace
+
+    std::size_t Pathfinder::Context::GetExpandedCount() const
+    {
+        return mExpanded;
+    }
+
+    void Pathfinder::Context::Begin(std::size_t aCellCount)
+    {
+        if (mStamps.size() != aCellCount)
+        {
+            mStamps.assign(aCellCount, 0);
+            mClosed.assign(aCellCount, 0);
+            mCosts.resize(aCellCount);
+            mParents.resize(aCellCount);
+            mDirections.resize(aCellCount);
+        }
+        if (++mStamp == 0)
+        {
+            std::fill(mStamps.begin(), mStamps.end(), 0);
+            std::fill(mClosed.begin(), mClosed.end(), 0);
+            std::fill(mNodeStamps.begin(), mNodeStamps.end(), 0);
+            std::fill(mNodeClosed.begin(), mNodeClosed.end(), 0);
+            mStamp = 1;
+        }
+        mHeap.clear();
+    }
+
+    Pathfinder::Pathfinder(const NavGrid &aGrid, int aClusterSize) : mGrid(aGrid), mClusterSize(std::max(aClusterSize, 4))
+    {
+    }
+
+    void Pathfinder::Invalidate(const std::vector<uint32_t> &aChangedCells)
+    {
+        if (mLayoutVersion != mGrid.GetLayoutVersion())
+        {
+            return;
+        }
+
+        for (const auto index : aChangedCells)
+        {
+            const auto cell = mGrid.GetCell(index);
+            const auto blocked = static_cast<uint8_t>(mGrid.IsBlocked(cell.x, cell.y) ? 1 : 0);
+            if (mBlocked[index] == blocked)
+            {
+                continue;
+            }
+            mBlocked[index] = blocked;
+            mDirtyClusters[GetCluster(cell.x, cell.y)] = 1;
+            mJumpDistancesDirty = true;
+            mClustersDirty = true;
+        }
+    }
+
+    bool Pathfinder::IsDirty() const
+    {
+        return mJumpDistancesDirty || mClustersDirty || mLayoutVersion != mGrid.GetLayoutVersion();
+    }
+
+    void Pathfinder::Update(JobSystem &aJobSystem)
+    {
+        if (mLayoutVersion != mGrid.GetLayoutVersion())
+        {
+            mLayoutVersion = mGrid.GetLayoutVersion();
+            mWidth = mGrid.GetWidth();
+            mHeight = mGrid.GetHeight();
+            mBlocked.resize(mGrid.GetCellCount());
+            for (std::size_t i = 0; i < mBlocked.size(); ++i)
+            {
+                mBlocked[i] = mGrid.GetCosts()[i] == NavGrid::kBlocked ? 1 : 0;
+            }
+
+            mClustersX = (mWidth + mClusterSize - 1) / mClusterSize;
+            mClustersY = (mHeight + mClusterSize - 1) / mClusterSize;
+            const auto clusterCount = static_cast<std::size_t>(mClustersX) * static_cast<std::size_t>(mClustersY);
+            mEastBorders.assign(clusterCount, {});
+            mNorthBorders.assign(clusterCount, {});
+            mClusterNodes.assign(clusterCount, {});
+            mClusterEdges.assign(clusterCount, {});
+            mDirtyClusters.assign(clusterCount, 1);
+            mCellNodes.assign(mGrid.GetCellCount(), kInvalid);
+            mNodeCells.clear();
+            mJumpDistancesDirty = true;
+            mClustersDirty = true;
+        }
+
+        if (mJumpDistancesDirty)
+        {
+            BuildJumpDistances();
+            mJumpDistancesDirty = false;
+        }
+        if (mClustersDirty)
+        {
+            BuildClusters(aJobSystem);
+            mClustersDirty = false;
+        }
+    }
+
+    bool Pathfinder::FindPath(Context &aContext, const glm::ivec2 &aStart, const glm::ivec2 &aGoal, Search aSearch, std::vector<glm::ivec2> &aPath) const
+    {
+        aPath.clear();
+        aContext.mExpanded = 0;
+        if (mGrid.IsBlocked(aStart.x, aStart.y) || mGrid.IsBlocked(aGoal.x, aGoal.y))
+        {
+            return false;
+        }
+        if (aStart == aGoal)
+        {
+            aPath.push_back(aStart);
+            return true;
+        }
+
+        // Stale tables would walk through walls, plain A* only needs the grid
+        const auto start = mGrid.GetIndex(aStart.x, aStart.y);
+        const auto goal = mGrid.GetIndex(aGoal.x, aGoal.y);
+        if (aSearch == SEARCH_ASTAR || IsDirty())
+        {
+            return FindPathAStar(aContext, start, goal, aPath);
+        }
+        if (aSearch == SEARCH_JPSPLUS)
+        {
+            return FindPathJPS(aContext, start, goal, aPath);
+        }
+        return FindPathHierarchical(aContext, start, goal, aPath);
+    }
+
+    int Pathfinder::GetClusterSize() const
+    {
+        return mClusterSize;
+    }
+
+    std::size_t Pathfinder::GetClusterCount() const
+    {
+        return mClusterNodes.size();
+    }
+
+    std::size_t Pathfinder::GetNodeCount() const
+    {
+        return mNodeCells.size();
+    }
+
+    std::size_t Pathfinder::GetEdgeCount() const
+    {
+        return mEdges.size();
+    }
+
+    void Pathfinder::BuildJumpDistances()
+    {
+        mJumpDistances.assign(mGrid.GetCellCount() * 8, 0);
+
+        // Straight directions first, the diagonal ones stop where a straight jump starts.
+        // Cells are visited from the far end so the next one along the direction is done.
+        for (const uint8_t direction : {0, 2, 4, 6, 1, 3, 5, 7})
+        {
+            const auto dx = NavGrid::kOffsetX[direction];
+            const auto dy = NavGrid::kOffsetY[direction];
+            const bool diagonal = (direction & 1U) != 0;
+            for (int row = 0; row < mHeight; ++row)
+            {
+                const auto y = dy > 0 ? mHeight - 1 - row : row;
+                for (int column = 0; column < mWidth; ++column)
+                {
+                    const auto x = dx > 0 ? mWidth - 1 - column : column;
+                    if (mGrid.IsBlocked(x, y))
+                    {
+                        continue;
+                    }
+
+                    auto &distance = mJumpDistances[mGrid.GetIndex(x, y) * 8 + direction];
+                    if ((mGrid.GetSteps(x, y) & (1U << direction)) == 0)
+                    {
+                        distance = 0;
+                        continue;
+                    }
+
+                    const auto next = mGrid.GetIndex(x + dx, y + dy) * 8;
+                    const bool jumpPoint = diagonal ? mJumpDistances[next + direction - 1] > 0 || mJumpDistances[next + ((direction + 1U) & 7U)] > 0
+                                                    : IsJumpPoint(x + dx, y + dy, direction);
+                    if (jumpPoint)
+                    {
+                        distance = 1;
+                        continue;
+                    }
+                    const auto nextDistance = mJumpDistances[next + direction];
+                    distance = static_cast<int16_t>(nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+                }
+            }
+        }
+    }
+
+    bool Pathfinder::IsJumpPoint(int aX, int aY, uint8_t aDirection) const
+    {
+        // Entering (aX, aY) along a straight direction, a side cell is only reached best
+        // from here when the same side of the previous cell is blocked
+        const auto px = aX - NavGrid::kOffsetX[aDirection];
+        const auto py = aY - NavGrid::kOffsetY[aDirection];
+        if (mGrid.IsBlocked(px, py))
+        {
+            return false;
+        }
+        for (const auto side : {(aDirection + 2U) & 7U, (aDirection + 6U) & 7U})
+        {
+            const auto sx = NavGrid::kOffsetX[side];
+            const auto sy = NavGrid::kOffsetY[side];
+            if (!mGrid.IsBlocked(aX + sx, aY + sy) && mGrid.IsBlocked(px + sx, py + sy))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Pathfinder::BuildClusters(JobSystem &aJobSystem)
+    {
+        // Borders touching a changed cluster, then every cluster whose entrances may have moved
+        std::vector<uint32_t> clusters;
+        for (int cy = 0; cy < mClustersY; ++cy)
+        {
+            for (int cx = 0; cx < mClustersX; ++cx)
+            {
+                const auto cluster = static_cast<uint32_t>(cy * mClustersX + cx);
+                const bool dirty = mDirtyClusters[cluster] != 0;
+                const bool eastDirty = cx + 1 < mClustersX && (dirty || mDirtyClusters[cluster + 1] != 0);
+                const bool northDirty = cy + 1 < mClustersY && (dirty || mDirtyClusters[cluster + static_cast<uint32_t>(mClustersX)] != 0);
+                if (eastDirty)
+                {
+                    BuildBorder(cx, cy, true);
+                }
+                if (northDirty)
+                {
+                    BuildBorder(cx, cy, false);
+                }
+
+                const bool westDirty = cx > 0 && mDirtyClusters[cluster - 1] != 0;
+                const bool southDirty = cy > 0 && mDirtyClusters[cluster - static_cast<uint32_t>(mClustersX)] != 0;
+                if (dirty || eastDirty || northDirty || westDirty || southDirty)
+                {
+                    clusters.push_back(cluster);
+                }
+            }
+        }
+
+        aJobSystem.ParallelFor(clusters.size(), kClusterGrainSize, [this, &clusters](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   std::vector<uint32_t> costs;
+                                   std::vector<uint64_t> heap;
+                                   for (auto i = aBegin; i < aEnd; ++i)
+                                   {
+                                       BuildCluster(clusters[i], costs, heap);
+                                   } });
+
+        std::fill(mDirtyClusters.begin(), mDirtyClusters.end(), 0);
+        BuildGraph();
+    }
+
+    void Pathfinder::BuildBorder(int aClusterX, int aClusterY, bool aEast)
+    {
+        const auto bounds = GetClusterBounds(aClusterX, aClusterY);
+        const auto cluster = static_cast<std::size_t>(aClusterY * mClustersX + aClusterX);
+        auto &transitions = aEast ? mEastBorders[cluster] : mNorthBorders[cluster];
+        transitions.clear();
+
+        // Runs of open cell pairs across the border, wide ones get a transition at both ends
+        const auto length = aEast ? bounds.w - bounds.y + 1 : bounds.z - bounds.x + 1;
+        const auto getPair = [this, &bounds, aEast](int aOffset) -> Transition
+        {
+            if (aEast)
+            {
+                return {mGrid.GetIndex(bounds.z, bounds.y + aOffset), mGrid.GetIndex(bounds.z + 1, bounds.y + aOffset)};
+            }
+            return {mGrid.GetIndex(bounds.x + aOffset, bounds.w), mGrid.GetIndex(bounds.x + aOffset, bounds.w + 1)};
+        };
+        const auto isOpen = [this, &getPair](int aOffset)
+        {
+            const auto pair = getPair(aOffset);
+            return mBlocked[pair.first] == 0 && mBlocked[pair.second] == 0;
+        };
+
+        int offset = 0;
+        while (offset < length)
+        {
+            if (!isOpen(offset))
+            {
+                ++offset;
+                continue;
+            }
+            const auto begin = offset;
+            while (offset < length && isOpen(offset))
+            {
+                ++offset;
+            }
+            const auto end = offset - 1;
+            if (end - begin + 1 >= kWideEntrance)
+            {
+                transitions.push_back(getPair(begin));
+                transitions.push_back(getPair(end));
+            }
+            else
+            {
+                transitions.push_back(getPair(begin + (end - begin) / 2));
+            }
+        }
+    }
+
+    void Pathfinder::BuildCluster(uint32_t aCluster, std::vector<uint32_t> &aCosts, std::vector<uint64_t> &aHeap)
+    {
+        const auto cx = static_cast<int>(aCluster % static_cast<uint32_t>(mClustersX));
+        const auto cy = static_cast<int>(aCluster / static_cast<uint32_t>(mClustersX));
+        std::vector<uint32_t> nodes;
+        if (cx > 0)
+        {
+            for (const auto &transition : mEastBorders[aCluster - 1])
+            {
+                nodes.push_back(transition.second);
+            }
+        }
+        if (cy > 0)
+        {
+            for (const auto &transition : mNorthBorders[aCluster - static_cast<uint32_t>(mClustersX)])
+            {
+                nodes.push_back(transition.second);
+            }
+        }
+        if (cx + 1 < mClustersX)
+        {
+            for (const auto &transition : mEastBorders[aCluster])
+            {
+                nodes.push_back(transition.first);
+            }
+        }
+        if (cy + 1 < mClustersY)
+        {
+            for (const auto &transition : mNorthBorders[aCluster])
+            {
+                nodes.push_back(transition.first);
+            }
+        }
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+        // Nothing inside changed and the entrances are the same, the cached paths still hold
+        if (mDirtyClusters[aCluster] == 0 && nodes == mClusterNodes[aCluster])
+        {
+            return;
+        }
+
+        auto &edges = mClusterEdges[aCluster];
+        edges.clear();
+        const auto bounds = GetClusterBounds(cx, cy);
+        for (std::size_t i = 0; i + 1 < nodes.size(); ++i)
+        {
+            SearchCluster(nodes[i], aCosts, aHeap);
+            for (auto j = i + 1; j < nodes.size(); ++j)
+            {
+                const auto cell = mGrid.GetCell(nodes[j]);
+                const auto cost = aCosts[static_cast<std::size_t>((cell.y - bounds.y) * mClusterSize + cell.x - bounds.x)];
+                if (cost != kInvalid)
+                {
+                    edges.push_back({nodes[i], nodes[j], cost});
+                }
+            }
+        }
+        mClusterNodes[aCluster] = std::move(nodes);
+    }
+
+    void Pathfinder::BuildGraph()
+    {
+        for (const auto cell : mNodeCells)
+        {
+            mCellNodes[cell] = kInvalid;
+        }
+        mNodeCells.clear();
+        for (const auto &nodes : mClusterNodes)
+        {
+            for (const auto cell : nodes)
+            {
+                mCellNodes[cell] = static_cast<uint32_t>(mNodeCells.size());
+                mNodeCells.push_back(cell);
+            }
+        }
+
+        // Both ways for every cached path and every transition, grouped by node
+        std::vector<ClusterEdge> edges;
+        for (const auto &clusterEdges : mClusterEdges)
+        {
+            for (const auto &edge : clusterEdges)
+            {
+                edges.push_back({mCellNodes[edge.from], mCellNodes[edge.to], edge.cost});
+                edges.push_back({mCellNodes[edge.to], mCellNodes[edge.from], edge.cost});
+            }
+        }
+        for (const auto *borders : {&mEastBorders, &mNorthBorders})
+        {
+            for (const auto &transitions : *borders)
+            {
+                for (const auto &transition : transitions)
+                {
+                    edges.push_back({mCellNodes[transition.first], mCellNodes[transition.second], kStraightCost});
+                    edges.push_back({mCellNodes[transition.second], mCellNodes[transition.first], kStraightCost});
+                }
+            }
+        }
+
+        mEdgeOffsets.assign(mNodeCells.size() + 1, 0);
+        for (const auto &edge : edges)
+        {
+            ++mEdgeOffsets[edge.from + 1];
+        }
+        for (std::size_t i = 1; i < mEdgeOffsets.size(); ++i)
+        {
+            mEdgeOffsets[i] += mEdgeOffsets[i - 1];
+        }
+        mEdges.resize(edges.size());
+        std::vector<uint32_t> next(mEdgeOffsets.begin(), mEdgeOffsets.end() - 1);
+        for (const auto &edge : edges)
+        {
+            mEdges[next[edge.from]++] = {edge.to, edge.cost};
+        }
+    }
+
+    glm::ivec4 Pathfinder::GetClusterBounds(int aClusterX, int aClusterY) const
+    {
+        const auto x = aClusterX * mClusterSize;
+        const auto y = aClusterY * mClusterSize;
+        return {x, y, std::min(x + mClusterSize, mWidth) - 1, std::min(y + mClusterSize, mHeight) - 1};
+    }
+
+    uint32_t Pathfinder::GetCluster(int aX, int aY) const
+    {
+        return static_cast<uint32_t>((aY / mClusterSize) * mClustersX + aX / mClusterSize);
+    }
+
+    uint32_t Pathfinder::GetHeuristic(const glm::ivec2 &aFrom, const glm::ivec2 &aTo)
+    {
+        const auto dx = static_cast<uint32_t>(std::abs(aTo.x - aFrom.x));
+        const auto dy = static_cast<uint32_t>(std::abs(aTo.y - aFrom.y));
+        const auto diagonal = std::min(dx, dy);
+        return kDiagonalCost * diagonal + kStraightCost * (std::max(dx, dy) - diagonal);
+    }
+
+    bool Pathfinder::FindPathAStar(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const
+    {
+        aContext.Begin(mGrid.GetCellCount());
+        const auto goal = mGrid.GetCell(aGoal);
+        const auto stamp = aContext.mStamp;
+        aContext.mStamps[aStart] = stamp;
+        aContext.mCosts[aStart] = 0;
+        aContext.mParents[aStart] = kInvalid;
+        PushHeap(aContext.mHeap, GetHeuristic(mGrid.GetCell(aStart), goal), aStart);
+
+        while (!aContext.mHeap.empty())
+        {
+            const auto index = static_cast<uint32_t>(PopHeap(aContext.mHeap));
+            if (aContext.mClosed[index] == stamp)
+            {
+                continue;
+            }
+            aContext.mClosed[index] = stamp;
+            ++aContext.mExpanded;
+            if (index == aGoal)
+            {
+                BuildPath(aContext, aGoal, aPath);
+                return true;
+            }
+
+            const auto cell = mGrid.GetCell(index);
+            const auto cost = aContext.mCosts[index];
+            const auto steps = mGrid.GetSteps(cell.x, cell.y);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                if ((steps & (1U << direction)) == 0)
+                {
+                    continue;
+                }
+                const glm::ivec2 neighbour(cell.x + NavGrid::kOffsetX[direction], cell.y + NavGrid::kOffsetY[direction]);
+                const auto neighbourIndex = mGrid.GetIndex(neighbour.x, neighbour.y);
+                const auto neighbourCost = cost + ((direction & 1U) != 0 ? kDiagonalCost : kStraightCost);
+                if (aContext.mStamps[neighbourIndex] != stamp || neighbourCost < aContext.mCosts[neighbourIndex])
+                {
+                    aContext.mStamps[neighbourIndex] = stamp;
+                    aContext.mCosts[neighbourIndex] = neighbourCost;
+                    aContext.mParents[neighbourIndex] = index;
+                    PushHeap(aContext.mHeap, neighbourCost + GetHeuristic(neighbour, goal), neighbourIndex);
+                }
+            }
+        }
+        return false;
+    }
+
+    bool Pathfinder::FindPathJPS(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const
+    {
+        aContext.Begin(mGrid.GetCellCount());
+        const auto goal = mGrid.GetCell(aGoal);
+        const auto stamp = aContext.mStamp;
+        aContext.mStamps[aStart] = stamp;
+        aContext.mCosts[aStart] = 0;
+        aContext.mParents[aStart] = kInvalid;
+        aContext.mDirections[aStart] = 8;
+        PushHeap(aContext.mHeap, GetHeuristic(mGrid.GetCell(aStart), goal), aStart);
+
+        while (!aContext.mHeap.empty())
+        {
+            const auto index = static_cast<uint32_t>(PopHeap(aContext.mHeap));
+            if (aContext.mClosed[index] == stamp)
+            {
+                continue;
+            }
+            aContext.mClosed[index] = stamp;
+            ++aContext.mExpanded;
+            if (index == aGoal)
+            {
+                BuildPath(aContext, aGoal, aPath);
+                return true;
+            }
+
+            // Straight travel goes on, turns 45 degrees or turns to either side (the jump points
+            // are where the sides open up). Diagonal travel goes on or splits in its two halves.
+            const auto cell = mGrid.GetCell(index);
+            const auto cost = aContext.mCosts[index];
+            const auto travel = aContext.mDirections[index];
+            uint8_t directions = 0xFF;
+            if (travel < 8)
+            {
+                // Around +X, rotated to the direction of travel
+                const auto mask = static_cast<uint32_t>((travel & 1U) != 0 ? 0x83U : 0xC7U);
+                directions = static_cast<uint8_t>((mask << travel) | (mask >> (8U - travel)));
+            }
+
+            const auto gx = goal.x - cell.x;
+            const auto gy = goal.y - cell.y;
+            const auto *distances = &mJumpDistances[static_cast<std::size_t>(index) * 8];
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                if ((directions & (1U << direction)) == 0)
+                {
+                    continue;
+                }
+                const auto dx = NavGrid::kOffsetX[direction];
+                const auto dy = NavGrid::kOffsetY[direction];
+                const auto distance = static_cast<int>(distances[direction]);
+                const bool diagonal = (direction & 1U) != 0;
+
+                // The goal before the next jump point or wall ends the jump there
+                int steps = 0;
+                if (!diagonal && (dx != 0 ? gy == 0 && Sign(gx) == dx && std::abs(gx) <= std::abs(distance) : gx == 0 && Sign(gy) == dy && std::abs(gy) <= std::abs(distance)))
+                {
+                    steps = dx != 0 ? std::abs(gx) : std::abs(gy);
+                }
+                else if (diagonal && Sign(gx) == dx && Sign(gy) == dy && (std::abs(gx) <= std::abs(distance) || std::abs(gy) <= std::abs(distance)))
+                {
+                    steps = std::min(std::abs(gx), std::abs(gy));
+                }
+                else if (distance > 0)
+                {
+                    steps = distance;
+                }
+                if (steps == 0)
+                {
+                    continue;
+                }
+
+                const glm::ivec2 successor(cell.x + dx * steps, cell.y + dy * steps);
+                const auto successorIndex = mGrid.GetIndex(successor.x, successor.y);
+                const auto successorCost = cost + static_cast<uint32_t>(steps) * (diagonal ? kDiagonalCost : kStraightCost);
+                if (aContext.mStamps[successorIndex] != stamp || successorCost < aContext.mCosts[successorIndex])
+                {
+                    aContext.mStamps[successorIndex] = stamp;
+                    aContext.mCosts[successorIndex] = successorCost;
+                    aContext.mParents[successorIndex] = index;
+                    aContext.mDirections[successorIndex] = direction;
+                    PushHeap(aContext.mHeap, successorCost + GetHeuristic(successor, goal), successorIndex);
+                }
+            }
+        }
+        return false;
+    }
+
+    bool Pathfinder::FindPathHierarchical(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const
+    {
+        // Close ends don't gain anything from the cluster graph
+        const auto start = mGrid.GetCell(aStart);
+        const auto goal = mGrid.GetCell(aGoal);
+        if ((std::abs(goal.x - start.x) <= mClusterSize && std::abs(goal.y - start.y) <= mClusterSize) || mNodeCells.empty())
+        {
+            return FindPathJPS(aContext, aStart, aGoal, aPath);
+        }
+
+        const auto startCluster = GetCluster(start.x, start.y);
+        const auto goalCluster = GetCluster(goal.x, goal.y);
+        SearchCluster(aStart, aContext.mStartCosts, aContext.mHeap);
+        SearchCluster(aGoal, aContext.mGoalCosts, aContext.mHeap);
+        const auto goalBounds = GetClusterBounds(static_cast<int>(goalCluster % static_cast<uint32_t>(mClustersX)), static_cast<int>(goalCluster / static_cast<uint32_t>(mClustersX)));
+        const auto startBounds = GetClusterBounds(static_cast<int>(startCluster % static_cast<uint32_t>(mClustersX)), static_cast<int>(startCluster / static_cast<uint32_t>(mClustersX)));
+
+        // A* over the entrances, the start cluster's ones seeded with their cost from the start
+        // and a last node standing for the goal
+        aContext.Begin(mGrid.GetCellCount());
+        const auto nodeCount = mNodeCells.size();
+        const auto goalNode = static_cast<uint32_t>(nodeCount);
+        if (aContext.mNodeStamps.size() != nodeCount + 1)
+        {
+            aContext.mNodeStamps.assign(nodeCount + 1, 0);
+            aContext.mNodeClosed.assign(nodeCount + 1, 0);
+            aContext.mNodeCosts.resize(nodeCount + 1);
+            aContext.mNodeParents.resize(nodeCount + 1);
+        }
+        const auto stamp = aContext.mStamp;
+        const auto relax = [&aContext, stamp](uint32_t aNode, uint32_t aCost, uint32_t aParent, uint32_t aHeuristic)
+        {
+            if (aContext.mNodeStamps[aNode] != stamp || aCost < aContext.mNodeCosts[aNode])
+            {
+                aContext.mNodeStamps[aNode] = stamp;
+                aContext.mNodeCosts[aNode] = aCost;
+                aContext.mNodeParents[aNode] = aParent;
+                PushHeap(aContext.mHeap, aCost + aHeuristic, aNode);
+            }
+        };
+        for (const auto cell : mClusterNodes[startCluster])
+        {
+            const auto position = mGrid.GetCell(cell);
+            const auto cost = aContext.mStartCosts[static_cast<std::size_t>((position.y - startBounds.y) * mClusterSize + position.x - startBounds.x)];
+            if (cost != kInvalid)
+            {
+                relax(mCellNodes[cell], cost, kInvalid, GetHeuristic(position, goal));
+            }
+        }
+
+        bool found = false;
+        while (!aContext.mHeap.empty())
+        {
+            const auto node = static_cast<uint32_t>(PopHeap(aContext.mHeap));
+            if (aContext.mNodeClosed[node] == stamp)
+            {
+                continue;
+            }
+            aContext.mNodeClosed[node] = stamp;
+            ++aContext.mExpanded;
+            if (node == goalNode)
+            {
+                found = true;
+                break;
+            }
+
+            const auto cost = aContext.mNodeCosts[node];
+            const auto position = mGrid.GetCell(mNodeCells[node]);
+            if (GetCluster(position.x, position.y) == goalCluster)
+            {
+                const auto goalCost = aContext.mGoalCosts[static_cast<std::size_t>((position.y - goalBounds.y) * mClusterSize + position.x - goalBounds.x)];
+                if (goalCost != kInvalid)
+                {
+                    relax(goalNode, cost + goalCost, node, 0);
+                }
+            }
+            for (auto i = mEdgeOffsets[node]; i < mEdgeOffsets[node + 1]; ++i)
+            {
+                const auto &edge = mEdges[i];
+                relax(edge.to, cost + edge.cost, node, GetHeuristic(mGrid.GetCell(mNodeCells[edge.to]), goal));
+            }
+        }
+        if (!found)
+        {
+            return false;
+        }
+
+        auto &nodes = aContext.mNodePath;
+        nodes.clear();
+        nodes.push_back(aGoal);
+        for (auto node = aContext.mNodeParents[goalNode]; node != kInvalid; node = aContext.mNodeParents[node])
+        {
+            nodes.push_back(mNodeCells[node]);
+        }
+        nodes.push_back(aStart);
+        std::reverse(nodes.begin(), nodes.end());
+
+        // Transitions are single steps, the rest is refined inside the clusters with JPS+
+        aPath.push_back(start);
+        for (std::size_t i = 0; i + 1 < nodes.size(); ++i)
+        {
+            const auto from = mGrid.GetCell(nodes[i]);
+            const auto to = mGrid.GetCell(nodes[i + 1]);
+            if (from == to)
+            {
+                continue;
+            }
+            if (std::abs(to.x - from.x) + std::abs(to.y - from.y) == 1)
+            {
+                aPath.push_back(to);
+                continue;
+            }
+            if (!FindPathJPS(aContext, nodes[i], nodes[i + 1], aContext.mSegment))
+            {
+                aPath.clear();
+                return false;
+            }
+            aPath.insert(aPath.end(), aContext.mSegment.begin() + 1, aContext.mSegment.end());
+        }
+        RemoveCollinear(aPath);
+        return true;
+    }
+
+    void Pathfinder::SearchCluster(uint32_t aCell, std::vector<uint32_t> &aCosts, std::vector<uint64_t> &aHeap) const
+    {
+        const auto origin = mGrid.GetCell(aCell);
+        const auto bounds = GetClusterBounds(origin.x / mClusterSize, origin.y / mClusterSize);
+        const auto getLocal = [this, &bounds](int aX, int aY)
+        {
+            return static_cast<uint32_t>((aY - bounds.y) * mClusterSize + aX - bounds.x);
+        };
+
+        aCosts.assign(static_cast<std::size_t>(mClusterSize) * static_cast<std::size_t>(mClusterSize), kInvalid);
+        aHeap.clear();
+        aCosts[getLocal(origin.x, origin.y)] = 0;
+        PushHeap(aHeap, 0, getLocal(origin.x, origin.y));
+        while (!aHeap.empty())
+        {
+            const auto item = PopHeap(aHeap);
+            const auto cost = static_cast<uint32_t>(item >> 32U);
+            const auto local = static_cast<uint32_t>(item);
+            if (cost != aCosts[local])
+            {
+                continue;
+            }
+
+            const auto x = bounds.x + static_cast<int>(local % static_cast<uint32_t>(mClusterSize));
+            const auto y = bounds.y + static_cast<int>(local / static_cast<uint32_t>(mClusterSize));
+            const auto steps = mGrid.GetSteps(x, y);
+            for (uint8_t direction = 0; direction < 8; ++direction)
+            {
+                const auto nx = x + NavGrid::kOffsetX[direction];
+                const auto ny = y + NavGrid::kOffsetY[direction];
+                if ((steps & (1U << direction)) == 0 || nx < bounds.x || ny < bounds.y || nx > bounds.z || ny > bounds.w)
+                {
+                    continue;
+                }
+                const auto neighbour = getLocal(nx, ny);
+                const auto neighbourCost = cost + ((direction & 1U) != 0 ? kDiagonalCost : kStraightCost);
+                if (neighbourCost < aCosts[neighbour])
+                {
+                    aCosts[neighbour] = neighbourCost;
+                    PushHeap(aHeap, neighbourCost, neighbour);
+                }
+            }
+        }
+    }
+
+    void Pathfinder::BuildPath(const Context &aContext, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const
+    {
+        aPath.clear();
+        for (auto index = aGoal; index != kInvalid; index = aContext.mParents[index])
+        {
+            aPath.push_back(mGrid.GetCell(index));
+        }
+        std::reverse(aPath.begin(), aPath.end());
+        RemoveCollinear(aPath);
+    }
+
+    void Pathfinder::RemoveCollinear(std::vector<glm::ivec2> &aPath)
+    {
+        if (aPath.size() < 3)
+        {
+            return;
+        }
+
+        std::size_t kept = 1;
+        for (std::size_t i = 1; i + 1 < aPath.size(); ++i)
+        {
+            const glm::ivec2 in(Sign(aPath[i].x - aPath[kept - 1].x), Sign(aPath[i].y - aPath[kept - 1].y));
+            const glm::ivec2 out(Sign(aPath[i + 1].x - aPath[i].x), Sign(aPath[i + 1].y - aPath[i].y));
+            if (in != out)
+            {
+                aPath[kept++] = aPath[i];
+            }
+        }
+        aPath[kept++] = aPath.back();
+        aPath.resize(kept);
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
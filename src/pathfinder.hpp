@@ -0,0 +1,191 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_PATHFINDER_HPP
+#define NABLA2D_PATHFINDER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "navgrid.hpp"
+#include "jobsystem.hpp"
+
+namespace nabla2d
+{
+    // Point to point paths on a NavGrid, where every cell that isn't blocked costs the same
+    // (10 per straight step, 14 per diagonal one, no cutting blocked corners).
+    //   SEARCH_ASTAR        plain A*, the reference
+    //   SEARCH_JPSPLUS      A* over jump points, with the jump distances of every cell in the
+    //                       8 directions precomputed
+    //   SEARCH_HIERARCHICAL the grid is split in square clusters, connected by the entrances
+    //                       found along their borders. Long paths are searched on that graph
+    //                       and each step refined with JPS+, they are close to the shortest.
+    // Paths are the turning points from start to goal, consecutive ones are on a straight or
+    // diagonal line. Searches are const and only touch their Context, so any number can run
+    // at the same time, one Context each.
+    class Pathfinder
+    {
+    public:
+        typedef enum
+        {
+            SEARCH_ASTAR,
+            SEARCH_JPSPLUS,
+            SEARCH_HIERARCHICAL
+        } Search;
+
+        // Scratch memory of a search, reused from one search to the next
+        class Context
+        {
+        public:
+            Context() = default;
+            ~Context() = default;
+
+            // Cells (or graph nodes) taken off the open list by the last search
+            std::size_t GetExpandedCount() const;
+
+        private:
+            friend class Pathfinder;
+
+            std::vector<uint32_t> mStamps;
+            std::vector<uint32_t> mClosed;
+            std::vector<uint32_t> mCosts;
+            std::vector<uint32_t> mParents;
+            std::vector<uint8_t> mDirections;
+            std::vector<uint64_t> mHeap;
+            uint32_t mStamp{0};
+
+            std::vector<uint32_t> mNodeStamps;
+            std::vector<uint32_t> mNodeClosed;
+            std::vector<uint32_t> mNodeCosts;
+            std::vector<uint32_t> mNodeParents;
+            std::vector<uint32_t> mStartCosts;
+            std::vector<uint32_t> mGoalCosts;
+            std::vector<uint32_t> mNodePath;
+            std::vector<glm::ivec2> mSegment;
+            std::size_t mExpanded{0};
+
+            void Begin(std::size_t aCellCount);
+        };
+
+        explicit Pathfinder(const NavGrid &aGrid, int aClusterSize = 16);
+        Pathfinder(const Pathfinder &aPathfinder) = delete;
+        Pathfinder &operator=(const Pathfinder &aPathfinder) = delete;
+        ~Pathfinder() = default;
+
+        // Marks what depends on aChangedCells for the next Update
+        void Invalidate(const std::vector<uint32_t> &aChangedCells);
+        bool IsDirty() const;
+        // Rebuilds the jump distances and the clusters that were invalidated, or everything
+        // if the grid layout changed. Clusters are split over the job system.
+        void Update(JobSystem &aJobSystem);
+
+        // Needs an Update after the grid changed. aPath is cleared, and left empty when no
+        // path exists or either end is blocked.
+        bool FindPath(Context &aContext, const glm::ivec2 &aStart, const glm::ivec2 &aGoal, Search aSearch, std::vector<glm::ivec2> &aPath) const;
+
+        int GetClusterSize() const;
+        std::size_t GetClusterCount() const;
+        // Entrance cells, the nodes of the cluster graph
+        std::size_t GetNodeCount() const;
+        std::size_t GetEdgeCount() const;
+
+    private:
+        static constexpr uint32_t kInvalid = 0xFFFFFFFFU;
+        static constexpr uint32_t kStraightCost = 10;
+        static constexpr uint32_t kDiagonalCost = 14;
+        // Entrances at least this wide get a transition at both ends instead of the middle
+        static constexpr int kWideEntrance = 6;
+        static constexpr std::size_t kClusterGrainSize = 16;
+
+        // Adjacent cells on both sides of a border
+        struct Transition
+        {
+            uint32_t first;
+            uint32_t second;
+        };
+
+        struct ClusterEdge
+        {
+            uint32_t from;
+            uint32_t to;
+            uint32_t cost;
+        };
+
+        struct Edge
+        {
+            uint32_t to;
+            uint32_t cost;
+        };
+
+        const NavGrid &mGrid;
+        int mClusterSize;
+        int mWidth{0};
+        int mHeight{0};
+        uint32_t mLayoutVersion{0xFFFFFFFFU};
+
+        // Jump distance of every cell in the 8 directions: to the next jump point when
+        // positive, minus the distance to the wall otherwise (grids up to 32767 cells wide)
+        std::vector<int16_t> mJumpDistances;
+        bool mJumpDistancesDirty{true};
+        // Blocked state the tables were built for, cost changes alone don't matter here
+        std::vector<uint8_t> mBlocked;
+
+        int mClustersX{0};
+        int mClustersY{0};
+        // Between cluster (x, y) and (x + 1, y), and between (x, y) and (x, y + 1)
+        std::vector<std::vector<Transition>> mEastBorders;
+        std::vector<std::vector<Transition>> mNorthBorders;
+        // Entrance cells of every cluster, sorted, and the cached paths between them
+        std::vector<std::vector<uint32_t>> mClusterNodes;
+        std::vector<std::vector<ClusterEdge>> mClusterEdges;
+        std::vector<uint8_t> mDirtyClusters;
+        bool mClustersDirty{true};
+
+        std::vector<uint32_t> mNodeCells;
+        std::vector<uint32_t> mCellNodes;
+        std::vector<uint32_t> mEdgeOffsets;
+        std::vector<Edge> mEdges;
+
+        void BuildJumpDistances();
+        bool IsJumpPoint(int aX, int aY, uint8_t aDirection) const;
+        void BuildClusters(JobSystem &aJobSystem);
+        void BuildBorder(int aClusterX, int aClusterY, bool aEast);
+        void BuildCluster(uint32_t aCluster, std::vector<uint32_t> &aCosts, std::vector<uint64_t> &aHeap);
+        void BuildGraph();
+
+        glm::ivec4 GetClusterBounds(int aClusterX, int aClusterY) const;
+        uint32_t GetCluster(int aX, int aY) const;
+        static uint32_t GetHeuristic(const glm::ivec2 &aFrom, const glm::ivec2 &aTo);
+
+        bool FindPathAStar(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const;
+        bool FindPathJPS(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const;
+        bool FindPathHierarchical(Context &aContext, uint32_t aStart, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const;
+        // Dijkstra from aCell limited to its cluster, aCosts gets one cost per cluster cell
+        void SearchCluster(uint32_t aCell, std::vector<uint32_t> &aCosts, std::vector<uint64_t> &aHeap) const;
+        void BuildPath(const Context &aContext, uint32_t aGoal, std::vector<glm::ivec2> &aPath) const;
+        static void RemoveCollinear(std::vector<glm::ivec2> &aPath);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_PATHFINDER_HPP
+
+// くコ:彡
\ No newline at end of file
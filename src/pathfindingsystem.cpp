@@ -0,0 +1,144 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "pathfindingsystem.hpp"
+
+namespace nabla2d
+{
+    PathfindingSystem::PathfindingSystem(JobSystem &aJobSystem, const NavGrid &aGrid, int aClusterSize) : mJobSystem(aJobSystem),
+                                                                                                         mGrid(aGrid),
+                                                                                                         mPathfinder(aGrid, aClusterSize),
+                                                                                                         mContexts(aJobSystem.GetThreadCount() + 1)
+    {
+    }
+
+    std::size_t PathfindingSystem::GetBudget() const
+    {
+        return mBudget;
+    }
+
+    void PathfindingSystem::SetBudget(std::size_t aExpandedNodes)
+    {
+        mBudget = aExpandedNodes;
+    }
+
+    PathfindingSystem::RequestID PathfindingSystem::RequestPath(const glm::vec2 &aStart, const glm::vec2 &aGoal, Pathfinder::Search aSearch)
+    {
+        const auto request = mNextRequest++;
+        if (mNextRequest == kInvalidRequest)
+        {
+            mNextRequest = 1;
+        }
+        mRequests[request] = {mGrid.WorldToCell(aStart), mGrid.WorldToCell(aGoal), aSearch, PATH_PENDING, {}};
+        mQueue.push_back(request);
+        return request;
+    }
+
+    PathfindingSystem::Status PathfindingSystem::GetStatus(RequestID aRequest) const
+    {
+        const auto it = mRequests.find(aRequest);
+        return it == mRequests.end() ? PATH_UNKNOWN : it->second.status;
+    }
+
+    bool PathfindingSystem::TakePath(RequestID aRequest, std::vector<glm::vec2> &aWaypoints)
+    {
+        aWaypoints.clear();
+        const auto it = mRequests.find(aRequest);
+        if (it == mRequests.end() || it->second.status == PATH_PENDING)
+        {
+            return false;
+        }
+
+        aWaypoints.reserve(it->second.path.size());
+        for (const auto &cell : it->second.path)
+        {
+            aWaypoints.push_back(mGrid.CellToWorld(cell));
+        }
+        mRequests.erase(it);
+        return true;
+    }
+
+    void PathfindingSystem::Cancel(RequestID aRequest)
+    {
+        // Left in the queue, skipped when its turn comes
+        mRequests.erase(aRequest);
+    }
+
+    std::size_t PathfindingSystem::GetPendingCount() const
+    {
+        return mQueue.size();
+    }
+
+    void PathfindingSystem::Update(const std::vector<uint32_t> &aChangedCells)
+    {
+        mPathfinder.Invalidate(aChangedCells);
+        mExpanded = 0;
+        if (mQueue.empty())
+        {
+            return;
+        }
+        mPathfinder.Update(mJobSystem);
+
+        // One request per context, so one per thread
+        while (!mQueue.empty() && mExpanded < mBudget)
+        {
+            mJobs.clear();
+            while (!mQueue.empty() && mJobs.size() < mContexts.size())
+            {
+                const auto request = mQueue.front();
+                mQueue.pop_front();
+                const auto it = mRequests.find(request);
+                if (it != mRequests.end())
+                {
+                    mJobs.push_back({request, &it->second, false, 0});
+                }
+            }
+
+            mJobSystem.ParallelFor(mJobs.size(), 1, [this](std::size_t aBegin, std::size_t aEnd)
+                                   {
+                                       for (auto i = aBegin; i < aEnd; ++i)
+                                       {
+                                           auto &job = mJobs[i];
+                                           auto &context = mContexts[i];
+                                           job.found = mPathfinder.FindPath(context, job.data->start, job.data->goal, job.data->search, job.data->path);
+                                           job.expanded = context.GetExpandedCount();
+                                       } });
+
+            for (const auto &job : mJobs)
+            {
+                job.data->status = job.found ? PATH_FOUND : PATH_NOT_FOUND;
+                mExpanded += job.expanded;
+            }
+        }
+    }
+
+    const Pathfinder &PathfindingSystem::GetPathfinder() const
+    {
+        return mPathfinder;
+    }
+
+    std::size_t PathfindingSystem::GetExpandedCount() const
+    {
+        return mExpanded;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
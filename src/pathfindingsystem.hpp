@@ -0,0 +1,110 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_PATHFINDINGSYSTEM_HPP
+#define NABLA2D_PATHFINDINGSYSTEM_HPP
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "navgrid.hpp"
+#include "jobsystem.hpp"
+#include "pathfinder.hpp"
+
+namespace nabla2d
+{
+    // Path requests answered over the following updates. Each Update applies the grid changes,
+    // then runs queued requests in batches over the job system until its budget of expanded
+    // nodes is spent, checked between batches so at least one batch runs.
+    class PathfindingSystem
+    {
+    public:
+        typedef uint32_t RequestID;
+        static constexpr RequestID kInvalidRequest = 0;
+        static constexpr std::size_t kDefaultBudget = 50000;
+
+        typedef enum
+        {
+            PATH_UNKNOWN,
+            PATH_PENDING,
+            PATH_FOUND,
+            PATH_NOT_FOUND
+        } Status;
+
+        PathfindingSystem(JobSystem &aJobSystem, const NavGrid &aGrid, int aClusterSize = 16);
+        PathfindingSystem(const PathfindingSystem &aPathfindingSystem) = delete;
+        PathfindingSystem &operator=(const PathfindingSystem &aPathfindingSystem) = delete;
+        ~PathfindingSystem() = default;
+
+        std::size_t GetBudget() const;
+        void SetBudget(std::size_t aExpandedNodes);
+
+        // World positions, snapped to their cells
+        RequestID RequestPath(const glm::vec2 &aStart, const glm::vec2 &aGoal, Pathfinder::Search aSearch = Pathfinder::SEARCH_HIERARCHICAL);
+        Status GetStatus(RequestID aRequest) const;
+        // Moves the waypoints of a finished request out (cell centers, start and goal included)
+        // and forgets the request. False while pending.
+        bool TakePath(RequestID aRequest, std::vector<glm::vec2> &aWaypoints);
+        void Cancel(RequestID aRequest);
+        std::size_t GetPendingCount() const;
+
+        void Update(const std::vector<uint32_t> &aChangedCells);
+        const Pathfinder &GetPathfinder() const;
+        // Expanded by the last Update
+        std::size_t GetExpandedCount() const;
+
+    private:
+        struct Request
+        {
+            glm::ivec2 start;
+            glm::ivec2 goal;
+            Pathfinder::Search search;
+            Status status;
+            std::vector<glm::ivec2> path;
+        };
+
+        struct Job
+        {
+            RequestID request;
+            Request *data;
+            bool found;
+            std::size_t expanded;
+        };
+
+        JobSystem &mJobSystem;
+        const NavGrid &mGrid;
+        Pathfinder mPathfinder;
+        std::vector<Pathfinder::Context> mContexts;
+        std::unordered_map<RequestID, Request> mRequests;
+        std::deque<RequestID> mQueue;
+        std::vector<Job> mJobs;
+        RequestID mNextRequest{1};
+        std::size_t mBudget{kDefaultBudget};
+        std::size_t mExpanded{0};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_PATHFINDINGSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
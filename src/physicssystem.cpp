@@ -0,0 +1,444 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "physicssystem.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+#include "components.hpp"
+#include "transform2d.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        float Cross(const glm::vec2 &aFirst, const glm::vec2 &aSecond)
+        {
+            return aFirst.x * aSecond.y - aFirst.y * aSecond.x;
+        }
+
+        glm::vec2 Cross(float aScalar, const glm::vec2 &aVector)
+        {
+            return {-aScalar * aVector.y, aScalar * aVector.x};
+        }
+    } // namespace
+
+    PhysicsSystem::PhysicsSystem(JobSystem &aJobSystem) : mJobSystem(aJobSystem)
+    {
+    }
+
+    const glm::vec2 &PhysicsSystem::GetGravity() const
+    {
+        return mGravity;
+    }
+
+    void PhysicsSystem::SetGravity(const glm::vec2 &aGravity)
+    {
+        mGravity = aGravity;
+    }
+
+    int PhysicsSystem::GetIterations() const
+    {
+        return mIterations;
+    }
+
+    void PhysicsSystem::SetIterations(int aIterations)
+    {
+        mIterations = std::max(aIterations, 1);
+    }
+
+    bool PhysicsSystem::IsSleepEnabled() const
+    {
+        return mSleepEnabled;
+    }
+
+    void PhysicsSystem::SetSleepEnabled(bool aEnabled)
+    {
+        mSleepEnabled = aEnabled;
+    }
+
+    void PhysicsSystem::Step(Scene &aScene, const CollisionSystem &aCollisionSystem, float aDeltaTime)
+    {
+        auto &registry = aScene.GetRegistry();
+        GatherBodies(aScene);
+        BuildConstraints(registry, aCollisionSystem.GetContacts());
+        BuildIslands();
+
+        const auto islandCount = mIslandAwake.size();
+        mJobSystem.ParallelFor(islandCount, kGrainSize, [this, aDeltaTime](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   for (auto island = aBegin; island < aEnd; ++island)
+                                   {
+                                       SolveIsland(island, aDeltaTime);
+                                   } });
+
+        // Sleeping islands didn't change, the ones that just fell asleep were still solved
+        for (std::size_t island = 0; island < islandCount; ++island)
+        {
+            if (mIslandAwake[island] == 0)
+            {
+                continue;
+            }
+            for (auto i = mIslandBodyOffsets[island]; i < mIslandBodyOffsets[island + 1]; ++i)
+            {
+                const auto &body = mBodies[mIslandBodies[i]];
+                auto &transform = registry.get<Transform2D>(body.entity);
+                transform.SetPosition(body.position);
+                if (body.invInertia > 0.0F)
+                {
+                    transform.SetRotation(glm::degrees(body.angle));
+                }
+
+                auto &rigidBody = registry.get<RigidBody>(body.entity);
+                rigidBody.velocity = body.velocity;
+                rigidBody.angularVelocity = body.angularVelocity;
+                rigidBody.sleepTime = body.sleepTime;
+                rigidBody.awake = body.awake;
+            }
+        }
+
+        // Contacts are sorted by pair, so the cache is too
+        mCache.clear();
+        mCache.reserve(mConstraints.size());
+        for (const auto &constraint : mConstraints)
+        {
+            mCache.push_back({constraint.key, constraint.normalImpulse, constraint.tangentImpulse});
+        }
+    }
+
+    void PhysicsSystem::Clear()
+    {
+        mBodies.clear();
+        mSparse.clear();
+        mConstraints.clear();
+        mCache.clear();
+        mParents.clear();
+        mIslandBodies.clear();
+        mIslandBodyOffsets.clear();
+        mIslandConstraints.clear();
+        mIslandConstraintOffsets.clear();
+        mIslandAwake.clear();
+        mAwakeIslandCount = 0;
+    }
+
+    std::size_t PhysicsSystem::GetBodyCount() const
+    {
+        return mBodies.size();
+    }
+
+    std::size_t PhysicsSystem::GetIslandCount() const
+    {
+        return mIslandAwake.size();
+    }
+
+    std::size_t PhysicsSystem::GetAwakeIslandCount() const
+    {
+        return mAwakeIslandCount;
+    }
+
+    uint32_t PhysicsSystem::GetBody(entt::entity aEntity) const
+    {
+        const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+        if (id >= mSparse.size() || mSparse[id] >= mBodies.size() || mBodies[mSparse[id]].entity != aEntity)
+        {
+            return kStatic;
+        }
+        return mSparse[id];
+    }
+
+    uint32_t PhysicsSystem::FindRoot(uint32_t aBody)
+    {
+        while (mParents[aBody] != aBody)
+        {
+            mParents[aBody] = mParents[mParents[aBody]];
+            aBody = mParents[aBody];
+        }
+        return aBody;
+    }
+
+    void PhysicsSystem::GatherBodies(Scene &aScene)
+    {
+        const auto &registry = aScene.GetRegistry();
+        mBodies.clear();
+        registry.view<RigidBody, Transform2D>().each([this, &aScene, &registry](auto aEntity, const RigidBody &aBody, const Transform2D &aTransform)
+                                                     {
+                                                         if (!(aBody.mass > 0.0F) || aScene.GetParent(aEntity) != entt::null)
+                                                         {
+                                                             return;
+                                                         }
+
+                                                         // Only circles rotate, around the entity origin
+                                                         float invInertia = 0.0F;
+                                                         const auto *circle = registry.try_get<CircleCollider>(aEntity);
+                                                         if (circle != nullptr && !registry.all_of<BoxCollider>(aEntity))
+                                                         {
+                                                             const auto &scale = aTransform.GetScale();
+                                                             const auto radius = circle->radius * std::max(std::abs(scale.x), std::abs(scale.y));
+                                                             const auto center = circle->center * scale;
+                                                             const auto inertia = aBody.mass * (0.5F * radius * radius + glm::dot(center, center));
+                                                             invInertia = inertia > 0.0F ? 1.0F / inertia : 0.0F;
+                                                         }
+
+                                                         const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+                                                         if (id >= mSparse.size())
+                                                         {
+                                                             mSparse.resize(std::max(id + 1, mSparse.size() * 2), kStatic);
+                                                         }
+                                                         mSparse[id] = static_cast<uint32_t>(mBodies.size());
+                                                         mBodies.push_back({aEntity,
+                                                                            aTransform.GetPosition(),
+                                                                            glm::radians(aTransform.GetRotation()),
+                                                                            aBody.velocity,
+                                                                            aBody.angularVelocity,
+                                                                            1.0F / aBody.mass,
+                                                                            invInertia,
+                                                                            aBody.gravityScale,
+                                                                            aBody.sleepTime,
+                                                                            aBody.awake}); });
+    }
+
+    void PhysicsSystem::BuildConstraints(const entt::registry &aRegistry, const std::vector<CollisionSystem::Contact> &aContacts)
+    {
+        const RigidBody defaults;
+        mConstraints.clear();
+        std::size_t cached = 0;
+        for (const auto &contact : aContacts)
+        {
+            const auto a = GetBody(contact.a);
+            const auto b = GetBody(contact.b);
+            if (a == kStatic && b == kStatic)
+            {
+                continue;
+            }
+
+            const auto *bodyA = aRegistry.try_get<RigidBody>(contact.a);
+            const auto *bodyB = aRegistry.try_get<RigidBody>(contact.b);
+            const auto &materialA = bodyA != nullptr ? *bodyA : defaults;
+            const auto &materialB = bodyB != nullptr ? *bodyB : defaults;
+
+            Constraint constraint{};
+            constraint.key = (static_cast<uint64_t>(entt::to_integral(contact.a)) << 32U) | entt::to_integral(contact.b);
+            constraint.a = a;
+            constraint.b = b;
+            constraint.normal = contact.normal;
+            constraint.rA = a != kStatic ? contact.point - mBodies[a].position : glm::vec2(0.0F);
+            constraint.rB = b != kStatic ? contact.point - mBodies[b].position : glm::vec2(0.0F);
+            constraint.depth = contact.depth;
+            constraint.friction = std::sqrt(materialA.friction * materialB.friction);
+            constraint.restitution = std::max(materialA.restitution, materialB.restitution);
+
+            // Warm start from the impulses of the same pair last tick
+            while (cached < mCache.size() && mCache[cached].key < constraint.key)
+            {
+                ++cached;
+            }
+            if (cached < mCache.size() && mCache[cached].key == constraint.key)
+            {
+                constraint.normalImpulse = mCache[cached].normal;
+                constraint.tangentImpulse = mCache[cached].tangent;
+            }
+            mConstraints.push_back(constraint);
+        }
+    }
+
+    void PhysicsSystem::BuildIslands()
+    {
+        const auto bodyCount = static_cast<uint32_t>(mBodies.size());
+        mParents.resize(bodyCount);
+        std::iota(mParents.begin(), mParents.end(), 0U);
+        for (const auto &constraint : mConstraints)
+        {
+            if (constraint.a == kStatic || constraint.b == kStatic)
+            {
+                continue;
+            }
+            const auto rootA = FindRoot(constraint.a);
+            const auto rootB = FindRoot(constraint.b);
+            mParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+
+        // Islands are numbered in the order of their first body
+        std::vector<uint32_t> islands(bodyCount);
+        std::vector<uint32_t> rootIslands(bodyCount, kStatic);
+        uint32_t islandCount = 0;
+        for (uint32_t body = 0; body < bodyCount; ++body)
+        {
+            auto &island = rootIslands[FindRoot(body)];
+            if (island == kStatic)
+            {
+                island = islandCount++;
+            }
+            islands[body] = island;
+        }
+
+        auto bucket = [islandCount](const std::vector<uint32_t> &aIslands, std::vector<uint32_t> &aItems, std::vector<uint32_t> &aOffsets)
+        {
+            aOffsets.assign(islandCount + 1, 0);
+            for (auto island : aIslands)
+            {
+                ++aOffsets[island + 1];
+            }
+            std::partial_sum(aOffsets.begin(), aOffsets.end(), aOffsets.begin());
+            aItems.resize(aIslands.size());
+            std::vector<uint32_t> cursors(aOffsets.begin(), aOffsets.end() - 1);
+            for (uint32_t item = 0; item < aIslands.size(); ++item)
+            {
+                aItems[cursors[aIslands[item]]++] = item;
+            }
+        };
+        bucket(islands, mIslandBodies, mIslandBodyOffsets);
+
+        std::vector<uint32_t> constraintIslands(mConstraints.size());
+        for (std::size_t i = 0; i < mConstraints.size(); ++i)
+        {
+            const auto &constraint = mConstraints[i];
+            constraintIslands[i] = islands[constraint.a != kStatic ? constraint.a : constraint.b];
+        }
+        bucket(constraintIslands, mIslandConstraints, mIslandConstraintOffsets);
+
+        // An island is awake if any of its bodies is, touching a sleeping island wakes it up
+        mIslandAwake.assign(islandCount, 0);
+        for (uint32_t body = 0; body < bodyCount; ++body)
+        {
+            mIslandAwake[islands[body]] |= mBodies[body].awake ? 1 : 0;
+        }
+        mAwakeIslandCount = static_cast<std::size_t>(std::count(mIslandAwake.begin(), mIslandAwake.end(), 1));
+    }
+
+    void PhysicsSystem::SolveIsland(std::size_t aIsland, float aDeltaTime)
+    {
+        if (mIslandAwake[aIsland] == 0)
+        {
+            return;
+        }
+
+        const auto bodiesBegin = mIslandBodies.begin() + mIslandBodyOffsets[aIsland];
+        const auto bodiesEnd = mIslandBodies.begin() + mIslandBodyOffsets[aIsland + 1];
+        const auto constraintsBegin = mIslandConstraints.begin() + mIslandConstraintOffsets[aIsland];
+        const auto constraintsEnd = mIslandConstraints.begin() + mIslandConstraintOffsets[aIsland + 1];
+
+        for (auto it = bodiesBegin; it != bodiesEnd; ++it)
+        {
+            auto &body = mBodies[*it];
+            body.velocity += mGravity * body.gravityScale * aDeltaTime;
+        }
+
+        // Static bodies have no mass and no velocity
+        Body staticBody{};
+        auto getBody = [this, &staticBody](uint32_t aBody) -> Body &
+        { return aBody != kStatic ? mBodies[aBody] : staticBody; };
+        auto applyImpulse = [&getBody](const Constraint &aConstraint, const glm::vec2 &aImpulse)
+        {
+            if (aConstraint.a != kStatic)
+            {
+                auto &bodyA = getBody(aConstraint.a);
+                bodyA.velocity -= aImpulse * bodyA.invMass;
+                bodyA.angularVelocity -= Cross(aConstraint.rA, aImpulse) * bodyA.invInertia;
+            }
+            if (aConstraint.b != kStatic)
+            {
+                auto &bodyB = getBody(aConstraint.b);
+                bodyB.velocity += aImpulse * bodyB.invMass;
+                bodyB.angularVelocity += Cross(aConstraint.rB, aImpulse) * bodyB.invInertia;
+            }
+        };
+        auto getRelativeVelocity = [&getBody](const Constraint &aConstraint)
+        {
+            const auto &bodyA = getBody(aConstraint.a);
+            const auto &bodyB = getBody(aConstraint.b);
+            return bodyB.velocity + Cross(bodyB.angularVelocity, aConstraint.rB) - bodyA.velocity - Cross(bodyA.angularVelocity, aConstraint.rA);
+        };
+
+        for (auto it = constraintsBegin; it != constraintsEnd; ++it)
+        {
+            auto &constraint = mConstraints[*it];
+            const auto &bodyA = getBody(constraint.a);
+            const auto &bodyB = getBody(constraint.b);
+            const glm::vec2 tangent{constraint.normal.y, -constraint.normal.x};
+
+            const auto rnA = Cross(constraint.rA, constraint.normal);
+            const auto rnB = Cross(constraint.rB, constraint.normal);
+            constraint.normalMass = 1.0F / (bodyA.invMass + bodyB.invMass + bodyA.invInertia * rnA * rnA + bodyB.invInertia * rnB * rnB);
+            const auto rtA = Cross(constraint.rA, tangent);
+            const auto rtB = Cross(constraint.rB, tangent);
+            constraint.tangentMass = 1.0F / (bodyA.invMass + bodyB.invMass + bodyA.invInertia * rtA * rtA + bodyB.invInertia * rtB * rtB);
+
+            // Pushes overlapping bodies apart over a few ticks, and bounces fast hits
+            constraint.bias = kBaumgarte / aDeltaTime * std::max(0.0F, constraint.depth - kAllowedPenetration);
+            const auto normalVelocity = glm::dot(getRelativeVelocity(constraint), constraint.normal);
+            if (normalVelocity < -kRestitutionThreshold)
+            {
+                constraint.bias = std::max(constraint.bias, -constraint.restitution * normalVelocity);
+            }
+
+            applyImpulse(constraint, constraint.normal * constraint.normalImpulse + tangent * constraint.tangentImpulse);
+        }
+
+        for (int iteration = 0; iteration < mIterations; ++iteration)
+        {
+            for (auto it = constraintsBegin; it != constraintsEnd; ++it)
+            {
+                auto &constraint = mConstraints[*it];
+                const glm::vec2 tangent{constraint.normal.y, -constraint.normal.x};
+
+                // Friction first, bounded by the normal impulse of the previous pass
+                const auto maxFriction = constraint.friction * constraint.normalImpulse;
+                const auto tangentImpulse = std::clamp(constraint.tangentImpulse - constraint.tangentMass * glm::dot(getRelativeVelocity(constraint), tangent), -maxFriction, maxFriction);
+                applyImpulse(constraint, tangent * (tangentImpulse - constraint.tangentImpulse));
+                constraint.tangentImpulse = tangentImpulse;
+
+                const auto normalImpulse = std::max(constraint.normalImpulse + constraint.normalMass * (constraint.bias - glm::dot(getRelativeVelocity(constraint), constraint.normal)), 0.0F);
+                applyImpulse(constraint, constraint.normal * (normalImpulse - constraint.normalImpulse));
+                constraint.normalImpulse = normalImpulse;
+            }
+        }
+
+        float minSleepTime = std::numeric_limits<float>::max();
+        for (auto it = bodiesBegin; it != bodiesEnd; ++it)
+        {
+            auto &body = mBodies[*it];
+            body.position += body.velocity * aDeltaTime;
+            body.angle += body.angularVelocity * aDeltaTime;
+
+            const bool still = glm::dot(body.velocity, body.velocity) <= kSleepLinearVelocity * kSleepLinearVelocity &&
+                               body.angularVelocity * body.angularVelocity <= kSleepAngularVelocity * kSleepAngularVelocity;
+            body.sleepTime = still ? body.sleepTime + aDeltaTime : 0.0F;
+            minSleepTime = std::min(minSleepTime, body.sleepTime);
+        }
+
+        const bool asleep = mSleepEnabled && minSleepTime >= kTimeToSleep;
+        for (auto it = bodiesBegin; it != bodiesEnd; ++it)
+        {
+            auto &body = mBodies[*it];
+            body.awake = !asleep;
+            if (asleep)
+            {
+                body.velocity = {0.0F, 0.0F};
+                body.angularVelocity = 0.0F;
+            }
+        }
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,144 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_PHYSICSSYSTEM_HPP
+#define NABLA2D_PHYSICSSYSTEM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "jobsystem.hpp"
+#include "collisionsystem.hpp"
+
+namespace nabla2d
+{
+    // Sequential impulse solver for RigidBody entities, fed by the contacts of CollisionSystem.
+    // Bodies touching each other are grouped into islands, solved in chunks over the job
+    // system. Islands don't share dynamic bodies so the result doesn't depend on the number of
+    // workers, and everything is visited in entity and contact order for a given registry.
+    // Islands that stay still long enough fall asleep and are skipped until something touches them.
+    class PhysicsSystem
+    {
+    public:
+        explicit PhysicsSystem(JobSystem &aJobSystem);
+        PhysicsSystem(const PhysicsSystem &aPhysicsSystem) = delete;
+        PhysicsSystem &operator=(const PhysicsSystem &aPhysicsSystem) = delete;
+        ~PhysicsSystem() = default;
+
+        const glm::vec2 &GetGravity() const;
+        void SetGravity(const glm::vec2 &aGravity);
+        int GetIterations() const;
+        void SetIterations(int aIterations);
+        bool IsSleepEnabled() const;
+        void SetSleepEnabled(bool aEnabled);
+
+        // Call once per fixed tick, after aCollisionSystem was updated with the current poses.
+        // Writes the new velocities to RigidBody and the new poses to Transform2D.
+        void Step(Scene &aScene, const CollisionSystem &aCollisionSystem, float aDeltaTime);
+        void Clear();
+
+        std::size_t GetBodyCount() const;
+        std::size_t GetIslandCount() const;
+        std::size_t GetAwakeIslandCount() const;
+
+    private:
+        static constexpr uint32_t kStatic = 0xFFFFFFFFU;
+        static constexpr std::size_t kGrainSize = 8;
+        static constexpr float kBaumgarte = 0.2F;
+        static constexpr float kAllowedPenetration = 0.01F;
+        static constexpr float kRestitutionThreshold = 1.0F;
+        static constexpr float kSleepLinearVelocity = 0.05F;
+        static constexpr float kSleepAngularVelocity = 0.05F;
+        static constexpr float kTimeToSleep = 0.5F;
+
+        struct Body
+        {
+            entt::entity entity;
+            glm::vec2 position;
+            float angle;
+            glm::vec2 velocity;
+            float angularVelocity;
+            float invMass;
+            float invInertia;
+            float gravityScale;
+            float sleepTime;
+            bool awake;
+        };
+
+        // Bodies are kStatic when they don't move
+        struct Constraint
+        {
+            uint64_t key;
+            uint32_t a;
+            uint32_t b;
+            glm::vec2 normal;
+            glm::vec2 rA;
+            glm::vec2 rB;
+            float depth;
+            float friction;
+            float restitution;
+            float normalMass;
+            float tangentMass;
+            float bias;
+            float normalImpulse;
+            float tangentImpulse;
+        };
+
+        struct CachedImpulse
+        {
+            uint64_t key;
+            float normal;
+            float tangent;
+        };
+
+        JobSystem &mJobSystem;
+        glm::vec2 mGravity{0.0F, -9.81F};
+        int mIterations{8};
+        bool mSleepEnabled{true};
+
+        std::vector<Body> mBodies;
+        std::vector<uint32_t> mSparse;
+        std::vector<Constraint> mConstraints;
+        std::vector<CachedImpulse> mCache;
+
+        std::vector<uint32_t> mParents;
+        std::vector<uint32_t> mIslandBodies;
+        std::vector<uint32_t> mIslandBodyOffsets;
+        std::vector<uint32_t> mIslandConstraints;
+        std::vector<uint32_t> mIslandConstraintOffsets;
+        std::vector<uint8_t> mIslandAwake;
+        std::size_t mAwakeIslandCount{0};
+
+        uint32_t GetBody(entt::entity aEntity) const;
+        uint32_t FindRoot(uint32_t aBody);
+        void GatherBodies(Scene &aScene);
+        void BuildConstraints(const entt::registry &aRegistry, const std::vector<CollisionSystem::Contact> &aContacts);
+        void BuildIslands();
+        void SolveIsland(std::size_t aIsland, float aDeltaTime);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_PHYSICSSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,117 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_PLUGINAPI_HPP
+#define NABLA2D_PLUGINAPI_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "input.hpp"
+#include "camera.hpp"
+#include "stringid.hpp"
+#include "renderer/renderer.hpp"
+
+#if defined(_WIN32)
+#define NABLA2D_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define NABLA2D_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// Entry points of a gameplay plugin, all exported with NABLA2D_PLUGIN_EXPORT:
+//   uint32_t nabla2d_plugin_version()
+//       returns kPluginAPIVersion, libraries built against another version are not loaded
+//   bool nabla2d_plugin_load(const PluginAPI *aAPI, const std::vector<uint8_t> *aState)
+//       aState is what the previous build of the plugin saved, or nullptr on the first load
+//   void nabla2d_plugin_update(const PluginAPI *aAPI, float aDeltaTime)
+//       called every fixed tick
+//   void nabla2d_plugin_unload(const PluginAPI *aAPI, std::vector<uint8_t> *aState)
+//       saves the plugin state in aState before a reload, or is given nullptr when the plugin
+//       goes away for good (it should then destroy what it created)
+namespace nabla2d
+{
+    // Bumped whenever PluginAPI, PluginData or the engine types they expose change layout
+    static constexpr uint32_t kPluginAPIVersion = 1;
+
+    // What the host gives to plugins. Input goes through functions because its state lives in
+    // the statics of the host, which a plugin can't reach on every platform.
+    struct PluginAPI
+    {
+        uint32_t version;
+        // Name of the plugin (its file name without extension), and id of its PluginData storage
+        StringID name;
+        Scene *scene;
+        Renderer *renderer;
+        Camera *camera;
+        bool (*keyDown)(Input::Key aKey);
+        bool (*keyUp)(Input::Key aKey);
+        bool (*keyHeld)(Input::Key aKey);
+        const glm::vec2 &(*getAxis)(Input::Axis aAxis);
+        glm::vec2 (*getMousePos)();
+    };
+
+    // Per-entity state of a plugin, kept in the registry across reloads. A component type
+    // defined by the plugin itself would leave its storage code behind when the library is
+    // unloaded, so plugins store their trivially copyable state in this one instead.
+    struct PluginData
+    {
+        static constexpr std::size_t kSize = 64;
+
+        alignas(16) std::array<uint8_t, kSize> bytes{};
+
+        template <typename T>
+        T Get() const
+        {
+            static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= kSize, "PluginData holds up to 64 bytes of trivially copyable data");
+            T value;
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void Set(const T &aValue)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= kSize, "PluginData holds up to 64 bytes of trivially copyable data");
+            std::memcpy(bytes.data(), &aValue, sizeof(T));
+        }
+    };
+
+    // Every plugin has its own PluginData storage, created by the host before the plugin is loaded
+    inline entt::storage_for_t<PluginData> &GetPluginData(const PluginAPI &aAPI)
+    {
+        return aAPI.scene->GetRegistry().storage<PluginData>(aAPI.name.GetValue());
+    }
+
+    typedef uint32_t (*PluginVersionFunction)();
+    typedef bool (*PluginLoadFunction)(const PluginAPI *aAPI, const std::vector<uint8_t> *aState);
+    typedef void (*PluginUpdateFunction)(const PluginAPI *aAPI, float aDeltaTime);
+    typedef void (*PluginUnloadFunction)(const PluginAPI *aAPI, std::vector<uint8_t> *aState);
+} // namespace nabla2d
+
+#endif // NABLA2D_PLUGINAPI_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,306 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "pluginhost.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <SDL2/SDL.h>
+#include <fmt/format.h>
+
+#include "logger.hpp"
+#include "components.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        // Saved plugin states, by plugin name
+        struct PluginStates
+        {
+            std::unordered_map<StringID, std::vector<uint8_t>> states;
+        };
+
+        // A storage belongs to the code that created it, one first touched by a plugin would
+        // point into the library once it is unloaded. So the host creates them all up front.
+        template <typename... T>
+        void CreateStorages(entt::registry &aRegistry)
+        {
+            (static_cast<void>(aRegistry.storage<T>()), ...);
+        }
+
+        template <typename T>
+        bool LoadFunction(void *aHandle, const char *aName, T &aFunction)
+        {
+            aFunction = reinterpret_cast<T>(SDL_LoadFunction(aHandle, aName));
+            return aFunction != nullptr;
+        }
+    } // namespace
+
+    PluginHost::PluginHost(Scene &aScene, Camera &aCamera) : mScene(aScene),
+                                                             mCamera(aCamera)
+    {
+        CreateStorages<Transform, Transform2D, WorldTransform, PreviousTransform, PreviousTransform2D, Bounds,
+                       SpriteRenderer, BoxCollider, CircleCollider, RigidBody, FlowAgent>(mScene.GetRegistry());
+    }
+
+    PluginHost::~PluginHost()
+    {
+        Destroy();
+    }
+
+    void PluginHost::Init(std::shared_ptr<Renderer> aRenderer)
+    {
+        mRenderer = aRenderer;
+        for (auto &plugin : mPlugins)
+        {
+            plugin->api.renderer = mRenderer.get();
+        }
+    }
+
+    void PluginHost::Destroy()
+    {
+        while (!mPlugins.empty())
+        {
+            Unload(mPlugins.back()->path.string());
+        }
+    }
+
+    bool PluginHost::Load(const std::string &aPath)
+    {
+        const std::filesystem::path path(aPath);
+        if (std::any_of(mPlugins.begin(), mPlugins.end(), [&](const std::unique_ptr<Plugin> &aPlugin)
+                        { return aPlugin->path == path; }))
+        {
+            Logger::error("PluginHost::Load: '{}' is already loaded", aPath);
+            return false;
+        }
+
+        std::error_code error;
+        auto plugin = std::make_unique<Plugin>();
+        plugin->path = path;
+        plugin->writeTime = std::filesystem::last_write_time(path, error);
+        plugin->pendingWriteTime = plugin->writeTime;
+        if (error)
+        {
+            Logger::error("PluginHost::Load: Cannot open '{}': {}", aPath, error.message());
+            return false;
+        }
+
+        const auto name = StringID::Intern(path.stem().string());
+        plugin->api = {kPluginAPIVersion, name, &mScene, mRenderer.get(), &mCamera,
+                       &Input::KeyDown, &Input::KeyUp, &Input::KeyHeld, &Input::GetAxis, &Input::GetMousePos};
+        mScene.GetRegistry().storage<PluginData>(name.GetValue());
+
+        if (!Open(path, plugin->library))
+        {
+            return false;
+        }
+        if (!plugin->library.load(&plugin->api, nullptr))
+        {
+            Logger::error("PluginHost::Load: '{}' failed to start", aPath);
+            Close(plugin->library);
+            return false;
+        }
+
+        Logger::info("Loaded plugin '{}'", aPath);
+        mPlugins.push_back(std::move(plugin));
+        return true;
+    }
+
+    bool PluginHost::Unload(const std::string &aPath)
+    {
+        const std::filesystem::path path(aPath);
+        const auto it = std::find_if(mPlugins.begin(), mPlugins.end(), [&](const std::unique_ptr<Plugin> &aPlugin)
+                                     { return aPlugin->path == path; });
+        if (it == mPlugins.end())
+        {
+            Logger::error("PluginHost::Unload: '{}' isn't loaded", aPath);
+            return false;
+        }
+
+        auto &plugin = **it;
+        if (plugin.library.handle != nullptr)
+        {
+            plugin.library.unload(&plugin.api, nullptr);
+            Close(plugin.library);
+        }
+
+        auto &registry = mScene.GetRegistry();
+        registry.storage<PluginData>(plugin.api.name.GetValue()).clear();
+        if (auto *states = registry.ctx().find<PluginStates>(); states != nullptr)
+        {
+            states->states.erase(plugin.api.name);
+        }
+
+        Logger::info("Unloaded plugin '{}'", aPath);
+        mPlugins.erase(it);
+        return true;
+    }
+
+    void PluginHost::Update(float aDeltaTime)
+    {
+        mPollTimer += aDeltaTime;
+        if (mPollTimer >= kPollInterval)
+        {
+            mPollTimer = 0.0F;
+            for (auto &plugin : mPlugins)
+            {
+                std::error_code error;
+                const auto writeTime = std::filesystem::last_write_time(plugin->path, error);
+                if (error || writeTime == plugin->writeTime)
+                {
+                    continue;
+                }
+
+                if (writeTime == plugin->pendingWriteTime)
+                {
+                    Reload(*plugin);
+                }
+                else
+                {
+                    plugin->pendingWriteTime = writeTime;
+                }
+            }
+        }
+
+        for (auto &plugin : mPlugins)
+        {
+            if (plugin->library.handle != nullptr)
+            {
+                plugin->library.update(&plugin->api, aDeltaTime);
+            }
+        }
+    }
+
+    std::size_t PluginHost::GetPluginCount() const
+    {
+        return mPlugins.size();
+    }
+
+    std::size_t PluginHost::GetReloadCount() const
+    {
+        return mReloadCount;
+    }
+
+    bool PluginHost::Open(const std::filesystem::path &aPath, Library &aLibrary)
+    {
+        // Some platforms lock loaded libraries, others hand back the same library for a path
+        // that was already opened, so every build is opened from its own copy
+        std::error_code error;
+        const auto stamp = std::chrono::system_clock::now().time_since_epoch().count();
+        aLibrary.copy = std::filesystem::temp_directory_path(error) /
+                        fmt::format("{}-{}-{}{}", aPath.stem().string(), stamp, mCopyCount++, aPath.extension().string());
+        if (error || !std::filesystem::copy_file(aPath, aLibrary.copy, std::filesystem::copy_options::overwrite_existing, error))
+        {
+            Logger::error("PluginHost::Open: Cannot copy '{}': {}", aPath.string(), error.message());
+            aLibrary = {};
+            return false;
+        }
+
+        aLibrary.handle = SDL_LoadObject(aLibrary.copy.string().c_str());
+        if (aLibrary.handle == nullptr)
+        {
+            Logger::error("PluginHost::Open: Cannot load '{}': {}", aPath.string(), SDL_GetError());
+            Close(aLibrary);
+            return false;
+        }
+
+        PluginVersionFunction version = nullptr;
+        if (!LoadFunction(aLibrary.handle, "nabla2d_plugin_version", version) ||
+            !LoadFunction(aLibrary.handle, "nabla2d_plugin_load", aLibrary.load) ||
+            !LoadFunction(aLibrary.handle, "nabla2d_plugin_update", aLibrary.update) ||
+            !LoadFunction(aLibrary.handle, "nabla2d_plugin_unload", aLibrary.unload))
+        {
+            Logger::error("PluginHost::Open: '{}' doesn't export the plugin entry points", aPath.string());
+            Close(aLibrary);
+            return false;
+        }
+        if (version() != kPluginAPIVersion)
+        {
+            Logger::error("PluginHost::Open: '{}' was built for plugin API {}, expected {}", aPath.string(), version(), kPluginAPIVersion);
+            Close(aLibrary);
+            return false;
+        }
+        return true;
+    }
+
+    void PluginHost::Close(Library &aLibrary)
+    {
+        if (aLibrary.handle != nullptr)
+        {
+            SDL_UnloadObject(aLibrary.handle);
+        }
+        if (!aLibrary.copy.empty())
+        {
+            std::error_code error;
+            std::filesystem::remove(aLibrary.copy, error);
+        }
+        aLibrary = {};
+    }
+
+    // A broken build leaves the previous one running. If the new build fails to start, the
+    // plugin stays stopped with its state saved until the next change to the file.
+    void PluginHost::Reload(Plugin &aPlugin)
+    {
+        aPlugin.writeTime = aPlugin.pendingWriteTime;
+
+        Library library;
+        if (!Open(aPlugin.path, library))
+        {
+            Logger::warn("Keeping the previous build of plugin '{}'", aPlugin.path.string());
+            return;
+        }
+
+        auto &state = GetState(aPlugin.api.name);
+        if (aPlugin.library.handle != nullptr)
+        {
+            state.clear();
+            aPlugin.library.unload(&aPlugin.api, &state);
+            Close(aPlugin.library);
+        }
+
+        aPlugin.library = library;
+        if (!aPlugin.library.load(&aPlugin.api, &state))
+        {
+            Logger::error("PluginHost::Reload: '{}' failed to start", aPlugin.path.string());
+            Close(aPlugin.library);
+            return;
+        }
+
+        ++mReloadCount;
+        Logger::info("Reloaded plugin '{}' ({} bytes of state)", aPlugin.path.string(), state.size());
+    }
+
+    std::vector<uint8_t> &PluginHost::GetState(StringID aName)
+    {
+        auto &context = mScene.GetRegistry().ctx();
+        auto *states = context.find<PluginStates>();
+        if (states == nullptr)
+        {
+            states = &context.emplace<PluginStates>();
+        }
+        return states->states[aName];
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
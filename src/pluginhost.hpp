@@ -0,0 +1,105 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_PLUGINHOST_HPP
+#define NABLA2D_PLUGINHOST_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include "scene.hpp"
+#include "camera.hpp"
+#include "pluginapi.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // Loads native gameplay plugins (shared libraries exporting the entry points described in
+    // pluginapi.hpp) and reloads them when their file changes. Libraries are opened from a copy
+    // so they can be rebuilt while loaded. On reload the new build is opened first, and the old
+    // one only saves its state and goes away once the new one is known to be valid. The state
+    // is kept in the registry context, per-entity state in the plugin's PluginData storage.
+    class PluginHost
+    {
+    public:
+        PluginHost(Scene &aScene, Camera &aCamera);
+        PluginHost(const PluginHost &aPluginHost) = delete;
+        PluginHost &operator=(const PluginHost &aPluginHost) = delete;
+        ~PluginHost();
+
+        void Init(std::shared_ptr<Renderer> aRenderer);
+        // Unloads every plugin for good
+        void Destroy();
+
+        bool Load(const std::string &aPath);
+        bool Unload(const std::string &aPath);
+
+        // Reloads the libraries that changed since the last check, then updates every plugin
+        void Update(float aDeltaTime);
+
+        std::size_t GetPluginCount() const;
+        std::size_t GetReloadCount() const;
+
+    private:
+        // How often the files are checked, a change is only picked up once the file stopped
+        // changing for one interval so a library still being written isn't opened
+        static constexpr float kPollInterval = 0.5F;
+
+        struct Library
+        {
+            void *handle{nullptr};
+            std::filesystem::path copy;
+            PluginLoadFunction load{nullptr};
+            PluginUpdateFunction update{nullptr};
+            PluginUnloadFunction unload{nullptr};
+        };
+
+        struct Plugin
+        {
+            std::filesystem::path path;
+            std::filesystem::file_time_type writeTime;
+            std::filesystem::file_time_type pendingWriteTime;
+            Library library;
+            PluginAPI api;
+        };
+
+        Scene &mScene;
+        Camera &mCamera;
+        std::shared_ptr<Renderer> mRenderer;
+        // Plugins keep a pointer to their PluginAPI, so they don't move
+        std::vector<std::unique_ptr<Plugin>> mPlugins;
+        float mPollTimer{0.0F};
+        std::size_t mReloadCount{0};
+        uint32_t mCopyCount{0};
+
+        bool Open(const std::filesystem::path &aPath, Library &aLibrary);
+        static void Close(Library &aLibrary);
+        void Reload(Plugin &aPlugin);
+        std::vector<uint8_t> &GetState(StringID aName);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_PLUGINHOST_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,86 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "prefab.hpp"
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    uint32_t Prefab::AddEntity(uint32_t aParent)
+    {
+        if (aParent != kNoParent && aParent >= mParents.size())
+        {
+            Logger::error("Prefab::AddEntity: Parent #{} does not exist, adding entity at the root", aParent);
+            aParent = kNoParent;
+        }
+
+        mParents.push_back(aParent);
+        return static_cast<uint32_t>(mParents.size() - 1);
+    }
+
+    std::size_t Prefab::GetEntityCount() const
+    {
+        return mParents.size();
+    }
+
+    std::vector<entt::entity> Prefab::Instantiate(Scene &aScene, std::size_t aCount, entt::entity aParent) const
+    {
+        const auto templateCount = mParents.size();
+        const auto totalCount = templateCount * aCount;
+        if (totalCount == 0)
+        {
+            return {};
+        }
+
+        std::vector<StringID> tags(totalCount);
+        std::vector<uint32_t> parents(totalCount);
+        for (std::size_t j = 0; j < templateCount; ++j)
+        {
+            for (std::size_t i = 0; i < aCount; ++i)
+            {
+                parents[j * aCount + i] = mParents[j] == kNoParent ? kNoParent : static_cast<uint32_t>(mParents[j] * aCount + i);
+            }
+        }
+
+        auto entities = aScene.CreateEntities(tags, parents, aParent);
+        if (entities.size() != totalCount)
+        {
+            Logger::error("Prefab::Instantiate: Failed to create {} instances", aCount);
+            return {};
+        }
+
+        auto &registry = aScene.GetRegistry();
+        for (const auto &pool : mPools)
+        {
+            pool->Instantiate(registry, entities, aCount);
+        }
+
+        return entities;
+    }
+
+    void Prefab::LogInvalidEntity(uint32_t aEntity)
+    {
+        Logger::error("Prefab::AddComponent: Entity #{} does not exist", aEntity);
+    }
+
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,117 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_PREFAB_HPP
+#define NABLA2D_PREFAB_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <typeindex>
+#include <unordered_map>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+
+namespace nabla2d
+{
+    // Flat template of entities (parent indices) and their components.
+    // Components are copied as-is into every instance, so assets referenced
+    // by handle or pointer are shared rather than loaded again.
+    class Prefab
+    {
+    public:
+        static constexpr uint32_t kNoParent = Scene::kNoParent;
+
+        Prefab() = default;
+        Prefab(Prefab &&aPrefab) = default;
+        Prefab &operator=(Prefab &&aPrefab) = default;
+        ~Prefab() = default;
+
+        uint32_t AddEntity(uint32_t aParent = kNoParent);
+        std::size_t GetEntityCount() const;
+
+        // Adding a component the entity already has replaces its value
+        template <typename T>
+        void AddComponent(uint32_t aEntity, const T &aComponent)
+        {
+            if (aEntity >= mParents.size())
+            {
+                LogInvalidEntity(aEntity);
+                return;
+            }
+
+            auto pool = mPoolIndices.find(typeid(T));
+            if (pool == mPoolIndices.end())
+            {
+                pool = mPoolIndices.emplace(typeid(T), mPools.size()).first;
+                mPools.push_back(std::make_unique<ComponentPool<T>>());
+            }
+
+            auto &typedPool = static_cast<ComponentPool<T> &>(*mPools[pool->second]);
+            const auto existing = std::find(typedPool.entities.begin(), typedPool.entities.end(), aEntity);
+            if (existing != typedPool.entities.end())
+            {
+                typedPool.components[static_cast<std::size_t>(existing - typedPool.entities.begin())] = aComponent;
+                return;
+            }
+            typedPool.entities.push_back(aEntity);
+            typedPool.components.push_back(aComponent);
+        }
+
+        // Creates aCount copies of the prefab in one batch. The result is laid out
+        // template-major: entity j of instance i is at index j * aCount + i.
+        std::vector<entt::entity> Instantiate(Scene &aScene, std::size_t aCount = 1, entt::entity aParent = entt::null) const;
+
+    private:
+        struct ComponentPoolBase
+        {
+            virtual ~ComponentPoolBase() = default;
+            virtual void Instantiate(entt::registry &aRegistry, const std::vector<entt::entity> &aEntities, std::size_t aCount) const = 0;
+        };
+
+        template <typename T>
+        struct ComponentPool : public ComponentPoolBase
+        {
+            std::vector<uint32_t> entities;
+            std::vector<T> components;
+
+            void Instantiate(entt::registry &aRegistry, const std::vector<entt::entity> &aEntities, std::size_t aCount) const override
+            {
+                for (std::size_t i = 0; i < entities.size(); ++i)
+                {
+                    const auto first = aEntities.begin() + static_cast<std::ptrdiff_t>(entities[i] * aCount);
+                    aRegistry.insert<T>(first, first + static_cast<std::ptrdiff_t>(aCount), components[i]);
+                }
+            }
+        };
+
+        std::vector<uint32_t> mParents;
+        std::vector<std::unique_ptr<ComponentPoolBase>> mPools;
+        std::unordered_map<std::type_index, std::size_t> mPoolIndices;
+
+        static void LogInvalidEntity(uint32_t aEntity);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_PREFAB_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,333 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "nullrenderer.hpp"
+
+#include <stb_image.h>
+
+#include "../../logger.hpp"
+
+namespace nabla2d
+{
+    NullRenderer::NullRenderer(const std::pair<int, int> &aSize) : mWidth(aSize.first),
+                                                                   mHeight(aSize.second)
+    {
+        Logger::info("Null Renderer initialized");
+    }
+
+    int NullRenderer::GetWidth() const
+    {
+        return mWidth;
+    }
+
+    int NullRenderer::GetHeight() const
+    {
+        return mHeight;
+    }
+
+    float NullRenderer::GetAspectRatio() const
+    {
+        return static_cast<float>(mWidth) / static_cast<float>(mHeight);
+    }
+
+    const std::string &NullRenderer::GetRendererInfo() const
+    {
+        return mRendererInfo;
+    }
+
+    bool NullRenderer::PollWindowEvents()
+    {
+        return true;
+    }
+
+    void NullRenderer::SetMouseCapture(bool /*aCapture*/)
+    {
+    }
+
+    void NullRenderer::SetInputEnabled(bool /*aEnabled*/)
+    {
+    }
+
+    bool NullRenderer::HasBeenResized() const
+    {
+        return false;
+    }
+
+    void NullRenderer::Clear()
+    {
+        mFrameStats = FrameStats{0, 0, 0, 0, 0};
+    }
+
+    void NullRenderer::Render()
+    {
+    }
+
+    const Renderer::FrameStats &NullRenderer::GetFrameStats() const
+    {
+        return mFrameStats;
+    }
+
+    Renderer::DataHandle NullRenderer::LoadDataInternal(std::size_t aVertexCount, std::size_t aIndexCount)
+    {
+        const auto handle = mNextHandle++;
+        mData[handle] = aIndexCount > 0 ? aIndexCount : aVertexCount;
+        ++mFrameStats.dataUploads;
+        return handle;
+    }
+
+    Renderer::DataHandle NullRenderer::LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData)
+    {
+        return LoadDataInternal(aData.size(), 0);
+    }
+
+    Renderer::DataHandle NullRenderer::LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices)
+    {
+        return LoadDataInternal(aData.size(), aIndices.size());
+    }
+
+    Renderer::DataHandle NullRenderer::LoadDataDynamic(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData)
+    {
+        return LoadDataInternal(aData.size(), 0);
+    }
+
+    Renderer::DataHandle NullRenderer::LoadDataDynamic(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices)
+    {
+        return LoadDataInternal(aData.size(), aIndices.size());
+    }
+
+    Renderer::DataHandle NullRenderer::LoadDataLines(const std::vector<glm::vec3> &aPoints, const std::vector<unsigned int> &aIndices)
+    {
+        return LoadDataInternal(aPoints.size(), aIndices.size());
+    }
+
+    void NullRenderer::UpdateData(DataHandle aHandle, const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices)
+    {
+        auto data = mData.find(aHandle);
+        if (data == mData.end())
+        {
+            Logger::warn("Tried to update data #{}, which does not exist", aHandle);
+            return;
+        }
+
+        data->second = aIndices.empty() ? aVertices.size() / 5 : aIndices.size();
+        ++mFrameStats.dataUploads;
+    }
+
+    void NullRenderer::DeleteData(DataHandle aHandle)
+    {
+        if (mData.erase(aHandle) == 0)
+        {
+            Logger::warn("Tried to delete data #{}, which does not exist", aHandle);
+        }
+    }
+
+    void NullRenderer::DrawData(DataHandle aHandle, const Camera &aCamera, const glm::mat4 &aTransform, const DrawParameters & /*aDrawParameters*/)
+    {
+        auto data = mData.find(aHandle);
+        if (data == mData.end())
+        {
+            Logger::warn("Tried to draw data #{}, which does not exist", aHandle);
+            return;
+        }
+
+        mLastModelViewProjection = aCamera.GetProjectionViewMatrix() * aTransform;
+        ++mFrameStats.drawCalls;
+        mFrameStats.elements += data->second;
+    }
+
+    void NullRenderer::DrawInstances(DataHandle aHandle, TextureHandle aTexture, const Camera &aCamera, const Instance *aInstances, std::size_t aCount)
+    {
+        auto data = mData.find(aHandle);
+        if (data == mData.end())
+        {
+            Logger::warn("Tried to draw data #{}, which does not exist", aHandle);
+            return;
+        }
+
+        if (mTextures.find(aTexture) == mTextures.end())
+        {
+            Logger::warn("Tried to draw data #{} with texture #{}, which does not exist", aHandle, aTexture);
+            return;
+        }
+
+        mCurrentTexture = aTexture;
+        ++mFrameStats.textureBinds;
+
+        // Like the GL backend, one upload and one draw call per batch
+        if (aCount > 0)
+        {
+            mLastModelViewProjection = aCamera.GetProjectionViewMatrix() * aInstances[aCount - 1].transform;
+            ++mFrameStats.dataUploads;
+            ++mFrameStats.drawCalls;
+        }
+        mFrameStats.elements += data->second * aCount;
+    }
+
+    Renderer::ShaderHandle NullRenderer::LoadShader(const std::string & /*aVertexPath*/, const std::string & /*aFragmentPath*/)
+    {
+        const auto handle = mNextHandle++;
+        mShaders.insert(handle);
+        return handle;
+    }
+
+    void NullRenderer::DeleteShader(ShaderHandle aHandle)
+    {
+        if (mShaders.erase(aHandle) == 0)
+        {
+            Logger::warn("Tried to delete shader #{}, which does not exist", aHandle);
+            return;
+        }
+
+        if (mCurrentShader == aHandle)
+        {
+            mCurrentShader = 0;
+        }
+    }
+
+    void NullRenderer::UseShader(ShaderHandle aHandle)
+    {
+        if (mShaders.find(aHandle) == mShaders.end())
+        {
+            Logger::error("Shader #{} does not exist, it can not be used", aHandle);
+            return;
+        }
+
+        mCurrentShader = aHandle;
+        ++mFrameStats.shaderBinds;
+    }
+
+    Renderer::TextureHandle NullRenderer::LoadTexture(const std::string &aPath, Renderer::TextureFilter /*aFilter*/)
+    {
+        // Only the header is read, sprites still get the right atlas coordinates
+        TextureInfo info{0, 0, 0};
+        if (stbi_info(aPath.c_str(), &info.width, &info.height, &info.channels) == 0)
+        {
+            Logger::error("Failed to load texture: {}", aPath);
+            return 0;
+        }
+
+        const auto handle = mNextHandle++;
+        mTextures[handle] = info;
+        return handle;
+    }
+
+    void NullRenderer::DeleteTexture(TextureHandle aHandle)
+    {
+        if (mTextures.erase(aHandle) == 0)
+        {
+            Logger::warn("Tried to delete texture #{}, which does not exist", aHandle);
+            return;
+        }
+
+        if (mCurrentTexture == aHandle)
+        {
+            mCurrentTexture = 0;
+        }
+    }
+
+    void NullRenderer::UseTexture(TextureHandle aHandle)
+    {
+        if (mTextures.find(aHandle) == mTextures.end())
+        {
+            Logger::error("Texture #{} does not exist, it can not be used", aHandle);
+            return;
+        }
+
+        mCurrentTexture = aHandle;
+        ++mFrameStats.textureBinds;
+    }
+
+    Renderer::TextureInfo NullRenderer::GetTextureInfo(TextureHandle aHandle)
+    {
+        auto texture = mTextures.find(aHandle);
+        if (texture == mTextures.end())
+        {
+            Logger::error("Texture #{} does not exist", aHandle);
+            return {0, 0, 0};
+        }
+        return texture->second;
+    }
+
+    Renderer::TextureHandle NullRenderer::LoadDataTexture(int aWidth, int aHeight, const std::vector<uint32_t> &aData)
+    {
+        if (aWidth <= 0 || aHeight <= 0 || aData.size() < static_cast<std::size_t>(aWidth) * static_cast<std::size_t>(aHeight))
+        {
+            Logger::error("Failed to load data texture: {} values for {}x{} texels", aData.size(), aWidth, aHeight);
+            return 0;
+        }
+
+        const auto handle = mNextHandle++;
+        mTextures[handle] = {aWidth, aHeight, 1};
+        ++mFrameStats.dataUploads;
+        return handle;
+    }
+
+    void NullRenderer::UpdateDataTexture(TextureHandle aHandle, int aX, int aY, int aWidth, int aHeight, const std::vector<uint32_t> &aData)
+    {
+        auto texture = mTextures.find(aHandle);
+        if (texture == mTextures.end() || texture->second.channels != 1)
+        {
+            Logger::warn("Tried to update data texture #{}, which does not exist", aHandle);
+            return;
+        }
+
+        const auto &info = texture->second;
+        if (aX < 0 || aY < 0 || aWidth <= 0 || aHeight <= 0 || aX + aWidth > info.width || aY + aHeight > info.height ||
+            aData.size() < static_cast<std::size_t>(aWidth) * static_cast<std::size_t>(aHeight))
+        {
+            Logger::warn("Tried to update data texture #{} out of its bounds", aHandle);
+            return;
+        }
+        ++mFrameStats.dataUploads;
+    }
+
+    void NullRenderer::BindTexture(TextureHandle aHandle, int /*aUnit*/)
+    {
+        if (mTextures.find(aHandle) == mTextures.end())
+        {
+            Logger::error("Texture #{} does not exist, it can not be bound", aHandle);
+            return;
+        }
+        ++mFrameStats.textureBinds;
+    }
+
+    void NullRenderer::SetUniform(const std::string & /*aName*/, int /*aValue*/)
+    {
+    }
+
+    void NullRenderer::SetUniform(const std::string & /*aName*/, float /*aValue*/)
+    {
+    }
+
+    void NullRenderer::SetUniform(const std::string & /*aName*/, const glm::vec2 & /*aValue*/)
+    {
+    }
+
+    void NullRenderer::SetUniform(const std::string & /*aName*/, const glm::vec4 & /*aValue*/)
+    {
+    }
+
+    const glm::mat4 &NullRenderer::GetLastModelViewProjection() const
+    {
+        return mLastModelViewProjection;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,106 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_NULLRENDERER_HPP
+#define NABLA2D_NULLRENDERER_HPP
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../renderer.hpp"
+
+namespace nabla2d
+{
+    // Renderer without a window or GPU context. Resources are tracked by handle and draws
+    // do the CPU side of the work (handle lookup, MVP), which makes it suitable for
+    // benchmarks and headless runs.
+    class NullRenderer : public Renderer
+    {
+    public:
+        explicit NullRenderer(const std::pair<int, int> &aSize);
+        ~NullRenderer() override = default;
+
+        int GetWidth() const override;
+        int GetHeight() const override;
+        float GetAspectRatio() const override;
+        const std::string &GetRendererInfo() const override;
+
+        bool PollWindowEvents() override;
+        void SetMouseCapture(bool aCapture) override;
+        void SetInputEnabled(bool aEnabled) override;
+        bool HasBeenResized() const override;
+
+        void Clear() override;
+        void Render() override;
+        const FrameStats &GetFrameStats() const override;
+
+        DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData) override;
+        DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices) override;
+        DataHandle LoadDataDynamic(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData) override;
+        DataHandle LoadDataDynamic(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices) override;
+        DataHandle LoadDataLines(const std::vector<glm::vec3> &aPoints, const std::vector<unsigned int> &aIndices) override;
+        void UpdateData(DataHandle aHandle, const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices) override;
+        void DeleteData(DataHandle aHandle) override;
+        void DrawData(DataHandle aHandle, const Camera &aCamera, const glm::mat4 &aTransform, const DrawParameters &aDrawParameters) override;
+        void DrawInstances(DataHandle aHandle, TextureHandle aTexture, const Camera &aCamera, const Instance *aInstances, std::size_t aCount) override;
+
+        ShaderHandle LoadShader(const std::string &aVertexPath, const std::string &aFragmentPath) override;
+        void DeleteShader(ShaderHandle aHandle) override;
+        void UseShader(ShaderHandle aHandle) override;
+
+        TextureHandle LoadTexture(const std::string &aPath, Renderer::TextureFilter aFilter) override;
+        void DeleteTexture(TextureHandle aHandle) override;
+        void UseTexture(TextureHandle aHandle) override;
+        TextureInfo GetTextureInfo(TextureHandle aHandle) override;
+        TextureHandle LoadDataTexture(int aWidth, int aHeight, const std::vector<uint32_t> &aData) override;
+        void UpdateDataTexture(TextureHandle aHandle, int aX, int aY, int aWidth, int aHeight, const std::vector<uint32_t> &aData) override;
+        void BindTexture(TextureHandle aHandle, int aUnit) override;
+
+        void SetUniform(const std::string &aName, int aValue) override;
+        void SetUniform(const std::string &aName, float aValue) override;
+        void SetUniform(const std::string &aName, const glm::vec2 &aValue) override;
+        void SetUniform(const std::string &aName, const glm::vec4 &aValue) override;
+
+        const glm::mat4 &GetLastModelViewProjection() const;
+
+    private:
+        DataHandle LoadDataInternal(std::size_t aVertexCount, std::size_t aIndexCount);
+
+        int mWidth;
+        int mHeight;
+        std::string mRendererInfo{"Null"};
+        FrameStats mFrameStats{0, 0, 0, 0, 0};
+
+        uint64_t mNextHandle{1};
+        std::unordered_map<DataHandle, std::size_t> mData{};
+        std::unordered_set<ShaderHandle> mShaders{};
+        std::unordered_map<TextureHandle, TextureInfo> mTextures{};
+
+        ShaderHandle mCurrentShader{0};
+        TextureHandle mCurrentTexture{0};
+        glm::mat4 mLastModelViewProjection{1.0F};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_NULLRENDERER_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -130,6 +130,16 @@ namespace nabla2d
         return mColorLocation;
     }
 
+    GLint GLShader::GetUniformLocation(const std::string &aName)
+    {
+        auto location = mUniformLocations.find(aName);
+        if (location == mUniformLocations.end())
+        {
+            location = mUniformLocations.emplace(aName, glGetUniformLocation(mProgram, aName.c_str())).first;
+        }
+        return location->second;
+    }
+
 } // namespace nabla2d
 
 // くコ:彡
\ No newline at end of file
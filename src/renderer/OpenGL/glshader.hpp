@@ -22,6 +22,7 @@
 #define NABLA2D_GLSHADER_HPP
 
 #include <string>
+#include <unordered_map>
 #include <GL/glew.h>
 
 namespace nabla2d
@@ -37,6 +38,8 @@ namespace nabla2d
         GLint GetTextureLocation() const;
         GLint GetAtlasInfoLocation() const;
         GLint GetColorLocation() const;
+        // Location of any other uniform, -1 if the program doesn't use it
+        GLint GetUniformLocation(const std::string &aName);
 
     private:
         GLuint mProgram{0};
@@ -44,6 +47,7 @@ namespace nabla2d
         GLint mTextureLocation{0};
         GLint mAtlasInfoLocation{0};
         GLint mColorLocation{0};
+        std::unordered_map<std::string, GLint> mUniformLocations;
     };
 } // namespace nabla2d
 
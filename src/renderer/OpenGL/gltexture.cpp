@@ -78,11 +78,35 @@ namespace nabla2d
         glBindTexture(GL_TEXTURE_2D, 0);
     }
 
+    GLTexture::GLTexture(int aWidth, int aHeight, const uint32_t *aData) : mWidth(aWidth), mHeight(aHeight), mChannels(1)
+    {
+        glGenTextures(1, &mTexture);
+        glBindTexture(GL_TEXTURE_2D, mTexture);
+
+        // Integer textures can't be filtered
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, mWidth, mHeight, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, aData);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
     GLTexture::~GLTexture()
     {
         glDeleteTextures(1, &mTexture);
     }
 
+    void GLTexture::Update(int aX, int aY, int aWidth, int aHeight, const uint32_t *aData)
+    {
+        glBindTexture(GL_TEXTURE_2D, mTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, aX, aY, aWidth, aHeight, GL_RED_INTEGER, GL_UNSIGNED_INT, aData);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
     int GLTexture::GetWidth() const
     {
         return mWidth;
@@ -22,6 +22,7 @@
 #define NABLA2D_GLTEXTURE_HPP
 
 #include <string>
+#include <cstdint>
 #include <GL/glew.h>
 
 namespace nabla2d
@@ -40,8 +41,13 @@ namespace nabla2d
         } GLTextureFilter;
 
         GLTexture(const std::string &aPath, GLTextureFilter aFilter);
+        // Single channel GL_R32UI texture, always sampled with GL_NEAREST
+        GLTexture(int aWidth, int aHeight, const uint32_t *aData);
         ~GLTexture();
 
+        // Only for textures created from data
+        void Update(int aX, int aY, int aWidth, int aHeight, const uint32_t *aData);
+
         int GetWidth() const;
         int GetHeight() const;
         int GetChannels() const;
@@ -21,6 +21,7 @@
 #include "sdlglrenderer.hpp"
 
 #include <array>
+#include <cstddef>
 #include <algorithm>
 #include <stdexcept>
 #include <glm/glm.hpp>
@@ -36,6 +37,39 @@
 
 namespace nabla2d
 {
+    namespace
+    {
+        // DrawInstances' program, the sprite shader with the transform and the atlas rectangle
+        // read from the instance buffer
+        const char *const kInstanceVertexShader = R"(
+        #version 330 core
+        uniform mat4 u_ProjectionViewMatrix;
+        layout (location = 0) in vec3 a_Position;
+        layout (location = 1) in vec2 a_TexCoord;
+        layout (location = 2) in mat4 a_Transform;
+        layout (location = 6) in vec4 a_AtlasInfo;
+        out vec2 v_TexCoord;
+        void main()
+        {
+            gl_Position = u_ProjectionViewMatrix * a_Transform * vec4(a_Position, 1.0);
+            v_TexCoord = a_TexCoord * a_AtlasInfo.zw + a_AtlasInfo.xy;
+        }
+        )";
+
+        const char *const kInstanceFragmentShader = R"(
+        #version 330 core
+        uniform sampler2D u_Texture;
+        in vec2 v_TexCoord;
+        out vec4 FragColor;
+        void main()
+        {
+            FragColor = texture(u_Texture, v_TexCoord);
+        }
+        )";
+
+        constexpr GLuint kTransformAttribute = 2;
+        constexpr GLuint kAtlasInfoAttribute = 6;
+    } // namespace
 
     SDLGLRenderer::SDLGLRenderer(const std::string &aTitle, const std::pair<int, int> &aSize) : mWidth(aSize.first),
                                                                                                 mHeight(aSize.second),
@@ -110,6 +144,11 @@ namespace nabla2d
 
         ImGui_ImplSDL2_InitForOpenGL(mWindow, mGLContext);
         ImGui_ImplOpenGL3_Init("#version 330");
+
+        // Instanced sprites
+        mInstanceShader = std::make_unique<GLShader>(kInstanceVertexShader, kInstanceFragmentShader);
+        mProjectionViewLocation = mInstanceShader->GetUniformLocation("u_ProjectionViewMatrix");
+        glGenBuffers(1, &mInstanceVBO);
     }
 
     SDLGLRenderer::~SDLGLRenderer()
@@ -120,6 +159,8 @@ namespace nabla2d
         mData.clear();
         mShaders.clear();
         mTextures.clear();
+        mInstanceShader = nullptr;
+        glDeleteBuffers(1, &mInstanceVBO);
 
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL2_Shutdown();
@@ -257,8 +298,11 @@ namespace nabla2d
             }
         }
 
-        const uint8_t *keys = SDL_GetKeyboardState(nullptr);
-        UpdateInput(keys, mouseScroll);
+        if (mInputEnabled)
+        {
+            const uint8_t *keys = SDL_GetKeyboardState(nullptr);
+            UpdateInput(keys, mouseScroll);
+        }
 
         return true;
     }
@@ -277,6 +321,11 @@ namespace nabla2d
         mMouseCapured = aCapture;
     }
 
+    void SDLGLRenderer::SetInputEnabled(bool aEnabled)
+    {
+        mInputEnabled = aEnabled;
+    }
+
     bool SDLGLRenderer::HasBeenResized() const
     {
         return mResized;
@@ -287,6 +336,7 @@ namespace nabla2d
         glViewport(0, 0, mWidth, mHeight);
         glClearColor(0.5F, 0.5F, 0.5F, 1.0F);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        mFrameStats = FrameStats{0, 0, 0, 0, 0};
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL2_NewFrame(mWindow);
@@ -300,12 +350,18 @@ namespace nabla2d
         SDL_GL_SwapWindow(mWindow);
     }
 
+    const Renderer::FrameStats &SDLGLRenderer::GetFrameStats() const
+    {
+        return mFrameStats;
+    }
+
     Renderer::DataHandle SDLGLRenderer::LoadDataInternal(const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices, GLenum aDrawMode, GLenum aDrawUsage)
     {
         try
         {
             auto data = std::make_shared<GLData>(aVertices, aIndices, aDrawMode, aDrawUsage);
             mData[data->GetVAO()] = data;
+            ++mFrameStats.dataUploads;
             return data->GetVAO();
         }
         catch (std::runtime_error &e)
@@ -385,6 +441,7 @@ namespace nabla2d
         }
 
         data->second->ChangeData(aVertices, aIndices);
+        ++mFrameStats.dataUploads;
     }
 
     void SDLGLRenderer::DeleteData(DataHandle aHandle)
@@ -454,6 +511,8 @@ namespace nabla2d
         {
             glDrawArrays(mode, 0, data->second->GetSize());
         }
+        ++mFrameStats.drawCalls;
+        mFrameStats.elements += data->second->GetSize();
 
         if (mode == GL_LINES)
         {
@@ -464,6 +523,80 @@ namespace nabla2d
         glBindVertexArray(0);
     }
 
+    void SDLGLRenderer::DrawInstances(DataHandle aHandle, TextureHandle aTexture, const Camera &aCamera, const Instance *aInstances, std::size_t aCount)
+    {
+        auto data = mData.find(aHandle);
+        if (data == mData.end())
+        {
+            Logger::warn("Tried to draw data #{}, which does not exist", aHandle);
+            return;
+        }
+
+        auto texture = mTextures.find(aTexture);
+        if (texture == mTextures.end())
+        {
+            Logger::warn("Tried to draw data #{} with texture #{}, which does not exist", aHandle, aTexture);
+            return;
+        }
+
+        if (aCount == 0)
+        {
+            return;
+        }
+
+        // Orphans the previous contents instead of waiting for the draws still reading them
+        const auto instanceSize = static_cast<GLsizeiptr>(sizeof(Instance));
+        glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+        mInstanceCapacity = std::max(mInstanceCapacity, aCount);
+        glBufferData(GL_ARRAY_BUFFER, instanceSize * static_cast<GLsizeiptr>(mInstanceCapacity), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instanceSize * static_cast<GLsizeiptr>(aCount), aInstances);
+        ++mFrameStats.dataUploads;
+
+        // The instance attributes are only enabled for this draw, the data keeps its own layout
+        glBindVertexArray(data->second->GetVAO());
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(kTransformAttribute + column);
+            glVertexAttribPointer(kTransformAttribute + column, 4, GL_FLOAT, GL_FALSE, instanceSize, reinterpret_cast<const void *>(offsetof(Instance, transform) + sizeof(glm::vec4) * column));
+            glVertexAttribDivisor(kTransformAttribute + column, 1);
+        }
+        glEnableVertexAttribArray(kAtlasInfoAttribute);
+        glVertexAttribPointer(kAtlasInfoAttribute, 4, GL_FLOAT, GL_FALSE, instanceSize, reinterpret_cast<const void *>(offsetof(Instance, atlasInfo)));
+        glVertexAttribDivisor(kAtlasInfoAttribute, 1);
+
+        glUseProgram(mInstanceShader->GetProgram());
+        glUniformMatrix4fv(mProjectionViewLocation, 1, GL_FALSE, glm::value_ptr(aCamera.GetProjectionViewMatrix()));
+        mCurrentTexture = texture->second;
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mCurrentTexture->GetTexture());
+        glUniform1i(mInstanceShader->GetTextureLocation(), 0);
+        ++mFrameStats.textureBinds;
+
+        const auto mode = data->second->GetMode();
+        const auto size = static_cast<GLsizei>(data->second->GetSize());
+        const auto instances = static_cast<GLsizei>(aCount);
+        if (data->second->GetEBO() != 0)
+        {
+            glDrawElementsInstanced(mode, size, GL_UNSIGNED_INT, 0, instances);
+        }
+        else
+        {
+            glDrawArraysInstanced(mode, 0, size, instances);
+        }
+        ++mFrameStats.drawCalls;
+        mFrameStats.elements += static_cast<uint64_t>(size) * aCount;
+
+        for (GLuint attribute = kTransformAttribute; attribute <= kAtlasInfoAttribute; ++attribute)
+        {
+            glVertexAttribDivisor(attribute, 0);
+            glDisableVertexAttribArray(attribute);
+        }
+        glUseProgram(mCurrentShader != nullptr ? mCurrentShader->GetProgram() : 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     Renderer::ShaderHandle SDLGLRenderer::LoadShader(const std::string &aVertexPath, const std::string &aFragmentPath)
     {
         try
@@ -507,6 +640,7 @@ namespace nabla2d
 
         mCurrentShader = shader->second;
         glUseProgram(mCurrentShader->GetProgram());
+        ++mFrameStats.shaderBinds;
     }
 
     Renderer::TextureHandle SDLGLRenderer::LoadTexture(const std::string &aPath, Renderer::TextureFilter aFilter)
@@ -578,6 +712,7 @@ namespace nabla2d
 
         mCurrentTexture = texture->second;
         glBindTexture(GL_TEXTURE_2D, mCurrentTexture->GetTexture());
+        ++mFrameStats.textureBinds;
     }
 
     Renderer::TextureInfo SDLGLRenderer::GetTextureInfo(TextureHandle aHandle)
@@ -592,6 +727,96 @@ namespace nabla2d
         return {texture->second->GetWidth(), texture->second->GetHeight(), texture->second->GetChannels()};
     }
 
+    Renderer::TextureHandle SDLGLRenderer::LoadDataTexture(int aWidth, int aHeight, const std::vector<uint32_t> &aData)
+    {
+        if (aWidth <= 0 || aHeight <= 0 || aData.size() < static_cast<std::size_t>(aWidth) * static_cast<std::size_t>(aHeight))
+        {
+            Logger::error("Failed to load data texture: {} values for {}x{} texels", aData.size(), aWidth, aHeight);
+            return 0;
+        }
+
+        auto texture = std::make_shared<GLTexture>(aWidth, aHeight, aData.data());
+        mTextures[texture->GetTexture()] = texture;
+        ++mFrameStats.dataUploads;
+        return texture->GetTexture();
+    }
+
+    void SDLGLRenderer::UpdateDataTexture(TextureHandle aHandle, int aX, int aY, int aWidth, int aHeight, const std::vector<uint32_t> &aData)
+    {
+        auto texture = mTextures.find(aHandle);
+        if (texture == mTextures.end() || texture->second->GetChannels() != 1)
+        {
+            Logger::warn("Tried to update data texture #{}, which does not exist", aHandle);
+            return;
+        }
+
+        const auto &glTexture = texture->second;
+        if (aX < 0 || aY < 0 || aWidth <= 0 || aHeight <= 0 || aX + aWidth > glTexture->GetWidth() || aY + aHeight > glTexture->GetHeight() ||
+            aData.size() < static_cast<std::size_t>(aWidth) * static_cast<std::size_t>(aHeight))
+        {
+            Logger::warn("Tried to update data texture #{} out of its bounds", aHandle);
+            return;
+        }
+
+        glTexture->Update(aX, aY, aWidth, aHeight, aData.data());
+        ++mFrameStats.dataUploads;
+    }
+
+    void SDLGLRenderer::BindTexture(TextureHandle aHandle, int aUnit)
+    {
+        auto texture = mTextures.find(aHandle);
+        if (texture == mTextures.end())
+        {
+            Logger::error("Texture #{} does not exist, it can not be bound", aHandle);
+            return;
+        }
+
+        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(aUnit));
+        glBindTexture(GL_TEXTURE_2D, texture->second->GetTexture());
+        glActiveTexture(GL_TEXTURE0);
+        ++mFrameStats.textureBinds;
+    }
+
+    void SDLGLRenderer::SetUniform(const std::string &aName, int aValue)
+    {
+        if (mCurrentShader == nullptr)
+        {
+            Logger::warn("Tried to set uniform '{}', but no shader is set", aName);
+            return;
+        }
+        glUniform1i(mCurrentShader->GetUniformLocation(aName), aValue);
+    }
+
+    void SDLGLRenderer::SetUniform(const std::string &aName, float aValue)
+    {
+        if (mCurrentShader == nullptr)
+        {
+            Logger::warn("Tried to set uniform '{}', but no shader is set", aName);
+            return;
+        }
+        glUniform1f(mCurrentShader->GetUniformLocation(aName), aValue);
+    }
+
+    void SDLGLRenderer::SetUniform(const std::string &aName, const glm::vec2 &aValue)
+    {
+        if (mCurrentShader == nullptr)
+        {
+            Logger::warn("Tried to set uniform '{}', but no shader is set", aName);
+            return;
+        }
+        glUniform2fv(mCurrentShader->GetUniformLocation(aName), 1, glm::value_ptr(aValue));
+    }
+
+    void SDLGLRenderer::SetUniform(const std::string &aName, const glm::vec4 &aValue)
+    {
+        if (mCurrentShader == nullptr)
+        {
+            Logger::warn("Tried to set uniform '{}', but no shader is set", aName);
+            return;
+        }
+        glUniform4fv(mCurrentShader->GetUniformLocation(aName), 1, glm::value_ptr(aValue));
+    }
+
 } // namespace nabla2d
 
 // くコ:彡
\ No newline at end of file
@@ -50,10 +50,12 @@ namespace nabla2d
 
         bool PollWindowEvents() override;
         void SetMouseCapture(bool aCapture) override;
+        void SetInputEnabled(bool aEnabled) override;
         bool HasBeenResized() const override;
 
         void Clear() override;
         void Render() override;
+        const FrameStats &GetFrameStats() const override;
 
         DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData) override;
         DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices) override;
@@ -63,6 +65,7 @@ namespace nabla2d
         void UpdateData(DataHandle aHandle, const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices) override;
         void DeleteData(DataHandle aHandle) override;
         void DrawData(DataHandle aHandle, const Camera &aCamera, const glm::mat4 &aTransform, const DrawParameters &aDrawParameters) override;
+        void DrawInstances(DataHandle aHandle, TextureHandle aTexture, const Camera &aCamera, const Instance *aInstances, std::size_t aCount) override;
 
         ShaderHandle LoadShader(const std::string &aVertexPath, const std::string &aFragmentPath) override;
         void DeleteShader(ShaderHandle aHandle) override;
@@ -72,6 +75,14 @@ namespace nabla2d
         void DeleteTexture(TextureHandle aHandle) override;
         void UseTexture(TextureHandle aHandle) override;
         TextureInfo GetTextureInfo(TextureHandle aHandle) override;
+        TextureHandle LoadDataTexture(int aWidth, int aHeight, const std::vector<uint32_t> &aData) override;
+        void UpdateDataTexture(TextureHandle aHandle, int aX, int aY, int aWidth, int aHeight, const std::vector<uint32_t> &aData) override;
+        void BindTexture(TextureHandle aHandle, int aUnit) override;
+
+        void SetUniform(const std::string &aName, int aValue) override;
+        void SetUniform(const std::string &aName, float aValue) override;
+        void SetUniform(const std::string &aName, const glm::vec2 &aValue) override;
+        void SetUniform(const std::string &aName, const glm::vec4 &aValue) override;
 
     private:
         DataHandle LoadDataInternal(const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices, GLenum aDrawMode, GLenum aDrawUsage);
@@ -80,6 +91,7 @@ namespace nabla2d
         int mHeight;
         std::string mRendererInfo;
         bool mResized{false};
+        FrameStats mFrameStats{0, 0, 0, 0, 0};
 
         std::shared_ptr<GLShader> mCurrentShader;
         std::shared_ptr<GLTexture> mCurrentTexture;
@@ -88,6 +100,12 @@ namespace nabla2d
         std::unordered_map<ShaderHandle, std::shared_ptr<GLShader>> mShaders{};
         std::unordered_map<TextureHandle, std::shared_ptr<GLTexture>> mTextures{};
 
+        // DrawInstances' program and per-instance buffer, grown to the largest batch
+        std::unique_ptr<GLShader> mInstanceShader;
+        GLint mProjectionViewLocation{-1};
+        GLuint mInstanceVBO{0};
+        std::size_t mInstanceCapacity{0};
+
         SDL_Window *mWindow;
         SDL_GLContext mGLContext;
 
@@ -97,6 +115,7 @@ namespace nabla2d
         void UpdateInput(const uint8_t *aKeys, float aMouseScroll);
         bool mMouseButtons[3]{false, false, false};
         bool mMouseCapured{false};
+        bool mInputEnabled{true};
     };
 } // namespace nabla2d
 
@@ -20,11 +20,16 @@
 
 #include "renderer.hpp"
 #include "SDL/sdlglrenderer.hpp"
+#include "Null/nullrenderer.hpp"
 
 namespace nabla2d
 {
-    Renderer *Renderer::Create(const std::string &aTitle, const std::pair<int, int> &aSize)
+    Renderer *Renderer::Create(const std::string &aTitle, const std::pair<int, int> &aSize, Backend aBackend)
     {
+        if (aBackend == BACKEND_NULL)
+        {
+            return new NullRenderer(aSize);
+        }
         return new SDLGLRenderer(aTitle, aSize);
     }
 } // namespace nabla2d
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <glm/glm.hpp>
 
@@ -37,6 +38,12 @@ namespace nabla2d
         typedef uint64_t ShaderHandle;
         typedef uint64_t TextureHandle;
 
+        typedef enum
+        {
+            BACKEND_SDLGL,
+            BACKEND_NULL // No window or GPU, for benchmarks and headless runs
+        } Backend;
+
         typedef enum
         {
             NEAREST,
@@ -61,9 +68,26 @@ namespace nabla2d
             float lineWidth = 0.0F;
         } DrawParameters;
 
+        // One copy of some data, drawn by DrawInstances
+        typedef struct
+        {
+            glm::mat4 transform;
+            glm::vec4 atlasInfo;
+        } Instance;
+
+        // Counters for the current frame, reset by Clear()
+        typedef struct
+        {
+            uint64_t drawCalls;
+            uint64_t elements;
+            uint64_t shaderBinds;
+            uint64_t textureBinds;
+            uint64_t dataUploads;
+        } FrameStats;
+
         virtual ~Renderer() = default;
 
-        static Renderer *Create(const std::string &aTitle, const std::pair<int, int> &aSize);
+        static Renderer *Create(const std::string &aTitle, const std::pair<int, int> &aSize, Backend aBackend = BACKEND_SDLGL);
 
         virtual int GetWidth() const = 0;
         virtual int GetHeight() const = 0;
@@ -72,10 +96,13 @@ namespace nabla2d
 
         virtual bool PollWindowEvents() = 0;
         virtual void SetMouseCapture(bool aCapture) = 0;
+        // When disabled, PollWindowEvents leaves Input alone (e.g. while replaying recorded input)
+        virtual void SetInputEnabled(bool aEnabled) = 0;
         virtual bool HasBeenResized() const = 0;
 
         virtual void Clear() = 0;
         virtual void Render() = 0;
+        virtual const FrameStats &GetFrameStats() const = 0;
 
         virtual DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData) = 0;
         virtual DataHandle LoadData(const std::vector<std::pair<glm::vec3, glm::vec2>> &aData, const std::vector<unsigned int> &aIndices) = 0;
@@ -85,6 +112,9 @@ namespace nabla2d
         virtual void UpdateData(DataHandle aHandle, const std::vector<float> &aVertices, const std::vector<unsigned int> &aIndices) = 0;
         virtual void DeleteData(DataHandle aHandle) = 0;
         virtual void DrawData(DataHandle aHandle, const Camera &aCamera, const glm::mat4 &aTransform, const DrawParameters &aDrawParameters) = 0;
+        // Draws aCount instances of the same data and texture as one instanced draw call, with a built-in
+        // textured shader applying each instance's transform and atlas rectangle. Leaves the current shader in use.
+        virtual void DrawInstances(DataHandle aHandle, TextureHandle aTexture, const Camera &aCamera, const Instance *aInstances, std::size_t aCount) = 0;
 
         virtual ShaderHandle LoadShader(const std::string &aVertexPath, const std::string &aFragmentPath) = 0;
         virtual void DeleteShader(ShaderHandle aHandle) = 0;
@@ -94,6 +124,17 @@ namespace nabla2d
         virtual void DeleteTexture(TextureHandle aHandle) = 0;
         virtual void UseTexture(TextureHandle aHandle) = 0;
         virtual TextureInfo GetTextureInfo(TextureHandle aHandle) = 0;
+        // Single channel 32 bits unsigned integer texture, for shaders reading raw values with texelFetch
+        virtual TextureHandle LoadDataTexture(int aWidth, int aHeight, const std::vector<uint32_t> &aData) = 0;
+        virtual void UpdateDataTexture(TextureHandle aHandle, int aX, int aY, int aWidth, int aHeight, const std::vector<uint32_t> &aData) = 0;
+        // Binds a texture to another unit than the one DrawData uses (0), for shaders with several samplers
+        virtual void BindTexture(TextureHandle aHandle, int aUnit) = 0;
+
+        // Uniforms of the current shader
+        virtual void SetUniform(const std::string &aName, int aValue) = 0;
+        virtual void SetUniform(const std::string &aName, float aValue) = 0;
+        virtual void SetUniform(const std::string &aName, const glm::vec2 &aValue) = 0;
+        virtual void SetUniform(const std::string &aName, const glm::vec4 &aValue) = 0;
 
         // TODO : Define a way to get the "error" handle, don't hardcode it to 0 everywhere
     };
@@ -0,0 +1,68 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "rendersystem.hpp"
+
+#include <tuple>
+#include <glm/gtx/transform.hpp>
+
+#include "components.hpp"
+
+namespace nabla2d
+{
+    void RenderSystem::Draw(Scene &aScene, Renderer &aRenderer, const Camera &aCamera)
+    {
+        auto group = aScene.GetRegistry().group<SpriteRenderer, WorldTransform>();
+
+        // Nearly sorted from one frame to the next, insertion sort is close to a single pass
+        group.sort<SpriteRenderer>([](const SpriteRenderer &aLhs, const SpriteRenderer &aRhs)
+                                   { return std::tie(aLhs.texture, aLhs.data) < std::tie(aRhs.texture, aRhs.data); },
+                                   entt::insertion_sort{});
+
+        mInstances.clear();
+        mInstances.reserve(group.size());
+
+        Renderer::TextureHandle texture{0};
+        Renderer::DataHandle data{0};
+        std::size_t batchStart = 0;
+        const auto flush = [&]()
+        {
+            if (mInstances.size() > batchStart)
+            {
+                aRenderer.DrawInstances(data, texture, aCamera, mInstances.data() + batchStart, mInstances.size() - batchStart);
+            }
+            batchStart = mInstances.size();
+        };
+
+        group.each([&](const SpriteRenderer &aSprite, const WorldTransform &aWorldTransform)
+                   {
+                       if (aSprite.texture != texture || aSprite.data != data)
+                       {
+                           flush();
+                           texture = aSprite.texture;
+                           data = aSprite.data;
+                       }
+                       mInstances.push_back({glm::scale(aWorldTransform.matrix, {aSprite.size.x, aSprite.size.y, 1.0F}), aSprite.atlasInfo}); });
+        flush();
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,51 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_RENDERSYSTEM_HPP
+#define NABLA2D_RENDERSYSTEM_HPP
+
+#include <vector>
+
+#include "scene.hpp"
+#include "camera.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    class RenderSystem
+    {
+    public:
+        RenderSystem() = default;
+        ~RenderSystem() = default;
+
+        // Draws every entity with a SpriteRenderer and a WorldTransform. The entities are kept
+        // sorted by texture in an owning group, so each texture is one instanced draw call
+        // over contiguous components.
+        void Draw(Scene &aScene, Renderer &aRenderer, const Camera &aCamera);
+
+    private:
+        std::vector<Renderer::Instance> mInstances;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_RENDERSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #include "scene.hpp"
 
+#include <unordered_set>
 #include <fmt/format.h>
 #include "logger.hpp"
 
@@ -27,11 +28,7 @@ namespace nabla2d
 {
     Scene::Scene()
     {
-        mTags[mRootTag] = entt::null;
-        mReverseTags[entt::null] = mRootTag;
-
-        mParents[entt::null] = entt::null;
-        mChildren[entt::null] = {};
+        Clear();
     }
 
     entt::entity Scene::CreateEntity(const std::string &aTag, entt::entity aParent)
@@ -41,24 +38,80 @@ namespace nabla2d
             Logger::error("Cannot create entity with reserved tag '{}'!", aTag);
             return entt::null;
         }
-        if (mTags.find(aTag) != mTags.end())
+        const auto tag = StringID::Intern(aTag);
+        if (mTags.find(tag) != mTags.end())
         {
             Logger::error("Cannot create entity with the tag '{}', one with the same tag alread exists!", aTag);
             return entt::null;
         }
 
         auto entity = mRegistry.create();
-        mTags[aTag] = entity;
-        mReverseTags[entity] = aTag;
+        mTags[tag] = entity;
+        mReverseTags[entity] = tag;
         mParents[entity] = aParent;
         mChildren[aParent].push_back(entity);
         mChildren[entity] = {};
 
-        BuildEntityTree();
+        mEntityTreeDirty = true;
 
         return entity;
     }
 
+    std::vector<entt::entity> Scene::CreateEntities(const std::vector<StringID> &aTags, const std::vector<uint32_t> &aParents, entt::entity aParent)
+    {
+        if (aTags.size() != aParents.size())
+        {
+            Logger::error("Cannot create entities, got {} tags for {} parents!", aTags.size(), aParents.size());
+            return {};
+        }
+
+        const auto count = aTags.size();
+        std::unordered_set<StringID> batchTags;
+        batchTags.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (aTags[i].IsValid() && (mTags.find(aTags[i]) != mTags.end() || !batchTags.insert(aTags[i]).second))
+            {
+                Logger::error("Cannot create entity with the tag '{}', one with the same tag alread exists!", aTags[i].GetString());
+                return {};
+            }
+            if (aParents[i] != kNoParent && aParents[i] >= count)
+            {
+                Logger::error("Cannot create entity '{}', its parent index {} is out of range!", aTags[i].GetString(), aParents[i]);
+                return {};
+            }
+        }
+
+        std::vector<entt::entity> entities(count);
+        mRegistry.create(entities.begin(), entities.end());
+
+        mTags.reserve(mTags.size() + count);
+        mReverseTags.reserve(mReverseTags.size() + count);
+        mParents.reserve(mParents.size() + count);
+        mChildren.reserve(mChildren.size() + count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (aTags[i].IsValid())
+            {
+                mTags[aTags[i]] = entities[i];
+            }
+            mReverseTags[entities[i]] = aTags[i];
+            mChildren[entities[i]] = {};
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto parent = aParents[i] == kNoParent ? aParent : entities[aParents[i]];
+            mParents[entities[i]] = parent;
+            mChildren[parent].push_back(entities[i]);
+        }
+
+        mEntityTreeDirty = true;
+
+        return entities;
+    }
+
     void Scene::DestroyEntity(entt::entity aEntity)
     {
         if (aEntity == entt::null)
@@ -84,11 +137,98 @@ namespace nabla2d
 
         mRegistry.destroy(aEntity);
         const auto tag = mReverseTags.at(aEntity);
-        mTags.erase(tag);
+        if (tag.IsValid())
+        {
+            mTags.erase(tag);
+        }
         mReverseTags.erase(aEntity);
         mParents.erase(aEntity);
+        mChildren.erase(aEntity);
 
-        BuildEntityTree();
+        mEntityTreeDirty = true;
+    }
+
+    void Scene::DestroyEntities(const std::vector<entt::entity> &aEntities)
+    {
+        // Destroyed in the order given, the set only answers membership
+        std::vector<entt::entity> entities;
+        std::unordered_set<entt::entity> destroyed;
+        entities.reserve(aEntities.size());
+        destroyed.reserve(aEntities.size());
+        std::size_t invalid = 0;
+        for (auto entity : aEntities)
+        {
+            if (entity == entt::null || mParents.find(entity) == mParents.end())
+            {
+                ++invalid;
+            }
+            else if (destroyed.insert(entity).second)
+            {
+                entities.push_back(entity);
+            }
+        }
+        if (invalid > 0)
+        {
+            Logger::error("Cannot delete {} of the {} entities, they don't appear to be valid!", invalid, aEntities.size());
+        }
+
+        for (auto entity : entities)
+        {
+            auto parent = mParents.at(entity);
+            if (destroyed.find(parent) == destroyed.end())
+            {
+                auto &parentChildren = mChildren.at(parent);
+                parentChildren.erase(std::remove(parentChildren.begin(), parentChildren.end(), entity), parentChildren.end());
+            }
+
+            for (auto child : mChildren.at(entity))
+            {
+                if (destroyed.find(child) != destroyed.end())
+                {
+                    continue;
+                }
+                while (destroyed.find(parent) != destroyed.end())
+                {
+                    parent = mParents.at(parent);
+                }
+                mParents[child] = parent;
+                mChildren.at(parent).push_back(child);
+            }
+        }
+
+        for (auto entity : entities)
+        {
+            const auto tag = mReverseTags.at(entity);
+            if (tag.IsValid())
+            {
+                mTags.erase(tag);
+            }
+            mReverseTags.erase(entity);
+            mParents.erase(entity);
+            mChildren.erase(entity);
+        }
+
+        mRegistry.destroy(entities.begin(), entities.end());
+
+        mEntityTreeDirty = true;
+    }
+
+    void Scene::Clear()
+    {
+        mRegistry.clear();
+        mTags.clear();
+        mReverseTags.clear();
+        mParents.clear();
+        mChildren.clear();
+
+        const auto rootTag = StringID::Intern(mRootTag);
+        mTags[rootTag] = entt::null;
+        mReverseTags[entt::null] = rootTag;
+
+        mParents[entt::null] = entt::null;
+        mChildren[entt::null] = {};
+
+        mEntityTreeDirty = true;
     }
 
     bool Scene::IsEntityTagValid(const std::string &aTag, std::string &aReason) const
@@ -104,7 +244,7 @@ namespace nabla2d
             aReason = fmt::format("'{}' is a reserved tag!", aTag);
             return false;
         }
-        if (mTags.find(aTag) != mTags.end())
+        if (mTags.find(StringID(aTag)) != mTags.end())
         {
             aReason = fmt::format("'{}' already exists!", aTag);
             return false;
@@ -125,17 +265,22 @@ namespace nabla2d
         return true;
     }
 
+    entt::registry &Scene::GetRegistry()
+    {
+        return mRegistry;
+    }
+
     const entt::registry &Scene::GetRegistry() const
     {
         return mRegistry;
     }
 
-    entt::entity Scene::GetEntity(const std::string &aTag) const
+    entt::entity Scene::GetEntity(StringID aTag) const
     {
         auto entity = mTags.find(aTag);
         if (entity == mTags.end())
         {
-            Logger::error("No entity with the tag '{}' exists!", aTag);
+            Logger::error("No entity with the tag '{}' exists!", aTag.GetString());
             return entt::null;
         }
         return entity->second;
@@ -149,6 +294,21 @@ namespace nabla2d
             Logger::error("No entity with the specified id exists!");
             return mErrorTag;
         }
+        if (!tag->second.IsValid())
+        {
+            return mErrorTag;
+        }
+        return tag->second.GetString();
+    }
+
+    StringID Scene::GetTagID(entt::entity aEntity) const
+    {
+        auto tag = mReverseTags.find(aEntity);
+        if (tag == mReverseTags.end())
+        {
+            Logger::error("No entity with the specified id exists!");
+            return StringID();
+        }
         return tag->second;
     }
 
@@ -179,28 +339,44 @@ namespace nabla2d
         parent = aParent;
         mChildren[aParent].push_back(aEntity);
 
-        BuildEntityTree();
+        mEntityTreeDirty = true;
+    }
+
+    const std::vector<entt::entity> &Scene::GetChildren(entt::entity aEntity) const
+    {
+        auto children = mChildren.find(aEntity);
+        if (children == mChildren.end())
+        {
+            Logger::error("No entity with the specified id exists!");
+            return mNoChildren;
+        }
+        return children->second;
     }
 
     const Scene::EntityTree &Scene::GetEntityTree() const
     {
+        if (mEntityTreeDirty)
+        {
+            BuildEntityTree();
+        }
         return mEntityTree;
     }
 
-    void Scene::BuildEntityTree()
+    void Scene::BuildEntityTree() const
     {
         mEntityTree = {};
         BuildEntityTreeRecursive(mEntityTree, entt::null);
+        mEntityTreeDirty = false;
     }
 
-    void Scene::BuildEntityTreeRecursive(EntityNode &aNode, entt::entity aEntity)
+    void Scene::BuildEntityTreeRecursive(EntityNode &aNode, entt::entity aEntity) const
     {
         aNode.entity = aEntity;
-        for (auto child : mChildren.at(aEntity))
+        const auto &children = mChildren.at(aEntity);
+        aNode.children.resize(children.size());
+        for (std::size_t i = 0; i < children.size(); ++i)
         {
-            EntityNode childNode;
-            BuildEntityTreeRecursive(childNode, child);
-            aNode.children.push_back(childNode);
+            BuildEntityTreeRecursive(aNode.children[i], children[i]);
         }
     }
 
@@ -23,9 +23,12 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <unordered_map>
 #include <entt/entt.hpp>
 
+#include "stringid.hpp"
+
 namespace nabla2d
 {
     class Scene
@@ -38,37 +41,49 @@ namespace nabla2d
         };
         typedef EntityNode EntityTree;
 
+        static constexpr uint32_t kNoParent = 0xFFFFFFFFU;
+
         Scene();
         ~Scene() = default;
 
         entt::entity CreateEntity(const std::string &aTag, entt::entity aParent = entt::null);
+        // Entities with an invalid StringID are anonymous and can't be looked up by tag
+        std::vector<entt::entity> CreateEntities(const std::vector<StringID> &aTags, const std::vector<uint32_t> &aParents, entt::entity aParent = entt::null);
         void DestroyEntity(entt::entity aEntity);
+        // Children of destroyed entities that aren't destroyed themselves move up to the first surviving ancestor
+        void DestroyEntities(const std::vector<entt::entity> &aEntities);
+        void Clear();
 
         bool IsEntityTagValid(const std::string &aTag, std::string &aReason) const;
 
+        entt::registry &GetRegistry();
         const entt::registry &GetRegistry() const;
-        entt::entity GetEntity(const std::string &aTag) const;
+        entt::entity GetEntity(StringID aTag) const;
         const std::string &GetTag(entt::entity aEntity) const;
+        StringID GetTagID(entt::entity aEntity) const;
 
         entt::entity GetParent(entt::entity aEntity) const;
         void SetParent(entt::entity aEntity, entt::entity aParent);
+        const std::vector<entt::entity> &GetChildren(entt::entity aEntity) const;
 
         const EntityTree &GetEntityTree() const;
 
     private:
         const std::string mErrorTag{""};
         const std::string mRootTag{"Root"};
+        const std::vector<entt::entity> mNoChildren{};
 
         entt::registry mRegistry;
-        std::unordered_map<std::string, entt::entity> mTags;
-        std::unordered_map<entt::entity, std::string> mReverseTags;
+        std::unordered_map<StringID, entt::entity> mTags;
+        std::unordered_map<entt::entity, StringID> mReverseTags;
         std::unordered_map<entt::entity, entt::entity> mParents;
         std::unordered_map<entt::entity, std::vector<entt::entity>> mChildren;
 
-        EntityTree mEntityTree;
+        mutable EntityTree mEntityTree;
+        mutable bool mEntityTreeDirty{true};
 
-        void BuildEntityTree();
-        void BuildEntityTreeRecursive(EntityNode &aNode, entt::entity aEntity);
+        void BuildEntityTree() const;
+        void BuildEntityTreeRecursive(EntityNode &aNode, entt::entity aEntity) const;
     };
 
 } // namespace nabla2d
@@ -0,0 +1,405 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "sceneserializer.hpp"
+
+#include <memory>
+#include <fstream>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+#include "logger.hpp"
+#include "mappedfile.hpp"
+
+using json = nlohmann::json;
+
+namespace nabla2d
+{
+    namespace
+    {
+        constexpr uint32_t kFlagNames = 1U << 0U;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t flags;
+            uint32_t entityCount;
+            uint32_t poolCount;
+            uint32_t nameBytes;
+        };
+
+        struct PoolHeader
+        {
+            uint32_t type;
+            uint32_t elementSize;
+            uint32_t count;
+        };
+
+        constexpr std::size_t Align(std::size_t aSize)
+        {
+            return (aSize + 3U) & ~static_cast<std::size_t>(3U);
+        }
+
+        void WriteBytes(std::ofstream &aFile, const void *aData, std::size_t aSize)
+        {
+            static const char kPadding[4] = {0, 0, 0, 0};
+            aFile.write(static_cast<const char *>(aData), static_cast<std::streamsize>(aSize));
+            aFile.write(kPadding, static_cast<std::streamsize>(Align(aSize) - aSize));
+        }
+    } // namespace
+
+    std::map<StringID, SceneSerializer::ComponentInfo> &SceneSerializer::GetComponentInfos()
+    {
+        static std::map<StringID, ComponentInfo> sComponentInfos;
+        return sComponentInfos;
+    }
+
+    void SceneSerializer::RegisterComponent(StringID aType, const ComponentInfo &aInfo)
+    {
+        GetComponentInfos()[aType] = aInfo;
+    }
+
+    SceneSerializer::SceneData SceneSerializer::Capture(const Scene &aScene)
+    {
+        std::vector<entt::entity> entities;
+        std::vector<const Scene::EntityNode *> stack{&aScene.GetEntityTree()};
+        while (!stack.empty())
+        {
+            const auto *node = stack.back();
+            stack.pop_back();
+            if (node->entity != entt::null)
+            {
+                entities.push_back(node->entity);
+            }
+            for (auto child = node->children.rbegin(); child != node->children.rend(); ++child)
+            {
+                stack.push_back(&*child);
+            }
+        }
+        return Capture(aScene, entities);
+    }
+
+    SceneSerializer::SceneData SceneSerializer::Capture(const Scene &aScene, const std::vector<entt::entity> &aEntities)
+    {
+        SceneData data;
+        const auto count = aEntities.size();
+        data.tags.reserve(count);
+        data.parents.reserve(count);
+
+        std::unordered_map<entt::entity, uint32_t> indices;
+        indices.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            indices[aEntities[i]] = static_cast<uint32_t>(i);
+        }
+
+        for (auto entity : aEntities)
+        {
+            data.tags.push_back(aScene.GetTagID(entity));
+            auto parent = indices.find(aScene.GetParent(entity));
+            data.parents.push_back(parent != indices.end() ? parent->second : Scene::kNoParent);
+#ifdef NABLA2D_EDITOR
+            data.names.push_back(aScene.GetTag(entity));
+#endif
+        }
+
+        const auto &registry = aScene.GetRegistry();
+        for (const auto &[type, info] : GetComponentInfos())
+        {
+            ComponentPool pool;
+            pool.type = type;
+            pool.elementSize = info.size;
+            info.capture(registry, aEntities, pool);
+            if (!pool.indices.empty())
+            {
+                data.pools.push_back(std::move(pool));
+            }
+        }
+
+        return data;
+    }
+
+    std::vector<entt::entity> SceneSerializer::Restore(Scene &aScene, const SceneData &aData, entt::entity aParent)
+    {
+        for (const auto &name : aData.names)
+        {
+            if (!name.empty())
+            {
+                StringID::Intern(name);
+            }
+        }
+
+        auto entities = aScene.CreateEntities(aData.tags, aData.parents, aParent);
+        if (entities.size() != aData.tags.size())
+        {
+            Logger::error("SceneSerializer::Restore: Failed to create {} entities", aData.tags.size());
+            return {};
+        }
+
+        const auto &infos = GetComponentInfos();
+        auto &registry = aScene.GetRegistry();
+        for (const auto &pool : aData.pools)
+        {
+            auto info = infos.find(pool.type);
+            if (info == infos.end())
+            {
+                Logger::warn("SceneSerializer::Restore: Skipping unregistered component '{}'", pool.type.GetString());
+                continue;
+            }
+            if (info->second.size != pool.elementSize)
+            {
+                Logger::error("SceneSerializer::Restore: Component '{}' has size {}, expected {}", pool.type.GetString(), pool.elementSize, info->second.size);
+                continue;
+            }
+            info->second.restore(registry, entities, pool);
+        }
+
+        return entities;
+    }
+
+    bool SceneSerializer::Write(const SceneData &aData, const std::string &aPath)
+    {
+        std::ofstream file(aPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::error("SceneSerializer::Write: Failed to open file '{}'", aPath);
+            return false;
+        }
+
+        const auto count = static_cast<uint32_t>(aData.tags.size());
+        const bool hasNames = aData.names.size() == aData.tags.size() && count > 0;
+
+        std::vector<uint32_t> nameOffsets;
+        std::string nameBlob;
+        if (hasNames)
+        {
+            nameOffsets.reserve(count + 1);
+            for (const auto &name : aData.names)
+            {
+                nameOffsets.push_back(static_cast<uint32_t>(nameBlob.size()));
+                nameBlob += name;
+            }
+            nameOffsets.push_back(static_cast<uint32_t>(nameBlob.size()));
+        }
+
+        const FileHeader header{kMagic, kVersion, hasNames ? kFlagNames : 0U, count, static_cast<uint32_t>(aData.pools.size()), static_cast<uint32_t>(nameBlob.size())};
+        WriteBytes(file, &header, sizeof(header));
+        WriteBytes(file, aData.tags.data(), count * sizeof(StringID));
+        WriteBytes(file, aData.parents.data(), count * sizeof(uint32_t));
+        if (hasNames)
+        {
+            WriteBytes(file, nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+            WriteBytes(file, nameBlob.data(), nameBlob.size());
+        }
+
+        for (const auto &pool : aData.pools)
+        {
+            const PoolHeader poolHeader{pool.type.GetValue(), pool.elementSize, static_cast<uint32_t>(pool.indices.size())};
+            WriteBytes(file, &poolHeader, sizeof(poolHeader));
+            WriteBytes(file, pool.indices.data(), pool.indices.size() * sizeof(uint32_t));
+            WriteBytes(file, pool.GetData(), pool.indices.size() * pool.elementSize);
+        }
+
+        if (!file.good())
+        {
+            Logger::error("SceneSerializer::Write: Failed to write file '{}'", aPath);
+            return false;
+        }
+        return true;
+    }
+
+    bool SceneSerializer::Read(const std::string &aPath, SceneData &aData)
+    {
+        auto file = std::make_shared<const MappedFile>(aPath);
+        if (!file->IsOpen())
+        {
+            return false;
+        }
+
+        const uint8_t *cursor = file->GetData();
+        const uint8_t *end = cursor + file->GetSize();
+        auto take = [&cursor, end](std::size_t aSize) -> const uint8_t *
+        {
+            if (cursor == nullptr || static_cast<std::size_t>(end - cursor) < Align(aSize))
+            {
+                return nullptr;
+            }
+            const uint8_t *data = cursor;
+            cursor += Align(aSize);
+            return data;
+        };
+
+        FileHeader header;
+        const uint8_t *headerData = take(sizeof(header));
+        if (headerData == nullptr)
+        {
+            Logger::error("SceneSerializer::Read: File '{}' is too small", aPath);
+            return false;
+        }
+        std::memcpy(&header, headerData, sizeof(header));
+        if (header.magic != kMagic || header.version != kVersion)
+        {
+            Logger::error("SceneSerializer::Read: File '{}' is not a version {} scene", aPath, kVersion);
+            return false;
+        }
+
+        const std::size_t count = header.entityCount;
+        const uint8_t *tags = take(count * sizeof(StringID));
+        const uint8_t *parents = take(count * sizeof(uint32_t));
+        if (tags == nullptr || parents == nullptr)
+        {
+            Logger::error("SceneSerializer::Read: File '{}' is truncated", aPath);
+            return false;
+        }
+
+        aData = {};
+        aData.file = file;
+        aData.tags.resize(count);
+        aData.parents.resize(count);
+        std::memcpy(aData.tags.data(), tags, count * sizeof(StringID));
+        std::memcpy(aData.parents.data(), parents, count * sizeof(uint32_t));
+
+        if ((header.flags & kFlagNames) != 0U)
+        {
+            const auto *offsetData = take((count + 1) * sizeof(uint32_t));
+            const auto *nameBlob = reinterpret_cast<const char *>(take(header.nameBytes));
+            if (offsetData == nullptr || nameBlob == nullptr)
+            {
+                Logger::error("SceneSerializer::Read: File '{}' is truncated", aPath);
+                return false;
+            }
+
+            std::vector<uint32_t> offsets(count + 1);
+            std::memcpy(offsets.data(), offsetData, offsets.size() * sizeof(uint32_t));
+            aData.names.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (offsets[i] > offsets[i + 1] || offsets[i + 1] > header.nameBytes)
+                {
+                    Logger::error("SceneSerializer::Read: File '{}' has a corrupted name table", aPath);
+                    return false;
+                }
+                aData.names.emplace_back(nameBlob + offsets[i], offsets[i + 1] - offsets[i]);
+            }
+        }
+
+        aData.pools.resize(header.poolCount);
+        for (auto &pool : aData.pools)
+        {
+            PoolHeader poolHeader;
+            const uint8_t *poolHeaderData = take(sizeof(poolHeader));
+            if (poolHeaderData == nullptr)
+            {
+                Logger::error("SceneSerializer::Read: File '{}' is truncated", aPath);
+                return false;
+            }
+            std::memcpy(&poolHeader, poolHeaderData, sizeof(poolHeader));
+
+            const std::size_t dataSize = static_cast<std::size_t>(poolHeader.count) * poolHeader.elementSize;
+            const uint8_t *indices = take(poolHeader.count * sizeof(uint32_t));
+            const uint8_t *data = take(dataSize);
+            if (indices == nullptr || data == nullptr)
+            {
+                Logger::error("SceneSerializer::Read: File '{}' is truncated", aPath);
+                return false;
+            }
+
+            pool.type = StringID(poolHeader.type);
+            pool.elementSize = poolHeader.elementSize;
+            pool.indices.resize(poolHeader.count);
+            pool.mapped = data;
+            std::memcpy(pool.indices.data(), indices, pool.indices.size() * sizeof(uint32_t));
+
+            for (auto index : pool.indices)
+            {
+                if (index >= count)
+                {
+                    Logger::error("SceneSerializer::Read: File '{}' has a corrupted '{}' pool", aPath, pool.type.GetString());
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SceneSerializer::Save(const Scene &aScene, const std::string &aPath)
+    {
+        return Write(Capture(aScene), aPath);
+    }
+
+    bool SceneSerializer::Load(Scene &aScene, const std::string &aPath)
+    {
+        SceneData data;
+        if (!Read(aPath, data))
+        {
+            return false;
+        }
+
+        aScene.Clear();
+        return Restore(aScene, data).size() == data.tags.size();
+    }
+
+    bool SceneSerializer::ExportJSON(const Scene &aScene, const std::string &aPath)
+    {
+        std::ofstream file(aPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::error("SceneSerializer::ExportJSON: Failed to open file '{}'", aPath);
+            return false;
+        }
+
+        const auto data = Capture(aScene);
+
+        json entities = json::array();
+        for (std::size_t i = 0; i < data.tags.size(); ++i)
+        {
+            json entity;
+            entity["tag"] = i < data.names.size() ? data.names[i] : data.tags[i].GetString();
+            entity["id"] = data.tags[i].GetValue();
+            entity["parent"] = data.parents[i] == Scene::kNoParent ? json(nullptr) : json(data.parents[i]);
+            entity["components"] = json::array();
+            entities.push_back(entity);
+        }
+
+        json pools = json::object();
+        for (const auto &pool : data.pools)
+        {
+            const auto &name = pool.type.GetString();
+            pools[name] = {{"elementSize", pool.elementSize}, {"count", pool.indices.size()}};
+            for (auto index : pool.indices)
+            {
+                entities[index]["components"].push_back(name);
+            }
+        }
+
+        json scene;
+        scene["version"] = kVersion;
+        scene["entities"] = entities;
+        scene["pools"] = pools;
+        file << scene.dump(2);
+
+        return file.good();
+    }
+
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
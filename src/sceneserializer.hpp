@@ -0,0 +1,147 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_SCENESERIALIZER_HPP
+#define NABLA2D_SCENESERIALIZER_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "stringid.hpp"
+
+namespace nabla2d
+{
+    class MappedFile;
+
+    // Binary scene format (native endianness), every array is 4-byte aligned:
+    //   Header
+    //   StringID tags[entityCount]
+    //   uint32_t parents[entityCount]      (index in the file, or Scene::kNoParent)
+    //   uint32_t nameOffsets[entityCount + 1] + char names[]   (editor builds only)
+    //   for each pool: PoolHeader, uint32_t indices[count], uint8_t data[count * elementSize]
+    class SceneSerializer
+    {
+    public:
+        static constexpr uint32_t kMagic = 0x5344324EU; // "N2DS"
+        static constexpr uint32_t kVersion = 1;
+
+        struct ComponentPool
+        {
+            StringID type;
+            uint32_t elementSize{0};
+            std::vector<uint32_t> indices;
+            // Filled by Capture, Read leaves it empty and points mapped into the file instead
+            std::vector<uint8_t> data;
+            const uint8_t *mapped{nullptr};
+
+            const uint8_t *GetData() const { return mapped != nullptr ? mapped : data.data(); }
+        };
+
+        struct SceneData
+        {
+            std::vector<StringID> tags;
+            std::vector<uint32_t> parents;
+            std::vector<std::string> names;
+            std::vector<ComponentPool> pools;
+            // Keeps the pools' mapped data alive, shared by copies
+            std::shared_ptr<const MappedFile> file;
+        };
+
+        // Components are stored as raw bytes, so only trivially copyable types can be registered
+        template <typename T>
+        static void RegisterComponent(const std::string &aName)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Serialized components must be trivially copyable");
+            RegisterComponent(StringID::Intern(aName), {static_cast<uint32_t>(sizeof(T)), &CaptureComponent<T>, &RestoreComponent<T>});
+        }
+
+        static SceneData Capture(const Scene &aScene);
+        static SceneData Capture(const Scene &aScene, const std::vector<entt::entity> &aEntities);
+        static std::vector<entt::entity> Restore(Scene &aScene, const SceneData &aData, entt::entity aParent = entt::null);
+
+        static bool Write(const SceneData &aData, const std::string &aPath);
+        static bool Read(const std::string &aPath, SceneData &aData);
+
+        static bool Save(const Scene &aScene, const std::string &aPath);
+        static bool Load(Scene &aScene, const std::string &aPath);
+
+        static bool ExportJSON(const Scene &aScene, const std::string &aPath);
+
+    private:
+        struct ComponentInfo
+        {
+            uint32_t size;
+            void (*capture)(const entt::registry &, const std::vector<entt::entity> &, ComponentPool &);
+            void (*restore)(entt::registry &, const std::vector<entt::entity> &, const ComponentPool &);
+        };
+
+        static std::map<StringID, ComponentInfo> &GetComponentInfos();
+        static void RegisterComponent(StringID aType, const ComponentInfo &aInfo);
+
+        template <typename T>
+        static void CaptureComponent(const entt::registry &aRegistry, const std::vector<entt::entity> &aEntities, ComponentPool &aPool)
+        {
+            for (std::size_t i = 0; i < aEntities.size(); ++i)
+            {
+                const T *component = aRegistry.try_get<T>(aEntities[i]);
+                if (component != nullptr)
+                {
+                    const auto offset = aPool.data.size();
+                    aPool.indices.push_back(static_cast<uint32_t>(i));
+                    aPool.data.resize(offset + sizeof(T));
+                    std::memcpy(aPool.data.data() + offset, component, sizeof(T));
+                }
+            }
+        }
+
+        template <typename T>
+        static void RestoreComponent(entt::registry &aRegistry, const std::vector<entt::entity> &aEntities, const ComponentPool &aPool)
+        {
+            std::vector<entt::entity> entities(aPool.indices.size());
+            for (std::size_t i = 0; i < entities.size(); ++i)
+            {
+                entities[i] = aEntities[aPool.indices[i]];
+            }
+
+            // Pools are 4-byte aligned in the file, components that need more go through a copy
+            const uint8_t *data = aPool.GetData();
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+            {
+                aRegistry.insert<T>(entities.begin(), entities.end(), reinterpret_cast<const T *>(data));
+                return;
+            }
+
+            std::vector<T> components(aPool.indices.size());
+            std::memcpy(components.data(), data, components.size() * sizeof(T));
+            aRegistry.insert<T>(entities.begin(), entities.end(), components.begin());
+        }
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_SCENESERIALIZER_HPP
+
+// くコ:彡
\ No newline at end of file
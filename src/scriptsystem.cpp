@@ -0,0 +1,783 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "scriptsystem.hpp"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <lua.hpp>
+
+#include "input.hpp"
+#include "logger.hpp"
+#include "stringid.hpp"
+#include "components.hpp"
+#include "transform2d.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        struct ComponentBinding
+        {
+            const char *name;
+            void (*collect)(const entt::registry &, std::vector<entt::entity> &);
+            // Drops the entities without the component
+            void (*filter)(entt::registry &, std::vector<entt::entity> &);
+            // One pointer per entity, nullptr when it doesn't have the component
+            void (*fetch)(entt::registry &, const std::vector<entt::entity> &, void **);
+        };
+
+        struct FieldBinding
+        {
+            uint32_t component;
+            const char *name;
+            float (*get)(const void *);
+            void (*set)(void *, float);
+        };
+
+        template <typename T>
+        void Collect(const entt::registry &aRegistry, std::vector<entt::entity> &aEntities)
+        {
+            aEntities.clear();
+            aRegistry.view<const T>().each([&aEntities](auto aEntity, const T &)
+                                           { aEntities.push_back(aEntity); });
+        }
+
+        // The storage is looked up once, then each entity is a sparse set lookup
+        template <typename T>
+        void Filter(entt::registry &aRegistry, std::vector<entt::entity> &aEntities)
+        {
+            const auto &storage = aRegistry.storage<T>();
+            aEntities.erase(std::remove_if(aEntities.begin(), aEntities.end(), [&storage](entt::entity aEntity)
+                                           { return !storage.contains(aEntity); }),
+                            aEntities.end());
+        }
+
+        template <typename T>
+        void Fetch(entt::registry &aRegistry, const std::vector<entt::entity> &aEntities, void **aComponents)
+        {
+            auto &storage = aRegistry.storage<T>();
+            for (std::size_t i = 0; i < aEntities.size(); ++i)
+            {
+                aComponents[i] = storage.contains(aEntities[i]) ? &storage.get(aEntities[i]) : nullptr;
+            }
+        }
+
+        template <typename T>
+        const T &As(const void *aComponent)
+        {
+            return *static_cast<const T *>(aComponent);
+        }
+
+        template <typename T>
+        T &As(void *aComponent)
+        {
+            return *static_cast<T *>(aComponent);
+        }
+
+        const std::array<ComponentBinding, 3> kComponents = {{
+            {"Transform2D", Collect<Transform2D>, Filter<Transform2D>, Fetch<Transform2D>},
+            {"RigidBody", Collect<RigidBody>, Filter<RigidBody>, Fetch<RigidBody>},
+            {"FlowAgent", Collect<FlowAgent>, Filter<FlowAgent>, Fetch<FlowAgent>},
+        }};
+
+        // The fields of a component are next to each other. Bodies are woken up when a script
+        // changes their velocity.
+        const std::array<FieldBinding, 9> kFields = {{
+            {0, "x",
+             [](const void *aComponent)
+             { return As<Transform2D>(aComponent).GetPosition().x; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &transform = As<Transform2D>(aComponent);
+                 transform.SetPosition({aValue, transform.GetPosition().y});
+             }},
+            {0, "y",
+             [](const void *aComponent)
+             { return As<Transform2D>(aComponent).GetPosition().y; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &transform = As<Transform2D>(aComponent);
+                 transform.SetPosition({transform.GetPosition().x, aValue});
+             }},
+            {0, "rotation",
+             [](const void *aComponent)
+             { return As<Transform2D>(aComponent).GetRotation(); },
+             [](void *aComponent, float aValue)
+             { As<Transform2D>(aComponent).SetRotation(aValue); }},
+            {0, "scaleX",
+             [](const void *aComponent)
+             { return As<Transform2D>(aComponent).GetScale().x; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &transform = As<Transform2D>(aComponent);
+                 transform.SetScale({aValue, transform.GetScale().y});
+             }},
+            {0, "scaleY",
+             [](const void *aComponent)
+             { return As<Transform2D>(aComponent).GetScale().y; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &transform = As<Transform2D>(aComponent);
+                 transform.SetScale({transform.GetScale().x, aValue});
+             }},
+            {1, "vx",
+             [](const void *aComponent)
+             { return As<RigidBody>(aComponent).velocity.x; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &body = As<RigidBody>(aComponent);
+                 body.velocity.x = aValue;
+                 body.awake = true;
+             }},
+            {1, "vy",
+             [](const void *aComponent)
+             { return As<RigidBody>(aComponent).velocity.y; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &body = As<RigidBody>(aComponent);
+                 body.velocity.y = aValue;
+                 body.awake = true;
+             }},
+            {1, "angularVelocity",
+             [](const void *aComponent)
+             { return As<RigidBody>(aComponent).angularVelocity; },
+             [](void *aComponent, float aValue)
+             {
+                 auto &body = As<RigidBody>(aComponent);
+                 body.angularVelocity = aValue;
+                 body.awake = true;
+             }},
+            {2, "speed",
+             [](const void *aComponent)
+             { return As<FlowAgent>(aComponent).speed; },
+             [](void *aComponent, float aValue)
+             { As<FlowAgent>(aComponent).speed = aValue; }},
+        }};
+
+        const std::array<std::pair<const char *, Input::Key>, Input::KEY_COUNT> kKeys = {{
+            {"UP", Input::KEY_UP},
+            {"DOWN", Input::KEY_DOWN},
+            {"LEFT", Input::KEY_LEFT},
+            {"RIGHT", Input::KEY_RIGHT},
+            {"SPACE", Input::KEY_SPACE},
+            {"ENTER", Input::KEY_ENTER},
+            {"ESCAPE", Input::KEY_ESCAPE},
+            {"BACKSPACE", Input::KEY_BACKSPACE},
+            {"TAB", Input::KEY_TAB},
+            {"LCTRL", Input::KEY_LCTRL},
+            {"LSHIFT", Input::KEY_LSHIFT},
+            {"LALT", Input::KEY_LALT},
+            {"MOUSE0", Input::KEY_MOUSE0},
+            {"MOUSE1", Input::KEY_MOUSE1},
+            {"MOUSE2", Input::KEY_MOUSE2},
+        }};
+
+        Scene &GetScene(lua_State *aState)
+        {
+            return *static_cast<Scene *>(lua_touserdata(aState, lua_upvalueindex(1)));
+        }
+
+        entt::entity CheckEntity(lua_State *aState, int aIndex)
+        {
+            return static_cast<entt::entity>(static_cast<uint32_t>(luaL_checkinteger(aState, aIndex)));
+        }
+
+        void PushEntity(lua_State *aState, entt::entity aEntity)
+        {
+            if (aEntity == entt::null)
+            {
+                lua_pushnil(aState);
+                return;
+            }
+            lua_pushinteger(aState, static_cast<lua_Integer>(entt::to_integral(aEntity)));
+        }
+
+        int Traceback(lua_State *aState)
+        {
+            const char *message = lua_tostring(aState, 1);
+            luaL_traceback(aState, aState, message != nullptr ? message : "(error object is not a string)", 1);
+            return 1;
+        }
+
+        int Log(lua_State *aState)
+        {
+            Logger::info("[Lua] {}", luaL_checkstring(aState, 1));
+            return 0;
+        }
+
+        // nabla.scene.create([tag]), anonymous without a tag
+        int SceneCreate(lua_State *aState)
+        {
+            auto &scene = GetScene(aState);
+            const std::string tag = luaL_optstring(aState, 1, "");
+            PushEntity(aState, tag.empty() ? scene.CreateEntities({StringID()}, {Scene::kNoParent}).front() : scene.CreateEntity(tag));
+            return 1;
+        }
+
+        int SceneDestroy(lua_State *aState)
+        {
+            auto &scene = GetScene(aState);
+            const auto entity = CheckEntity(aState, 1);
+            if (scene.GetRegistry().valid(entity))
+            {
+                scene.DestroyEntity(entity);
+            }
+            return 0;
+        }
+
+        int SceneFind(lua_State *aState)
+        {
+            PushEntity(aState, GetScene(aState).GetEntity(StringID(std::string(luaL_checkstring(aState, 1)))));
+            return 1;
+        }
+
+        int SceneValid(lua_State *aState)
+        {
+            lua_pushboolean(aState, GetScene(aState).GetRegistry().valid(CheckEntity(aState, 1)) ? 1 : 0);
+            return 1;
+        }
+
+        // nabla.transform.get(entity) -> x, y, rotation, or nil without a Transform2D
+        int TransformGet(lua_State *aState)
+        {
+            auto &registry = GetScene(aState).GetRegistry();
+            const auto entity = CheckEntity(aState, 1);
+            const auto *transform = registry.valid(entity) ? registry.try_get<Transform2D>(entity) : nullptr;
+            if (transform == nullptr)
+            {
+                lua_pushnil(aState);
+                return 1;
+            }
+            lua_pushnumber(aState, transform->GetPosition().x);
+            lua_pushnumber(aState, transform->GetPosition().y);
+            lua_pushnumber(aState, transform->GetRotation());
+            return 3;
+        }
+
+        // nabla.transform.set(entity, x, y[, rotation]), adds the Transform2D if needed
+        int TransformSet(lua_State *aState)
+        {
+            auto &registry = GetScene(aState).GetRegistry();
+            const auto entity = CheckEntity(aState, 1);
+            if (!registry.valid(entity))
+            {
+                return luaL_error(aState, "invalid entity");
+            }
+
+            const auto position = glm::vec2(luaL_checknumber(aState, 2), luaL_checknumber(aState, 3));
+            auto *transform = registry.try_get<Transform2D>(entity);
+            if (transform == nullptr)
+            {
+                registry.emplace<Transform2D>(entity, position, static_cast<float>(luaL_optnumber(aState, 4, 0.0)));
+                return 0;
+            }
+            transform->SetPosition(position);
+            if (!lua_isnoneornil(aState, 4))
+            {
+                transform->SetRotation(static_cast<float>(luaL_checknumber(aState, 4)));
+            }
+            return 0;
+        }
+
+        int TransformTranslate(lua_State *aState)
+        {
+            auto &registry = GetScene(aState).GetRegistry();
+            const auto entity = CheckEntity(aState, 1);
+            auto *transform = registry.valid(entity) ? registry.try_get<Transform2D>(entity) : nullptr;
+            if (transform != nullptr)
+            {
+                transform->Translate(glm::vec2(luaL_checknumber(aState, 2), luaL_checknumber(aState, 3)));
+            }
+            return 0;
+        }
+
+        Input::Key CheckKey(lua_State *aState)
+        {
+            const auto key = luaL_checkinteger(aState, 1);
+            return key >= 0 && key < Input::KEY_COUNT ? static_cast<Input::Key>(key) : Input::KEY_UNKNOWN;
+        }
+
+        int InputHeld(lua_State *aState)
+        {
+            const auto key = CheckKey(aState);
+            lua_pushboolean(aState, key != Input::KEY_UNKNOWN && Input::KeyHeld(key) ? 1 : 0);
+            return 1;
+        }
+
+        int InputDown(lua_State *aState)
+        {
+            const auto key = CheckKey(aState);
+            lua_pushboolean(aState, key != Input::KEY_UNKNOWN && Input::KeyDown(key) ? 1 : 0);
+            return 1;
+        }
+
+        int InputUp(lua_State *aState)
+        {
+            const auto key = CheckKey(aState);
+            lua_pushboolean(aState, key != Input::KEY_UNKNOWN && Input::KeyUp(key) ? 1 : 0);
+            return 1;
+        }
+
+        int InputAxis(lua_State *aState)
+        {
+            const auto axis = luaL_optinteger(aState, 1, Input::AXIS_LEFT);
+            const auto value = axis >= 0 && axis < Input::AXIS_COUNT ? Input::GetAxis(static_cast<Input::Axis>(axis)) : glm::vec2(0.0F);
+            lua_pushnumber(aState, value.x);
+            lua_pushnumber(aState, value.y);
+            return 2;
+        }
+
+        int InputMouse(lua_State *aState)
+        {
+            const auto position = Input::GetMousePos();
+            lua_pushnumber(aState, position.x);
+            lua_pushnumber(aState, position.y);
+            return 2;
+        }
+
+        void SetFunction(lua_State *aState, const char *aName, lua_CFunction aFunction, Scene &aScene)
+        {
+            lua_pushlightuserdata(aState, &aScene);
+            lua_pushcclosure(aState, aFunction, 1);
+            lua_setfield(aState, -2, aName);
+        }
+    } // namespace
+
+    ScriptSystem::ScriptSystem(Scene &aScene) : mScene(aScene)
+    {
+        mState = luaL_newstate();
+        if (mState == nullptr)
+        {
+            Logger::error("ScriptSystem: Failed to create the Lua state");
+            return;
+        }
+        luaL_openlibs(mState);
+
+        lua_newtable(mState);
+        SetFunction(mState, "log", Log, mScene);
+
+        lua_newtable(mState);
+        SetFunction(mState, "create", SceneCreate, mScene);
+        SetFunction(mState, "destroy", SceneDestroy, mScene);
+        SetFunction(mState, "find", SceneFind, mScene);
+        SetFunction(mState, "valid", SceneValid, mScene);
+        lua_setfield(mState, -2, "scene");
+
+        lua_newtable(mState);
+        SetFunction(mState, "get", TransformGet, mScene);
+        SetFunction(mState, "set", TransformSet, mScene);
+        SetFunction(mState, "translate", TransformTranslate, mScene);
+        lua_setfield(mState, -2, "transform");
+
+        lua_newtable(mState);
+        SetFunction(mState, "held", InputHeld, mScene);
+        SetFunction(mState, "down", InputDown, mScene);
+        SetFunction(mState, "up", InputUp, mScene);
+        SetFunction(mState, "axis", InputAxis, mScene);
+        SetFunction(mState, "mouse", InputMouse, mScene);
+        lua_setfield(mState, -2, "input");
+
+        lua_newtable(mState);
+        for (const auto &key : kKeys)
+        {
+            lua_pushinteger(mState, key.second);
+            lua_setfield(mState, -2, key.first);
+        }
+        lua_setfield(mState, -2, "keys");
+
+        lua_setglobal(mState, "nabla");
+    }
+
+    ScriptSystem::~ScriptSystem()
+    {
+        if (mState != nullptr)
+        {
+            lua_close(mState);
+        }
+    }
+
+    bool ScriptSystem::Load(const std::string &aPath)
+    {
+        std::ifstream file(aPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            Logger::error("ScriptSystem::Load: Failed to open file '{}'", aPath);
+            return false;
+        }
+        std::stringstream source;
+        source << file.rdbuf();
+        return LoadSource(aPath, source.str());
+    }
+
+    bool ScriptSystem::LoadSource(const std::string &aName, const std::string &aSource)
+    {
+        if (mState == nullptr)
+        {
+            return false;
+        }
+
+        const int top = lua_gettop(mState);
+        lua_pushcfunction(mState, Traceback);
+        if (luaL_loadbuffer(mState, aSource.data(), aSource.size(), ("@" + aName).c_str()) != 0 || lua_pcall(mState, 0, 1, top + 1) != 0)
+        {
+            Logger::error("ScriptSystem::LoadSource: Failed to run '{}': {}", aName, lua_tostring(mState, -1));
+            lua_settop(mState, top);
+            return false;
+        }
+        if (!lua_istable(mState, -1))
+        {
+            Logger::error("ScriptSystem::LoadSource: '{}' must return a table", aName);
+            lua_settop(mState, top);
+            return false;
+        }
+
+        Script script;
+        script.stats = {aName, true, 0, 0.0, 0.0};
+        lua_getfield(mState, -1, "components");
+        for (int i = 1; lua_istable(mState, -1); ++i)
+        {
+            lua_rawgeti(mState, -1, i);
+            if (lua_isnil(mState, -1))
+            {
+                lua_pop(mState, 1);
+                break;
+            }
+
+            const char *name = lua_tostring(mState, -1);
+            const auto component = std::find_if(kComponents.begin(), kComponents.end(), [name](const ComponentBinding &aComponent)
+                                                { return name != nullptr && std::string(name) == aComponent.name; });
+            if (component == kComponents.end())
+            {
+                Logger::error("ScriptSystem::LoadSource: Unknown component '{}' in '{}'", name != nullptr ? name : "?", aName);
+                lua_settop(mState, top);
+                return false;
+            }
+            const auto index = static_cast<uint32_t>(component - kComponents.begin());
+            if (std::find(script.components.begin(), script.components.end(), index) == script.components.end())
+            {
+                script.components.push_back(index);
+            }
+            lua_pop(mState, 1);
+        }
+        lua_pop(mState, 1);
+
+        lua_getfield(mState, -1, "each");
+        if (lua_isfunction(mState, -1) && script.components.empty())
+        {
+            Logger::error("ScriptSystem::LoadSource: '{}' has an each function but no components", aName);
+            lua_settop(mState, top);
+            return false;
+        }
+        script.each = lua_isfunction(mState, -1) ? luaL_ref(mState, LUA_REGISTRYINDEX) : LUA_NOREF;
+        lua_settop(mState, top + 2);
+        lua_getfield(mState, -1, "update");
+        script.update = lua_isfunction(mState, -1) ? luaL_ref(mState, LUA_REGISTRYINDEX) : LUA_NOREF;
+        lua_settop(mState, top + 2);
+
+        for (uint32_t i = 0; i < kFields.size(); ++i)
+        {
+            if (std::find(script.components.begin(), script.components.end(), kFields[i].component) != script.components.end())
+            {
+                script.fields.push_back(i);
+            }
+        }
+
+        // One array per field then the entity ids, reused between ticks
+        lua_createtable(mState, static_cast<int>(script.fields.size() + 1), 0);
+        for (std::size_t i = 0; i <= script.fields.size(); ++i)
+        {
+            lua_newtable(mState);
+            lua_rawseti(mState, -2, static_cast<int>(i + 1));
+        }
+        script.arrayTable = luaL_ref(mState, LUA_REGISTRYINDEX);
+        lua_newtable(mState);
+        script.view = luaL_ref(mState, LUA_REGISTRYINDEX);
+        script.viewSize = 0;
+
+        lua_getfield(mState, -1, "start");
+        const bool start = lua_isfunction(mState, -1);
+        lua_pop(mState, 1);
+        script.table = luaL_ref(mState, LUA_REGISTRYINDEX);
+        lua_settop(mState, top);
+
+        auto existing = std::find_if(mScripts.begin(), mScripts.end(), [&aName](const Script &aScript)
+                                     { return aScript.stats.name == aName; });
+        if (existing != mScripts.end())
+        {
+            Unload(*existing);
+            *existing = std::move(script);
+        }
+        else
+        {
+            existing = mScripts.insert(mScripts.end(), std::move(script));
+        }
+
+        if (start)
+        {
+            lua_rawgeti(mState, LUA_REGISTRYINDEX, existing->table);
+            lua_getfield(mState, -1, "start");
+            lua_remove(mState, -2);
+            return Call(*existing, 0);
+        }
+        return true;
+    }
+
+    void ScriptSystem::Clear()
+    {
+        for (auto &script : mScripts)
+        {
+            Unload(script);
+        }
+        mScripts.clear();
+    }
+
+    void ScriptSystem::Update(float aDeltaTime)
+    {
+        for (auto &script : mScripts)
+        {
+            if (!script.stats.enabled)
+            {
+                continue;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            if (script.update != LUA_NOREF)
+            {
+                lua_rawgeti(mState, LUA_REGISTRYINDEX, script.update);
+                lua_pushnumber(mState, aDeltaTime);
+                Call(script, 1);
+            }
+
+            if (script.stats.enabled && script.each != LUA_NOREF)
+            {
+                Gather(script);
+                if (!script.entities.empty())
+                {
+                    lua_rawgeti(mState, LUA_REGISTRYINDEX, script.each);
+                    PushView(script);
+                    lua_pushinteger(mState, static_cast<lua_Integer>(script.entities.size()));
+                    lua_pushnumber(mState, aDeltaTime);
+                    if (Call(script, 3))
+                    {
+                        ReadView(script);
+                        Scatter(script);
+                    }
+                }
+            }
+
+            auto &stats = script.stats;
+            stats.entityCount = script.entities.size();
+            stats.lastMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            stats.averageMilliseconds = stats.averageMilliseconds == 0.0 ? stats.lastMilliseconds : stats.averageMilliseconds * 0.95 + stats.lastMilliseconds * 0.05;
+        }
+    }
+
+    std::size_t ScriptSystem::GetScriptCount() const
+    {
+        return mScripts.size();
+    }
+
+    const ScriptSystem::ScriptStats &ScriptSystem::GetStats(std::size_t aScript) const
+    {
+        return mScripts[aScript].stats;
+    }
+
+    void ScriptSystem::Unload(Script &aScript)
+    {
+        for (const int reference : {aScript.table, aScript.update, aScript.each, aScript.view, aScript.arrayTable})
+        {
+            luaL_unref(mState, LUA_REGISTRYINDEX, reference);
+        }
+    }
+
+    // The function and its arguments are on the stack, they are all popped
+    bool ScriptSystem::Call(Script &aScript, int aArguments)
+    {
+        const int base = lua_gettop(mState) - aArguments;
+        lua_pushcfunction(mState, Traceback);
+        lua_insert(mState, base);
+        const bool success = lua_pcall(mState, aArguments, 0, base) == 0;
+        if (!success)
+        {
+            Logger::error("ScriptSystem: '{}' disabled: {}", aScript.stats.name, lua_tostring(mState, -1));
+            aScript.stats.enabled = false;
+            lua_pop(mState, 1);
+        }
+        lua_remove(mState, base);
+        return success;
+    }
+
+    void ScriptSystem::Gather(Script &aScript)
+    {
+        auto &registry = mScene.GetRegistry();
+        auto &entities = aScript.entities;
+        kComponents[aScript.components.front()].collect(registry, entities);
+        for (std::size_t i = 1; i < aScript.components.size(); ++i)
+        {
+            kComponents[aScript.components[i]].filter(registry, entities);
+        }
+
+        const auto count = entities.size();
+        aScript.ids.resize(count);
+        aScript.values.resize(aScript.fields.size() * count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            aScript.ids[i] = entt::to_integral(entities[i]);
+        }
+        FetchComponents(aScript);
+        for (std::size_t field = 0; field < aScript.fields.size(); ++field)
+        {
+            const auto &binding = kFields[aScript.fields[field]];
+            const auto *components = GetComponents(aScript, binding.component);
+            auto *values = aScript.values.data() + field * count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = binding.get(components[i]);
+            }
+        }
+        aScript.gathered = aScript.values;
+    }
+
+    // Only what the script changed is written, entities it destroyed or stripped are skipped
+    void ScriptSystem::Scatter(Script &aScript)
+    {
+        // The script may have added or removed components, the storages can have moved
+        FetchComponents(aScript);
+        const auto count = aScript.entities.size();
+        aScript.skipped.assign(count, 0);
+        for (std::size_t slot = 0; slot < aScript.components.size(); ++slot)
+        {
+            const auto *components = aScript.pointers.data() + slot * count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                aScript.skipped[i] |= components[i] == nullptr ? 1U : 0U;
+            }
+        }
+
+        for (std::size_t field = 0; field < aScript.fields.size(); ++field)
+        {
+            const auto &binding = kFields[aScript.fields[field]];
+            auto *components = GetComponents(aScript, binding.component);
+            const auto *values = aScript.values.data() + field * count;
+            const auto *gathered = aScript.gathered.data() + field * count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (values[i] != gathered[i] && aScript.skipped[i] == 0)
+                {
+                    binding.set(components[i], values[i]);
+                }
+            }
+        }
+    }
+
+    void ScriptSystem::FetchComponents(Script &aScript)
+    {
+        auto &registry = mScene.GetRegistry();
+        const auto count = aScript.entities.size();
+        aScript.pointers.resize(aScript.components.size() * count);
+        for (std::size_t slot = 0; slot < aScript.components.size(); ++slot)
+        {
+            kComponents[aScript.components[slot]].fetch(registry, aScript.entities, aScript.pointers.data() + slot * count);
+        }
+    }
+
+    void **ScriptSystem::GetComponents(Script &aScript, uint32_t aComponent)
+    {
+        const auto slot = static_cast<std::size_t>(std::find(aScript.components.begin(), aScript.components.end(), aComponent) - aScript.components.begin());
+        return aScript.pointers.data() + slot * aScript.entities.size();
+    }
+
+    // Fills the arrays in one pass per field, the script then only reads and writes plain
+    // tables. Entries left from a larger tick are cleared so the length operator stays right.
+    void ScriptSystem::PushView(Script &aScript)
+    {
+        const auto count = aScript.entities.size();
+        lua_rawgeti(mState, LUA_REGISTRYINDEX, aScript.view);
+        lua_rawgeti(mState, LUA_REGISTRYINDEX, aScript.arrayTable);
+        for (std::size_t field = 0; field <= aScript.fields.size(); ++field)
+        {
+            lua_rawgeti(mState, -1, static_cast<lua_Integer>(field + 1));
+            if (field < aScript.fields.size())
+            {
+                const auto *values = aScript.values.data() + field * count;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    lua_pushnumber(mState, values[i]);
+                    lua_rawseti(mState, -2, static_cast<lua_Integer>(i + 1));
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    lua_pushinteger(mState, static_cast<lua_Integer>(aScript.ids[i]));
+                    lua_rawseti(mState, -2, static_cast<lua_Integer>(i + 1));
+                }
+            }
+            for (std::size_t i = count; i < aScript.viewSize; ++i)
+            {
+                lua_pushnil(mState);
+                lua_rawseti(mState, -2, static_cast<lua_Integer>(i + 1));
+            }
+
+            // Puts back an array the script may have replaced in the view
+            lua_setfield(mState, -3, field < aScript.fields.size() ? kFields[aScript.fields[field]].name : "entity");
+        }
+        lua_pop(mState, 1);
+        aScript.viewSize = count;
+    }
+
+    // Reads the arrays of the view back into the packed buffer, values that aren't numbers keep
+    // what was gathered
+    void ScriptSystem::ReadView(Script &aScript)
+    {
+        const auto count = aScript.entities.size();
+        lua_rawgeti(mState, LUA_REGISTRYINDEX, aScript.view);
+        for (std::size_t field = 0; field < aScript.fields.size(); ++field)
+        {
+            if (lua_getfield(mState, -1, kFields[aScript.fields[field]].name) != LUA_TTABLE)
+            {
+                lua_pop(mState, 1);
+                continue;
+            }
+            auto *values = aScript.values.data() + field * count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                int isNumber = 0;
+                lua_rawgeti(mState, -1, static_cast<lua_Integer>(i + 1));
+                const auto value = lua_tonumberx(mState, -1, &isNumber);
+                if (isNumber != 0)
+                {
+                    values[i] = static_cast<float>(value);
+                }
+                lua_pop(mState, 1);
+            }
+            lua_pop(mState, 1);
+        }
+        lua_pop(mState, 1);
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
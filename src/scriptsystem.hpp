@@ -0,0 +1,118 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_SCRIPTSYSTEM_HPP
+#define NABLA2D_SCRIPTSYSTEM_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+
+struct lua_State;
+
+namespace nabla2d
+{
+    // Runs Lua scripts once per fixed tick.
+    // A script returns a table with any of these fields:
+    //   components: names of the components `each` iterates on ("Transform2D", "RigidBody", "FlowAgent")
+    //   start(): called once after loading
+    //   update(dt): called every tick
+    //   each(view, count, dt): called every tick with every entity having all the components
+    // `each` sees the components as arrays of numbers indexed from 1 to count (view.x[i],
+    // view.vx[i], view.entity[i]...). They are plain Lua tables filled once per tick and read
+    // back after the call, so the script never calls into C++ per entity, and only the values
+    // it changed are written to the components.
+    // The `nabla` global gives access to the scene, the transforms and the input.
+    class ScriptSystem
+    {
+    public:
+        typedef struct
+        {
+            std::string name;
+            bool enabled;
+            std::size_t entityCount;
+            double lastMilliseconds;
+            double averageMilliseconds;
+        } ScriptStats;
+
+        explicit ScriptSystem(Scene &aScene);
+        ScriptSystem(const ScriptSystem &aScriptSystem) = delete;
+        ScriptSystem &operator=(const ScriptSystem &aScriptSystem) = delete;
+        ~ScriptSystem();
+
+        // Loading a script with the name of a loaded one replaces it
+        bool Load(const std::string &aPath);
+        bool LoadSource(const std::string &aName, const std::string &aSource);
+        void Clear();
+
+        // A script raising an error is disabled until it is loaded again
+        void Update(float aDeltaTime);
+
+        std::size_t GetScriptCount() const;
+        const ScriptStats &GetStats(std::size_t aScript) const;
+
+    private:
+        struct Script
+        {
+            ScriptStats stats;
+            int table;
+            int update;
+            int each;
+            // Reused between ticks, holds the arrays given to `each`
+            int view;
+            // Keeps the arrays whatever the script does to the view
+            int arrayTable;
+            // Entries in the arrays since the last tick
+            std::size_t viewSize;
+
+            std::vector<uint32_t> components;
+            std::vector<uint32_t> fields;
+            std::vector<entt::entity> entities;
+            std::vector<uint32_t> ids;
+            // One run of entities.size() values per field
+            std::vector<float> values;
+            // The values as gathered, so calls made by the script during `each` aren't undone
+            std::vector<float> gathered;
+            // One run of entities.size() component pointers per component
+            std::vector<void *> pointers;
+            std::vector<uint8_t> skipped;
+        };
+
+        Scene &mScene;
+        lua_State *mState{nullptr};
+        std::vector<Script> mScripts;
+
+        void Unload(Script &aScript);
+        bool Call(Script &aScript, int aArguments);
+        void Gather(Script &aScript);
+        void Scatter(Script &aScript);
+        void FetchComponents(Script &aScript);
+        void **GetComponents(Script &aScript, uint32_t aComponent);
+        void PushView(Script &aScript);
+        void ReadView(Script &aScript);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_SCRIPTSYSTEM_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,523 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "spatialindex.hpp"
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include "components.hpp"
+
+namespace nabla2d
+{
+    template <typename F>
+    void SpatialIndex::ForEachCandidate(const AABB &aBounds, F &&aCallback) const
+    {
+        if (mProxies.empty())
+        {
+            return;
+        }
+
+        const auto first = glm::max(GetCell(aBounds.min - mMaxHalfSize), mMinCell);
+        const auto last = glm::min(GetCell(aBounds.max + mMaxHalfSize), mMaxCell);
+        if (first.x > last.x || first.y > last.y)
+        {
+            return;
+        }
+
+        // Large queries walk the occupied cells instead of the covered ones
+        const auto covered = static_cast<std::size_t>(last.x - first.x + 1) * static_cast<std::size_t>(last.y - first.y + 1);
+        if (covered > mCells.size())
+        {
+            for (const auto &[key, slots] : mCells)
+            {
+                const glm::ivec2 cell{static_cast<int32_t>(key >> 32U), static_cast<int32_t>(key & 0xFFFFFFFFU)};
+                if (cell.x < first.x || cell.x > last.x || cell.y < first.y || cell.y > last.y)
+                {
+                    continue;
+                }
+                for (auto proxy : slots)
+                {
+                    aCallback(mProxies[proxy]);
+                }
+            }
+            return;
+        }
+
+        for (int y = first.y; y <= last.y; ++y)
+        {
+            for (int x = first.x; x <= last.x; ++x)
+            {
+                auto cell = mCells.find(GetCellKey({x, y}));
+                if (cell == mCells.end())
+                {
+                    continue;
+                }
+                for (auto proxy : cell->second)
+                {
+                    aCallback(mProxies[proxy]);
+                }
+            }
+        }
+    }
+
+    SpatialIndex::SpatialIndex(float aCellSize) : mCellSize(aCellSize),
+                                                  mInvCellSize(1.0F / aCellSize)
+    {
+    }
+
+    float SpatialIndex::GetCellSize() const
+    {
+        return mCellSize;
+    }
+
+    std::size_t SpatialIndex::GetSize() const
+    {
+        return mProxies.size();
+    }
+
+    void SpatialIndex::Insert(entt::entity aEntity, const AABB &aBounds)
+    {
+        if (GetProxy(aEntity) != kInvalid)
+        {
+            Update(aEntity, aBounds);
+            return;
+        }
+
+        const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+        if (id >= mSparse.size())
+        {
+            mSparse.resize(std::max(id + 1, mSparse.size() * 2), kInvalid);
+        }
+        else if (mSparse[id] != kInvalid)
+        {
+            // The id was recycled before the previous entity left the index, its proxy is
+            // taken over so the id never maps to two proxies
+            mProxies[mSparse[id]].entity = aEntity;
+            Update(aEntity, aBounds);
+            return;
+        }
+
+        const auto proxy = static_cast<uint32_t>(mProxies.size());
+        mSparse[id] = proxy;
+        mProxies.push_back({aEntity, aBounds, 0, 0, mStamp});
+        mMaxHalfSize = glm::max(mMaxHalfSize, aBounds.GetHalfSize());
+        AddToCell(proxy, GetCell(aBounds.GetCenter()));
+    }
+
+    void SpatialIndex::Update(entt::entity aEntity, const AABB &aBounds)
+    {
+        const auto proxy = GetProxy(aEntity);
+        if (proxy == kInvalid)
+        {
+            Insert(aEntity, aBounds);
+            return;
+        }
+
+        mProxies[proxy].bounds = aBounds;
+        mProxies[proxy].stamp = mStamp;
+        mMaxHalfSize = glm::max(mMaxHalfSize, aBounds.GetHalfSize());
+
+        const auto cell = GetCell(aBounds.GetCenter());
+        if (GetCellKey(cell) != mProxies[proxy].cell)
+        {
+            RemoveFromCell(proxy);
+            AddToCell(proxy, cell);
+        }
+    }
+
+    void SpatialIndex::Remove(entt::entity aEntity)
+    {
+        const auto proxy = GetProxy(aEntity);
+        if (proxy == kInvalid)
+        {
+            return;
+        }
+
+        RemoveFromCell(proxy);
+        mSparse[entt::to_entity(aEntity)] = kInvalid;
+
+        const auto last = static_cast<uint32_t>(mProxies.size() - 1);
+        if (proxy != last)
+        {
+            const auto &moved = mProxies[last];
+            mCells.at(moved.cell)[moved.slot] = proxy;
+            mSparse[entt::to_entity(moved.entity)] = proxy;
+            mProxies[proxy] = moved;
+        }
+        mProxies.pop_back();
+    }
+
+    bool SpatialIndex::Contains(entt::entity aEntity) const
+    {
+        return GetProxy(aEntity) != kInvalid;
+    }
+
+    void SpatialIndex::Clear()
+    {
+        mProxies.clear();
+        mSparse.clear();
+        mCells.clear();
+        mMaxHalfSize = {0.0F, 0.0F};
+        mMinCell = {0, 0};
+        mMaxCell = {-1, -1};
+    }
+
+    void SpatialIndex::Update(const entt::registry &aRegistry)
+    {
+        ++mStamp;
+        aRegistry.view<WorldTransform, Bounds>().each([this](auto aEntity, const WorldTransform &aWorld, const Bounds &aBounds)
+                                                      {
+                                                          const auto &m = aWorld.matrix;
+                                                          const glm::vec2 center = glm::vec2(m * glm::vec4(aBounds.center, 0.0F, 1.0F));
+                                                          const glm::vec2 halfSize{std::abs(m[0][0]) * aBounds.halfSize.x + std::abs(m[1][0]) * aBounds.halfSize.y,
+                                                                                   std::abs(m[0][1]) * aBounds.halfSize.x + std::abs(m[1][1]) * aBounds.halfSize.y};
+                                                          Update(aEntity, {center - halfSize, center + halfSize}); });
+
+        // Whatever wasn't touched lost its components or was destroyed. Going backwards
+        // means the proxy swapped into a freed slot has already been checked.
+        for (auto proxy = mProxies.size(); proxy-- > 0;)
+        {
+            if (mProxies[proxy].stamp != mStamp)
+            {
+                Remove(mProxies[proxy].entity);
+            }
+        }
+    }
+
+    void SpatialIndex::QueryAABB(const AABB &aBounds, std::vector<entt::entity> &aResults) const
+    {
+        ForEachCandidate(aBounds, [&aBounds, &aResults](const Proxy &aProxy)
+                         {
+                             if (aProxy.bounds.Overlaps(aBounds))
+                             {
+                                 aResults.push_back(aProxy.entity);
+                             } });
+    }
+
+    void SpatialIndex::QueryCircle(const glm::vec2 &aCenter, float aRadius, std::vector<entt::entity> &aResults) const
+    {
+        const auto radius2 = aRadius * aRadius;
+        ForEachCandidate({aCenter - aRadius, aCenter + aRadius}, [&aCenter, radius2, &aResults](const Proxy &aProxy)
+                         {
+                             if (aProxy.bounds.GetDistance2(aCenter) <= radius2)
+                             {
+                                 aResults.push_back(aProxy.entity);
+                             } });
+    }
+
+    void SpatialIndex::QueryPoint(const glm::vec2 &aPoint, std::vector<entt::entity> &aResults) const
+    {
+        ForEachCandidate({aPoint, aPoint}, [&aPoint, &aResults](const Proxy &aProxy)
+                         {
+                             if (aProxy.bounds.Contains(aPoint))
+                             {
+                                 aResults.push_back(aProxy.entity);
+                             } });
+    }
+
+    void SpatialIndex::QueryNearest(const glm::vec2 &aPoint, std::size_t aCount, std::vector<entt::entity> &aResults) const
+    {
+        if (aCount == 0 || mProxies.empty())
+        {
+            return;
+        }
+
+        // Max-heap of the best candidates so far, by squared distance
+        std::vector<std::pair<float, uint32_t>> best;
+        best.reserve(aCount + 1);
+        auto consider = [&best, &aPoint, aCount, this](uint32_t aProxy)
+        {
+            const auto distance2 = mProxies[aProxy].bounds.GetDistance2(aPoint);
+            if (best.size() == aCount && distance2 >= best.front().first)
+            {
+                return;
+            }
+            best.emplace_back(distance2, aProxy);
+            std::push_heap(best.begin(), best.end());
+            if (best.size() > aCount)
+            {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+        };
+
+        const auto center = GetCell(aPoint);
+        const auto looseness = glm::length(mMaxHalfSize);
+        for (int ring = 0;; ++ring)
+        {
+            // Any box stored in this ring is at least this far away
+            const auto minDistance = std::max(0.0F, static_cast<float>(ring - 1) * mCellSize - looseness);
+            if (best.size() == aCount && minDistance * minDistance > best.front().first)
+            {
+                break;
+            }
+
+            // Rings bigger than the number of occupied cells are cheaper to replace by a full scan
+            if (static_cast<std::size_t>(ring) * 8 > mCells.size())
+            {
+                best.clear();
+                for (uint32_t proxy = 0; proxy < mProxies.size(); ++proxy)
+                {
+                    consider(proxy);
+                }
+                break;
+            }
+
+            for (int y = center.y - ring; y <= center.y + ring; ++y)
+            {
+                const bool edgeRow = y == center.y - ring || y == center.y + ring;
+                const int step = edgeRow || ring == 0 ? 1 : ring * 2;
+                for (int x = center.x - ring; x <= center.x + ring; x += step)
+                {
+                    auto cell = mCells.find(GetCellKey({x, y}));
+                    if (cell == mCells.end())
+                    {
+                        continue;
+                    }
+                    for (auto proxy : cell->second)
+                    {
+                        consider(proxy);
+                    }
+                }
+            }
+
+            if (center.x - ring <= mMinCell.x && center.x + ring >= mMaxCell.x && center.y - ring <= mMinCell.y && center.y + ring >= mMaxCell.y)
+            {
+                break;
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        for (const auto &candidate : best)
+        {
+            aResults.push_back(mProxies[candidate.second].entity);
+        }
+    }
+
+    void SpatialIndex::QueryAABB(const std::vector<AABB> &aBounds, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const
+    {
+        aResults.clear();
+        aOffsets.resize(aBounds.size() + 1);
+        for (std::size_t i = 0; i < aBounds.size(); ++i)
+        {
+            aOffsets[i] = static_cast<uint32_t>(aResults.size());
+            QueryAABB(aBounds[i], aResults);
+        }
+        aOffsets.back() = static_cast<uint32_t>(aResults.size());
+    }
+
+    void SpatialIndex::QueryCircle(const std::vector<glm::vec2> &aCenters, const std::vector<float> &aRadii, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const
+    {
+        aResults.clear();
+        const auto count = std::min(aCenters.size(), aRadii.size());
+        aOffsets.resize(count + 1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            aOffsets[i] = static_cast<uint32_t>(aResults.size());
+            QueryCircle(aCenters[i], aRadii[i], aResults);
+        }
+        aOffsets.back() = static_cast<uint32_t>(aResults.size());
+    }
+
+    void SpatialIndex::QueryPoint(const std::vector<glm::vec2> &aPoints, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const
+    {
+        aResults.clear();
+        aOffsets.resize(aPoints.size() + 1);
+        for (std::size_t i = 0; i < aPoints.size(); ++i)
+        {
+            aOffsets[i] = static_cast<uint32_t>(aResults.size());
+            QueryPoint(aPoints[i], aResults);
+        }
+        aOffsets.back() = static_cast<uint32_t>(aResults.size());
+    }
+
+    void SpatialIndex::QueryNearest(const std::vector<glm::vec2> &aPoints, std::size_t aCount, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const
+    {
+        aResults.clear();
+        aOffsets.resize(aPoints.size() + 1);
+        for (std::size_t i = 0; i < aPoints.size(); ++i)
+        {
+            aOffsets[i] = static_cast<uint32_t>(aResults.size());
+            QueryNearest(aPoints[i], aCount, aResults);
+        }
+        aOffsets.back() = static_cast<uint32_t>(aResults.size());
+    }
+
+    void SpatialIndex::QueryPairs(JobSystem &aJobSystem, std::vector<std::pair<entt::entity, entt::entity>> &aPairs) const
+    {
+        aPairs.clear();
+        if (mProxies.empty())
+        {
+            return;
+        }
+
+        // Rows first, with the sign bits flipped so the integer order matches the cell order
+        auto getOrder = [](const glm::ivec2 &aCell)
+        { return (static_cast<uint64_t>(static_cast<uint32_t>(aCell.y) ^ 0x80000000U) << 32U) | (static_cast<uint32_t>(aCell.x) ^ 0x80000000U); };
+
+        struct PairCell
+        {
+            uint64_t order;
+            glm::ivec2 cell;
+            uint32_t begin;
+            uint32_t end;
+            const std::vector<uint32_t> *slots;
+        };
+
+        // Occupied cells row by row, with their boxes copied next to each other in that order
+        std::vector<PairCell> cells;
+        cells.reserve(mCells.size());
+        for (const auto &[key, slots] : mCells)
+        {
+            const glm::ivec2 cell{static_cast<int32_t>(key >> 32U), static_cast<int32_t>(key & 0xFFFFFFFFU)};
+            cells.push_back({getOrder(cell), cell, 0, 0, &slots});
+        }
+        std::sort(cells.begin(), cells.end(), [](const PairCell &aFirst, const PairCell &aSecond)
+                  { return aFirst.order < aSecond.order; });
+
+        std::vector<AABB> bounds;
+        std::vector<entt::entity> entities;
+        bounds.reserve(mProxies.size());
+        entities.reserve(mProxies.size());
+        for (auto &cell : cells)
+        {
+            cell.begin = static_cast<uint32_t>(bounds.size());
+            for (auto proxy : *cell.slots)
+            {
+                bounds.push_back(mProxies[proxy].bounds);
+                entities.push_back(mProxies[proxy].entity);
+            }
+            cell.end = static_cast<uint32_t>(bounds.size());
+        }
+
+        // Boxes are binned by center, two of them can only overlap if their cells are this close
+        const glm::ivec2 reach = glm::ivec2(glm::ceil(mMaxHalfSize * 2.0F * mInvCellSize));
+        std::vector<std::vector<std::pair<entt::entity, entt::entity>>> chunks((cells.size() + kPairGrainSize - 1) / kPairGrainSize);
+        aJobSystem.ParallelFor(cells.size(), kPairGrainSize, [&cells, &bounds, &entities, &chunks, &reach, &getOrder](std::size_t aBegin, std::size_t aEnd)
+                               {
+                                   auto &pairs = chunks[aBegin / kPairGrainSize];
+                                   auto test = [&bounds, &entities, &pairs](uint32_t aFirst, uint32_t aSecond)
+                                   {
+                                       if (bounds[aFirst].Overlaps(bounds[aSecond]))
+                                       {
+                                           pairs.emplace_back(entities[aFirst], entities[aSecond]);
+                                       }
+                                   };
+
+                                   // One cursor per row of the half neighbourhood (the rest of this row, then
+                                   // the rows above). Cells are visited in order, so cursors only move forward.
+                                   std::vector<std::size_t> cursors(static_cast<std::size_t>(reach.y) + 1, aBegin);
+                                   for (auto c = aBegin; c < aEnd; ++c)
+                                   {
+                                       const auto &cell = cells[c];
+                                       for (auto i = cell.begin; i < cell.end; ++i)
+                                       {
+                                           for (auto j = i + 1; j < cell.end; ++j)
+                                           {
+                                               test(i, j);
+                                           }
+                                       }
+
+                                       for (int y = 0; y <= reach.y; ++y)
+                                       {
+                                           const glm::ivec2 first{y == 0 ? cell.cell.x + 1 : cell.cell.x - reach.x, cell.cell.y + y};
+                                           const auto firstOrder = getOrder(first);
+                                           auto &cursor = cursors[static_cast<std::size_t>(y)];
+                                           while (cursor < cells.size() && cells[cursor].order < firstOrder)
+                                           {
+                                               ++cursor;
+                                           }
+                                           for (auto n = cursor; n < cells.size() && cells[n].cell.y == first.y && cells[n].cell.x <= cell.cell.x + reach.x; ++n)
+                                           {
+                                               for (auto i = cell.begin; i < cell.end; ++i)
+                                               {
+                                                   for (auto j = cells[n].begin; j < cells[n].end; ++j)
+                                                   {
+                                                       test(i, j);
+                                                   }
+                                               }
+                                           }
+                                       }
+                                   } });
+
+        for (const auto &pairs : chunks)
+        {
+            aPairs.insert(aPairs.end(), pairs.begin(), pairs.end());
+        }
+    }
+
+    glm::ivec2 SpatialIndex::GetCell(const glm::vec2 &aPoint) const
+    {
+        return {static_cast<int>(std::floor(aPoint.x * mInvCellSize)), static_cast<int>(std::floor(aPoint.y * mInvCellSize))};
+    }
+
+    uint64_t SpatialIndex::GetCellKey(const glm::ivec2 &aCell)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(aCell.x)) << 32U) | static_cast<uint32_t>(aCell.y);
+    }
+
+    uint32_t SpatialIndex::GetProxy(entt::entity aEntity) const
+    {
+        const auto id = static_cast<std::size_t>(entt::to_entity(aEntity));
+        if (id >= mSparse.size() || mSparse[id] == kInvalid || mProxies[mSparse[id]].entity != aEntity)
+        {
+            return kInvalid;
+        }
+        return mSparse[id];
+    }
+
+    void SpatialIndex::AddToCell(uint32_t aProxy, const glm::ivec2 &aCell)
+    {
+        auto &cell = mCells[GetCellKey(aCell)];
+        mProxies[aProxy].cell = GetCellKey(aCell);
+        mProxies[aProxy].slot = static_cast<uint32_t>(cell.size());
+        cell.push_back(aProxy);
+
+        if (mMaxCell.x < mMinCell.x)
+        {
+            mMinCell = aCell;
+            mMaxCell = aCell;
+        }
+        else
+        {
+            mMinCell = glm::min(mMinCell, aCell);
+            mMaxCell = glm::max(mMaxCell, aCell);
+        }
+    }
+
+    void SpatialIndex::RemoveFromCell(uint32_t aProxy)
+    {
+        const auto &proxy = mProxies[aProxy];
+        auto cell = mCells.find(proxy.cell);
+        auto &slots = cell->second;
+        const auto last = slots.back();
+        slots[proxy.slot] = last;
+        mProxies[last].slot = proxy.slot;
+        slots.pop_back();
+        if (slots.empty())
+        {
+            mCells.erase(cell);
+        }
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,114 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_SPATIALINDEX_HPP
+#define NABLA2D_SPATIALINDEX_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "aabb.hpp"
+#include "jobsystem.hpp"
+
+namespace nabla2d
+{
+    // Loose uniform grid: every entity lives in the single cell containing the center of
+    // its box and queries are widened by the largest half size seen. Moving an entity is
+    // a box update, plus a swap-remove and push when it changes cells.
+    class SpatialIndex
+    {
+    public:
+        explicit SpatialIndex(float aCellSize = 4.0F);
+        ~SpatialIndex() = default;
+
+        float GetCellSize() const;
+        std::size_t GetSize() const;
+
+        void Insert(entt::entity aEntity, const AABB &aBounds);
+        void Update(entt::entity aEntity, const AABB &aBounds);
+        void Remove(entt::entity aEntity);
+        bool Contains(entt::entity aEntity) const;
+        void Clear();
+
+        // Inserts, moves and removes entities to match the WorldTransform and Bounds
+        // components in aRegistry
+        void Update(const entt::registry &aRegistry);
+
+        // Single queries append to aResults
+        void QueryAABB(const AABB &aBounds, std::vector<entt::entity> &aResults) const;
+        void QueryCircle(const glm::vec2 &aCenter, float aRadius, std::vector<entt::entity> &aResults) const;
+        void QueryPoint(const glm::vec2 &aPoint, std::vector<entt::entity> &aResults) const;
+        // Closest first, by distance to the boxes
+        void QueryNearest(const glm::vec2 &aPoint, std::size_t aCount, std::vector<entt::entity> &aResults) const;
+
+        // Batch queries: results of query i are aResults[aOffsets[i], aOffsets[i + 1])
+        void QueryAABB(const std::vector<AABB> &aBounds, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const;
+        void QueryCircle(const std::vector<glm::vec2> &aCenters, const std::vector<float> &aRadii, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const;
+        void QueryPoint(const std::vector<glm::vec2> &aPoints, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const;
+        void QueryNearest(const std::vector<glm::vec2> &aPoints, std::size_t aCount, std::vector<entt::entity> &aResults, std::vector<uint32_t> &aOffsets) const;
+
+        // Every overlapping pair of boxes, once. Occupied cells are sorted by row and split in
+        // chunks over the job system, each one is only tested against itself and the
+        // neighbours after it.
+        void QueryPairs(JobSystem &aJobSystem, std::vector<std::pair<entt::entity, entt::entity>> &aPairs) const;
+
+    private:
+        static constexpr uint32_t kInvalid = 0xFFFFFFFFU;
+        static constexpr std::size_t kPairGrainSize = 64;
+
+        struct Proxy
+        {
+            entt::entity entity;
+            AABB bounds;
+            uint64_t cell;
+            uint32_t slot;
+            uint32_t stamp;
+        };
+
+        float mCellSize;
+        float mInvCellSize;
+        glm::vec2 mMaxHalfSize{0.0F, 0.0F};
+        glm::ivec2 mMinCell{0, 0};
+        glm::ivec2 mMaxCell{-1, -1};
+        uint32_t mStamp{0};
+
+        std::vector<Proxy> mProxies;
+        std::vector<uint32_t> mSparse;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> mCells;
+
+        glm::ivec2 GetCell(const glm::vec2 &aPoint) const;
+        static uint64_t GetCellKey(const glm::ivec2 &aCell);
+        uint32_t GetProxy(entt::entity aEntity) const;
+
+        void AddToCell(uint32_t aProxy, const glm::ivec2 &aCell);
+        void RemoveFromCell(uint32_t aProxy);
+
+        template <typename F>
+        void ForEachCandidate(const AABB &aBounds, F &&aCallback) const;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_SPATIALINDEX_HPP
+
+// くコ:彡
\ No newline at end of file
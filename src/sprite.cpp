@@ -284,6 +284,26 @@ namespace nabla2d
         }
     }
 
+    const std::vector<Sprite::Frame> &Sprite::GetFrames() const
+    {
+        return mFrames;
+    }
+
+    const std::unordered_map<std::string, Sprite::Animation> &Sprite::GetAnimations() const
+    {
+        return mAnimations;
+    }
+
+    const glm::vec4 &Sprite::GetAtlasInfo() const
+    {
+        return mFrames.at(mCurrentFrameIndex).atlasInfo;
+    }
+
+    SpriteRenderer Sprite::GetSpriteRenderer() const
+    {
+        return SpriteRenderer{mTexture, mSpriteData, mSize, GetAtlasInfo()};
+    }
+
     std::vector<std::pair<glm::vec3, glm::vec2>> Sprite::GetSquare(const glm::vec2 &aSize)
     {
         auto square = kDefaultSquare;
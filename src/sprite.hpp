@@ -29,6 +29,7 @@
 #include <glm/glm.hpp>
 #include <nlohmann/json.hpp>
 
+#include "components.hpp"
 #include "renderer/renderer.hpp"
 
 namespace nabla2d
@@ -82,6 +83,11 @@ namespace nabla2d
         const std::string &GetAnimation() const;
         void SetAnimation(const std::string &aAnimation);
 
+        const std::vector<Frame> &GetFrames() const;
+        const std::unordered_map<std::string, Animation> &GetAnimations() const;
+        const glm::vec4 &GetAtlasInfo() const;
+        SpriteRenderer GetSpriteRenderer() const;
+
     private:
         Sprite() = default;
         static std::vector<std::pair<glm::vec3, glm::vec2>> GetSquare(const glm::vec2 &aSize);
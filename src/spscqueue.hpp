@@ -0,0 +1,129 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_SPSCQUEUE_HPP
+#define NABLA2D_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace nabla2d
+{
+    // Fixed capacity ring for one producer thread and one consumer thread. Never locks and
+    // never allocates after construction, so it can feed real-time threads. Each side keeps a
+    // copy of the other side's index and only reloads it when the ring looks full or empty.
+    template <typename T>
+    class SPSCQueue
+    {
+    public:
+        // The capacity is rounded up to a power of two
+        explicit SPSCQueue(std::size_t aCapacity)
+        {
+            std::size_t capacity = 2;
+            while (capacity < aCapacity)
+            {
+                capacity *= 2;
+            }
+            mBuffer.resize(capacity);
+            mMask = capacity - 1;
+        }
+
+        SPSCQueue(const SPSCQueue &aQueue) = delete;
+        SPSCQueue &operator=(const SPSCQueue &aQueue) = delete;
+        ~SPSCQueue() = default;
+
+        // Producer side, fails when the queue is full
+        bool TryPush(const T &aValue)
+        {
+            const auto tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mCachedHead > mMask)
+            {
+                mCachedHead = mHead.load(std::memory_order_acquire);
+                if (tail - mCachedHead > mMask)
+                {
+                    return false;
+                }
+            }
+            mBuffer[tail & mMask] = aValue;
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side, fails when the queue is empty
+        bool TryPop(T &aValue)
+        {
+            const auto head = mHead.load(std::memory_order_relaxed);
+            if (head == mCachedTail)
+            {
+                mCachedTail = mTail.load(std::memory_order_acquire);
+                if (head == mCachedTail)
+                {
+                    return false;
+                }
+            }
+            aValue = mBuffer[head & mMask];
+            mHead.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side, appends everything queued to aOutput with a single index update.
+        // Returns the number of values moved.
+        std::size_t PopAll(std::vector<T> &aOutput)
+        {
+            const auto head = mHead.load(std::memory_order_relaxed);
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            for (auto index = head; index != mCachedTail; ++index)
+            {
+                aOutput.push_back(std::move(mBuffer[index & mMask]));
+            }
+            mHead.store(mCachedTail, std::memory_order_release);
+            return mCachedTail - head;
+        }
+
+        std::size_t GetCapacity() const
+        {
+            return mBuffer.size();
+        }
+
+        // Only a snapshot when called while the other side is running
+        std::size_t GetSize() const
+        {
+            return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+        }
+
+    private:
+        static constexpr std::size_t kCacheLineSize = 64;
+
+        std::vector<T> mBuffer;
+        std::size_t mMask{0};
+
+        // Each index sits on its own cache line with its owner's copy of the other one
+        alignas(kCacheLineSize) std::atomic<std::size_t> mHead{0};
+        std::size_t mCachedTail{0};
+        alignas(kCacheLineSize) std::atomic<std::size_t> mTail{0};
+        std::size_t mCachedHead{0};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_SPSCQUEUE_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,68 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "stringid.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        const std::string kUnknownString{"<unknown>"};
+
+#ifdef NABLA2D_EDITOR
+        std::mutex sInternMutex;
+        std::unordered_map<StringID::ValueType, std::string> sInternTable;
+#endif
+    } // namespace
+
+    StringID StringID::Intern(const std::string &aString)
+    {
+        const StringID id(aString);
+#ifdef NABLA2D_EDITOR
+        std::lock_guard<std::mutex> lock(sInternMutex);
+        auto [entry, inserted] = sInternTable.try_emplace(id.mValue, aString);
+        if (!inserted && entry->second != aString)
+        {
+            Logger::error("StringID: hash collision between '{}' and '{}'!", entry->second, aString);
+        }
+#endif
+        return id;
+    }
+
+    const std::string &StringID::GetString() const
+    {
+#ifdef NABLA2D_EDITOR
+        std::lock_guard<std::mutex> lock(sInternMutex);
+        auto entry = sInternTable.find(mValue);
+        if (entry != sInternTable.end())
+        {
+            return entry->second;
+        }
+#endif
+        return kUnknownString;
+    }
+
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,106 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_STRINGID_HPP
+#define NABLA2D_STRINGID_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace nabla2d
+{
+    // 32-bit FNV-1a hash of a string, usable at compile time for literals
+    // and at runtime through the intern table (which keeps the original
+    // strings around for debugging in editor builds only)
+    class StringID
+    {
+    public:
+        typedef uint32_t ValueType;
+
+        constexpr StringID() = default;
+        constexpr explicit StringID(ValueType aValue) : mValue(aValue) {}
+        // Stops at the first NUL, a char buffer can hold a shorter string than its size
+        template <std::size_t N>
+        constexpr StringID(const char (&aString)[N]) : mValue(Hash(aString, Length(aString, N))) {}
+        StringID(const std::string &aString) : mValue(Hash(aString.data(), aString.size())) {}
+
+        static constexpr ValueType Hash(const char *aString, std::size_t aLength)
+        {
+            ValueType hash = kOffsetBasis;
+            for (std::size_t i = 0; i < aLength; ++i)
+            {
+                hash = (hash ^ static_cast<uint8_t>(aString[i])) * kPrime;
+            }
+            return hash;
+        }
+
+        static constexpr std::size_t Length(const char *aString, std::size_t aSize)
+        {
+            std::size_t length = 0;
+            while (length < aSize && aString[length] != '\0')
+            {
+                ++length;
+            }
+            return length;
+        }
+
+        static StringID Intern(const std::string &aString);
+
+        constexpr ValueType GetValue() const { return mValue; }
+        constexpr bool IsValid() const { return mValue != 0; }
+        const std::string &GetString() const;
+
+        constexpr bool operator==(const StringID &aOther) const { return mValue == aOther.mValue; }
+        constexpr bool operator!=(const StringID &aOther) const { return mValue != aOther.mValue; }
+        constexpr bool operator<(const StringID &aOther) const { return mValue < aOther.mValue; }
+
+    private:
+        static constexpr ValueType kOffsetBasis = 2166136261U;
+        static constexpr ValueType kPrime = 16777619U;
+
+        ValueType mValue{0};
+    };
+
+    namespace literals
+    {
+        constexpr StringID operator""_sid(const char *aString, std::size_t aLength)
+        {
+            return StringID(StringID::Hash(aString, aLength));
+        }
+    } // namespace literals
+} // namespace nabla2d
+
+namespace std
+{
+    template <>
+    struct hash<nabla2d::StringID>
+    {
+        std::size_t operator()(const nabla2d::StringID &aID) const noexcept
+        {
+            return static_cast<std::size_t>(aID.GetValue());
+        }
+    };
+} // namespace std
+
+#endif // NABLA2D_STRINGID_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,351 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "tilemap.hpp"
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <tmxlite/Map.hpp>
+#include <tmxlite/TileLayer.hpp>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        struct TilesetInfo
+        {
+            Renderer::TextureHandle texture;
+            uint32_t firstGID;
+            uint32_t columns;
+            glm::vec2 tileSize;
+            glm::vec2 imageSize;
+            float margin;
+            float spacing;
+            // Size of the quad, in map tiles
+            glm::vec2 quadSize;
+        };
+
+        // Corners of one tile in the tileset image, as top left, top right, bottom left, bottom right
+        std::array<glm::vec2, 4> GetTileUVs(const TilesetInfo &aTileset, uint32_t aLocalID, uint8_t aFlipFlags)
+        {
+            const auto column = static_cast<float>(aLocalID % aTileset.columns);
+            const auto row = static_cast<float>(aLocalID / aTileset.columns);
+            const glm::vec2 position = glm::vec2(aTileset.margin) + glm::vec2(column, row) * (aTileset.tileSize + aTileset.spacing);
+            const auto min = position / aTileset.imageSize;
+            const auto max = (position + aTileset.tileSize) / aTileset.imageSize;
+            std::array<glm::vec2, 4> uvs = {glm::vec2{min.x, min.y}, glm::vec2{max.x, min.y}, glm::vec2{min.x, max.y}, glm::vec2{max.x, max.y}};
+
+            // Tiled flips along the diagonal first, then horizontally and vertically
+            if ((aFlipFlags & tmx::TileLayer::FlipFlag::Diagonal) != 0)
+            {
+                std::swap(uvs[1], uvs[2]);
+            }
+            if ((aFlipFlags & tmx::TileLayer::FlipFlag::Horizontal) != 0)
+            {
+                std::swap(uvs[0], uvs[1]);
+                std::swap(uvs[2], uvs[3]);
+            }
+            if ((aFlipFlags & tmx::TileLayer::FlipFlag::Vertical) != 0)
+            {
+                std::swap(uvs[0], uvs[2]);
+                std::swap(uvs[1], uvs[3]);
+            }
+            return uvs;
+        }
+    } // namespace
+
+    Tilemap::~Tilemap()
+    {
+        if (mRenderer != nullptr)
+        {
+            for (const auto &batch : mBatches)
+            {
+                mRenderer->DeleteData(batch.data);
+            }
+            for (auto texture : mTextures)
+            {
+                mRenderer->DeleteTexture(texture);
+            }
+        }
+    }
+
+    Tilemap *Tilemap::FromTMX(std::shared_ptr<Renderer> aRenderer,
+                              const std::string &aPath,
+                              int aChunkSize,
+                              const Renderer::TextureFilter &aFilter)
+    {
+        if (aChunkSize <= 0)
+        {
+            Logger::error("Tilemap::FromTMX: Invalid chunk size {}", aChunkSize);
+            return nullptr;
+        }
+
+        tmx::Map map;
+        if (!map.load(aPath))
+        {
+            Logger::error("Tilemap::FromTMX: Failed to load map '{}'", aPath);
+            return nullptr;
+        }
+        if (map.isInfinite() || map.getOrientation() != tmx::Orientation::Orthogonal)
+        {
+            Logger::error("Tilemap::FromTMX: Only finite orthogonal maps are supported ('{}')", aPath);
+            return nullptr;
+        }
+
+        Tilemap *tilemap = new Tilemap();
+        tilemap->mRenderer = aRenderer;
+        tilemap->mPath = aPath;
+        tilemap->mChunkSize = aChunkSize;
+        tilemap->mSize = {static_cast<int>(map.getTileCount().x), static_cast<int>(map.getTileCount().y)};
+        tilemap->mChunkCount = (tilemap->mSize + aChunkSize - 1) / aChunkSize;
+        const auto mapTileSize = glm::vec2(std::max(map.getTileSize().x, 1U), std::max(map.getTileSize().y, 1U));
+
+        // Tileset of every global tile id, -1 for the empty tile and the tiles we can't draw
+        std::vector<TilesetInfo> tilesets;
+        std::vector<int> tileTilesets(1, -1);
+        for (const auto &tileset : map.getTilesets())
+        {
+            if (tileset.getImagePath().empty() || tileset.getColumnCount() == 0 || tileset.getTileCount() == 0)
+            {
+                Logger::warn("Tilemap::FromTMX: Skipping image collection tileset '{}' in map '{}'", tileset.getName(), aPath);
+                continue;
+            }
+
+            const auto texture = aRenderer->LoadTexture(tileset.getImagePath(), aFilter);
+            if (texture == 0)
+            {
+                delete tilemap;
+                Logger::error("Tilemap::FromTMX: Failed to load tileset image '{}'", tileset.getImagePath());
+                return nullptr;
+            }
+            tilemap->mTextures.push_back(texture);
+
+            const auto textureInfo = aRenderer->GetTextureInfo(texture);
+            TilesetInfo info;
+            info.texture = texture;
+            info.firstGID = tileset.getFirstGID();
+            info.columns = tileset.getColumnCount();
+            info.tileSize = glm::vec2(tileset.getTileSize().x, tileset.getTileSize().y);
+            info.imageSize = glm::vec2(std::max(textureInfo.width, 1), std::max(textureInfo.height, 1));
+            info.margin = static_cast<float>(tileset.getMargin());
+            info.spacing = static_cast<float>(tileset.getSpacing());
+            info.quadSize = info.tileSize / mapTileSize;
+            tilemap->mOverhang = glm::max(tilemap->mOverhang, info.quadSize - 1.0F);
+
+            tileTilesets.resize(std::max<std::size_t>(tileTilesets.size(), tileset.getLastGID() + 1), -1);
+            std::fill(tileTilesets.begin() + info.firstGID, tileTilesets.begin() + tileset.getLastGID() + 1, static_cast<int>(tilesets.size()));
+            tilesets.push_back(info);
+        }
+
+        std::size_t tileLayerCount = 0;
+        for (const auto &layer : map.getLayers())
+        {
+            tileLayerCount += layer->getType() == tmx::Layer::Type::Tile ? 1 : 0;
+        }
+
+        const auto width = static_cast<std::size_t>(tilemap->mSize.x);
+        std::vector<std::vector<std::pair<glm::vec3, glm::vec2>>> vertices(tilesets.size());
+        std::vector<std::vector<unsigned int>> indices(tilesets.size());
+        std::size_t layerIndex = 0;
+        for (const auto &mapLayer : map.getLayers())
+        {
+            if (mapLayer->getType() != tmx::Layer::Type::Tile)
+            {
+                continue;
+            }
+            const auto depth = (static_cast<float>(layerIndex++) - static_cast<float>(tileLayerCount)) * kLayerDepth;
+            if (!mapLayer->getVisible())
+            {
+                continue;
+            }
+
+            const auto &tiles = mapLayer->getLayerAs<tmx::TileLayer>().getTiles();
+            if (tiles.size() < width * static_cast<std::size_t>(tilemap->mSize.y))
+            {
+                Logger::warn("Tilemap::FromTMX: Skipping incomplete layer '{}' in map '{}'", mapLayer->getName(), aPath);
+                continue;
+            }
+
+            Layer layer;
+            layer.name = mapLayer->getName();
+            layer.depth = depth;
+            layer.chunks.resize(static_cast<std::size_t>(tilemap->mChunkCount.x * tilemap->mChunkCount.y));
+            for (int chunkY = 0; chunkY < tilemap->mChunkCount.y; ++chunkY)
+            {
+                for (int chunkX = 0; chunkX < tilemap->mChunkCount.x; ++chunkX)
+                {
+                    auto &chunk = layer.chunks[static_cast<std::size_t>(chunkY * tilemap->mChunkCount.x + chunkX)];
+                    chunk.bounds = {glm::vec2(INFINITY), glm::vec2(-INFINITY)};
+                    chunk.firstBatch = static_cast<uint32_t>(tilemap->mBatches.size());
+                    chunk.batchCount = 0;
+
+                    const int endX = std::min((chunkX + 1) * aChunkSize, tilemap->mSize.x);
+                    const int endY = std::min((chunkY + 1) * aChunkSize, tilemap->mSize.y);
+                    for (int y = chunkY * aChunkSize; y < endY; ++y)
+                    {
+                        // Tiled rows go down, ours go up
+                        const auto row = static_cast<std::size_t>(tilemap->mSize.y - 1 - y);
+                        for (int x = chunkX * aChunkSize; x < endX; ++x)
+                        {
+                            const auto &tile = tiles[row * width + static_cast<std::size_t>(x)];
+                            const int tilesetIndex = tile.ID < tileTilesets.size() ? tileTilesets[tile.ID] : -1;
+                            if (tilesetIndex < 0)
+                            {
+                                continue;
+                            }
+
+                            const auto &tileset = tilesets[static_cast<std::size_t>(tilesetIndex)];
+                            const auto uvs = GetTileUVs(tileset, tile.ID - tileset.firstGID, tile.flipFlags);
+                            const glm::vec2 min{static_cast<float>(x), static_cast<float>(y)};
+                            const auto max = min + tileset.quadSize;
+                            chunk.bounds.min = glm::min(chunk.bounds.min, min);
+                            chunk.bounds.max = glm::max(chunk.bounds.max, max);
+
+                            auto &tileVertices = vertices[static_cast<std::size_t>(tilesetIndex)];
+                            const auto base = static_cast<unsigned int>(tileVertices.size());
+                            tileVertices.push_back({{min.x, min.y, depth}, uvs[2]});
+                            tileVertices.push_back({{max.x, min.y, depth}, uvs[3]});
+                            tileVertices.push_back({{max.x, max.y, depth}, uvs[1]});
+                            tileVertices.push_back({{min.x, max.y, depth}, uvs[0]});
+                            indices[static_cast<std::size_t>(tilesetIndex)].insert(indices[static_cast<std::size_t>(tilesetIndex)].end(),
+                                                                                   {base, base + 1, base + 2, base + 2, base + 3, base});
+                        }
+                    }
+
+                    for (std::size_t i = 0; i < tilesets.size(); ++i)
+                    {
+                        if (vertices[i].empty())
+                        {
+                            continue;
+                        }
+                        tilemap->mBatches.push_back({aRenderer->LoadData(vertices[i], indices[i]), tilesets[i].texture});
+                        ++chunk.batchCount;
+                        vertices[i].clear();
+                        indices[i].clear();
+                    }
+                }
+            }
+            tilemap->mLayers.push_back(std::move(layer));
+        }
+
+        return tilemap;
+    }
+
+    void Tilemap::Draw(const Camera &aCamera)
+    {
+        mDrawnChunkCount = 0;
+        mDrawCallCount = 0;
+        if (mChunkCount.x == 0 || mChunkCount.y == 0)
+        {
+            return;
+        }
+
+        Renderer::DrawParameters parameters;
+        parameters.atlasInfo = {0.0F, 0.0F, 1.0F, 1.0F};
+        const glm::mat4 identity(1.0F);
+        const auto chunkSize = static_cast<float>(mChunkSize);
+        const auto lastChunk = glm::vec2(mChunkCount - 1);
+
+        Renderer::TextureHandle texture = 0;
+        for (const auto &layer : mLayers)
+        {
+            // Tiles reach up and right of their cell, chunks left and below the view may still show
+            const auto view = aCamera.GetVisibleBounds(layer.depth);
+            const auto first = glm::ivec2(glm::clamp(glm::floor((view.min - mOverhang) / chunkSize), glm::vec2(0.0F), lastChunk));
+            const auto last = glm::ivec2(glm::clamp(glm::floor(view.max / chunkSize), glm::vec2(0.0F), lastChunk));
+            for (int y = first.y; y <= last.y; ++y)
+            {
+                for (int x = first.x; x <= last.x; ++x)
+                {
+                    const auto &chunk = layer.chunks[static_cast<std::size_t>(y * mChunkCount.x + x)];
+                    if (chunk.batchCount == 0 || !chunk.bounds.Overlaps(view))
+                    {
+                        continue;
+                    }
+
+                    ++mDrawnChunkCount;
+                    for (uint32_t i = chunk.firstBatch; i < chunk.firstBatch + chunk.batchCount; ++i)
+                    {
+                        const auto &batch = mBatches[i];
+                        if (batch.texture != texture)
+                        {
+                            texture = batch.texture;
+                            mRenderer->UseTexture(texture);
+                        }
+                        mRenderer->DrawData(batch.data, aCamera, identity, parameters);
+                        ++mDrawCallCount;
+                    }
+                }
+            }
+        }
+    }
+
+    const std::string &Tilemap::GetPath() const
+    {
+        return mPath;
+    }
+
+    const glm::ivec2 &Tilemap::GetSize() const
+    {
+        return mSize;
+    }
+
+    int Tilemap::GetChunkSize() const
+    {
+        return mChunkSize;
+    }
+
+    AABB Tilemap::GetBounds() const
+    {
+        return {glm::vec2(0.0F), glm::vec2(mSize) + mOverhang};
+    }
+
+    std::size_t Tilemap::GetLayerCount() const
+    {
+        return mLayers.size();
+    }
+
+    std::size_t Tilemap::GetChunkCount() const
+    {
+        std::size_t count = 0;
+        for (const auto &layer : mLayers)
+        {
+            count += static_cast<std::size_t>(std::count_if(layer.chunks.begin(), layer.chunks.end(), [](const Chunk &aChunk)
+                                                            { return aChunk.batchCount > 0; }));
+        }
+        return count;
+    }
+
+    std::size_t Tilemap::GetDrawnChunkCount() const
+    {
+        return mDrawnChunkCount;
+    }
+
+    std::size_t Tilemap::GetDrawCallCount() const
+    {
+        return mDrawCallCount;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
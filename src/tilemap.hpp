@@ -0,0 +1,114 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_TILEMAP_HPP
+#define NABLA2D_TILEMAP_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+#include "camera.hpp"
+#include "renderer/renderer.hpp"
+
+namespace nabla2d
+{
+    // Orthogonal Tiled map baked into static geometry. Every tile layer is cut into chunks of
+    // aChunkSize x aChunkSize tiles, and the tiles of a chunk are merged into one indexed buffer
+    // per tileset, so drawing only costs a few calls per chunk on screen. One world unit is one
+    // tile with y going up, the bottom left corner of the map being the origin, like NavGrid.
+    class Tilemap
+    {
+    public:
+        ~Tilemap();
+        Tilemap(const Tilemap &aTilemap) = delete;
+        Tilemap &operator=(const Tilemap &aTilemap) = delete;
+
+        static constexpr int kDefaultChunkSize = 32;
+        // Depth between two layers, later layers are drawn in front and everything stays behind z = 0
+        static constexpr float kLayerDepth = 0.001F;
+
+        static Tilemap *FromTMX(std::shared_ptr<Renderer> aRenderer,
+                                const std::string &aPath,
+                                int aChunkSize = kDefaultChunkSize,
+                                const Renderer::TextureFilter &aFilter = Renderer::TextureFilter::NEAREST);
+
+        // Draws the chunks overlapping the view with the current shader
+        void Draw(const Camera &aCamera);
+
+        const std::string &GetPath() const;
+        const glm::ivec2 &GetSize() const;
+        int GetChunkSize() const;
+        AABB GetBounds() const;
+        std::size_t GetLayerCount() const;
+        std::size_t GetChunkCount() const;
+        // Chunks and draw calls of the last Draw
+        std::size_t GetDrawnChunkCount() const;
+        std::size_t GetDrawCallCount() const;
+
+    private:
+        Tilemap() = default;
+
+        // Tiles of one chunk using the same tileset
+        struct Batch
+        {
+            Renderer::DataHandle data;
+            Renderer::TextureHandle texture;
+        };
+
+        struct Chunk
+        {
+            AABB bounds;
+            uint32_t firstBatch;
+            uint32_t batchCount;
+        };
+
+        // Chunks are stored row by row, from the bottom, empty ones have no batch
+        struct Layer
+        {
+            std::string name;
+            float depth;
+            std::vector<Chunk> chunks;
+        };
+
+        std::shared_ptr<Renderer> mRenderer;
+        std::string mPath{""};
+        glm::ivec2 mSize{0, 0};
+        int mChunkSize{kDefaultChunkSize};
+        glm::ivec2 mChunkCount{0, 0};
+        // How far tiles taller or wider than the map tiles reach past their chunk
+        glm::vec2 mOverhang{0.0F, 0.0F};
+
+        std::vector<Renderer::TextureHandle> mTextures;
+        std::vector<Batch> mBatches;
+        std::vector<Layer> mLayers;
+
+        std::size_t mDrawnChunkCount{0};
+        std::size_t mDrawCallCount{0};
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_TILEMAP_HPP
+
+// くコ:彡
\ No newline at end of file
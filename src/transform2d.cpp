@@ -0,0 +1,169 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "transform2d.hpp"
+
+#include <cmath>
+
+namespace nabla2d
+{
+    Transform2D::Transform2D(const glm::vec2 &aPosition,
+                             float aRotation,
+                             const glm::vec2 &aScale) : mPosition(aPosition),
+                                                        mRotation(aRotation),
+                                                        mScale(aScale)
+    {
+    }
+
+    const glm::vec2 &Transform2D::GetPosition() const
+    {
+        return mPosition;
+    }
+
+    float Transform2D::GetRotation() const
+    {
+        return mRotation;
+    }
+
+    const glm::vec2 &Transform2D::GetScale() const
+    {
+        return mScale;
+    }
+
+    void Transform2D::SetPosition(const glm::vec2 &aPosition)
+    {
+        mPosition = aPosition;
+    }
+
+    void Transform2D::SetRotation(float aRotation)
+    {
+        mRotation = aRotation;
+    }
+
+    void Transform2D::SetScale(const glm::vec2 &aScale)
+    {
+        mScale = aScale;
+    }
+
+    void Transform2D::Translate(const glm::vec2 &aTranslation)
+    {
+        mPosition += aTranslation;
+    }
+
+    void Transform2D::Rotate(float aAngle)
+    {
+        mRotation += aAngle;
+    }
+
+    void Transform2D::Scale(const glm::vec2 &aScale)
+    {
+        mScale *= aScale;
+    }
+
+    void Transform2D::Lerp(const Transform2D &aTarget, float aInterpolation)
+    {
+        mPosition += (aTarget.mPosition - mPosition) * aInterpolation;
+        mRotation += (aTarget.mRotation - mRotation) * aInterpolation;
+        mScale += (aTarget.mScale - mScale) * aInterpolation;
+    }
+
+    Transform2D Transform2D::Lerp(const Transform2D &aT1, const Transform2D &aT2, float aInterpolation)
+    {
+        Transform2D result = aT1;
+        result.Lerp(aT2, aInterpolation);
+        return result;
+    }
+
+    glm::mat3x2 Transform2D::GetMatrix() const
+    {
+        const float angle = glm::radians(mRotation);
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        return glm::mat3x2(glm::vec2(c, s) * mScale.x, glm::vec2(-s, c) * mScale.y, mPosition);
+    }
+
+    glm::mat3x2 Transform2D::GetInverseMatrix() const
+    {
+        const float angle = glm::radians(mRotation);
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const float invScaleX = 1.0F / mScale.x;
+        const float invScaleY = 1.0F / mScale.y;
+
+        // Rows of the inverse linear part are the rotated axes divided by their scale
+        const glm::vec2 row0{c * invScaleX, s * invScaleX};
+        const glm::vec2 row1{-s * invScaleY, c * invScaleY};
+        return glm::mat3x2(glm::vec2(row0.x, row1.x),
+                           glm::vec2(row0.y, row1.y),
+                           glm::vec2(-glm::dot(row0, mPosition), -glm::dot(row1, mPosition)));
+    }
+
+    glm::vec2 Transform2D::GetRight() const
+    {
+        const float angle = glm::radians(mRotation);
+        return {std::cos(angle), std::sin(angle)};
+    }
+
+    glm::vec2 Transform2D::GetUp() const
+    {
+        const float angle = glm::radians(mRotation);
+        return {-std::sin(angle), std::cos(angle)};
+    }
+
+    glm::mat3x2 Transform2D::Inverse(const glm::mat3x2 &aMatrix)
+    {
+        const float invDeterminant = 1.0F / (aMatrix[0][0] * aMatrix[1][1] - aMatrix[1][0] * aMatrix[0][1]);
+        const glm::vec2 column0 = glm::vec2(aMatrix[1][1], -aMatrix[0][1]) * invDeterminant;
+        const glm::vec2 column1 = glm::vec2(-aMatrix[1][0], aMatrix[0][0]) * invDeterminant;
+        const glm::vec2 translation = -(column0 * aMatrix[2][0] + column1 * aMatrix[2][1]);
+        return glm::mat3x2(column0, column1, translation);
+    }
+
+    glm::mat3x2 Transform2D::Multiply(const glm::mat3x2 &aParent, const glm::mat3x2 &aChild)
+    {
+        return glm::mat3x2(aParent[0] * aChild[0][0] + aParent[1] * aChild[0][1],
+                           aParent[0] * aChild[1][0] + aParent[1] * aChild[1][1],
+                           aParent[0] * aChild[2][0] + aParent[1] * aChild[2][1] + aParent[2]);
+    }
+
+    glm::mat4 Transform2D::Multiply(const glm::mat4 &aParent, const glm::mat3x2 &aChild)
+    {
+        return glm::mat4(aParent[0] * aChild[0][0] + aParent[1] * aChild[0][1],
+                         aParent[0] * aChild[1][0] + aParent[1] * aChild[1][1],
+                         aParent[2],
+                         aParent[0] * aChild[2][0] + aParent[1] * aChild[2][1] + aParent[3]);
+    }
+
+    glm::vec2 Transform2D::TransformPoint(const glm::mat3x2 &aMatrix, const glm::vec2 &aPoint)
+    {
+        return aMatrix[0] * aPoint.x + aMatrix[1] * aPoint.y + aMatrix[2];
+    }
+
+    glm::mat4 Transform2D::ToMat4(const glm::mat3x2 &aMatrix)
+    {
+        return glm::mat4(glm::vec4(aMatrix[0], 0.0F, 0.0F),
+                         glm::vec4(aMatrix[1], 0.0F, 0.0F),
+                         glm::vec4(0.0F, 0.0F, 1.0F, 0.0F),
+                         glm::vec4(aMatrix[2], 0.0F, 1.0F));
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,77 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_TRANSFORM2D_HPP
+#define NABLA2D_TRANSFORM2D_HPP
+
+#include <glm/glm.hpp>
+
+namespace nabla2d
+{
+    // Position, rotation (degrees, around Z) and scale on the XY plane, 20 bytes instead of
+    // Transform's full 3D state. Matrices are 3x2 affine (columns: X axis, Y axis, translation)
+    // and computed on demand.
+    class Transform2D
+    {
+    public:
+        explicit Transform2D(const glm::vec2 &aPosition = {0.0F, 0.0F},
+                             float aRotation = 0.0F,
+                             const glm::vec2 &aScale = {1.0F, 1.0F});
+
+        const glm::vec2 &GetPosition() const;
+        float GetRotation() const;
+        const glm::vec2 &GetScale() const;
+
+        void SetPosition(const glm::vec2 &aPosition);
+        void SetRotation(float aRotation);
+        void SetScale(const glm::vec2 &aScale);
+
+        void Translate(const glm::vec2 &aTranslation);
+        void Rotate(float aAngle);
+        void Scale(const glm::vec2 &aScale);
+
+        // Rotation is interpolated as a plain angle, keep it unwrapped to lerp the short way
+        void Lerp(const Transform2D &aTarget, float aInterpolation);
+        static Transform2D Lerp(const Transform2D &aT1, const Transform2D &aT2, float aInterpolation);
+
+        glm::mat3x2 GetMatrix() const;
+        // Built straight from the components: scale^-1 * rotation^T * translation^-1
+        glm::mat3x2 GetInverseMatrix() const;
+        glm::vec2 GetRight() const;
+        glm::vec2 GetUp() const;
+
+        static glm::mat3x2 Inverse(const glm::mat3x2 &aMatrix);
+        static glm::mat3x2 Multiply(const glm::mat3x2 &aParent, const glm::mat3x2 &aChild);
+        // aParent * aChild with aChild lifted to 3D, skipping the terms that are always 0 or 1
+        static glm::mat4 Multiply(const glm::mat4 &aParent, const glm::mat3x2 &aChild);
+        static glm::vec2 TransformPoint(const glm::mat3x2 &aMatrix, const glm::vec2 &aPoint);
+        static glm::mat4 ToMat4(const glm::mat3x2 &aMatrix);
+
+    private:
+        glm::vec2 mPosition;
+        float mRotation;
+        glm::vec2 mScale;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_TRANSFORM2D_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,257 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "transformbatch.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define NABLA2D_TRANSFORMBATCH_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NABLA2D_TRANSFORMBATCH_SSE
+#endif
+
+namespace nabla2d
+{
+#if defined(NABLA2D_TRANSFORMBATCH_AVX) || defined(NABLA2D_TRANSFORMBATCH_SSE)
+    namespace
+    {
+        // Four lanes of each column component to four matrices
+        inline void StoreColumns(__m128 aX0, __m128 aY0, __m128 aZ0,
+                                 __m128 aX1, __m128 aY1, __m128 aZ1,
+                                 __m128 aX2, __m128 aY2, __m128 aZ2,
+                                 __m128 aX3, __m128 aY3, __m128 aZ3,
+                                 glm::mat4 *aMatrices)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0F);
+
+            __m128 w = zero;
+            _MM_TRANSPOSE4_PS(aX0, aY0, aZ0, w);
+            __m128 w1 = zero;
+            _MM_TRANSPOSE4_PS(aX1, aY1, aZ1, w1);
+            __m128 w2 = zero;
+            _MM_TRANSPOSE4_PS(aX2, aY2, aZ2, w2);
+            __m128 w3 = one;
+            _MM_TRANSPOSE4_PS(aX3, aY3, aZ3, w3);
+
+            const __m128 columns[4][4] = {{aX0, aX1, aX2, aX3},
+                                          {aY0, aY1, aY2, aY3},
+                                          {aZ0, aZ1, aZ2, aZ3},
+                                          {w, w1, w2, w3}};
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                float *matrix = &aMatrices[lane][0][0];
+                for (int column = 0; column < 4; ++column)
+                {
+                    _mm_storeu_ps(matrix + column * 4, columns[lane][column]);
+                }
+            }
+        }
+    } // namespace
+#endif
+
+    void TransformBatch::Resize(std::size_t aSize)
+    {
+        mPositionX.resize(aSize, 0.0F);
+        mPositionY.resize(aSize, 0.0F);
+        mPositionZ.resize(aSize, 0.0F);
+        mRotationX.resize(aSize, 0.0F);
+        mRotationY.resize(aSize, 0.0F);
+        mRotationZ.resize(aSize, 0.0F);
+        mRotationW.resize(aSize, 1.0F);
+        mScaleX.resize(aSize, 1.0F);
+        mScaleY.resize(aSize, 1.0F);
+        mScaleZ.resize(aSize, 1.0F);
+    }
+
+    void TransformBatch::Clear()
+    {
+        Resize(0);
+    }
+
+    std::size_t TransformBatch::GetSize() const
+    {
+        return mPositionX.size();
+    }
+
+    void TransformBatch::Set(std::size_t aIndex, const glm::vec3 &aPosition, const glm::quat &aRotation, const glm::vec3 &aScale)
+    {
+        mPositionX[aIndex] = aPosition.x;
+        mPositionY[aIndex] = aPosition.y;
+        mPositionZ[aIndex] = aPosition.z;
+        mRotationX[aIndex] = aRotation.x;
+        mRotationY[aIndex] = aRotation.y;
+        mRotationZ[aIndex] = aRotation.z;
+        mRotationW[aIndex] = aRotation.w;
+        mScaleX[aIndex] = aScale.x;
+        mScaleY[aIndex] = aScale.y;
+        mScaleZ[aIndex] = aScale.z;
+    }
+
+    void TransformBatch::Set(std::size_t aIndex, const Transform &aTransform)
+    {
+        Set(aIndex, aTransform.GetPosition(), aTransform.GetRotationQuat(), aTransform.GetScale());
+    }
+
+    void TransformBatch::Compose(glm::mat4 *aMatrices) const
+    {
+        Compose(0, GetSize(), aMatrices);
+    }
+
+    const char *TransformBatch::GetInstructionSet()
+    {
+#if defined(NABLA2D_TRANSFORMBATCH_AVX)
+        return "AVX";
+#elif defined(NABLA2D_TRANSFORMBATCH_SSE)
+        return "SSE";
+#else
+        return "scalar";
+#endif
+    }
+
+    void TransformBatch::Compose(std::size_t aBegin, std::size_t aEnd, glm::mat4 *aMatrices) const
+    {
+        std::size_t i = aBegin;
+
+#if defined(NABLA2D_TRANSFORMBATCH_AVX)
+        const __m256 one = _mm256_set1_ps(1.0F);
+        const __m256 two = _mm256_set1_ps(2.0F);
+        for (; i + 8 <= aEnd; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(&mRotationX[i]);
+            const __m256 y = _mm256_loadu_ps(&mRotationY[i]);
+            const __m256 z = _mm256_loadu_ps(&mRotationZ[i]);
+            const __m256 w = _mm256_loadu_ps(&mRotationW[i]);
+            const __m256 sx = _mm256_loadu_ps(&mScaleX[i]);
+            const __m256 sy = _mm256_loadu_ps(&mScaleY[i]);
+            const __m256 sz = _mm256_loadu_ps(&mScaleZ[i]);
+
+            const __m256 x2 = _mm256_mul_ps(x, two);
+            const __m256 y2 = _mm256_mul_ps(y, two);
+            const __m256 z2 = _mm256_mul_ps(z, two);
+            const __m256 xx = _mm256_mul_ps(x, x2);
+            const __m256 yy = _mm256_mul_ps(y, y2);
+            const __m256 zz = _mm256_mul_ps(z, z2);
+            const __m256 xy = _mm256_mul_ps(x, y2);
+            const __m256 xz = _mm256_mul_ps(x, z2);
+            const __m256 yz = _mm256_mul_ps(y, z2);
+            const __m256 wx = _mm256_mul_ps(w, x2);
+            const __m256 wy = _mm256_mul_ps(w, y2);
+            const __m256 wz = _mm256_mul_ps(w, z2);
+
+            const __m256 m00 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx);
+            const __m256 m01 = _mm256_mul_ps(_mm256_add_ps(xy, wz), sx);
+            const __m256 m02 = _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx);
+            const __m256 m10 = _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy);
+            const __m256 m11 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy);
+            const __m256 m12 = _mm256_mul_ps(_mm256_add_ps(yz, wx), sy);
+            const __m256 m20 = _mm256_mul_ps(_mm256_add_ps(xz, wy), sz);
+            const __m256 m21 = _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz);
+            const __m256 m22 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz);
+            const __m256 px = _mm256_loadu_ps(&mPositionX[i]);
+            const __m256 py = _mm256_loadu_ps(&mPositionY[i]);
+            const __m256 pz = _mm256_loadu_ps(&mPositionZ[i]);
+
+            for (int half = 0; half < 2; ++half)
+            {
+                const auto lanes = [half](__m256 aValue)
+                { return half == 0 ? _mm256_castps256_ps128(aValue) : _mm256_extractf128_ps(aValue, 1); };
+                StoreColumns(lanes(m00), lanes(m01), lanes(m02),
+                             lanes(m10), lanes(m11), lanes(m12),
+                             lanes(m20), lanes(m21), lanes(m22),
+                             lanes(px), lanes(py), lanes(pz),
+                             aMatrices + i + half * 4);
+            }
+        }
+#elif defined(NABLA2D_TRANSFORMBATCH_SSE)
+        const __m128 one = _mm_set1_ps(1.0F);
+        const __m128 two = _mm_set1_ps(2.0F);
+        for (; i + 4 <= aEnd; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(&mRotationX[i]);
+            const __m128 y = _mm_loadu_ps(&mRotationY[i]);
+            const __m128 z = _mm_loadu_ps(&mRotationZ[i]);
+            const __m128 w = _mm_loadu_ps(&mRotationW[i]);
+            const __m128 sx = _mm_loadu_ps(&mScaleX[i]);
+            const __m128 sy = _mm_loadu_ps(&mScaleY[i]);
+            const __m128 sz = _mm_loadu_ps(&mScaleZ[i]);
+
+            const __m128 x2 = _mm_mul_ps(x, two);
+            const __m128 y2 = _mm_mul_ps(y, two);
+            const __m128 z2 = _mm_mul_ps(z, two);
+            const __m128 xx = _mm_mul_ps(x, x2);
+            const __m128 yy = _mm_mul_ps(y, y2);
+            const __m128 zz = _mm_mul_ps(z, z2);
+            const __m128 xy = _mm_mul_ps(x, y2);
+            const __m128 xz = _mm_mul_ps(x, z2);
+            const __m128 yz = _mm_mul_ps(y, z2);
+            const __m128 wx = _mm_mul_ps(w, x2);
+            const __m128 wy = _mm_mul_ps(w, y2);
+            const __m128 wz = _mm_mul_ps(w, z2);
+
+            StoreColumns(_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+                         _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                         _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+                         _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                         _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+                         _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+                         _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                         _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                         _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+                         _mm_loadu_ps(&mPositionX[i]),
+                         _mm_loadu_ps(&mPositionY[i]),
+                         _mm_loadu_ps(&mPositionZ[i]),
+                         aMatrices + i);
+        }
+#endif
+
+        ComposeScalar(i, aEnd, aMatrices);
+    }
+
+    void TransformBatch::ComposeScalar(std::size_t aBegin, std::size_t aEnd, glm::mat4 *aMatrices) const
+    {
+        for (std::size_t i = aBegin; i < aEnd; ++i)
+        {
+            const float x = mRotationX[i];
+            const float y = mRotationY[i];
+            const float z = mRotationZ[i];
+            const float w = mRotationW[i];
+            const float xx = 2.0F * x * x;
+            const float yy = 2.0F * y * y;
+            const float zz = 2.0F * z * z;
+            const float xy = 2.0F * x * y;
+            const float xz = 2.0F * x * z;
+            const float yz = 2.0F * y * z;
+            const float wx = 2.0F * w * x;
+            const float wy = 2.0F * w * y;
+            const float wz = 2.0F * w * z;
+
+            auto &matrix = aMatrices[i];
+            matrix[0] = glm::vec4(1.0F - yy - zz, xy + wz, xz - wy, 0.0F) * mScaleX[i];
+            matrix[1] = glm::vec4(xy - wz, 1.0F - xx - zz, yz + wx, 0.0F) * mScaleY[i];
+            matrix[2] = glm::vec4(xz + wy, yz - wx, 1.0F - xx - yy, 0.0F) * mScaleZ[i];
+            matrix[3] = glm::vec4(mPositionX[i], mPositionY[i], mPositionZ[i], 1.0F);
+        }
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
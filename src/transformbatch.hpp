@@ -0,0 +1,75 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_TRANSFORMBATCH_HPP
+#define NABLA2D_TRANSFORMBATCH_HPP
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "transform.hpp"
+
+namespace nabla2d
+{
+    // Position, rotation and scale of many transforms as separate arrays, composed into
+    // matrices (translate * rotate * scale, like Transform::GetMatrix) in one pass. The
+    // kernel is picked at compile time: AVX, then SSE, then plain scalar code.
+    class TransformBatch
+    {
+    public:
+        TransformBatch() = default;
+        ~TransformBatch() = default;
+
+        void Resize(std::size_t aSize);
+        void Clear();
+        std::size_t GetSize() const;
+
+        void Set(std::size_t aIndex, const glm::vec3 &aPosition, const glm::quat &aRotation, const glm::vec3 &aScale);
+        void Set(std::size_t aIndex, const Transform &aTransform);
+
+        // aMatrices must hold GetSize() matrices
+        void Compose(glm::mat4 *aMatrices) const;
+        // Composes [aBegin, aEnd) into aMatrices[aBegin, aEnd), for splitting over jobs
+        void Compose(std::size_t aBegin, std::size_t aEnd, glm::mat4 *aMatrices) const;
+
+        static const char *GetInstructionSet();
+
+    private:
+        std::vector<float> mPositionX;
+        std::vector<float> mPositionY;
+        std::vector<float> mPositionZ;
+        std::vector<float> mRotationX;
+        std::vector<float> mRotationY;
+        std::vector<float> mRotationZ;
+        std::vector<float> mRotationW;
+        std::vector<float> mScaleX;
+        std::vector<float> mScaleY;
+        std::vector<float> mScaleZ;
+
+        void ComposeScalar(std::size_t aBegin, std::size_t aEnd, glm::mat4 *aMatrices) const;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_TRANSFORMBATCH_HPP
+
+// くコ:彡
\ No newline at end of file
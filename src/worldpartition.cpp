@@ -0,0 +1,207 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "worldpartition.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <unordered_map>
+#include <fmt/format.h>
+
+#include "logger.hpp"
+#include "transform.hpp"
+#include "transform2d.hpp"
+#include "sceneserializer.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        struct IndexHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            float cellSize;
+            uint32_t cellCount;
+        };
+
+        std::string GetIndexPath(const std::string &aDirectory)
+        {
+            return fmt::format("{}/world.n2dw", aDirectory);
+        }
+    } // namespace
+
+    WorldPartition::WorldPartition(float aCellSize) : mCellSize(aCellSize)
+    {
+    }
+
+    float WorldPartition::GetCellSize() const
+    {
+        return mCellSize;
+    }
+
+    WorldPartition::Cell WorldPartition::GetCell(const glm::vec3 &aPosition) const
+    {
+        return {static_cast<int>(std::floor(aPosition.x / mCellSize)), static_cast<int>(std::floor(aPosition.y / mCellSize))};
+    }
+
+    bool WorldPartition::HasCell(const Cell &aCell) const
+    {
+        return mCells.find(GetCellKey(aCell)) != mCells.end();
+    }
+
+    std::size_t WorldPartition::GetCellCount() const
+    {
+        return mCells.size();
+    }
+
+    uint64_t WorldPartition::GetCellKey(const Cell &aCell)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(aCell.x)) << 32U) | static_cast<uint32_t>(aCell.y);
+    }
+
+    std::string WorldPartition::GetCellPath(const std::string &aDirectory, const Cell &aCell)
+    {
+        return fmt::format("{}/cell_{}_{}.n2ds", aDirectory, aCell.x, aCell.y);
+    }
+
+    bool WorldPartition::Open(const std::string &aDirectory)
+    {
+        const auto path = GetIndexPath(aDirectory);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            Logger::error("WorldPartition::Open: Failed to open file '{}'", path);
+            return false;
+        }
+
+        IndexHeader header;
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file.good() || header.magic != kMagic || header.version != kVersion || !(header.cellSize > 0.0F))
+        {
+            Logger::error("WorldPartition::Open: File '{}' is not a version {} world index", path, kVersion);
+            return false;
+        }
+
+        std::vector<Cell> cells(header.cellCount);
+        file.read(reinterpret_cast<char *>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(Cell)));
+        if (!file.good())
+        {
+            Logger::error("WorldPartition::Open: File '{}' is truncated", path);
+            return false;
+        }
+
+        mCellSize = header.cellSize;
+        mCells.clear();
+        mCells.reserve(cells.size());
+        for (const auto &cell : cells)
+        {
+            mCells.insert(GetCellKey(cell));
+        }
+        return true;
+    }
+
+    bool WorldPartition::Build(const Scene &aScene, const std::string &aDirectory, float aCellSize)
+    {
+        if (!(aCellSize > 0.0F))
+        {
+            Logger::error("WorldPartition::Build: Invalid cell size {}", aCellSize);
+            return false;
+        }
+
+        const WorldPartition partition(aCellSize);
+        const auto &registry = aScene.GetRegistry();
+        std::unordered_map<uint64_t, std::vector<entt::entity>> cellEntities;
+        std::vector<Cell> cells;
+        std::size_t skipped = 0;
+
+        for (auto root : aScene.GetChildren(entt::null))
+        {
+            glm::vec3 position;
+            if (const auto *transform = registry.try_get<Transform>(root); transform != nullptr)
+            {
+                position = transform->GetPosition();
+            }
+            else if (const auto *transform2D = registry.try_get<Transform2D>(root); transform2D != nullptr)
+            {
+                position = glm::vec3(transform2D->GetPosition(), 0.0F);
+            }
+            else
+            {
+                ++skipped;
+                continue;
+            }
+
+            const auto cell = partition.GetCell(position);
+            auto [entities, inserted] = cellEntities.try_emplace(GetCellKey(cell));
+            if (inserted)
+            {
+                cells.push_back(cell);
+            }
+
+            // Parents first, so the subtree restores with a single batch
+            std::vector<entt::entity> stack{root};
+            while (!stack.empty())
+            {
+                const auto entity = stack.back();
+                stack.pop_back();
+                entities->second.push_back(entity);
+                const auto &children = aScene.GetChildren(entity);
+                stack.insert(stack.end(), children.rbegin(), children.rend());
+            }
+        }
+
+        if (skipped > 0)
+        {
+            Logger::warn("WorldPartition::Build: {} root entities have no Transform and were left out", skipped);
+        }
+
+        for (const auto &cell : cells)
+        {
+            const auto data = SceneSerializer::Capture(aScene, cellEntities.at(GetCellKey(cell)));
+            if (!SceneSerializer::Write(data, GetCellPath(aDirectory, cell)))
+            {
+                return false;
+            }
+        }
+
+        const auto path = GetIndexPath(aDirectory);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::error("WorldPartition::Build: Failed to open file '{}'", path);
+            return false;
+        }
+
+        const IndexHeader header{kMagic, kVersion, aCellSize, static_cast<uint32_t>(cells.size())};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(Cell)));
+        if (!file.good())
+        {
+            Logger::error("WorldPartition::Build: Failed to write file '{}'", path);
+            return false;
+        }
+
+        Logger::info("World partitioned into {} cells of size {}", cells.size(), aCellSize);
+        return true;
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
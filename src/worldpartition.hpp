@@ -0,0 +1,71 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_WORLDPARTITION_HPP
+#define NABLA2D_WORLDPARTITION_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+#include <glm/glm.hpp>
+
+#include "scene.hpp"
+
+namespace nabla2d
+{
+    // Splits a world into fixed-size square cells on the XY plane. Every cell is stored as
+    // its own scene file next to an index listing the cells that exist.
+    class WorldPartition
+    {
+    public:
+        typedef glm::ivec2 Cell;
+
+        static constexpr uint32_t kMagic = 0x5750324EU; // "N2PW"
+        static constexpr uint32_t kVersion = 1;
+
+        WorldPartition() = default;
+        explicit WorldPartition(float aCellSize);
+        ~WorldPartition() = default;
+
+        float GetCellSize() const;
+        Cell GetCell(const glm::vec3 &aPosition) const;
+        bool HasCell(const Cell &aCell) const;
+        std::size_t GetCellCount() const;
+
+        static uint64_t GetCellKey(const Cell &aCell);
+        static std::string GetCellPath(const std::string &aDirectory, const Cell &aCell);
+
+        bool Open(const std::string &aDirectory);
+
+        // Assigns every root entity (with its whole subtree) to the cell containing its
+        // Transform position, then writes the cell files and the index to aDirectory.
+        // Root entities without a Transform aren't part of any cell and are skipped.
+        static bool Build(const Scene &aScene, const std::string &aDirectory, float aCellSize);
+
+    private:
+        float mCellSize{0.0F};
+        std::unordered_set<uint64_t> mCells;
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_WORLDPARTITION_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,230 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "worldstreamer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    namespace
+    {
+        int GetCellDistance(const WorldPartition::Cell &aA, const WorldPartition::Cell &aB)
+        {
+            return std::max(std::abs(aA.x - aB.x), std::abs(aA.y - aB.y));
+        }
+    } // namespace
+
+    WorldStreamer::WorldStreamer(Scene &aScene, JobSystem &aJobSystem) : mScene(aScene),
+                                                                         mJobSystem(aJobSystem)
+    {
+    }
+
+    bool WorldStreamer::Open(const std::string &aDirectory)
+    {
+        return Open(aDirectory, Settings());
+    }
+
+    bool WorldStreamer::Open(const std::string &aDirectory, const Settings &aSettings)
+    {
+        Close();
+        if (!mPartition.Open(aDirectory))
+        {
+            return false;
+        }
+
+        mDirectory = aDirectory;
+        mSettings = aSettings;
+        if (mSettings.unloadRadius <= mSettings.loadRadius)
+        {
+            Logger::warn("WorldStreamer::Open: Unload radius {} must exceed load radius {}, using {}", mSettings.unloadRadius, mSettings.loadRadius, mSettings.loadRadius + 1);
+            mSettings.unloadRadius = mSettings.loadRadius + 1;
+        }
+        mOpen = true;
+
+        Logger::info("Streaming world '{}' ({} cells)", aDirectory, mPartition.GetCellCount());
+        return true;
+    }
+
+    void WorldStreamer::Close()
+    {
+        std::vector<entt::entity> entities;
+        for (auto &[key, state] : mCells)
+        {
+            entities.insert(entities.end(), state.entities.begin(), state.entities.end());
+        }
+        if (!entities.empty())
+        {
+            mScene.DestroyEntities(entities);
+        }
+
+        // Pending reads finish on their own, their results are simply dropped
+        mCells.clear();
+        mPendingCount = 0;
+        mOpen = false;
+    }
+
+    bool WorldStreamer::IsOpen() const
+    {
+        return mOpen;
+    }
+
+    void WorldStreamer::Update(const Camera &aCamera)
+    {
+        if (!mOpen)
+        {
+            return;
+        }
+
+        const auto center = mPartition.GetCell(aCamera.GetPosition());
+        UnloadDistantCells(center);
+        RequestNearbyCells(center);
+        IntegrateReadyCells(center);
+    }
+
+    const WorldPartition &WorldStreamer::GetPartition() const
+    {
+        return mPartition;
+    }
+
+    std::size_t WorldStreamer::GetLoadedCellCount() const
+    {
+        return mCells.size() - mPendingCount;
+    }
+
+    std::size_t WorldStreamer::GetPendingCellCount() const
+    {
+        return mPendingCount;
+    }
+
+    void WorldStreamer::UnloadDistantCells(const WorldPartition::Cell &aCenter)
+    {
+        std::vector<entt::entity> entities;
+        for (auto state = mCells.begin(); state != mCells.end();)
+        {
+            if (GetCellDistance(state->second.cell, aCenter) <= mSettings.unloadRadius)
+            {
+                ++state;
+                continue;
+            }
+
+            if (state->second.loaded)
+            {
+                entities.insert(entities.end(), state->second.entities.begin(), state->second.entities.end());
+            }
+            else
+            {
+                --mPendingCount;
+            }
+            state = mCells.erase(state);
+        }
+
+        if (!entities.empty())
+        {
+            mScene.DestroyEntities(entities);
+        }
+    }
+
+    void WorldStreamer::RequestNearbyCells(const WorldPartition::Cell &aCenter)
+    {
+        if (mPendingCount >= mSettings.maxPendingLoads)
+        {
+            return;
+        }
+
+        std::vector<WorldPartition::Cell> missing;
+        const auto radius = mSettings.loadRadius;
+        for (int y = aCenter.y - radius; y <= aCenter.y + radius; ++y)
+        {
+            for (int x = aCenter.x - radius; x <= aCenter.x + radius; ++x)
+            {
+                const WorldPartition::Cell cell{x, y};
+                if (mPartition.HasCell(cell) && mCells.find(WorldPartition::GetCellKey(cell)) == mCells.end())
+                {
+                    missing.push_back(cell);
+                }
+            }
+        }
+
+        // Closest cells are read first
+        std::sort(missing.begin(), missing.end(), [&aCenter](const auto &aA, const auto &aB)
+                  { return GetCellDistance(aA, aCenter) < GetCellDistance(aB, aCenter); });
+
+        for (const auto &cell : missing)
+        {
+            if (mPendingCount >= mSettings.maxPendingLoads)
+            {
+                break;
+            }
+
+            auto path = WorldPartition::GetCellPath(mDirectory, cell);
+            auto &state = mCells[WorldPartition::GetCellKey(cell)];
+            state.cell = cell;
+            state.request = mJobSystem.Schedule([path = std::move(path)]()
+                                             {
+                                                 SceneSerializer::SceneData data;
+                                                 SceneSerializer::Read(path, data);
+                                                 return data; });
+            ++mPendingCount;
+        }
+    }
+
+    void WorldStreamer::IntegrateReadyCells(const WorldPartition::Cell &aCenter)
+    {
+        std::vector<CellState *> ready;
+        for (auto &[key, state] : mCells)
+        {
+            if (!state.read && state.request.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                state.data = state.request.get();
+                state.read = true;
+            }
+            if (state.read && !state.loaded)
+            {
+                ready.push_back(&state);
+            }
+        }
+
+        std::sort(ready.begin(), ready.end(), [&aCenter](const auto *aA, const auto *aB)
+                  { return GetCellDistance(aA->cell, aCenter) < GetCellDistance(aB->cell, aCenter); });
+
+        std::size_t integrated = 0;
+        for (auto *state : ready)
+        {
+            const auto count = state->data.tags.size();
+            if (integrated > 0 && integrated + count > mSettings.entityBudget)
+            {
+                break;
+            }
+
+            state->entities = SceneSerializer::Restore(mScene, state->data);
+            state->data = {};
+            state->loaded = true;
+            integrated += count;
+            --mPendingCount;
+        }
+    }
+} // namespace nabla2d
+
+// くコ:彡
\ No newline at end of file
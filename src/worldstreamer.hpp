@@ -0,0 +1,102 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef NABLA2D_WORLDSTREAMER_HPP
+#define NABLA2D_WORLDSTREAMER_HPP
+
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdint>
+#include <unordered_map>
+#include <entt/entt.hpp>
+
+#include "scene.hpp"
+#include "camera.hpp"
+#include "jobsystem.hpp"
+#include "worldpartition.hpp"
+#include "sceneserializer.hpp"
+
+namespace nabla2d
+{
+    // Keeps the cells of a WorldPartition around the camera loaded in a Scene.
+    // Cell files are read on the job system; integration into the scene happens
+    // on the calling thread, a few cells per frame.
+    class WorldStreamer
+    {
+    public:
+        struct Settings
+        {
+            // Radii are in cells (Chebyshev distance). Cells load inside loadRadius
+            // and only unload past unloadRadius so crossing a border doesn't thrash.
+            int loadRadius{2};
+            int unloadRadius{3};
+            // Entities integrated per Update; at least one ready cell always gets in
+            std::size_t entityBudget{4096};
+            std::size_t maxPendingLoads{8};
+        };
+
+        WorldStreamer(Scene &aScene, JobSystem &aJobSystem);
+        WorldStreamer(const WorldStreamer &aWorldStreamer) = delete;
+        WorldStreamer &operator=(const WorldStreamer &aWorldStreamer) = delete;
+        ~WorldStreamer() = default;
+
+        bool Open(const std::string &aDirectory);
+        bool Open(const std::string &aDirectory, const Settings &aSettings);
+        void Close();
+        bool IsOpen() const;
+
+        void Update(const Camera &aCamera);
+
+        const WorldPartition &GetPartition() const;
+        std::size_t GetLoadedCellCount() const;
+        std::size_t GetPendingCellCount() const;
+
+    private:
+        struct CellState
+        {
+            WorldPartition::Cell cell;
+            std::future<SceneSerializer::SceneData> request;
+            SceneSerializer::SceneData data;
+            std::vector<entt::entity> entities;
+            bool read{false};
+            bool loaded{false};
+        };
+
+        Scene &mScene;
+        JobSystem &mJobSystem;
+
+        std::string mDirectory;
+        Settings mSettings;
+        WorldPartition mPartition;
+        bool mOpen{false};
+
+        std::unordered_map<uint64_t, CellState> mCells;
+        std::size_t mPendingCount{0};
+
+        void UnloadDistantCells(const WorldPartition::Cell &aCenter);
+        void RequestNearbyCells(const WorldPartition::Cell &aCenter);
+        void IntegrateReadyCells(const WorldPartition::Cell &aCenter);
+    };
+} // namespace nabla2d
+
+#endif // NABLA2D_WORLDSTREAMER_HPP
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,211 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "check.hpp"
+#include "audiosystem.hpp"
+
+namespace nabla2d
+{
+    constexpr int kSampleRate = 48000;
+    constexpr float kTolerance = 1e-5F;
+
+    static void PutLE(std::vector<char> &aData, uint32_t aValue, int aBytes)
+    {
+        for (int i = 0; i < aBytes; ++i)
+        {
+            aData.push_back(static_cast<char>((aValue >> (8 * i)) & 0xFF));
+        }
+    }
+
+    // 32 bit float .wav, decoded by the stream to exactly the samples written
+    static std::string WriteWAV(const std::string &aName, const std::vector<float> &aSamples, int aChannels, int aSampleRate)
+    {
+        const auto path = (std::filesystem::temp_directory_path() / aName).string();
+        const auto size = static_cast<uint32_t>(aSamples.size() * sizeof(float));
+        const auto channels = static_cast<uint32_t>(aChannels);
+        const auto rate = static_cast<uint32_t>(aSampleRate);
+        std::vector<char> data;
+        data.insert(data.end(), {'R', 'I', 'F', 'F'});
+        PutLE(data, 36 + size, 4);
+        data.insert(data.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+        PutLE(data, 16, 4);
+        PutLE(data, 3, 2);
+        PutLE(data, channels, 2);
+        PutLE(data, rate, 4);
+        PutLE(data, rate * channels * 4, 4);
+        PutLE(data, channels * 4, 2);
+        PutLE(data, 32, 2);
+        data.insert(data.end(), {'d', 'a', 't', 'a'});
+        PutLE(data, size, 4);
+        for (const float sample : aSamples)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &sample, sizeof(bits));
+            PutLE(data, bits, 4);
+        }
+        std::ofstream file(path, std::ios::binary);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return path;
+    }
+
+    static std::vector<float> MakeSignal(std::size_t aFrames, int aChannels)
+    {
+        std::vector<float> samples;
+        for (std::size_t i = 0; i < aFrames; ++i)
+        {
+            for (int channel = 0; channel < aChannels; ++channel)
+            {
+                samples.push_back(0.8F * std::sin(static_cast<float>(i) * 0.01F * static_cast<float>(channel + 1) + static_cast<float>(channel)));
+            }
+        }
+        return samples;
+    }
+
+    // Largest difference over aBuffers offline buffers, the streams are only filled by the
+    // decoding thread
+    static float Compare(AudioSystem &aAudio, AudioSystem &aOther, int aBuffers, std::size_t aFrames)
+    {
+        std::vector<float> output(aFrames * 2);
+        std::vector<float> other(aFrames * 2);
+        float difference = 0.0F;
+        for (int buffer = 0; buffer < aBuffers; ++buffer)
+        {
+            aAudio.RenderOffline(output.data(), aFrames);
+            aOther.RenderOffline(other.data(), aFrames);
+            for (std::size_t i = 0; i < output.size(); ++i)
+            {
+                difference = std::max(difference, std::fabs(output[i] - other[i]));
+            }
+        }
+        aAudio.Update();
+        aOther.Update();
+        return difference;
+    }
+
+    // A streamed file renders like the same samples loaded in memory, whatever the buffer
+    // size, and never underruns even when a buffer reads more than the ring holds
+    static void TestOffline()
+    {
+        const struct
+        {
+            int channels;
+            int sampleRate;
+            float pitch;
+            bool loop;
+            std::size_t frames;
+        } kCases[] = {{1, kSampleRate, 1.0F, false, 512}, {2, kSampleRate, 1.0F, true, 4096}, {2, 44100, 1.5F, false, 1024},
+                      {1, 22050, 3.0F, true, 4096}, {2, 96000, 4.0F, false, 2048}};
+        for (const auto &parameters : kCases)
+        {
+            const auto samples = MakeSignal(60000, parameters.channels);
+            const auto path = WriteWAV("nabla2d_audiostreamtest.wav", samples, parameters.channels, parameters.sampleRate);
+
+            AudioSystem streamed(kSampleRate);
+            AudioSystem memory(kSampleRate);
+            // The smallest buffer, a render can read several times what it holds
+            streamed.SetStreamLatency(0.0F);
+            AudioSystem::PlayParameters play;
+            play.pitch = parameters.pitch;
+            play.loop = parameters.loop;
+            play.pan = 0.3F;
+            const auto stream = streamed.PlayStream(path, play);
+            const auto voice = memory.Play(memory.LoadSamples(samples, parameters.channels, parameters.sampleRate), play);
+            NABLA2D_CHECK(stream != AudioSystem::kInvalidVoice);
+
+            const float difference = Compare(streamed, memory, 40, parameters.frames);
+            NABLA2D_CHECK(parameters.pitch != 1.0F || difference == 0.0F);
+            NABLA2D_CHECK(difference < kTolerance);
+            NABLA2D_CHECK(streamed.IsPlaying(stream) == memory.IsPlaying(voice));
+            NABLA2D_CHECK(streamed.GetStats().streamUnderruns == 0);
+        }
+    }
+
+    // Virtual streamed voices skip more frames than their buffer holds and come back in step
+    static void TestVirtual()
+    {
+        const auto samples = MakeSignal(200000, 2);
+        const auto path = WriteWAV("nabla2d_audiostreamtest.wav", samples, 2, kSampleRate);
+
+        AudioSystem streamed(kSampleRate);
+        AudioSystem memory(kSampleRate);
+        streamed.SetStreamLatency(0.0F);
+        AudioSystem::PlayParameters play;
+        play.pitch = 4.0F;
+        for (auto *audio : {&streamed, &memory})
+        {
+            audio->SetRealVoiceCount(0);
+        }
+        streamed.PlayStream(path, play);
+        memory.Play(memory.LoadSamples(samples, 2, kSampleRate), play);
+        Compare(streamed, memory, 4, 4096);
+
+        for (auto *audio : {&streamed, &memory})
+        {
+            audio->SetRealVoiceCount(1);
+        }
+        NABLA2D_CHECK(Compare(streamed, memory, 8, 512) < kTolerance);
+        NABLA2D_CHECK(streamed.GetStats().streamUnderruns == 0);
+    }
+
+    // The dummy driver, picked by ctest through SDL_AUDIODRIVER, runs the callback in real time
+    // while the decoding thread keeps the ring filled
+    static void TestDevice()
+    {
+        const auto samples = MakeSignal(20000, 2);
+        const auto path = WriteWAV("nabla2d_audiostreamtest.wav", samples, 2, kSampleRate);
+
+        AudioSystem audio(kSampleRate);
+        if (!NABLA2D_CHECK(audio.Init()))
+        {
+            return;
+        }
+        const auto voice = audio.PlayStream(path, {});
+        for (int frame = 0; frame < 200 && audio.IsPlaying(voice); ++frame)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            audio.Update();
+        }
+        NABLA2D_CHECK(!audio.IsPlaying(voice));
+        NABLA2D_CHECK(audio.GetStats().streamUnderruns == 0);
+        audio.Destroy();
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::TestOffline();
+    nabla2d::TestVirtual();
+    nabla2d::TestDevice();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,235 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+
+#include "check.hpp"
+#include "audiosystem.hpp"
+
+namespace nabla2d
+{
+    constexpr int kSampleRate = 48000;
+    // Not a multiple of four, so the vector loops and their scalar tails both run
+    constexpr std::size_t kFrames = 250;
+    constexpr float kTolerance = 1e-5F;
+
+    static bool Near(float aValue, float aExpected)
+    {
+        return std::fabs(aValue - aExpected) < kTolerance;
+    }
+
+    // A sound holding aLeft and aRight on every frame
+    static AudioSystem::SoundHandle LoadConstant(AudioSystem &aAudio, float aLeft, float aRight, std::size_t aFrames)
+    {
+        std::vector<float> samples;
+        for (std::size_t i = 0; i < aFrames; ++i)
+        {
+            samples.push_back(aLeft);
+            samples.push_back(aRight);
+        }
+        return aAudio.LoadSamples(samples, 2, kSampleRate);
+    }
+
+    // Frame i holds i / aFrames on the left and its opposite on the right
+    static std::vector<float> MakeRamp(std::size_t aFrames)
+    {
+        std::vector<float> samples;
+        for (std::size_t i = 0; i < aFrames; ++i)
+        {
+            samples.push_back(static_cast<float>(i) / static_cast<float>(aFrames));
+            samples.push_back(-static_cast<float>(i) / static_cast<float>(aFrames));
+        }
+        return samples;
+    }
+
+    static std::vector<float> Render(AudioSystem &aAudio)
+    {
+        std::vector<float> output(kFrames * 2);
+        aAudio.Render(output.data(), kFrames);
+        return output;
+    }
+
+    static bool IsConstant(const std::vector<float> &aOutput, float aLeft, float aRight)
+    {
+        for (std::size_t i = 0; i < aOutput.size(); i += 2)
+        {
+            if (!Near(aOutput[i], aLeft) || !Near(aOutput[i + 1], aRight))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Constant power for mono sounds, balance for stereo ones, and ramps on changes
+    static void TestPanning()
+    {
+        const float kHalfPower = std::sqrt(0.5F);
+        const struct
+        {
+            float pan;
+            float left;
+            float right;
+        } kMono[] = {{-1.0F, 1.0F, 0.0F}, {0.0F, kHalfPower, kHalfPower}, {1.0F, 0.0F, 1.0F}, {0.5F, std::cos(0.375F * 3.14159265F), std::sin(0.375F * 3.14159265F)}};
+        for (const auto &expected : kMono)
+        {
+            AudioSystem audio(kSampleRate);
+            const auto sound = audio.LoadSamples(std::vector<float>(1000, 0.5F), 1, kSampleRate);
+            AudioSystem::PlayParameters parameters;
+            parameters.pan = expected.pan;
+            audio.Play(sound, parameters);
+            NABLA2D_CHECK(IsConstant(Render(audio), 0.5F * expected.left, 0.5F * expected.right));
+        }
+
+        AudioSystem audio(kSampleRate);
+        AudioSystem::PlayParameters parameters;
+        parameters.pan = 0.5F;
+        const auto voice = audio.Play(LoadConstant(audio, 0.5F, 0.25F, 1000), parameters);
+        NABLA2D_CHECK(IsConstant(Render(audio), 0.25F, 0.25F));
+
+        // The gains move over the next buffer, then hold
+        audio.SetPan(voice, -1.0F);
+        const auto ramp = Render(audio);
+        const float last = static_cast<float>(kFrames - 1) / static_cast<float>(kFrames);
+        NABLA2D_CHECK(Near(ramp[0], 0.25F) && Near(ramp[1], 0.25F));
+        NABLA2D_CHECK(Near(ramp[kFrames * 2 - 2], 0.25F + 0.25F * last) && Near(ramp[kFrames * 2 - 1], 0.25F * (1.0F - last)));
+        NABLA2D_CHECK(IsConstant(Render(audio), 0.5F, 0.0F));
+    }
+
+    // Expected left sample of a ramp sound at aPosition, read with linear interpolation
+    static float Interpolate(const std::vector<float> &aSamples, double aPosition)
+    {
+        const auto index = static_cast<std::size_t>(aPosition);
+        const auto fraction = static_cast<float>(aPosition - static_cast<double>(index));
+        return aSamples[index * 2] + (aSamples[index * 2 + 2] - aSamples[index * 2]) * fraction;
+    }
+
+    // Whole steps of one copy the samples as they are, other steps interpolate
+    static void TestPitch()
+    {
+        const auto samples = MakeRamp(1000);
+        const struct
+        {
+            float pitch;
+            int sampleRate;
+        } kCases[] = {{1.0F, kSampleRate}, {2.0F, kSampleRate / 2}, {0.5F, kSampleRate * 2}, {2.0F, kSampleRate}, {0.75F, kSampleRate}};
+        for (const auto &parameters : kCases)
+        {
+            AudioSystem audio(kSampleRate);
+            AudioSystem::PlayParameters play;
+            play.pitch = parameters.pitch;
+            const auto voice = audio.Play(audio.LoadSamples(samples, 2, parameters.sampleRate), play);
+
+            const double step = static_cast<double>(parameters.pitch) * parameters.sampleRate / kSampleRate;
+            bool near = true;
+            bool exact = true;
+            for (std::size_t buffer = 0; buffer < 2; ++buffer)
+            {
+                const auto output = Render(audio);
+                for (std::size_t i = 0; i < kFrames; ++i)
+                {
+                    const double position = step * static_cast<double>(buffer * kFrames + i);
+                    const float left = Interpolate(samples, position);
+                    near = near && Near(output[i * 2], left) && Near(output[i * 2 + 1], -left);
+                    exact = exact && output[i * 2] == left && output[i * 2 + 1] == -left;
+                }
+            }
+            NABLA2D_CHECK(near);
+            NABLA2D_CHECK(step != 1.0 || exact);
+
+            // The third buffer runs past the end of the shorter sounds
+            Render(audio);
+            audio.Update();
+            NABLA2D_CHECK(audio.IsPlaying(voice) == (step * 3.0 * kFrames < 1000.0));
+        }
+
+        // Back to pitch 1 between two frames, the samples must still be interpolated
+        AudioSystem audio(kSampleRate);
+        AudioSystem::PlayParameters play;
+        play.pitch = 1.25F;
+        const auto voice = audio.Play(audio.LoadSamples(samples, 2, kSampleRate), play);
+        Render(audio);
+        audio.SetPitch(voice, 1.0F);
+        const auto output = Render(audio);
+        bool near = true;
+        for (std::size_t i = 0; i < kFrames; ++i)
+        {
+            const double position = 1.25 * kFrames + static_cast<double>(i);
+            near = near && Near(output[i * 2], Interpolate(samples, position));
+        }
+        NABLA2D_CHECK(near);
+    }
+
+    // Only the most important voices are heard, the others keep their place in the sound
+    static void TestVirtualVoices()
+    {
+        AudioSystem audio(kSampleRate);
+        audio.SetRealVoiceCount(1);
+        const auto samples = MakeRamp(2000);
+        AudioSystem::PlayParameters low;
+        low.priority = 0;
+        audio.Play(audio.LoadSamples(samples, 2, kSampleRate), low);
+        AudioSystem::PlayParameters high;
+        high.priority = 1;
+        high.volume = 0.25F;
+        const auto important = audio.Play(LoadConstant(audio, 1.0F, 1.0F, 4000), high);
+
+        NABLA2D_CHECK(IsConstant(Render(audio), 0.25F, 0.25F));
+        NABLA2D_CHECK(IsConstant(Render(audio), 0.25F, 0.25F));
+        auto stats = audio.GetStats();
+        NABLA2D_CHECK(stats.realVoices == 1 && stats.virtualVoices == 1);
+
+        // The virtual voice comes back where it would be, fading in over one buffer
+        audio.Stop(important);
+        const auto fadeIn = Render(audio);
+        const std::size_t start = kFrames * 2;
+        for (const std::size_t i : {std::size_t{0}, kFrames / 2, kFrames - 1})
+        {
+            const float gain = static_cast<float>(i) / static_cast<float>(kFrames);
+            NABLA2D_CHECK(Near(fadeIn[i * 2], samples[(start + i) * 2] * gain));
+            NABLA2D_CHECK(Near(fadeIn[i * 2 + 1], samples[(start + i) * 2 + 1] * gain));
+        }
+        const auto output = Render(audio);
+        NABLA2D_CHECK(output[0] == samples[(start + kFrames) * 2] && output[1] == samples[(start + kFrames) * 2 + 1]);
+        stats = audio.GetStats();
+        NABLA2D_CHECK(stats.realVoices == 1 && stats.virtualVoices == 0);
+
+        // A more important voice pushes it out, it fades out over one buffer
+        audio.Play(LoadConstant(audio, 1.0F, 1.0F, 4000), high);
+        const auto fadeOut = Render(audio);
+        const std::size_t position = start + kFrames * 2;
+        NABLA2D_CHECK(Near(fadeOut[0], 0.25F + samples[position * 2]));
+        NABLA2D_CHECK(Near(fadeOut[kFrames * 2 - 2], 0.25F + samples[(position + kFrames - 1) * 2] / static_cast<float>(kFrames)));
+        NABLA2D_CHECK(IsConstant(Render(audio), 0.25F, 0.25F));
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::TestPanning();
+    nabla2d::TestPitch();
+    nabla2d::TestVirtualVoices();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,55 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef NABLA2D_CHECK_HPP
+#define NABLA2D_CHECK_HPP
+
+#include <cstddef>
+
+#include "logger.hpp"
+
+namespace nabla2d
+{
+    // Minimal assertions for the tests/ executables. A failed check is logged and counted,
+    // the test keeps running and main returns NABLA2D_CHECK_RESULT() for ctest.
+    inline std::size_t &GetCheckFailures()
+    {
+        static std::size_t sFailures = 0;
+        return sFailures;
+    }
+
+    inline bool Check(bool aCondition, const char *aExpression, const char *aFile, int aLine)
+    {
+        if (!aCondition)
+        {
+            Logger::error("{}:{}: Check failed: {}", aFile, aLine, aExpression);
+            ++GetCheckFailures();
+        }
+        return aCondition;
+    }
+} // namespace nabla2d
+
+#define NABLA2D_CHECK(aCondition) nabla2d::Check((aCondition), #aCondition, __FILE__, __LINE__)
+#define NABLA2D_CHECK_RESULT() (nabla2d::GetCheckFailures() == 0 ? 0 : 1)
+
+#endif // NABLA2D_CHECK_HPP
+
+// くコ:彡
\ No newline at end of file
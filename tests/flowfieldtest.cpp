@@ -0,0 +1,160 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include "check.hpp"
+#include "navgrid.hpp"
+#include "flowfield.hpp"
+
+namespace nabla2d
+{
+    // Walls, loose blocked cells and patches of costlier ground
+    static void CreateMap(NavGrid &aGrid, int aSize, std::mt19937 &aRandom)
+    {
+        aGrid.Resize(aSize, aSize);
+        std::uniform_int_distribution<int> cell(0, aSize - 1);
+        std::uniform_int_distribution<int> length(3, aSize / 3);
+        std::uniform_int_distribution<int> cost(2, 9);
+        for (int i = 0; i < aSize / 2; ++i)
+        {
+            const auto x = cell(aRandom);
+            const auto y = cell(aRandom);
+            const auto wallLength = length(aRandom);
+            const bool horizontal = (aRandom() & 1U) != 0;
+            for (int j = 0; j < wallLength; ++j)
+            {
+                aGrid.SetCost(horizontal ? x + j : x, horizontal ? y : y + j, NavGrid::kBlocked);
+            }
+        }
+        for (int i = 0; i < aSize * aSize / 8; ++i)
+        {
+            aGrid.SetCost(cell(aRandom), cell(aRandom), (aRandom() & 3U) == 0 ? NavGrid::kBlocked : static_cast<uint8_t>(cost(aRandom)));
+        }
+    }
+
+    // Wall added or removed, or a new cost
+    static void ChangeCell(NavGrid &aGrid, int aX, int aY, std::mt19937 &aRandom)
+    {
+        if (!aGrid.IsInside(aX, aY))
+        {
+            return;
+        }
+        const auto roll = aRandom() % 3U;
+        if (roll == 0)
+        {
+            aGrid.SetCost(aX, aY, aGrid.IsBlocked(aX, aY) ? NavGrid::kDefaultCost : NavGrid::kBlocked);
+        }
+        else
+        {
+            aGrid.SetCost(aX, aY, static_cast<uint8_t>(1U + aRandom() % 9U));
+        }
+    }
+
+    static bool SameFields(const NavGrid &aGrid, const FlowField &aRepaired, const FlowField &aIntegrated)
+    {
+        for (int y = 0; y < aGrid.GetHeight(); ++y)
+        {
+            for (int x = 0; x < aGrid.GetWidth(); ++x)
+            {
+                if (aRepaired.GetIntegration(x, y) != aIntegrated.GetIntegration(x, y) || aRepaired.GetDirection(x, y) != aIntegrated.GetDirection(x, y))
+                {
+                    Logger::error("FlowFieldTest: Cell ({}, {}) differs, integration {} instead of {}, direction {} instead of {}", x, y,
+                                  aRepaired.GetIntegration(x, y), aIntegrated.GetIntegration(x, y), aRepaired.GetDirection(x, y), aIntegrated.GetDirection(x, y));
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Repair with the directions rebuilt over the dirty rows only, as FlowFieldSystem does,
+    // must give the field of a full integration cell for cell
+    static void TestRepair(int aSize, std::size_t aGoalCount, unsigned aSeed)
+    {
+        std::mt19937 random(aSeed);
+        NavGrid grid;
+        CreateMap(grid, aSize, random);
+        std::uniform_int_distribution<int> cell(0, aSize - 1);
+        std::vector<glm::ivec2> goals;
+        while (goals.size() < aGoalCount)
+        {
+            const glm::ivec2 goal(cell(random), cell(random));
+            if (!grid.IsBlocked(goal.x, goal.y))
+            {
+                goals.push_back(goal);
+            }
+        }
+
+        FlowField repaired;
+        repaired.SetGoals(goals);
+        repaired.Integrate(grid);
+        repaired.BuildDirections(grid, 0, aSize);
+        repaired.ClearDirtyRegion();
+        std::vector<uint32_t> changes;
+        grid.TakeChanges(changes);
+
+        for (int round = 0; round < 60; ++round)
+        {
+            const auto changeCount = 1 + static_cast<int>(random() % 12U);
+            for (int i = 0; i < changeCount; ++i)
+            {
+                ChangeCell(grid, cell(random), cell(random), random);
+            }
+            // Around a goal, and every few rounds the goal itself
+            const auto &goal = goals[random() % goals.size()];
+            ChangeCell(grid, goal.x + static_cast<int>(random() % 3U) - 1, goal.y + static_cast<int>(random() % 3U) - 1, random);
+            if (round % 5 == 0)
+            {
+                ChangeCell(grid, goal.x, goal.y, random);
+            }
+
+            changes.clear();
+            grid.TakeChanges(changes);
+            repaired.Repair(grid, changes);
+            repaired.BuildDirections(grid, 0, aSize);
+            repaired.ClearDirtyRegion();
+
+            FlowField integrated;
+            integrated.SetGoals(goals);
+            integrated.Integrate(grid);
+            integrated.BuildDirections(grid, 0, aSize);
+            if (!NABLA2D_CHECK(SameFields(grid, repaired, integrated)))
+            {
+                return;
+            }
+        }
+    }
+} // namespace nabla2d
+
+int main()
+{
+    for (unsigned seed = 1; seed <= 6; ++seed)
+    {
+        nabla2d::TestRepair(48, 1, seed);
+        nabla2d::TestRepair(96, 3, seed + 100);
+    }
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
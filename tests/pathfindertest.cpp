@@ -0,0 +1,184 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "check.hpp"
+#include "navgrid.hpp"
+#include "jobsystem.hpp"
+#include "pathfinder.hpp"
+
+namespace nabla2d
+{
+    // Hierarchical paths are close to the shortest, not the shortest. Short paths going
+    // through an entrance lose the most, up to a third on these maps.
+    constexpr float kHierarchicalTolerance = 1.4F;
+
+    // aSize x aSize map of random walls and loose blocked cells, aDensity in [0, 1]
+    static void CreateMap(NavGrid &aGrid, int aSize, float aDensity, unsigned aSeed)
+    {
+        aGrid.Resize(aSize, aSize);
+        std::mt19937 random(aSeed);
+        std::uniform_int_distribution<int> cell(0, aSize - 1);
+        std::uniform_int_distribution<int> length(3, aSize / 2);
+        const auto walls = static_cast<int>(static_cast<float>(aSize * aSize) * aDensity / 20.0F);
+        for (int i = 0; i < walls; ++i)
+        {
+            const auto x = cell(random);
+            const auto y = cell(random);
+            const auto wallLength = length(random);
+            const bool horizontal = (random() & 1U) != 0;
+            for (int j = 0; j < wallLength && aGrid.IsInside(horizontal ? x + j : x, horizontal ? y : y + j); ++j)
+            {
+                aGrid.SetCost(horizontal ? x + j : x, horizontal ? y : y + j, NavGrid::kBlocked);
+            }
+        }
+        for (int i = 0; i < static_cast<int>(static_cast<float>(aSize * aSize) * aDensity / 4.0F); ++i)
+        {
+            aGrid.SetCost(cell(random), cell(random), NavGrid::kBlocked);
+        }
+        std::vector<uint32_t> changes;
+        aGrid.TakeChanges(changes);
+    }
+
+    // Cost of a path of turning points, or 0 after a failed check when it isn't walkable
+    static uint32_t GetPathCost(const NavGrid &aGrid, const std::vector<glm::ivec2> &aPath, const glm::ivec2 &aStart, const glm::ivec2 &aGoal)
+    {
+        if (!NABLA2D_CHECK(!aPath.empty() && aPath.front() == aStart && aPath.back() == aGoal))
+        {
+            return 0;
+        }
+
+        uint32_t cost = 0;
+        for (std::size_t i = 1; i < aPath.size(); ++i)
+        {
+            const auto delta = aPath[i] - aPath[i - 1];
+            if (!NABLA2D_CHECK(delta.x == 0 || delta.y == 0 || std::abs(delta.x) == std::abs(delta.y)))
+            {
+                return 0;
+            }
+            const glm::ivec2 step(delta.x > 0 ? 1 : (delta.x < 0 ? -1 : 0), delta.y > 0 ? 1 : (delta.y < 0 ? -1 : 0));
+            for (auto cell = aPath[i - 1]; cell != aPath[i]; cell += step)
+            {
+                const auto next = cell + step;
+                const bool diagonal = step.x != 0 && step.y != 0;
+                if (!NABLA2D_CHECK(!aGrid.IsBlocked(next.x, next.y) &&
+                                   (!diagonal || (!aGrid.IsBlocked(cell.x + step.x, cell.y) && !aGrid.IsBlocked(cell.x, cell.y + step.y)))))
+                {
+                    return 0;
+                }
+                cost += diagonal ? 14U : 10U;
+            }
+        }
+        return cost;
+    }
+
+    // JPS+ must find paths exactly as short as A*, the hierarchical search paths within
+    // kHierarchicalTolerance of them, and all three must agree on which goals are reachable
+    static void CheckQueries(const NavGrid &aGrid, const Pathfinder &aPathfinder, unsigned aSeed, int aCount)
+    {
+        std::mt19937 random(aSeed);
+        std::uniform_int_distribution<int> cell(0, aGrid.GetWidth() - 1);
+        Pathfinder::Context context;
+        std::vector<glm::ivec2> path;
+        for (int i = 0; i < aCount; ++i)
+        {
+            const glm::ivec2 start(cell(random), cell(random));
+            const glm::ivec2 goal(cell(random), cell(random));
+
+            const bool found = aPathfinder.FindPath(context, start, goal, Pathfinder::SEARCH_ASTAR, path);
+            const auto optimal = found ? GetPathCost(aGrid, path, start, goal) : 0U;
+
+            NABLA2D_CHECK(aPathfinder.FindPath(context, start, goal, Pathfinder::SEARCH_JPSPLUS, path) == found);
+            if (found)
+            {
+                NABLA2D_CHECK(GetPathCost(aGrid, path, start, goal) == optimal);
+            }
+
+            NABLA2D_CHECK(aPathfinder.FindPath(context, start, goal, Pathfinder::SEARCH_HIERARCHICAL, path) == found);
+            if (found)
+            {
+                const auto cost = GetPathCost(aGrid, path, start, goal);
+                NABLA2D_CHECK(cost >= optimal && static_cast<float>(cost) <= static_cast<float>(optimal) * kHierarchicalTolerance);
+            }
+        }
+    }
+
+    static void TestRandomMaps()
+    {
+        JobSystem jobSystem(2);
+        const int sizes[] = {40, 96, 128};
+        const float densities[] = {0.05F, 0.15F, 0.3F};
+        unsigned seed = 1;
+        for (const auto size : sizes)
+        {
+            for (const auto density : densities)
+            {
+                NavGrid grid;
+                CreateMap(grid, size, density, seed);
+                Pathfinder pathfinder(grid);
+                pathfinder.Update(jobSystem);
+                CheckQueries(grid, pathfinder, seed++, 200);
+            }
+        }
+    }
+
+    // Incremental rebuilds after cells open and close must still agree with A*
+    static void TestChanges()
+    {
+        JobSystem jobSystem(2);
+        NavGrid grid;
+        CreateMap(grid, 96, 0.15F, 100);
+        Pathfinder pathfinder(grid, 8);
+        pathfinder.Update(jobSystem);
+
+        std::mt19937 random(101);
+        std::uniform_int_distribution<int> cell(0, grid.GetWidth() - 1);
+        std::vector<uint32_t> changes;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < 40; ++i)
+            {
+                const auto x = cell(random);
+                const auto y = cell(random);
+                grid.SetCost(x, y, grid.IsBlocked(x, y) ? NavGrid::kDefaultCost : NavGrid::kBlocked);
+            }
+            changes.clear();
+            grid.TakeChanges(changes);
+            pathfinder.Invalidate(changes);
+            pathfinder.Update(jobSystem);
+            NABLA2D_CHECK(!pathfinder.IsDirty());
+            CheckQueries(grid, pathfinder, 200 + static_cast<unsigned>(round), 50);
+        }
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::TestRandomMaps();
+    nabla2d::TestChanges();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
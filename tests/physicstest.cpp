@@ -0,0 +1,178 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "check.hpp"
+#include "scene.hpp"
+#include "jobsystem.hpp"
+#include "components.hpp"
+#include "transform2d.hpp"
+#include "physicssystem.hpp"
+#include "collisionsystem.hpp"
+#include "hierarchysystem.hpp"
+
+namespace nabla2d
+{
+    constexpr float kDeltaTime = 1.0F / 60.0F;
+    constexpr int kTicks = 300;
+
+    // Each world owns its job system, the scenes are built the same way so entities match
+    struct World
+    {
+        explicit World(std::size_t aWorkers) : jobSystem(aWorkers), collisionSystem(jobSystem), physicsSystem(jobSystem) {}
+
+        Scene scene;
+        JobSystem jobSystem;
+        CollisionSystem collisionSystem;
+        PhysicsSystem physicsSystem;
+        std::vector<entt::entity> bodies;
+    };
+
+    // aCount pyramids of unit boxes on one static ground, each its own island, and circles
+    // thrown at them so islands merge, split and fall asleep along the way
+    static void CreateScene(World &aWorld, std::size_t aCount, uint32_t aSeed)
+    {
+        constexpr std::size_t kBase = 6;
+        constexpr std::size_t kBoxes = kBase * (kBase + 1) / 2;
+        const float width = static_cast<float>(kBase) + 4.0F;
+        const std::size_t count = aCount * (kBoxes + 2);
+        const auto entities = aWorld.scene.CreateEntities(std::vector<StringID>(count + 1), std::vector<uint32_t>(count + 1, Scene::kNoParent));
+
+        auto &registry = aWorld.scene.GetRegistry();
+        const auto ground = entities.back();
+        const float halfWidth = width * static_cast<float>(aCount) * 0.5F;
+        registry.emplace<Transform2D>(ground, glm::vec2{halfWidth, -0.5F});
+        registry.emplace<BoxCollider>(ground, BoxCollider{{0.0F, 0.0F}, {halfWidth, 0.5F}});
+
+        std::mt19937 random(aSeed);
+        std::uniform_real_distribution<float> speed(-6.0F, 6.0F);
+        std::uniform_real_distribution<float> mass(0.5F, 4.0F);
+        std::size_t next = 0;
+        for (std::size_t pyramid = 0; pyramid < aCount; ++pyramid)
+        {
+            const float left = width * static_cast<float>(pyramid) + 2.0F;
+            for (std::size_t row = 0; row < kBase; ++row)
+            {
+                for (std::size_t column = 0; column < kBase - row; ++column)
+                {
+                    const auto entity = entities[next++];
+                    const float x = left + (static_cast<float>(column) + static_cast<float>(row) * 0.5F) * 1.05F;
+                    registry.emplace<Transform2D>(entity, glm::vec2{x, 0.5F + static_cast<float>(row)});
+                    registry.emplace<BoxCollider>(entity);
+                    registry.emplace<RigidBody>(entity);
+                    aWorld.bodies.push_back(entity);
+                }
+            }
+            for (int circle = 0; circle < 2; ++circle)
+            {
+                const auto entity = entities[next++];
+                RigidBody body;
+                body.velocity = {speed(random), speed(random) - 4.0F};
+                body.angularVelocity = speed(random);
+                body.mass = mass(random);
+                body.restitution = circle == 0 ? 0.3F : 0.0F;
+                registry.emplace<Transform2D>(entity, glm::vec2{left + static_cast<float>(circle) * 4.0F, 9.0F + static_cast<float>(circle) * 3.0F});
+                registry.emplace<CircleCollider>(entity, CircleCollider{{0.0F, 0.0F}, 0.4F + 0.2F * static_cast<float>(circle)});
+                registry.emplace<RigidBody>(entity, body);
+                aWorld.bodies.push_back(entity);
+            }
+        }
+    }
+
+    static void Step(World &aWorld)
+    {
+        HierarchySystem::Update(aWorld.scene);
+        aWorld.collisionSystem.Update(aWorld.scene.GetRegistry());
+        aWorld.physicsSystem.Step(aWorld.scene, aWorld.collisionSystem, kDeltaTime);
+    }
+
+    static bool SameBits(float aA, float aB)
+    {
+        return std::memcmp(&aA, &aB, sizeof(float)) == 0;
+    }
+
+    static bool SameBodies(World &aA, World &aB)
+    {
+        const auto &registryA = aA.scene.GetRegistry();
+        const auto &registryB = aB.scene.GetRegistry();
+        for (std::size_t i = 0; i < aA.bodies.size(); ++i)
+        {
+            const auto &transformA = registryA.get<Transform2D>(aA.bodies[i]);
+            const auto &transformB = registryB.get<Transform2D>(aB.bodies[i]);
+            const auto &bodyA = registryA.get<RigidBody>(aA.bodies[i]);
+            const auto &bodyB = registryB.get<RigidBody>(aB.bodies[i]);
+            if (!SameBits(transformA.GetPosition().x, transformB.GetPosition().x) || !SameBits(transformA.GetPosition().y, transformB.GetPosition().y) ||
+                !SameBits(transformA.GetRotation(), transformB.GetRotation()) ||
+                !SameBits(bodyA.velocity.x, bodyB.velocity.x) || !SameBits(bodyA.velocity.y, bodyB.velocity.y) ||
+                !SameBits(bodyA.angularVelocity, bodyB.angularVelocity) || bodyA.awake != bodyB.awake)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // One worker and aWorkers step the same scene in lockstep and must agree bit for bit on
+    // every tick, with enough islands to spread over several chunks
+    static void TestWorkerCount(std::size_t aWorkers, bool aSleep, uint32_t aSeed)
+    {
+        auto single = std::make_unique<World>(1);
+        auto parallel = std::make_unique<World>(aWorkers);
+        for (auto *world : {single.get(), parallel.get()})
+        {
+            CreateScene(*world, 24, aSeed);
+            world->physicsSystem.SetSleepEnabled(aSleep);
+        }
+
+        bool moved = false;
+        for (int tick = 0; tick < kTicks; ++tick)
+        {
+            Step(*single);
+            Step(*parallel);
+            if (!NABLA2D_CHECK(SameBodies(*single, *parallel)))
+            {
+                Logger::error("Workers {}, sleep {}, seed {}: bodies differ at tick {}", aWorkers, aSleep, aSeed, tick);
+                return;
+            }
+            moved = moved || single->physicsSystem.GetAwakeIslandCount() > 8U;
+        }
+        NABLA2D_CHECK(moved);
+        NABLA2D_CHECK(single->physicsSystem.GetIslandCount() == parallel->physicsSystem.GetIslandCount());
+        NABLA2D_CHECK(single->physicsSystem.GetAwakeIslandCount() == parallel->physicsSystem.GetAwakeIslandCount());
+    }
+} // namespace nabla2d
+
+int main()
+{
+    for (std::size_t workers : {2U, 4U, 8U})
+    {
+        nabla2d::TestWorkerCount(workers, true, static_cast<uint32_t>(workers));
+        nabla2d::TestWorkerCount(workers, false, static_cast<uint32_t>(workers) + 1U);
+    }
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,204 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include "check.hpp"
+#include "scene.hpp"
+#include "stringid.hpp"
+#include "sceneserializer.hpp"
+
+namespace nabla2d
+{
+    struct Health
+    {
+        int32_t value;
+        float regeneration;
+    };
+
+    // Stricter alignment than the file's 4 bytes
+    struct Seed
+    {
+        uint64_t value;
+        uint32_t flags;
+    };
+
+    static std::string GetPath(const std::string &aName)
+    {
+        return (std::filesystem::temp_directory_path() / aName).string();
+    }
+
+    // Three levels of named entities, some anonymous leaves and components on part of them
+    static void CreateScene(Scene &aScene)
+    {
+        auto &registry = aScene.GetRegistry();
+        for (int i = 0; i < 3; ++i)
+        {
+            const auto root = aScene.CreateEntity("root_" + std::to_string(i));
+            registry.emplace<Health>(root, Health{100 + i, 0.5F * static_cast<float>(i)});
+            for (int j = 0; j < 4; ++j)
+            {
+                const auto child = aScene.CreateEntity("child_" + std::to_string(i) + "_" + std::to_string(j), root);
+                if (j % 2 == 0)
+                {
+                    registry.emplace<Seed>(child, Seed{0x0123456789ABCDEFULL * static_cast<uint64_t>(i * 4 + j + 1), static_cast<uint32_t>(j)});
+                }
+                for (int k = 0; k < j; ++k)
+                {
+                    const auto leaf = aScene.CreateEntity("leaf_" + std::to_string(i) + "_" + std::to_string(j) + "_" + std::to_string(k), child);
+                    registry.emplace<Health>(leaf, Health{k, 1.0F});
+                    registry.emplace<Seed>(leaf, Seed{static_cast<uint64_t>(k) << 40U, 7});
+                }
+            }
+        }
+
+        const auto parent = aScene.GetEntity(StringID("child_1_3"));
+        const std::vector<StringID> tags(5);
+        const std::vector<uint32_t> parents{Scene::kNoParent, 0, 0, 1, Scene::kNoParent};
+        const auto anonymous = aScene.CreateEntities(tags, parents, parent);
+        registry.emplace<Health>(anonymous[3], Health{-1, -1.0F});
+    }
+
+    static bool SameData(const SceneSerializer::SceneData &aA, const SceneSerializer::SceneData &aB)
+    {
+        if (aA.tags != aB.tags || aA.parents != aB.parents || aA.pools.size() != aB.pools.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < aA.pools.size(); ++i)
+        {
+            const auto &a = aA.pools[i];
+            const auto &b = aB.pools[i];
+            if (a.type != b.type || a.elementSize != b.elementSize || a.indices != b.indices ||
+                std::memcmp(a.GetData(), b.GetData(), a.indices.size() * a.elementSize) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Saving then loading gives back the same tags, hierarchy and components
+    static void TestRoundTrip()
+    {
+        Scene scene;
+        CreateScene(scene);
+        const auto path = GetPath("nabla2d_sceneserializertest.n2ds");
+        NABLA2D_CHECK(SceneSerializer::Save(scene, path));
+
+        Scene loaded;
+        loaded.CreateEntity("stale");
+        NABLA2D_CHECK(SceneSerializer::Load(loaded, path));
+        NABLA2D_CHECK(loaded.GetEntity(StringID("stale")) == entt::null);
+        NABLA2D_CHECK(SameData(SceneSerializer::Capture(scene), SceneSerializer::Capture(loaded)));
+
+        const auto leaf = loaded.GetEntity(StringID("leaf_2_3_1"));
+        const auto child = loaded.GetEntity(StringID("child_2_3"));
+        NABLA2D_CHECK(leaf != entt::null && loaded.GetParent(leaf) == child);
+        NABLA2D_CHECK(loaded.GetParent(child) == loaded.GetEntity(StringID("root_2")));
+        NABLA2D_CHECK(loaded.GetTag(leaf) == "leaf_2_3_1");
+
+        const auto &registry = loaded.GetRegistry();
+        const auto *health = registry.try_get<Health>(leaf);
+        const auto *seed = registry.try_get<Seed>(child);
+        NABLA2D_CHECK(health != nullptr && health->value == 1 && health->regeneration == 1.0F);
+        NABLA2D_CHECK(seed == nullptr);
+        seed = registry.try_get<Seed>(loaded.GetEntity(StringID("child_2_2")));
+        NABLA2D_CHECK(seed != nullptr && seed->value == 0x0123456789ABCDEFULL * 11U && seed->flags == 2U);
+
+        // The anonymous entities hang under child_1_3, the fourth one under the second
+        const auto &children = loaded.GetChildren(loaded.GetEntity(StringID("child_1_3")));
+        std::size_t anonymous = 0;
+        for (auto entity : children)
+        {
+            anonymous += loaded.GetTagID(entity).IsValid() ? 0U : 1U;
+        }
+        NABLA2D_CHECK(anonymous == 2U);
+
+        std::filesystem::remove(path);
+    }
+
+    // Read data keeps the file mapped once the first copy is gone, and restores under a parent
+    static void TestReadRestore()
+    {
+        Scene scene;
+        CreateScene(scene);
+        const auto captured = SceneSerializer::Capture(scene);
+        const auto path = GetPath("nabla2d_sceneserializertest_read.n2ds");
+        NABLA2D_CHECK(SceneSerializer::Write(captured, path));
+
+        SceneSerializer::SceneData data;
+        {
+            SceneSerializer::SceneData read;
+            NABLA2D_CHECK(SceneSerializer::Read(path, read));
+            NABLA2D_CHECK(read.file != nullptr && read.pools.size() == 2U && read.pools[0].data.empty());
+            data = read;
+        }
+        std::filesystem::remove(path);
+        NABLA2D_CHECK(SameData(captured, data));
+
+        Scene target;
+        const auto parent = target.CreateEntity("parent");
+        const auto entities = SceneSerializer::Restore(target, data, parent);
+        NABLA2D_CHECK(entities.size() == captured.tags.size());
+        if (entities.size() != captured.tags.size())
+        {
+            return;
+        }
+
+        const auto &registry = target.GetRegistry();
+        for (std::size_t i = 0; i < entities.size(); ++i)
+        {
+            const auto expected = captured.parents[i] == Scene::kNoParent ? parent : entities[captured.parents[i]];
+            NABLA2D_CHECK(target.GetParent(entities[i]) == expected);
+            NABLA2D_CHECK(target.GetTagID(entities[i]) == captured.tags[i]);
+
+            const auto source = captured.tags[i].IsValid() ? scene.GetEntity(captured.tags[i]) : entt::null;
+            if (source == entt::null)
+            {
+                continue;
+            }
+            const auto *a = scene.GetRegistry().try_get<Seed>(source);
+            const auto *b = registry.try_get<Seed>(entities[i]);
+            NABLA2D_CHECK((a == nullptr) == (b == nullptr));
+            if (a != nullptr && b != nullptr)
+            {
+                NABLA2D_CHECK(a->value == b->value && a->flags == b->flags);
+            }
+        }
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::SceneSerializer::RegisterComponent<nabla2d::Health>("Health");
+    nabla2d::SceneSerializer::RegisterComponent<nabla2d::Seed>("Seed");
+
+    nabla2d::TestRoundTrip();
+    nabla2d::TestReadRestore();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
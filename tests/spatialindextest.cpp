@@ -0,0 +1,120 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "check.hpp"
+#include "jobsystem.hpp"
+#include "components.hpp"
+#include "spatialindex.hpp"
+
+namespace nabla2d
+{
+    static entt::entity CreateBox(entt::registry &aRegistry, const glm::vec2 &aPosition)
+    {
+        const auto entity = aRegistry.create();
+        aRegistry.emplace<WorldTransform>(entity).matrix[3] = glm::vec4(aPosition, 0.0F, 1.0F);
+        aRegistry.emplace<Bounds>(entity);
+        return entity;
+    }
+
+    static std::vector<entt::entity> QueryAll(const SpatialIndex &aIndex)
+    {
+        std::vector<entt::entity> results;
+        aIndex.QueryAABB({glm::vec2(-100.0F), glm::vec2(100.0F)}, results);
+        return results;
+    }
+
+    // The id of a destroyed entity comes back with a new version before the index saw it go
+    static void TestRecycledEntity()
+    {
+        entt::registry registry;
+        SpatialIndex index;
+        const auto first = CreateBox(registry, {0.0F, 0.0F});
+        const auto other = CreateBox(registry, {10.0F, 0.0F});
+        index.Update(registry);
+
+        registry.destroy(first);
+        const auto recycled = CreateBox(registry, {10.0F, 0.0F});
+        NABLA2D_CHECK(entt::to_entity(recycled) == entt::to_entity(first));
+        index.Update(registry);
+
+        NABLA2D_CHECK(index.GetSize() == 2);
+        NABLA2D_CHECK(!index.Contains(first));
+        NABLA2D_CHECK(index.Contains(recycled));
+        auto results = QueryAll(index);
+        std::sort(results.begin(), results.end());
+        NABLA2D_CHECK((results == std::vector<entt::entity>{std::min(recycled, other), std::max(recycled, other)}));
+
+        // The recycled entity sits on the other one, they must be the only pair
+        JobSystem jobSystem(1);
+        std::vector<std::pair<entt::entity, entt::entity>> pairs;
+        index.QueryPairs(jobSystem, pairs);
+        NABLA2D_CHECK(pairs.size() == 1);
+
+        // Removing through the swap with the last proxy keeps the recycled one reachable
+        registry.destroy(other);
+        index.Update(registry);
+        NABLA2D_CHECK(index.GetSize() == 1);
+        NABLA2D_CHECK(QueryAll(index) == std::vector<entt::entity>{recycled});
+        index.Remove(recycled);
+        NABLA2D_CHECK(index.GetSize() == 0);
+        NABLA2D_CHECK(QueryAll(index).empty());
+    }
+
+    // Same through the direct API, the stale handle must not touch the new proxy
+    static void TestRecycledInsert()
+    {
+        entt::registry registry;
+        SpatialIndex index;
+        const auto first = registry.create();
+        const auto second = registry.create();
+        index.Insert(first, {glm::vec2(0.0F), glm::vec2(1.0F)});
+        index.Insert(second, {glm::vec2(5.0F), glm::vec2(6.0F)});
+
+        registry.destroy(first);
+        const auto recycled = registry.create();
+        index.Insert(recycled, {glm::vec2(20.0F), glm::vec2(21.0F)});
+        NABLA2D_CHECK(index.GetSize() == 2);
+
+        index.Remove(first);
+        NABLA2D_CHECK(index.Contains(recycled));
+        index.Remove(second);
+        NABLA2D_CHECK(index.GetSize() == 1);
+
+        std::vector<entt::entity> results;
+        index.QueryPoint(glm::vec2(0.5F), results);
+        NABLA2D_CHECK(results.empty());
+        index.QueryPoint(glm::vec2(20.5F), results);
+        NABLA2D_CHECK(results == std::vector<entt::entity>{recycled});
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::TestRecycledEntity();
+    nabla2d::TestRecycledInsert();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,62 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <string>
+#include <cstring>
+
+#include "check.hpp"
+#include "stringid.hpp"
+
+namespace nabla2d
+{
+    using namespace literals;
+
+    static_assert(StringID("player") == "player"_sid, "Literals hash at compile time");
+    static_assert(StringID("") == ""_sid, "The empty string has an id");
+
+    // Every way of naming the same text gives the same id
+    static void TestSameText()
+    {
+        char buffer[64] = {};
+        std::strcpy(buffer, "player");
+        const std::string text("player");
+        NABLA2D_CHECK(StringID(buffer) == StringID(text));
+        NABLA2D_CHECK(StringID(buffer) == "player"_sid);
+        NABLA2D_CHECK(StringID::Intern(text) == StringID("player"));
+
+        // Leftovers of a longer string after the NUL don't count
+        std::strcpy(buffer, "player_two");
+        buffer[6] = '\0';
+        NABLA2D_CHECK(StringID(buffer) == StringID(text));
+
+        const char full[6] = {'p', 'l', 'a', 'y', 'e', 'r'};
+        NABLA2D_CHECK(StringID(full) == StringID(text));
+        NABLA2D_CHECK(StringID(buffer) != StringID("play"));
+    }
+} // namespace nabla2d
+
+int main()
+{
+    nabla2d::TestSameText();
+    return NABLA2D_CHECK_RESULT();
+}
+
+// くコ:彡
\ No newline at end of file
@@ -0,0 +1,136 @@
+//    _  __     __   __     ___  ___
+//   / |/ /__ _/ /  / /__ _|_  |/ _ |
+//  /    / _ `/ _ \/ / _ `/ __// // /
+// /_/|_/\_,_/_.__/_/\_,_/____/____/
+//
+// Copyright (C) 2023 - Efflam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Compares a --bench report against a stored baseline and flags regressions.
+// Exits with 1 when any tracked value got worse by more than the threshold.
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+  constexpr double kDefaultThreshold = 0.10;
+  // Timings below this many milliseconds are too noisy to flag
+  constexpr double kMinimumTime = 0.01;
+
+  bool LoadReport(const std::string &aPath, nlohmann::json &aReport)
+  {
+    std::ifstream file(aPath);
+    if (!file)
+    {
+      fmt::print(stderr, "Failed to open '{}'\n", aPath);
+      return false;
+    }
+
+    try
+    {
+      file >> aReport;
+    }
+    catch (const nlohmann::json::exception &e)
+    {
+      fmt::print(stderr, "Failed to parse '{}': {}\n", aPath, e.what());
+      return false;
+    }
+    return true;
+  }
+
+  // Returns true if aCurrent regressed from aBaseline
+  bool Compare(const std::string &aName, double aBaseline, double aCurrent, double aThreshold, double aMinimum)
+  {
+    const double change = aBaseline > 0.0 ? (aCurrent - aBaseline) / aBaseline : (aCurrent > 0.0 ? 1.0 : 0.0);
+    const bool regressed = change > aThreshold && aCurrent >= aMinimum;
+    fmt::print("{:<36} {:>12.4f} {:>12.4f} {:>+8.1f}% {}\n", aName, aBaseline, aCurrent, change * 100.0, regressed ? "REGRESSION" : "");
+    return regressed;
+  }
+
+  double Get(const nlohmann::json &aReport, const nlohmann::json::json_pointer &aPointer)
+  {
+    return aReport.contains(aPointer) ? aReport.at(aPointer).get<double>() : 0.0;
+  }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    fmt::print(stderr, "Usage: {} <baseline.json> <report.json> [threshold, default {}]\n", argv[0], kDefaultThreshold);
+    return 2;
+  }
+
+  const double threshold = argc > 3 ? std::strtod(argv[3], nullptr) : kDefaultThreshold;
+
+  nlohmann::json baseline;
+  nlohmann::json report;
+  if (!LoadReport(argv[1], baseline) || !LoadReport(argv[2], report))
+  {
+    return 2;
+  }
+
+  if (baseline.value("scenario", "") != report.value("scenario", ""))
+  {
+    fmt::print(stderr, "Scenario mismatch: '{}' vs '{}'\n", baseline.value("scenario", ""), report.value("scenario", ""));
+    return 2;
+  }
+
+  fmt::print("{:<36} {:>12} {:>12} {:>9}\n", report.value("scenario", ""), "baseline", "current", "change");
+
+  std::vector<std::string> timings = {"/frameTime"};
+  if (report.contains("phases"))
+  {
+    for (const auto &phase : report["phases"].items())
+    {
+      timings.push_back("/phases/" + phase.key());
+    }
+  }
+
+  int regressions = 0;
+  for (const auto &timing : timings)
+  {
+    for (const char *statistic : {"p50", "p95", "p99"})
+    {
+      const nlohmann::json::json_pointer pointer(timing + "/" + statistic);
+      regressions += Compare(pointer.to_string(), Get(baseline, pointer), Get(report, pointer), threshold, kMinimumTime) ? 1 : 0;
+    }
+  }
+
+  // Counters are deterministic for a given scenario, any increase is flagged
+  if (report.contains("renderer"))
+  {
+    for (const auto &counter : report["renderer"].items())
+    {
+      if (!counter.value().is_object())
+      {
+        continue;
+      }
+      const nlohmann::json::json_pointer pointer("/renderer/" + counter.key() + "/mean");
+      regressions += Compare(pointer.to_string(), Get(baseline, pointer), Get(report, pointer), 0.0, 0.0) ? 1 : 0;
+    }
+  }
+
+  fmt::print("{} regression(s) above {:.0f}%\n", regressions, threshold * 100.0);
+  return regressions > 0 ? 1 : 0;
+}
+
+// くコ:彡
\ No newline at end of file